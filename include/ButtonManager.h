@@ -2,12 +2,16 @@
 #define BUTTON_MANAGER_H
 
 #include <Arduino.h>
-#include <OneButton.h>
+#include "button_gesture.h"
 
+// 按键管理器 - 引脚中断记录带时间戳的边沿，tick()中识别手势并调用回调
+//   手势按边沿时间判定，主循环被显示或阻塞延时拖慢时点击不会丢失或误判
 class ButtonManager {
 public:
     ButtonManager(uint8_t buttonPin);
     void init();
+    // 允许按键在自动浅睡中唤醒，须在init()之后调用
+    void enableSleepWake();
     void tick();
     void enable();
     void disable();
@@ -30,12 +34,20 @@ public:
 
 private:
     uint8_t pin;
-    OneButton button;
     bool enabled;
-    unsigned long debounceTicks;
-    unsigned long clickTicks;
-    unsigned long pressTicks;
+    volatile bool sleepWake;
+    ButtonEdgeQueue edges;
+    ButtonGestureRecognizer recognizer;
+
+    void (*singleClickCallback)();
+    void (*doubleClickCallback)();
+    void (*longPressCallback)();
+    void (*multiClickCallback)(int);
+    void (*duringLongPressCallback)();
+    void (*longPressStopCallback)();
+
+    static void onEdgeISR(void* arg);
+    void dispatch(const ButtonEvent& event);
 };
 
 #endif // BUTTON_MANAGER_H
-
@@ -0,0 +1,91 @@
+#ifndef BUTTON_GESTURE_H
+#define BUTTON_GESTURE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "edge_queue.h"
+
+static_assert((BUTTON_EVENT_QUEUE_SIZE & (BUTTON_EVENT_QUEUE_SIZE - 1)) == 0, "事件队列长度必须为2的幂");
+
+// 按键原始边沿：中断中记录电平（true为按下）与时间戳
+typedef Edge ButtonEdge;
+typedef EdgeQueue<BUTTON_EDGE_QUEUE_SIZE> ButtonEdgeQueue;
+
+// 浅睡唤醒只支持电平触发，开启后引脚中断也随之变为电平触发：
+// 每次中断后改为等待与当前相反的电平，按下和松开各触发一次，边沿队列仍得到交替的电平
+static inline bool buttonWakeOnHigh(bool pressed) { return !pressed; }
+
+// 按键手势
+enum ButtonGesture {
+    GESTURE_CLICK,          // count次连击（1=单击，2=双击，3=三击）
+    GESTURE_LONG_PRESS,     // 按住达到长按阈值
+    GESTURE_HOLD_REPEAT,    // 长按保持期间周期触发，count为重复序号
+    GESTURE_LONG_RELEASE    // 长按后松开
+};
+
+struct ButtonEvent {
+    ButtonGesture gesture;
+    uint8_t count;
+    uint64_t atUs;          // 手势成立的时刻（按边沿时间戳推算，与主循环何时处理无关）
+};
+
+struct ButtonTiming {
+    uint32_t debounceUs;    // 电平需保持稳定的时间
+    uint32_t clickGapUs;    // 松开后等待下一次按下的窗口
+    uint32_t longPressUs;
+    uint32_t repeatUs;
+    uint8_t maxClicks;
+};
+
+// 手势识别器 - 只依据边沿时间戳判定，主循环延迟处理不影响结果
+//   feed()按时间顺序输入边沿，update()推进到当前时刻以处理超时
+class ButtonGestureRecognizer {
+public:
+    ButtonGestureRecognizer();
+
+    void setTiming(const ButtonTiming& timing) { this->timing = timing; }
+    const ButtonTiming& getTiming() const { return timing; }
+
+    void feed(const ButtonEdge& edge);
+    void update(uint64_t nowUs);
+    void reset();
+
+    bool nextEvent(ButtonEvent& event);
+    uint8_t pendingEvents() const { return (uint8_t)(eventHead - eventTail); }
+    uint32_t droppedEvents() const { return eventOverflows; }
+
+    bool isPressed() const { return stablePressed; }
+    bool isLongPressed() const { return state == STATE_HOLDING; }
+
+private:
+    enum State {
+        STATE_IDLE,
+        STATE_PRESSED,
+        STATE_WAIT_NEXT,
+        STATE_HOLDING
+    };
+
+    ButtonTiming timing;
+    State state;
+    uint64_t clockUs;       // 已推进到的时刻
+    bool rawPressed;
+    uint64_t rawSinceUs;
+    bool stablePressed;
+    uint64_t pressUs;
+    uint64_t releaseUs;
+    uint64_t nextRepeatUs;
+    uint8_t clicks;
+    uint8_t repeats;
+
+    ButtonEvent events[BUTTON_EVENT_QUEUE_SIZE];
+    uint8_t eventHead;
+    uint8_t eventTail;
+    uint32_t eventOverflows;
+
+    void advanceTo(uint64_t atUs);
+    void fireDeadlines(uint64_t untilUs);
+    void applyStable(bool pressed, uint64_t atUs);
+    void publish(ButtonGesture gesture, uint8_t count, uint64_t atUs);
+};
+
+#endif // BUTTON_GESTURE_H
@@ -14,14 +14,29 @@
 // LED配置
 #define LED_COUNT               12    // LED数量
 #define LED_BRIGHTNESS          50    // LED亮度 (0-255)
+#define LED_GAMMA_ENABLED       true  // 输出前做伽马校正
+#define LED_CURRENT_BUDGET_MA   300   // 灯带电流上限，超出时整帧按比例压暗（0为不限）
 
 // OLED配置
 #define OLED_WIDTH              128   // OLED宽度
 #define OLED_HEIGHT             64    // OLED高度
 #define OLED_RESET_PIN          -1    // OLED复位引脚
 
+// 电池检测配置 - 电池经100k/100k分压接ADC1
+#define BATTERY_ADC_PIN         3     // 电池分压检测引脚 (GPIO3)
+#define BATTERY_DIVIDER_X100    200   // 分压比×100
+#define BATTERY_INTERNAL_MOHM   150   // 电池内阻+保护板+走线 (mΩ)
+#define BATTERY_CAPACITY_MAH    1000  // 电池容量
+#define BATTERY_SAMPLE_INTERVAL_MS 10000  // 采样间隔
+#define BATTERY_OVERSAMPLE      16    // 每次采样的ADC读数
+#define BATTERY_BASE_LOAD_MA    95    // 除LED外的平均电流（芯片+无线+OLED）
+#define BATTERY_SHOWN_CONES     4     // 主菜单显示电量的锥桶数
+#define ENERGY_SAMPLE_INTERVAL_MS 100   // 能耗估算的采样间隔（LED/OLED状态、发射计数）
+
 // 震动传感器配置
-#define VIBRATION_SENSOR_TYPE   0     // 0=常闭开关量传感器，1=数值传感器
+#ifndef VIBRATION_SENSOR_TYPE
+#define VIBRATION_SENSOR_TYPE   0     // 0=常闭开关量传感器，1=模拟冲击传感器（连续ADC采样）
+#endif
 #define VIBRATION_DEBOUNCE_MS   200   // 震动防抖时间 (开关量传感器需要更长防抖)
 
 // 按钮配置
@@ -29,6 +44,10 @@
 #define BUTTON_CLICK_MS         400   // 点击间隔时间（双击检测窗口）
 #define BUTTON_DOUBLE_CLICK_MS  300   // 双击时间间隔 (ms)
 #define BUTTON_LONG_PRESS_MS    1000  // 长按时间阈值
+#define BUTTON_HOLD_REPEAT_MS   250   // 长按保持期间的重复事件间隔
+#define BUTTON_MAX_CLICKS       3     // 连击计数上限，达到后立即上报
+#define BUTTON_EDGE_QUEUE_SIZE  32    // 中断边沿队列长度（2的幂）
+#define BUTTON_EVENT_QUEUE_SIZE 8     // 手势事件队列长度（2的幂）
 
 // 计时配置
 #define TIMING_READY_DELAY_MS   3000  // 准备时间
@@ -36,10 +55,13 @@
 #define TIMING_ALERT_INTERVAL   5000  // 提醒间隔
 
 // ESP-NOW配置
-#define ESPNOW_CHANNEL          1     // ESP-NOW信道
+#define ESPNOW_CHANNEL          1     // 约定信道：开机及失联后在此会合，主机会话开始时可换到更空闲的信道
 #define ESPNOW_ENCRYPT          false // 是否加密
 #define DEVICE_A_MAC            {0x50, 0x78, 0x7d, 0x46, 0xd4, 0x80}  // 主机设备 COM8
 #define DEVICE_B_MAC            {0x50, 0x78, 0x7d, 0x46, 0xcc, 0x90}  // 从机设备 COM3
+#ifndef CONE_ID
+#define CONE_ID                 0     // 组命令中的锥桶号（主机0，从机从1起编号）
+#endif
 
 // 声音配置
 #define BEEP_FREQUENCY          2000  // 蜂鸣器频率
@@ -53,7 +75,8 @@ enum SystemState {
     STATE_TRAINING,       // 训练中
     STATE_TIMING,         // 计时中
     STATE_COMPLETE,       // 完成
-    STATE_ERROR           // 错误
+    STATE_ERROR,          // 错误
+    STATE_COUNT           // 状态数量（转换表维度）
 };
 
 // 训练模式
@@ -84,8 +107,8 @@ typedef struct {
     uint8_t command;
     uint8_t target_id;
     uint8_t source_id;
-    uint32_t timestamp;
-    uint32_t data;
+    uint32_t timestamp;    // 发送方Clock::stamp32()，单调时钟低32位（微秒）
+    uint32_t data;         // 用时类数据单位为0.1ms (CLOCK_TICK_US)
     uint8_t checksum;
 } message_t;
 
@@ -107,6 +130,20 @@ enum CommandType {
     CMD_VT_START_ROUND = 0x20,    // 主机发送：开始单次计时
     CMD_VT_ROUND_COMPLETE = 0x21, // 从机发送：单次完成
     CMD_VT_TRAINING_EXIT = 0x22,  // 退出训练
+    // 授时
+    CMD_TIME_SYNC = 0x30,         // 主机广播：墙钟时间 (TimeSyncMessage)
+    CMD_TIME_REQUEST = 0x31,      // 从机发送：请求立即授时
+    // 组命令
+    CMD_GROUP_COMMAND = 0x40,     // 主机广播：多锥桶灯光/布防 (group_command.h)
+    CMD_GROUP_REPORT = 0x41,      // 锥桶发送：组命令执行时刻偏差
+    CMD_LED_BRIGHTNESS = 0x42,    // 主机发送：LED亮度设置，data为0-100
+    CMD_DUTY_BEACON = 0x43,       // 主机广播：无线占空信标 (duty_cycle.h)
+    CMD_DUTY_ACK = 0x44,          // 锥桶发送：当前占空模式
+    // 信道管理
+    CMD_LINK_PING = 0x50,         // 往返探测，data为序号
+    CMD_LINK_PONG = 0x51,         // 探测回应，原样带回序号
+    CMD_CHANNEL_SWITCH = 0x52,    // 主机广播：换信道，data低8位为信道，高位为距切换的毫秒数
+    CMD_CHANNEL_SWITCH_ACK = 0x53, // 锥桶应答换信道
     CMD_ERROR = 0xFF
 };
 
@@ -137,7 +174,8 @@ enum PairingStatus {
 };
 
 // 配对相关配置
-#define PAIRING_SCAN_DURATION_MS    10000   // 扫描时长
+#define PAIRING_CONFIRM_TIMEOUT_MS  2000    // 发出配对确认后等待对端确认的时间
+#define PAIRING_RESULT_SHOW_MS      2000    // 配对结果显示时长
 #define PAIRING_TIMEOUT_MS          15000   // 配对超时
 #define MAX_DISCOVERED_DEVICES      5       // 最大发现设备数量
 
@@ -161,6 +199,14 @@ typedef struct {
 #define COLOR_CYAN              0x00FFFF
 #define COLOR_ORANGE            0xFF8000
 
+// 历史趋势范围
+enum HistoryRange {
+    HISTORY_RANGE_7_DAYS,
+    HISTORY_RANGE_30_DAYS,
+    HISTORY_RANGE_90_DAYS,
+    HISTORY_RANGE_COUNT
+};
+
 // 系统设置项
 enum SettingsItems {
     SETTING_SOUND_TOGGLE,
@@ -169,6 +215,7 @@ enum SettingsItems {
     SETTING_DATE_TIME,
     SETTING_ALERT_DURATION,
     SETTING_DEVICE_PAIRING,
+    SETTING_ENERGY_REPORT,
     SETTING_BACK,
     SETTING_ITEM_COUNT
 };
@@ -184,12 +231,13 @@ enum LedColorOption {
     LED_COLOR_COUNT
 };
 
-// 训练数据记录结构
+// 训练数据记录结构（记录存储中按8字节压缩保存，读取时展开为该结构）
 typedef struct {
-    uint32_t timestamp;     // 时间戳
-    uint32_t duration;      // 训练持续时间 (毫秒)
+    uint32_t timestamp;     // 壁钟时间戳 (Unix秒)
+    uint32_t duration;      // 训练持续时间 (0.1毫秒)
     uint8_t mode;          // 训练模式
     bool completed;        // 是否完成
+    bool clockValid;       // 记录时壁钟是否有效
 } TrainingRecord;
 
 // 训练统计数据结构
@@ -204,9 +252,22 @@ typedef struct {
 } TrainingStats;
 
 // 历史数据配置
-#define MAX_TRAINING_RECORDS    50    // 最大记录数
+#define TRAINING_RECORD_RAM_BUDGET  32768  // 训练记录环形缓冲区内存预算 (字节)
+#define MAX_TRAINING_RECORDS    (TRAINING_RECORD_RAM_BUDGET / 8)  // 最大记录数 (每条8字节)
 #define WEEKLY_TREND_POINTS     8     // 趋势图数据点数量
 
+// 训练日志配置 (LittleFS追加日志)
+#define LOG_SEGMENT_MAX_BYTES   16384 // 单个日志段最大字节数
+#define LOG_MAX_SEGMENTS        40    // 保留的最大段数 (超出后删除最旧段)
+#define LOG_BATCH_MAX           64    // 内存批次缓冲区最大记录数
+#define LOG_FLUSH_THRESHOLD     32    // 累积记录数达到该值后在空闲时落盘
+
+// 统计配置
+#define STATS_DAY_BUCKETS       90    // 日历日统计桶数量 (天)
+#define STATS_HIST_BINS         32    // 每日用时直方图桶数 (250ms起每倍频4桶，至64秒)
+#define STATS_TREND_MAX_POINTS  30    // 趋势序列最大点数 (超出时按天合并)
+#define STATS_SNAPSHOT_PATH     "/stats.bin"
+
 // 系统设置结构
 typedef struct {
     bool soundEnabled;
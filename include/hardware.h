@@ -2,21 +2,37 @@
 #define HARDWARE_H
 
 #include <Arduino.h>
-#include <FastLED.h>
-#include <U8g2lib.h>
 #include <Wire.h>
 #include <WiFi.h>
 // 移除Bounce2库，使用新的按键管理器
 #include "config.h"
+#include "hal_arduino.h"
+#include "hal_u8g2.h"
+#include "battery_gauge.h"
+#include "energy_account.h"
 
 // 包含中文字体支持
 #include "u8g2_wqy.h"
 
+// 硬件组件 - 与从机共用HAL，引脚和LED数量在编译期绑定
+typedef FastLedStrip<LED_PIN, LED_COUNT> StatusLeds;
+typedef ToneBuzzer<BUZZER_PIN> Beeper;
+#if VIBRATION_SENSOR_TYPE == 1
+#include "hal_adc_impact.h"
+typedef AdcImpactInput<VIBRATION_SENSOR_PIN, VIBRATION_DEBOUNCE_MS> ImpactSensor;
+#else
+typedef GpioTriggerInput<VIBRATION_SENSOR_PIN, VIBRATION_DEBOUNCE_MS> ImpactSensor;
+#endif
+typedef U8g2Display<OLED_SCL_PIN, OLED_SDA_PIN> OledDisplay;
+
 // 硬件管理类
 class HardwareManager {
 public:
     HardwareManager();
     bool init();
+    // 分阶段启动：引脚与设置 -> LED与显示屏 -> 训练数据
+    bool initCore();
+    bool initOutputs();
     void update();
     
     // LED控制
@@ -24,6 +40,7 @@ public:
     void setAllLEDs(uint32_t color);
     void clearLEDs();
     void showLEDs();
+    void setLedBrightness(uint8_t percent);
     void ledBreathingEffect(uint32_t color);
     void ledProgressBar(int progress, uint32_t color);
     void ledAlertEffect();
@@ -31,6 +48,8 @@ public:
     // 震动传感器
     bool isVibrationDetected();
     int getVibrationStrength();
+    // 最近一次触发的时刻（模拟传感器为越过阈值的采样时刻）
+    uint64_t lastImpactUs() const { return sensor.lastTriggerMicros(); }
     
     // 传统按钮接口（兼容性保留）
     bool isButtonPressed();
@@ -43,7 +62,23 @@ public:
     void playErrorSound();
     void playAlertSound();
     
+    // 电池
+    int batteryPercent() const;         // 尚未采样时为BATTERY_UNKNOWN
+    const BatteryGauge& batteryGauge() const { return battery; }
+    // 其他锥桶随心跳上报的电量（本机锥桶取本地测量值）
+    void setConeBattery(uint8_t cone, int percent);
+    void clearConeBatteries();
+    int coneBattery(uint8_t cone) const;
+    // 剩余可用电量：有测量时按电量，否则按容量减去本会话估算耗电
+    uint32_t remainingMah() const;
+    // 把LED、OLED和蜂鸣器的当前状态计入能耗估算
+    void sampleEnergy(EnergyAccount& account, uint64_t nowUs);
+    
     // OLED显示
+    // 电源状态：按键、触发、无线事件时唤醒；空闲超时随系统状态调暗/关闭面板
+    // 唤醒前面板已关闭时返回true
+    bool wakeDisplay();
+    void serviceDisplay(SystemState state, bool timingRound);
     void displayInit();
     void displayClear();
     void displayText(const char* text, int x = 0, int y = 0, int size = 1);
@@ -52,17 +87,19 @@ public:
     void displayMenu(const char* items[], int selectedIndex, int itemCount);
     void displayTimer(unsigned long time);
     void displayStatus(const char* status);
-    void displayResult(unsigned long time, const char* result);
+    void displayResult(uint32_t ticks, const char* result);  // 用时单位0.1ms
     void displayTrainingStatus(unsigned long totalTime, unsigned long lastTime);
     void displayTrainingDetailedStatus(float currentTime, int sessionCount, bool isConnected, int batteryLevel, int signalStrength, bool isMaster);
-    void displayHistoryData();
+    void displayHistoryData(HistoryRange range);
     
     // 训练数据管理
-    void addTrainingRecord(uint32_t duration, uint8_t mode, bool completed);
+    void addTrainingRecord(uint64_t durationUs, uint8_t mode, bool completed);
     void calculateTrainingStats();
     TrainingStats* getTrainingStats();
     void initializeTrainingData();
-    void createWeeklyTrainingData();
+    void addSessionRecord(uint64_t totalDurationUs, uint8_t mode);  // 课程汇总记录，仅写入日志
+    void flushTrainingLog();
+    void serviceTrainingLog(bool idle);
     void displaySystemSettings();
     void displaySystemSettingsMenu(int selectedIndex);
     void displaySystemSettingsDetail(SettingsItems item, int value = 0);
@@ -71,6 +108,7 @@ public:
     void displayDateTimeAdjustment(int year, int month, int day, int hour, int minute);
     void displayAlertDurationAdjustment(int duration);
     void displayDevicePairing(PairingStatus status, DiscoveredDevice* devices, int deviceCount, int selectedIndex);
+    void displayEnergyReport(const EnergyAccount& account);
     
     // 系统设置管理
     void initializeSettings();
@@ -82,14 +120,22 @@ public:
     const char* getLedColorName(LedColorOption colorOption);
     
 private:
-    CRGB leds[LED_COUNT];
-    U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2;
+    StatusLeds leds;
+    Beeper buzzer;
+    ImpactSensor sensor;
+    OledDisplay display;
+    U8G2& u8g2;
     
     unsigned long lastVibrationTime;
+    BatteryGauge battery;
+    uint64_t lastBatterySampleUs;
+    volatile int8_t coneBatteries[BATTERY_SHOWN_CONES];
+    uint32_t lastBuzzerMs;
     
     void updateVibration();
+    void updateBattery();
+    void drawConeBatteries();
     unsigned long formatTime(unsigned long ms);
-    void drawTrendGraph(); // 绘制趋势图表
 };
 
 extern HardwareManager hardware;
@@ -0,0 +1,27 @@
+#ifndef LITTLEFS_LOG_STORAGE_H
+#define LITTLEFS_LOG_STORAGE_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include "training_log.h"
+
+// LittleFS日志段存储 - 每段一个文件: <目录>/<段号8位十六进制>.seg
+class LittleFsLogStorage : public LogStorage {
+public:
+    explicit LittleFsLogStorage(const char* directory = "/tlog");
+
+    bool begin() override;
+    int listSegments(uint32_t* ids, int maxIds) override;
+    int32_t segmentSize(uint32_t id) override;
+    int32_t read(uint32_t id, uint32_t offset, void* buffer, uint32_t length) override;
+    bool append(uint32_t id, const void* data, uint32_t length) override;
+    bool truncate(uint32_t id, uint32_t size) override;
+    bool remove(uint32_t id) override;
+
+private:
+    const char* directory;
+
+    void segmentPath(uint32_t id, char* path, size_t pathSize);
+};
+
+#endif // LITTLEFS_LOG_STORAGE_H
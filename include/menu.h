@@ -8,7 +8,8 @@
 enum MenuState {
     MENU_STATE_MAIN,
     MENU_STATE_SETTINGS,
-    MENU_STATE_SETTINGS_DETAIL
+    MENU_STATE_SETTINGS_DETAIL,
+    MENU_STATE_HISTORY
 };
 
 class MenuManager {
@@ -42,6 +43,7 @@ private:
     int currentSettingsItem;
     SettingsItems currentSettingsDetail;
     int adjustmentValue;
+    HistoryRange historyRange;
     
     static const char* menuItems[];
     static const int menuItemCount;
@@ -49,6 +51,7 @@ private:
     void showMainMenu();
     void showSettingsMenu();
     void showSettingsDetail();
+    void showHistory();
     void handleMenuSelection();
     void handleSettingsSelection();
     void handleSettingsDetailSelection();
@@ -0,0 +1,61 @@
+#ifndef SETTINGS_CODEC_H
+#define SETTINGS_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+// 设置二进制格式 (小端):
+//   magic u16 | version u8 | payloadSize u8 | payload | crc u32 (覆盖前面全部字节)
+// payload 字段只追加不重排，旧版本的较短payload中缺少的字段保持默认值；
+// 字段语义变化时在迁移表中登记对应版本的迁移函数。
+// 日期时间不持久化，由TimeManager维护。
+#define SETTINGS_BLOB_MAGIC     0x5347  // "GS"
+#define SETTINGS_SCHEMA_VERSION 1
+
+// payload 字段偏移 (version 1)
+#define SETTINGS_OFFSET_FLAGS       0   // bit0 声音开关, bit1 已配对
+#define SETTINGS_OFFSET_LED_COLOR   1
+#define SETTINGS_OFFSET_BRIGHTNESS  2
+#define SETTINGS_OFFSET_ALERT       3   // u16
+#define SETTINGS_OFFSET_PAIRED_MAC  5   // 6字节
+#define SETTINGS_PAYLOAD_SIZE       11
+
+#define SETTINGS_HEADER_SIZE        4
+#define SETTINGS_BLOB_SIZE          (SETTINGS_HEADER_SIZE + SETTINGS_PAYLOAD_SIZE + 4)
+
+// 设置字段（脏标记位）
+enum SettingsField {
+    SETTINGS_FIELD_SOUND      = 1 << 0,
+    SETTINGS_FIELD_LED_COLOR  = 1 << 1,
+    SETTINGS_FIELD_BRIGHTNESS = 1 << 2,
+    SETTINGS_FIELD_ALERT      = 1 << 3,
+    SETTINGS_FIELD_PAIRING    = 1 << 4,
+    SETTINGS_FIELD_ALL        = 0x1F
+};
+
+// 解码结果
+enum SettingsDecodeResult {
+    SETTINGS_DECODE_OK,
+    SETTINGS_DECODE_MIGRATED,       // 旧版本数据，已迁移
+    SETTINGS_DECODE_BAD_LENGTH,
+    SETTINGS_DECODE_BAD_MAGIC,
+    SETTINGS_DECODE_BAD_CRC,
+    SETTINGS_DECODE_UNSUPPORTED     // 更新的固件写入的数据
+};
+
+// 从version迁移到version+1，payload为已按旧版本解码的设置
+typedef void (*SettingsMigration)(SystemSettings& settings);
+
+// 恢复可持久化字段的默认值（不修改日期时间）
+void settingsApplyDefaults(SystemSettings& settings);
+
+// 编码为blob，返回写入字节数（缓冲区不足时为0）
+size_t settingsEncode(const SystemSettings& settings, uint8_t* buffer, size_t size);
+
+// 解码blob到settings：失败时settings保持不变；成功时缺失字段保持传入的值，越界值被修正
+SettingsDecodeResult settingsDecode(const uint8_t* buffer, size_t size, SystemSettings& settings);
+
+const char* settingsDecodeResultString(SettingsDecodeResult result);
+
+#endif // SETTINGS_CODEC_H
@@ -0,0 +1,42 @@
+#ifndef SETTINGS_STORE_H
+#define SETTINGS_STORE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "config.h"
+#include "settings_codec.h"
+
+#define SETTINGS_NVS_NAMESPACE  "agility"
+#define SETTINGS_NVS_KEY        "settings"
+#define SETTINGS_COMMIT_DELAY   3000  // 最后一次修改后延迟提交 (毫秒)
+
+// 设置持久化 - NVS中保存一个带版本和CRC的blob
+// 修改时只做脏标记，停止调整一段时间后合并为一次写入；内容与已保存的相同时跳过写入
+class SettingsStore {
+public:
+    SettingsStore();
+
+    // 启动时加载一次，失败时settings保持默认值
+    bool load(SystemSettings& settings);
+
+    void markDirty(uint16_t fields);
+    uint16_t dirtyFields() const { return dirty; }
+
+    // 主循环调用：脏字段静默超过SETTINGS_COMMIT_DELAY后提交
+    void update(const SystemSettings& settings);
+    // 立即提交（配对等不能丢失的修改）
+    bool commit(const SystemSettings& settings);
+
+    uint32_t getCommitCount() const { return commitCount; }
+
+private:
+    uint16_t dirty;
+    unsigned long lastChangeTime;
+    uint32_t commitCount;
+    uint8_t savedBlob[SETTINGS_BLOB_SIZE];  // 最近一次写入NVS的内容
+    size_t savedSize;
+};
+
+extern SettingsStore settingsStore;
+
+#endif // SETTINGS_STORE_H
@@ -3,67 +3,206 @@
 
 #include <Arduino.h>
 #include "config.h"
-#include "ButtonManager.h"
+
+// 系统事件 - 所有状态变化都必须以事件形式投递给状态管理器
+enum SystemEvent : uint8_t {
+    EVT_NONE,
+    EVT_INIT_DONE,        // 系统初始化完成
+    EVT_MENU_START,       // 菜单选择了"开始训练"
+    EVT_START_LOCAL,      // 本机按键开始训练
+    EVT_START_LINKED,     // 与对端同步开始训练 (CMD_START_TASK / 双设备开始)
+    EVT_TRAINING_DONE,    // 本机训练完成
+    EVT_REMOTE_COMPLETE,  // 收到对端 CMD_TASK_COMPLETE (附带用时)
+    EVT_BACK,             // 用户返回菜单
+    EVT_REMOTE_RESET,     // 收到对端 CMD_RESET
+    EVT_LINK_CHANGED,     // 连接状态发生变化
+    EVT_FAULT,            // 系统故障
+    EVT_COUNT
+};
+
+// 转换动作 - 通过函数表O(1)分派
+enum StateAction : uint8_t {
+    ACT_NONE,
+    ACT_ENTER_MENU,
+    ACT_ENTER_READY,
+    ACT_REFRESH_READY,
+    ACT_START_TRAINING,
+    ACT_START_LINKED,
+    ACT_SHOW_RESULT,
+    ACT_SHOW_REMOTE_RESULT,
+    ACT_RETURN_TO_MENU,
+    ACT_ENTER_ERROR,
+    ACT_COUNT
+};
+
+// 转换表单元格
+struct StateTransition {
+    uint8_t next;    // 下一状态，STATE_IGNORED表示该事件在当前状态下被忽略
+    uint8_t action;  // StateAction
+};
+
+// 转换规则 (from = STATE_COUNT 表示任意状态)
+struct TransitionRule {
+    SystemState from;
+    SystemEvent event;
+    SystemState to;
+    StateAction action;
+};
+
+static constexpr uint8_t STATE_IGNORED = 0xFF;
+static constexpr SystemState STATE_ANY = STATE_COUNT;
+
+// 状态转换规则 - 编译期展开为 [状态 x 事件] 转换表
+static constexpr TransitionRule kTransitionRules[] = {
+    { STATE_INIT,     EVT_INIT_DONE,       STATE_MENU,     ACT_ENTER_MENU },
+    { STATE_MENU,     EVT_MENU_START,      STATE_READY,    ACT_ENTER_READY },
+    { STATE_MENU,     EVT_REMOTE_RESET,    STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_READY,    EVT_START_LOCAL,     STATE_TIMING,   ACT_START_TRAINING },
+    { STATE_READY,    EVT_START_LINKED,    STATE_TIMING,   ACT_START_LINKED },
+    { STATE_READY,    EVT_LINK_CHANGED,    STATE_READY,    ACT_REFRESH_READY },
+    { STATE_READY,    EVT_BACK,            STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_READY,    EVT_REMOTE_RESET,    STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_TIMING,   EVT_TRAINING_DONE,   STATE_COMPLETE, ACT_SHOW_RESULT },
+    { STATE_TIMING,   EVT_REMOTE_COMPLETE, STATE_COMPLETE, ACT_SHOW_REMOTE_RESULT },
+    { STATE_TIMING,   EVT_BACK,            STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_TIMING,   EVT_REMOTE_RESET,    STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_COMPLETE, EVT_BACK,            STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_COMPLETE, EVT_REMOTE_RESET,    STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_ERROR,    EVT_BACK,            STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_ERROR,    EVT_REMOTE_RESET,    STATE_MENU,     ACT_RETURN_TO_MENU },
+    { STATE_ANY,      EVT_FAULT,           STATE_ERROR,    ACT_ENTER_ERROR },
+};
+
+// 允许的状态边（自环总是允许）
+constexpr bool isValidTransition(SystemState from, SystemState to) {
+    return from == to ||
+        (from == STATE_INIT     && (to == STATE_MENU || to == STATE_ERROR)) ||
+        (from == STATE_MENU     && (to == STATE_READY || to == STATE_ERROR)) ||
+        (from == STATE_READY    && (to == STATE_TIMING || to == STATE_MENU || to == STATE_ERROR)) ||
+        (from == STATE_TIMING   && (to == STATE_COMPLETE || to == STATE_MENU || to == STATE_ERROR)) ||
+        (from == STATE_COMPLETE && (to == STATE_MENU || to == STATE_READY || to == STATE_ERROR)) ||
+        (from == STATE_ERROR    && (to == STATE_MENU || to == STATE_INIT)) ||
+        (from == STATE_TRAINING && to == STATE_ERROR);
+}
+
+struct TransitionTable {
+    StateTransition cell[STATE_COUNT][EVT_COUNT];
+};
+
+constexpr TransitionTable buildTransitionTable() {
+    TransitionTable table = {};
+    for (int s = 0; s < STATE_COUNT; ++s) {
+        for (int e = 0; e < EVT_COUNT; ++e) {
+            table.cell[s][e] = { STATE_IGNORED, ACT_NONE };
+        }
+    }
+    for (const TransitionRule& rule : kTransitionRules) {
+        for (int s = 0; s < STATE_COUNT; ++s) {
+            if (rule.from == STATE_ANY || rule.from == s) {
+                table.cell[s][rule.event] = { (uint8_t)rule.to, (uint8_t)rule.action };
+            }
+        }
+    }
+    return table;
+}
+
+// 编译期校验：表中每一条转换都必须是允许的状态边
+constexpr bool transitionTableIsValid(const TransitionTable& table) {
+    for (int s = 0; s < STATE_COUNT; ++s) {
+        for (int e = 0; e < EVT_COUNT; ++e) {
+            const StateTransition& t = table.cell[s][e];
+            if (t.next == STATE_IGNORED) continue;
+            if (t.next >= STATE_COUNT || t.action >= ACT_COUNT) return false;
+            if (!isValidTransition((SystemState)s, (SystemState)t.next)) return false;
+        }
+    }
+    return true;
+}
+
+static constexpr TransitionTable kTransitionTable = buildTransitionTable();
+static_assert(transitionTableIsValid(kTransitionTable), "状态转换表包含非法转换");
+
+// 状态转换跟踪记录 (用于故障后分析)
+struct TransitionTrace {
+    uint32_t timeUs;      // 分派时间 (micros)
+    uint16_t latencyUs;   // 投递到分派的排队延迟
+    uint16_t actionUs;    // 动作执行耗时
+    uint8_t from;
+    uint8_t event;
+    uint8_t to;           // STATE_IGNORED 表示事件被忽略
+    uint8_t action;
+};
+
+#define STATE_EVENT_QUEUE_SIZE   16   // 事件队列长度 (2的幂)
+#define STATE_TRACE_SIZE         32   // 转换跟踪环长度 (2的幂)
 
 // 系统状态管理器类
 class SystemStateManager {
 public:
     SystemStateManager();
-    
+
     // 初始化状态管理器
     bool init();
-    
-    // 更新状态管理器
+
+    // 分派队列中所有待处理事件（在主循环中调用）
     void update();
-    
+
+    // 投递事件，可在按键回调和ESP-NOW接收回调中调用
+    bool postEvent(SystemEvent event, uint32_t payload = 0);
+
     // 获取当前状态
-    SystemState getCurrentState();
-    
-    // 设置状态
-    void setState(SystemState newState);
-    
-    // 状态转换
-    bool canTransitionTo(SystemState newState);
-    void transitionTo(SystemState newState);
-    
-    // 处理按键事件
-    // void handleButtonEvent(ButtonEvent event); // 暂时禁用
-    
-    // 获取状态字符串
+    SystemState getCurrentState() const { return currentState; }
+    unsigned long getStateChangeTime() const { return stateChangeTime; }
+
+    // 获取状态/事件字符串
     const char* getStateString();
     const char* getStateString(SystemState state);
-    
-    // 状态监听
-    void onStateChange(SystemState oldState, SystemState newState);
-    
+    const char* getEventString(SystemEvent event);
+
+    // 转换跟踪
+    void dumpTrace();
+    uint32_t getDroppedEvents() const { return droppedEvents; }
+    uint32_t getMaxLatencyUs() const { return maxLatencyUs; }
+
 private:
-    SystemState currentState;
-    SystemState previousState;
+    struct QueuedEvent {
+        uint8_t event;
+        uint32_t payload;
+        uint32_t postedUs;
+    };
+
+    typedef void (SystemStateManager::*ActionHandler)(uint32_t payload);
+    static const ActionHandler actionHandlers[ACT_COUNT];
+
+    volatile SystemState currentState;
     unsigned long stateChangeTime;
-    bool stateChanged;
-    
-    // 按键事件处理
-    void handleClickInMenu();
-    void handleDoubleClickInMenu();
-    void handleLongPressInMenu();
-    
-    void handleClickInReady();
-    void handleLongPressInReady();
-    
-    void handleClickInComplete();
-    void handleLongPressInComplete();
-    
-    void handleLongPressInTiming();
-    
-    // 状态转换验证
-    bool isValidTransition(SystemState from, SystemState to);
-    
-    // 状态进入/退出处理
-    void onEnterState(SystemState state);
-    void onExitState(SystemState state);
-    
-    // 调试和日志
-    void logStateChange(SystemState oldState, SystemState newState);
+
+    // 事件队列 (多生产者，主循环单消费者)
+    QueuedEvent eventQueue[STATE_EVENT_QUEUE_SIZE];
+    volatile uint8_t queueHead;
+    volatile uint8_t queueTail;
+    uint32_t droppedEvents;
+    portMUX_TYPE queueMux;
+
+    // 转换跟踪环
+    TransitionTrace traceRing[STATE_TRACE_SIZE];
+    uint16_t traceCount;
+    uint32_t maxLatencyUs;
+
+    bool popEvent(QueuedEvent& out);
+    void dispatch(const QueuedEvent& queued);
+
+    // 转换动作
+    void actNone(uint32_t payload);
+    void actEnterMenu(uint32_t payload);
+    void actEnterReady(uint32_t payload);
+    void actRefreshReady(uint32_t payload);
+    void actStartTraining(uint32_t payload);
+    void actStartLinked(uint32_t payload);
+    void actShowResult(uint32_t payload);
+    void actShowRemoteResult(uint32_t payload);
+    void actReturnToMenu(uint32_t payload);
+    void actEnterError(uint32_t payload);
 };
 
 extern SystemStateManager stateManager;
@@ -22,6 +22,9 @@ public:
     // 手动设置时间
     bool setTime(int year, int month, int day, int hour, int minute, int second = 0);
     
+    // 按秒调整当前时间（保留秒内偏移）
+    void adjustTime(int32_t seconds);
+    
     // 获取当前时间
     struct tm getCurrentTime();
     
@@ -46,8 +49,9 @@ public:
     bool isLeapYear(int year);
     int getDaysInMonth(int year, int month);
     
-    // 时间校准（通过NTP服务器）
+    // 时间校准（通过NTP服务器），异步进行，立即返回
     bool syncWithNTP(const char* server = "pool.ntp.org");
+    bool isNtpSynced() const { return ntpSynced; }
     
     // 检查时间是否有效
     bool isTimeValid();
@@ -66,6 +70,7 @@ public:
     
     // 时区设置
     void setTimezone(int offsetHours, int offsetMinutes = 0);
+    int getTimezoneOffset() const { return timezoneOffset; }
     
     // 打印时间信息
     void printTimeInfo();
@@ -73,7 +78,9 @@ public:
 private:
     time_t bootTime;
     int timezoneOffset; // 时区偏移（秒）
-    bool ntpSynced;
+    volatile bool ntpSynced;
+    
+    static void onNtpSynced(struct timeval* tv);
     
     // 内部辅助函数
     bool isValidDate(int year, int month, int day);
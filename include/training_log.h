@@ -0,0 +1,156 @@
+#ifndef TRAINING_LOG_H
+#define TRAINING_LOG_H
+
+#include <stdint.h>
+#include "config.h"
+#include "training_record_store.h"
+
+// 日志段存储接口 - 设备上由LittleFS实现，主机测试中由普通文件实现
+class LogStorage {
+public:
+    virtual ~LogStorage() {}
+
+    virtual bool begin() = 0;
+    // 列出已存在的段号（顺序不限），返回数量
+    virtual int listSegments(uint32_t* ids, int maxIds) = 0;
+    // 段文件大小，不存在时返回-1
+    virtual int32_t segmentSize(uint32_t id) = 0;
+    // 从段的offset处读取，返回实际读取字节数
+    virtual int32_t read(uint32_t id, uint32_t offset, void* buffer, uint32_t length) = 0;
+    // 追加写入并提交到介质（段不存在时创建）
+    virtual bool append(uint32_t id, const void* data, uint32_t length) = 0;
+    virtual bool truncate(uint32_t id, uint32_t size) = 0;
+    virtual bool remove(uint32_t id) = 0;
+};
+
+// 日志段格式 (小端):
+//   段头   : magic 'TLOG' | version u16 | headerSize u16 | segmentId u32 | crc u32
+//   数据块 : magic 0xB10C u16 | count u16 | firstSequence u32 | count x 8字节记录 | crc u32
+//   段尾   : magic 'TEND' | firstSequence | recordCount | firstEpoch | lastEpoch
+//            | blockCount | dataCrc (各数据块CRC的累加CRC) | crc
+// 每次落盘写入一个完整数据块；段写满后追加段尾并封存。
+// 启动时封存段只读段头和段尾，未封存段逐块校验CRC，在第一个损坏块处截断。
+// 版本1的记录用时均为毫秒，读取时换算为当前单位；版本1的未封存段在启动时封存，不再追加。
+#define LOG_SEGMENT_MAGIC      0x474F4C54UL  // "TLOG"
+#define LOG_TRAILER_MAGIC      0x444E4554UL  // "TEND"
+#define LOG_BLOCK_MAGIC        0xB10C
+#define LOG_FORMAT_VERSION     2
+#define LOG_FORMAT_MIN_VERSION 1
+
+struct LogSegmentHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t segmentId;
+    uint32_t crc;
+};
+
+struct LogBlockHeader {
+    uint16_t magic;
+    uint16_t count;
+    uint32_t firstSequence;
+};
+
+struct LogSegmentTrailer {
+    uint32_t magic;
+    uint32_t firstSequence;
+    uint32_t recordCount;
+    uint32_t firstEpoch;
+    uint32_t lastEpoch;
+    uint32_t blockCount;
+    uint32_t dataCrc;
+    uint32_t crc;
+};
+
+static_assert(sizeof(LogSegmentHeader) == 16, "段头必须为16字节");
+static_assert(sizeof(LogBlockHeader) == 8, "块头必须为8字节");
+static_assert(sizeof(LogSegmentTrailer) == 32, "段尾必须为32字节");
+
+#define LOG_BLOCK_BYTES(count) (sizeof(LogBlockHeader) + (count) * sizeof(PackedTrainingRecord) + sizeof(uint32_t))
+
+// 段索引项
+struct LogSegmentInfo {
+    uint32_t id;
+    uint32_t size;           // 段文件字节数
+    uint32_t firstSequence;
+    uint32_t recordCount;
+    uint32_t firstEpoch;
+    uint32_t lastEpoch;
+    uint32_t blockCount;
+    uint32_t dataCrc;
+    uint16_t version;        // 段格式版本
+    bool sealed;
+};
+
+// 启动扫描报告
+struct LogScanReport {
+    uint16_t segments;          // 有效段数
+    uint16_t sealedSegments;    // 通过段尾直接建立索引的段数
+    uint16_t scannedSegments;   // 需要逐块校验的段数
+    uint16_t removedSegments;   // 因段头损坏或超出保留数量而删除的段数
+    uint32_t repairedBytes;     // 截断的撕裂写入字节数
+    uint32_t bytesRead;         // 扫描读取的总字节数
+};
+
+typedef void (*LogRecordCallback)(const PackedTrainingRecord& record, uint32_t sequence, void* context);
+
+// 追加式训练日志 - 记录先进入内存批次，按课程或批次大小落盘
+class TrainingLog {
+public:
+    explicit TrainingLog(LogStorage& storage,
+                         uint32_t segmentMaxBytes = LOG_SEGMENT_MAX_BYTES,
+                         uint16_t maxSegments = LOG_MAX_SEGMENTS);
+
+    // 启动扫描：重建段索引并修复撕裂写入
+    bool begin();
+
+    // 追加记录到内存批次（批次满时强制落盘），返回记录序号
+    uint32_t append(const PackedTrainingRecord& record);
+
+    // 将内存批次作为一个数据块写入当前段
+    bool flush();
+    bool needsFlush() const { return pendingCount >= LOG_FLUSH_THRESHOLD; }
+    uint16_t pendingRecords() const { return pendingCount; }
+
+    // 按序号遍历已落盘的记录
+    bool forEach(uint32_t fromSequence, LogRecordCallback callback, void* context);
+
+    uint32_t nextSequence() const { return persistedSequence + pendingCount; }
+    uint32_t persistedRecords() const;
+    int segmentCount() const { return indexCount; }
+    const LogSegmentInfo& segment(int index) const { return index_[index]; }
+    const LogScanReport& lastScan() const { return report; }
+    // 介质不可写且批次已满时丢弃的记录数
+    uint32_t dropped() const { return droppedRecords; }
+
+private:
+    LogStorage& storage;
+    uint32_t segmentMaxBytes;
+    uint16_t maxSegments;
+
+    LogSegmentInfo index_[LOG_MAX_SEGMENTS];
+    int indexCount;
+    bool activeOpen;             // 索引最后一段是否为可追加的未封存段
+    uint32_t persistedSequence;  // 下一条落盘记录的序号
+
+    PackedTrainingRecord pending[LOG_BATCH_MAX];
+    uint16_t pendingCount;
+
+    uint32_t droppedRecords;
+
+    LogScanReport report;
+    bool scanning;               // 启动扫描期间统计读取字节数
+
+    int32_t readCounted(uint32_t id, uint32_t offset, void* buffer, uint32_t length);
+    bool loadSegment(uint32_t id, LogSegmentInfo& info);
+    // 逐块校验段内数据，返回最后一个完整块之后的偏移；rebuilt非空时重建索引项
+    uint32_t scanBlocks(const LogSegmentInfo& info, uint32_t endOffset, LogSegmentInfo* rebuilt,
+                        LogRecordCallback callback, uint32_t fromSequence, void* context);
+    bool sealSegment(int index);
+    bool openSegment();
+    void dropSegment(int index);
+};
+
+extern TrainingLog trainingLog;
+
+#endif // TRAINING_LOG_H
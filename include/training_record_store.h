@@ -0,0 +1,66 @@
+#ifndef TRAINING_RECORD_STORE_H
+#define TRAINING_RECORD_STORE_H
+
+#include <stdint.h>
+#include "config.h"
+
+// 8字节压缩训练记录
+//   epochSeconds: 壁钟时间 (Unix秒)
+//   packed:       [0..23] 用时  [24..26] 训练模式  [27..31] 标志位
+//   单次记录用时单位为0.1毫秒（最长约28分钟），课程汇总记录单位为毫秒（最长约4.6小时）
+struct PackedTrainingRecord {
+    uint32_t epochSeconds;
+    uint32_t packed;
+};
+static_assert(sizeof(PackedTrainingRecord) == 8, "训练记录必须为8字节");
+
+#define RECORD_DURATION_BITS     24
+#define RECORD_DURATION_MAX      ((1UL << RECORD_DURATION_BITS) - 1)
+#define RECORD_TICK_US           100   // 单次记录用时单位
+#define RECORD_SESSION_UNIT_US   1000  // 课程汇总记录用时单位
+#define RECORD_MODE_SHIFT        24
+#define RECORD_MODE_MASK         0x07
+#define RECORD_FLAGS_SHIFT       27
+
+// 记录标志位
+#define RECORD_FLAG_COMPLETED    0x01  // 训练完成（未超时）
+#define RECORD_FLAG_CLOCK_VALID  0x02  // 记录时壁钟有效
+#define RECORD_FLAG_SESSION      0x04  // 训练课汇总记录（用时为整课总时长），仅写入日志
+
+#define TRAINING_RECORD_CAPACITY MAX_TRAINING_RECORDS
+static_assert((TRAINING_RECORD_CAPACITY & (TRAINING_RECORD_CAPACITY - 1)) == 0,
+              "记录容量必须为2的幂");
+
+// 训练记录环形存储 - 追加O(1)，满后覆盖最旧记录
+class TrainingRecordStore {
+public:
+    TrainingRecordStore();
+
+    // 追加一条记录，返回其序号（自启动以来单调递增）
+    uint32_t append(uint32_t epochSeconds, uint64_t durationUs, uint8_t mode, uint8_t flags);
+    uint32_t append(const PackedTrainingRecord& record);
+
+    // 按时间顺序访问：0为最旧，size()-1为最新
+    TrainingRecord at(uint32_t index) const;
+    const PackedTrainingRecord& rawAt(uint32_t index) const;
+
+    uint32_t size() const { return count; }
+    uint32_t capacity() const { return TRAINING_RECORD_CAPACITY; }
+    uint32_t totalAppended() const { return head; }
+    void clear();
+
+    // 用时按记录类型换算为存储单位，四舍五入并饱和
+    static PackedTrainingRecord pack(uint32_t epochSeconds, uint64_t durationUs, uint8_t mode, uint8_t flags);
+    static TrainingRecord unpack(const PackedTrainingRecord& record);
+    static uint64_t durationUs(const PackedTrainingRecord& record);
+    static uint32_t durationMs(const PackedTrainingRecord& record);
+
+private:
+    PackedTrainingRecord records[TRAINING_RECORD_CAPACITY];
+    uint32_t head;   // 下一个写入位置（未取模）
+    uint32_t count;
+};
+
+extern TrainingRecordStore recordStore;
+
+#endif // TRAINING_RECORD_STORE_H
@@ -0,0 +1,123 @@
+#ifndef TRAINING_STATS_H
+#define TRAINING_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+#include "training_record_store.h"
+
+// 累计统计（全部记录）
+//   mean/m2 为已完成单次用时的Welford在线均值与平方差和
+struct StatsTotals {
+    uint32_t rounds;         // 单次训练总数
+    uint32_t completed;      // 已完成的单次数
+    uint32_t sessions;       // 训练课数
+    uint32_t bestMs;         // 最佳用时，无记录时为0
+    uint64_t totalMs;        // 单次训练总用时
+    uint64_t sessionMs;      // 训练课总时长
+    double mean;
+    double m2;
+};
+
+// 日历日统计桶（按本地日期）
+struct StatsDayBucket {
+    uint32_t day;            // 自1970-01-01起的本地日序号，0表示空桶
+    uint16_t rounds;
+    uint16_t completed;
+    uint16_t sessions;
+    uint16_t reserved;
+    uint32_t totalMs;
+    uint32_t bestMs;
+    float mean;
+    float m2;
+    uint16_t hist[STATS_HIST_BINS];  // 已完成单次用时的几何分桶直方图，用于求中位数
+};
+static_assert(sizeof(StatsDayBucket) == 28 + STATS_HIST_BINS * 2, "日统计桶大小与直方图桶数不一致");
+
+// 日期范围汇总
+struct StatsRange {
+    uint32_t rounds;
+    uint32_t completed;
+    uint32_t sessions;
+    uint16_t activeDays;     // 有单次记录的天数
+    uint64_t totalMs;
+    uint32_t bestMs;
+    uint32_t meanMs;
+    uint32_t stddevMs;
+};
+
+// 趋势序列 - 每点为若干天合并直方图的中位数，0表示该点无数据
+struct StatsTrend {
+    uint8_t count;
+    uint8_t daysPerPoint;
+    uint32_t medianMs[STATS_TREND_MAX_POINTS];
+};
+
+// 统计快照格式 (小端): 快照头 + StatsSnapshotBody，与训练日志一同保存
+//   nextSequence 为快照已包含的日志序号上界，启动时只回放之后的记录
+#define STATS_SNAPSHOT_MAGIC    0x41545354UL  // "TSTA"
+#define STATS_SNAPSHOT_VERSION  2
+
+struct StatsSnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t dayBuckets;
+    uint32_t bodySize;
+    uint32_t crc;            // 快照头(不含crc) + 快照体
+};
+
+struct StatsSnapshotBody {
+    StatsTotals totals;
+    uint32_t nextSequence;
+    uint32_t latestDay;
+    StatsDayBucket days[STATS_DAY_BUCKETS];
+};
+
+#define STATS_SNAPSHOT_BYTES (sizeof(StatsSnapshotHeader) + sizeof(StatsSnapshotBody))
+
+// 增量统计引擎 - 每条记录O(1)更新，查询不再扫描原始记录
+class TrainingStatsEngine {
+public:
+    TrainingStatsEngine();
+
+    void reset();
+
+    // 本地时区相对UTC的偏移，用于划分日历日
+    void setUtcOffset(int32_t seconds) { utcOffset = seconds; }
+    uint32_t dayOf(uint32_t epochSeconds) const;
+
+    // 加入一条日志记录；序号小于nextSequence()的记录已统计过，直接忽略
+    void add(const PackedTrainingRecord& record, uint32_t sequence);
+    uint32_t nextSequence() const { return body.nextSequence; }
+
+    const StatsTotals& totals() const { return body.totals; }
+    uint32_t meanMs() const;
+    uint32_t stddevMs() const;
+    uint32_t latestDay() const { return body.latestDay; }
+
+    // 单日统计，该日无数据或已滚出窗口时返回nullptr
+    const StatsDayBucket* day(uint32_t day) const;
+    // 以lastDay结尾的dayCount天的合并统计
+    void range(uint32_t lastDay, uint16_t dayCount, StatsRange& out) const;
+    // 以lastDay结尾的dayCount天的中位数趋势，超过STATS_TREND_MAX_POINTS天时按天合并
+    void trend(uint32_t lastDay, uint16_t dayCount, StatsTrend& out) const;
+
+    // 用时直方图：几何分桶，中位数在桶内线性插值
+    static uint8_t histogramBin(uint32_t durationMs);
+    static uint32_t histogramEdge(uint8_t bin);
+    static uint32_t histogramMedian(const uint32_t* hist);
+
+    // 快照序列化，返回写入字节数（缓冲区不足时为0）
+    size_t saveSnapshot(uint8_t* buffer, size_t size) const;
+    bool loadSnapshot(const uint8_t* buffer, size_t size);
+
+private:
+    StatsSnapshotBody body;
+    int32_t utcOffset;
+
+    StatsDayBucket* bucketFor(uint32_t day);
+};
+
+extern TrainingStatsEngine statsEngine;
+
+#endif // TRAINING_STATS_H
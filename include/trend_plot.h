@@ -0,0 +1,31 @@
+#ifndef TREND_PLOT_H
+#define TREND_PLOT_H
+
+#include <stdint.h>
+
+// 单色帧缓冲区（SSD1306/u8g2全缓冲页格式）
+//   字节索引 = (y / 8) * width + x，位 = y % 8
+struct FrameBuffer {
+    uint8_t* data;
+    uint16_t width;
+    uint16_t height;
+};
+
+// 绘图区域（像素，含边界）
+struct PlotArea {
+    int16_t x;
+    int16_t y;
+    int16_t width;
+    int16_t height;
+};
+
+void plotPixel(const FrameBuffer& fb, int x, int y);
+// Bresenham直线，超出缓冲区的像素被裁剪
+void plotLine(const FrameBuffer& fb, int x0, int y0, int x1, int y1);
+
+// 按Q16定点比例将序列绘制为折线，值为0的点视为无数据并跳过
+//   点数不多时绘制点标记；返回有效点数，并输出纵轴范围供标注
+int plotTrend(const FrameBuffer& fb, const PlotArea& area, const uint32_t* values, uint8_t count,
+              uint32_t* minValue, uint32_t* maxValue);
+
+#endif // TREND_PLOT_H
@@ -3,6 +3,7 @@
 
 #include "config.h"
 #include "hardware.h"
+#include "role_swap.h"
 
 // 震动训练状态
 enum VibrationTrainingState {
@@ -21,40 +22,49 @@ public:
     void stop();
     void reset();
     void exitTraining();  // 退出训练并显示当天运动情况
+    void endSession();    // 记录本次课程汇总并落盘训练日志
     
     // 主机逻辑
     void handleMasterVibration();  // 主机检测到震动，结束单次计时
-    void handleSlaveComplete(unsigned long roundTime);  // 收到从机开始信号
+    void handleSlaveComplete(uint32_t data);  // 收到从机开始信号
     
     // 从机逻辑  
     void handleSlaveVibration();   // 从机检测到震动，发送开始信号
-    void handleRoundComplete(unsigned long roundTime); // 从机收到主机完成信号
+    void handleRoundComplete(uint32_t roundTicks); // 从机收到主机完成信号（用时单位0.1ms）
     
     bool isRunning() const { return running; }
     bool isCompleted() const { return completed; }
-    unsigned long getElapsedTime() const { return elapsedTime; }
-    unsigned long getTotalTrainingTime() const { return totalTrainingTime; }
+    bool isTimingRound() const { return running && state == VT_STATE_TIMING; }
+    uint64_t getElapsedUs() const { return elapsedUs; }
+    uint64_t getTotalTrainingUs() const { return totalTrainingUs; }
     int getSessionCount() const { return sessionCount; }
     
+    // 角色交换：回合之间才允许交接课程
+    bool isBetweenRounds() const { return running && state == VT_STATE_WAITING; }
+    RoleSwapSession snapshotSession() const;         // 课程计数部分，训练设置由调用方填写
+    void adoptSession(const RoleSwapSession& session); // 成为主机，接续对端的课程
+    void handOverSession();                           // 成为从机，课程汇总交由新主机记录
+    
 private:
     bool running;                    // 训练是否运行中
     bool completed;                  // 整个训练是否完成
     VibrationTrainingState state;    // 当前震动训练状态
     
+    // 时间均为Clock微秒
     // 单次计时相关
-    unsigned long singleStartTime;   // 单次开始时间
-    unsigned long singleElapsedTime; // 单次用时
+    uint64_t singleStartUs;          // 单次开始时间
+    uint64_t singleElapsedUs;        // 单次用时
     
     // 总体统计
-    unsigned long trainingStartTime; // 训练开始时间
-    unsigned long totalTrainingTime; // 总运动时长
-    unsigned long elapsedTime;       // 当前训练总时长
+    uint64_t trainingStartUs;        // 训练开始时间
+    uint64_t totalTrainingUs;        // 总运动时长
+    uint64_t elapsedUs;              // 当前训练总时长
     int sessionCount;                // 完成次数
-    unsigned long lastSessionTime;   // 上次单次用时
+    bool sessionLogged;              // 本次课程汇总是否已记录
+    uint64_t lastSessionUs;          // 上次单次用时
     
     // 提醒相关
-    unsigned long lastAlertTime;     // 上次提醒时间
-    unsigned long alertInterval;     // 提醒间隔
+    uint64_t lastAlertUs;            // 上次提醒时的总运动时长
     
     void updateTimer();
     void checkTimeout();                 // 检查超时
@@ -0,0 +1,83 @@
+#include "battery_gauge.h"
+
+// 典型单节锂电池小电流放电的开路电压曲线
+struct CurvePoint {
+    uint16_t mv;
+    uint8_t percent;
+};
+
+static const CurvePoint kDischargeCurve[] = {
+    {3300, 0},  {3600, 5},  {3690, 10}, {3730, 20}, {3770, 30}, {3800, 40},
+    {3840, 50}, {3870, 60}, {3950, 70}, {4020, 80}, {4110, 90}, {4200, 100},
+};
+static const uint8_t kCurvePoints = sizeof(kDischargeCurve) / sizeof(kDischargeCurve[0]);
+
+BatteryGauge::BatteryGauge(const BatteryConfig& config) : config(config) {
+    reset();
+}
+
+void BatteryGauge::reset() {
+    samples = 0;
+    filteredMv16 = 0;
+    loadMa16 = 0;
+    shownPercent = 0;
+}
+
+uint8_t BatteryGauge::percentFromMv(uint16_t openCircuitMv) {
+    if (openCircuitMv <= kDischargeCurve[0].mv) {
+        return 0;
+    }
+    for (uint8_t i = 1; i < kCurvePoints; i++) {
+        const CurvePoint& high = kDischargeCurve[i];
+        if (openCircuitMv < high.mv) {
+            const CurvePoint& low = kDischargeCurve[i - 1];
+            return (uint8_t)(low.percent + (uint32_t)(openCircuitMv - low.mv) * (high.percent - low.percent) /
+                                               (high.mv - low.mv));
+        }
+    }
+    return 100;
+}
+
+uint16_t BatteryGauge::compensate(uint16_t loadedMv, uint16_t loadMa, uint16_t milliOhm) {
+    // mA × mΩ / 1000 = mV
+    return (uint16_t)(loadedMv + (uint32_t)loadMa * milliOhm / 1000);
+}
+
+void BatteryGauge::addSample(uint16_t pinMv, uint16_t loadMa) {
+    uint16_t loadedMv = (uint16_t)((uint32_t)pinMv * config.dividerX100 / 100);
+    uint32_t openMv16 = (uint32_t)compensate(loadedMv, loadMa, config.internalMilliOhm) * 16;
+
+    if (samples == 0) {
+        filteredMv16 = openMv16;
+        loadMa16 = (uint32_t)loadMa * 16;
+    } else {
+        filteredMv16 = filteredMv16 - filteredMv16 / 4 + openMv16 / 4;
+        loadMa16 = loadMa16 - loadMa16 / 8 + (uint32_t)loadMa * 2;
+    }
+
+    uint8_t percent = percentFromMv(cellMv());
+    if (samples == 0 || percent < shownPercent || percent >= shownPercent + BATTERY_PERCENT_RISE_HYSTERESIS) {
+        shownPercent = percent;
+    }
+    samples++;
+}
+
+uint32_t BatteryGauge::remainingMinutes() const {
+    uint16_t load = averageLoadMa();
+    if (!valid() || load == 0) {
+        return 0;
+    }
+    return (uint32_t)shownPercent * config.capacityMah * 60 / 100 / load;
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+uint16_t batteryReadPinMv(uint8_t pin, uint8_t samples) {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < samples; i++) {
+        sum += analogReadMilliVolts(pin);
+    }
+    return samples ? (uint16_t)(sum / samples) : 0;
+}
+#endif
@@ -0,0 +1,63 @@
+#ifndef BATTERY_GAUGE_H
+#define BATTERY_GAUGE_H
+
+#include <stdint.h>
+
+// 锂电池电量计 - 单节3.7V锂电池经分压接ADC
+//   1. 每隔较长时间过采样读一次分压点电压，换算为电池端电压
+//   2. 按采样时刻的估算负载电流补偿内阻压降，得到近似开路电压
+//   3. 开路电压经放电曲线查表得到电量，按平均负载电流估算剩余时间
+// 电量只在明显回升（充电）时才上调，避免负载波动造成显示来回跳动
+#define BATTERY_PERCENT_RISE_HYSTERESIS 3
+#define BATTERY_UNKNOWN                 -1
+
+struct BatteryConfig {
+    uint16_t dividerX100;         // 分压比×100（100k/100k为200）
+    uint16_t internalMilliOhm;    // 电池内阻+保护板+走线
+    uint16_t capacityMah;
+};
+
+class BatteryGauge {
+public:
+    explicit BatteryGauge(const BatteryConfig& config);
+
+    void reset();
+    // 一次采样：分压点电压（已过采样平均）和采样时刻的估算负载电流
+    void addSample(uint16_t pinMv, uint16_t loadMa);
+
+    bool valid() const { return samples > 0; }
+    // 负载补偿并滤波后的电池开路电压
+    uint16_t cellMv() const { return (uint16_t)(filteredMv16 / 16); }
+    uint8_t percent() const { return shownPercent; }
+    uint16_t averageLoadMa() const { return (uint16_t)(loadMa16 / 16); }
+    // 按平均负载估算的剩余分钟数
+    uint32_t remainingMinutes() const;
+
+    // 开路电压 -> 电量（放电曲线分段线性插值）
+    static uint8_t percentFromMv(uint16_t openCircuitMv);
+    // 带载电压加上内阻压降
+    static uint16_t compensate(uint16_t loadedMv, uint16_t loadMa, uint16_t milliOhm);
+
+private:
+    BatteryConfig config;
+    uint32_t samples;
+    uint32_t filteredMv16;        // 开路电压，×16定点，1/4指数滤波
+    uint32_t loadMa16;            // 负载电流，×16定点，1/8指数滤波
+    uint8_t shownPercent;
+};
+
+// 心跳/应答data字段24-31位：电量+1，0表示未知
+static inline uint32_t batteryPackReport(uint32_t data, int percent) {
+    return percent < 0 ? data : (data & 0x00FFFFFFu) | ((uint32_t)(percent + 1) << 24);
+}
+static inline int batteryReportPercent(uint32_t data) {
+    uint32_t level = data >> 24;
+    return level == 0 || level > 101 ? BATTERY_UNKNOWN : (int)level - 1;
+}
+
+#ifdef ARDUINO
+// 过采样读取分压点电压（使用芯片ADC校准，单位mV）
+uint16_t batteryReadPinMv(uint8_t pin, uint8_t samples);
+#endif
+
+#endif // BATTERY_GAUGE_H
@@ -0,0 +1,42 @@
+#include "boot_profile.h"
+
+BootProfile bootProfile;
+
+BootProfile::BootProfile() : phaseCount(0), startUs(0), readyUs(0) {}
+
+void BootProfile::begin() {
+    phaseCount = 0;
+    readyUs = 0;
+    startUs = micros();
+}
+
+void BootProfile::mark(const char* name) {
+    if (phaseCount >= BOOT_PROFILE_MAX_PHASES) {
+        return;
+    }
+    phases[phaseCount].name = name;
+    phases[phaseCount].endUs = micros();
+    phaseCount++;
+}
+
+void BootProfile::markReady() {
+    readyUs = micros();
+}
+
+void BootProfile::report() const {
+    Serial.println("=== 启动阶段耗时 ===");
+    Serial.printf("  %-12s %8s %8s\n", "阶段", "耗时ms", "结束ms");
+    Serial.printf("  %-12s %8s %8.1f\n", "进入setup", "-", startUs / 1000.0f);
+
+    uint32_t previous = startUs;
+    for (uint8_t i = 0; i < phaseCount; i++) {
+        Serial.printf("  %-12s %8.1f %8.1f\n", phases[i].name,
+                      (phases[i].endUs - previous) / 1000.0f, phases[i].endUs / 1000.0f);
+        previous = phases[i].endUs;
+    }
+
+    if (readyUs != 0) {
+        Serial.printf("可触发时间: %.1f ms\n", readyUs / 1000.0f);
+    }
+    Serial.printf("启动完成: %.1f ms\n", previous / 1000.0f);
+}
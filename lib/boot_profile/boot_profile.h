@@ -0,0 +1,38 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+#define BOOT_PROFILE_MAX_PHASES 12
+
+// 启动阶段计时 - 记录每个阶段结束时的micros()，启动完成后输出报告
+//   micros()从应用启动开始计数，不含ROM和二级引导程序的时间
+class BootProfile {
+public:
+    BootProfile();
+
+    void begin();
+    // 结束当前阶段，name需为静态字符串
+    void mark(const char* name);
+    // 传感器和无线已就绪，可以响应触发
+    void markReady();
+    bool isReady() const { return readyUs != 0; }
+    uint32_t readyMicros() const { return readyUs; }
+
+    void report() const;
+
+private:
+    struct Phase {
+        const char* name;
+        uint32_t endUs;
+    };
+
+    Phase phases[BOOT_PROFILE_MAX_PHASES];
+    uint8_t phaseCount;
+    uint32_t startUs;
+    uint32_t readyUs;
+};
+
+extern BootProfile bootProfile;
+
+#endif // BOOT_PROFILE_H
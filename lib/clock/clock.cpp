@@ -0,0 +1,22 @@
+#include "clock.h"
+
+#ifndef ARDUINO
+static uint64_t virtualUs = CLOCK_EPOCH_OFFSET_US;
+
+uint64_t Clock::nowUs() {
+    return virtualUs;
+}
+
+void Clock::setUs(uint64_t us) {
+    virtualUs = us;
+}
+
+void Clock::advanceUs(uint64_t us) {
+    virtualUs += us;
+}
+#endif
+
+uint32_t Clock::toTicks(uint64_t us) {
+    uint64_t ticks = us / CLOCK_TICK_US + (us % CLOCK_TICK_US >= CLOCK_TICK_US / 2 ? 1 : 0);
+    return ticks > UINT32_MAX ? UINT32_MAX : (uint32_t)ticks;
+}
@@ -0,0 +1,49 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#ifdef ARDUINO
+#include <esp_timer.h>
+#endif
+
+// 64位微秒单调时间基准 - 设备上为esp_timer_get_time()，主机测试中为可设置的虚拟时钟
+//   时间差一律用无符号减法计算（now - since），跨越回绕边界时结果仍正确
+//   构建时定义CLOCK_EPOCH_OFFSET_US可让时钟从接近边界处开始，用于在设备上验证回绕
+
+#ifndef CLOCK_EPOCH_OFFSET_US
+#define CLOCK_EPOCH_OFFSET_US   0ULL
+#endif
+
+#define CLOCK_TICK_US           100     // 用时上报单位：0.1毫秒
+
+class Clock {
+public:
+#ifdef ARDUINO
+    // 内联展开，中断处理函数中也可直接取时间戳
+    static inline __attribute__((always_inline)) uint64_t nowUs() {
+        return (uint64_t)esp_timer_get_time() + CLOCK_EPOCH_OFFSET_US;
+    }
+#else
+    static uint64_t nowUs();
+#endif
+
+    static uint64_t elapsedUs(uint64_t sinceUs) { return nowUs() - sinceUs; }
+    static bool hasElapsed(uint64_t sinceUs, uint64_t intervalUs) { return nowUs() - sinceUs >= intervalUs; }
+
+    // 消息中的32位时间戳：单调时钟低32位（微秒），约71.6分钟回绕一次
+    static uint32_t stamp32() { return (uint32_t)nowUs(); }
+    // 两个32位时间戳之差，间隔小于35分钟时跨回绕也正确
+    static int32_t delta32(uint32_t later, uint32_t earlier) { return (int32_t)(later - earlier); }
+
+    // 微秒与0.1毫秒计数互换，四舍五入，超出32位时饱和
+    static uint32_t toTicks(uint64_t us);
+    static uint64_t fromTicks(uint32_t ticks) { return (uint64_t)ticks * CLOCK_TICK_US; }
+
+#ifndef ARDUINO
+    // 主机测试：虚拟时钟只在显式设置或推进时变化
+    static void setUs(uint64_t us);
+    static void advanceUs(uint64_t us);
+#endif
+};
+
+#endif // CLOCK_H
@@ -0,0 +1,12 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3, 多项式0xEDB88320)，支持分段累加计算
+//   crc = crc32Update(0, part1, len1);
+//   crc = crc32Update(crc, part2, len2);
+uint32_t crc32Update(uint32_t crc, const void* data, size_t length);
+
+#endif // CRC32_H
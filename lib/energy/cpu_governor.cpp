@@ -0,0 +1,201 @@
+#include "cpu_governor.h"
+#include <string.h>
+
+// 档位策略：80MHz时CPU运行电流约低三成；浅睡只在无线也允许时才会发生（锥桶占空窗口之外）
+static const CpuPolicy kCpuPolicies[CPU_DEMAND_COUNT] = {
+    //  时钟MHz       浅睡    降档保持ms
+    {CPU_MHZ_LOW,  true,   0},       // IDLE
+    {CPU_MHZ_LOW,  false,  2000},    // ACTIVE
+    {CPU_MHZ_FULL, false,  3000},    // TIMING：回合之间的间隙不降档
+};
+
+const CpuPolicy& cpuPolicyFor(CpuDemand demand) {
+    return kCpuPolicies[demand < CPU_DEMAND_COUNT ? demand : CPU_DEMAND_TIMING];
+}
+
+const char* cpuDemandName(CpuDemand demand) {
+    static const char* const names[CPU_DEMAND_COUNT] = {"idle", "active", "timing"};
+    return demand < CPU_DEMAND_COUNT ? names[demand] : "?";
+}
+
+CpuGovernor::CpuGovernor() {
+    begin(0);
+}
+
+void CpuGovernor::begin(uint64_t nowUs) {
+    current = CPU_DEMAND_TIMING;
+    lowering = false;
+    lowerSinceUs = 0;
+    lowerTarget = CPU_DEMAND_IDLE;
+    startUs = nowUs;
+    lastUs = nowUs;
+    memset(residency, 0, sizeof(residency));
+    switches = 0;
+    maxSwitchUs = 0;
+    totalSwitchUs = 0;
+}
+
+bool CpuGovernor::update(CpuDemand demand, uint64_t nowUs) {
+    if (demand >= CPU_DEMAND_COUNT) {
+        demand = CPU_DEMAND_TIMING;
+    }
+    advance(nowUs);
+
+    if (demand >= current) {
+        lowering = false;
+        if (demand == current) {
+            return false;
+        }
+        current = demand;
+        return true;
+    }
+
+    // 等待期间需求有起伏时，降到期间出现过的最高需求
+    if (!lowering) {
+        lowering = true;
+        lowerSinceUs = nowUs;
+        lowerTarget = demand;
+    } else if (demand > lowerTarget) {
+        lowerTarget = demand;
+    }
+    if (nowUs - lowerSinceUs < (uint64_t)cpuPolicyFor(current).holdMs * 1000) {
+        return false;
+    }
+    current = lowerTarget;
+    // 仍低于新档位时从此刻开始等待新档位的保持时间
+    lowering = demand < current;
+    lowerSinceUs = nowUs;
+    lowerTarget = demand;
+    return true;
+}
+
+void CpuGovernor::advance(uint64_t nowUs) {
+    if (nowUs > lastUs) {
+        residency[current] += nowUs - lastUs;
+        lastUs = nowUs;
+    }
+}
+
+void CpuGovernor::recordSwitch(uint32_t us) {
+    switches++;
+    totalSwitchUs += us;
+    if (us > maxSwitchUs) {
+        maxSwitchUs = us;
+    }
+}
+
+uint64_t CpuGovernor::residencyUs(CpuDemand level) const {
+    return level < CPU_DEMAND_COUNT ? residency[level] : 0;
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_pm.h>
+#include "clock.h"
+#include "energy_account.h"
+
+CpuGovernor cpuGovernor;
+
+#if CONFIG_PM_ENABLE
+// 电源管理可用时用锁表达策略：持有满频锁即160MHz，持有禁睡锁即不浅睡
+static esp_pm_lock_handle_t fullClockLock = nullptr;
+static esp_pm_lock_handle_t noSleepLock = nullptr;
+static bool fullClockHeld = false;
+static bool noSleepHeld = false;
+static bool pmConfigured = false;
+static bool lightSleepEnabled = false;
+
+static void holdLock(esp_pm_lock_handle_t lock, bool& held, bool hold) {
+    if (hold == held) {
+        return;
+    }
+    held = hold;
+    if (hold) {
+        esp_pm_lock_acquire(lock);
+    } else {
+        esp_pm_lock_release(lock);
+    }
+}
+#endif
+
+// 应用当前档位，返回切换耗时
+static uint32_t applyPolicy(const CpuPolicy& policy) {
+    uint64_t startUs = Clock::nowUs();
+#if CONFIG_PM_ENABLE
+    if (pmConfigured) {
+        holdLock(fullClockLock, fullClockHeld, policy.cpuMhz >= CPU_MHZ_FULL);
+        holdLock(noSleepLock, noSleepHeld, !policy.lightSleep);
+        return (uint32_t)Clock::elapsedUs(startUs);
+    }
+#endif
+    // 无电源管理时直接改时钟，不会浅睡
+    if (getCpuFrequencyMhz() != policy.cpuMhz) {
+        setCpuFrequencyMhz(policy.cpuMhz);
+    }
+    return (uint32_t)Clock::elapsedUs(startUs);
+}
+
+bool cpuGovernorBegin() {
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t config = {};
+    config.max_freq_mhz = CPU_MHZ_FULL;
+    config.min_freq_mhz = CPU_MHZ_LOW;
+    config.light_sleep_enable = true;
+    esp_err_t result = esp_pm_configure(&config);
+    if (result != ESP_OK) {
+        // 未启用tickless idle的构建不支持自动浅睡，只调频
+        config.light_sleep_enable = false;
+        result = esp_pm_configure(&config);
+    }
+    if (result == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "cpu_full", &fullClockLock) == ESP_OK &&
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "no_sleep", &noSleepLock) == ESP_OK) {
+        pmConfigured = true;
+        lightSleepEnabled = config.light_sleep_enable;
+        Serial.printf("CPU调频: 电源管理 %d-%d MHz, 自动浅睡%s\n", CPU_MHZ_LOW, CPU_MHZ_FULL,
+                      config.light_sleep_enable ? "开启" : "不可用");
+    } else {
+        Serial.printf("CPU调频: 电源管理不可用 (%d)，直接设置时钟\n", result);
+    }
+#endif
+
+    uint64_t now = Clock::nowUs();
+    cpuGovernor.begin(now);
+    applyPolicy(cpuGovernor.policy());
+    energyAccount.setCpuClock(now, cpuGovernor.policy().cpuMhz >= CPU_MHZ_FULL);
+#if CONFIG_PM_ENABLE
+    return lightSleepEnabled;
+#else
+    return false;
+#endif
+}
+
+void cpuGovernorService(CpuDemand demand) {
+    uint64_t now = Clock::nowUs();
+    if (!cpuGovernor.update(demand, now)) {
+        return;
+    }
+    // 切换耗时发生在本轮主循环内，计入主循环的CPU忙时间
+    cpuGovernor.recordSwitch(applyPolicy(cpuGovernor.policy()));
+    energyAccount.setCpuClock(now, cpuGovernor.policy().cpuMhz >= CPU_MHZ_FULL);
+}
+
+bool cpuHandleCommand(const char* command) {
+    if (strcmp(command, "cpu") != 0) {
+        return false;
+    }
+    cpuGovernor.advance(Clock::nowUs());
+    uint64_t session = cpuGovernor.sessionUs();
+    Serial.printf("CPU调频: 当前 %s %u MHz, 会话 %lu 秒\n", cpuDemandName(cpuGovernor.level()),
+                  cpuGovernor.policy().cpuMhz, (unsigned long)(session / 1000000ULL));
+    for (uint8_t level = 0; level < CPU_DEMAND_COUNT; level++) {
+        uint64_t residency = cpuGovernor.residencyUs((CpuDemand)level);
+        Serial.printf("cpu,%s,%lu,%lu\n", cpuDemandName((CpuDemand)level), (unsigned long)(residency / 1000000ULL),
+                      (unsigned long)(session ? residency * 1000 / session : 0));
+    }
+    Serial.printf("cpu,switches,%lu\n", (unsigned long)cpuGovernor.transitions());
+    Serial.printf("cpu,switch_avg_us,%lu\n", (unsigned long)cpuGovernor.switchAverageUs());
+    Serial.printf("cpu,switch_max_us,%lu\n", (unsigned long)cpuGovernor.switchMaxUs());
+    return true;
+}
+#endif
@@ -0,0 +1,76 @@
+#ifndef CPU_GOVERNOR_H
+#define CPU_GOVERNOR_H
+
+#include <stdint.h>
+
+// CPU调频 - 按系统状态对应的需求档位选择时钟和是否允许自动浅睡
+//   1. 升档立即生效：进入计时时已是满频
+//   2. 降档需较低需求持续达到当前档位的保持时间，训练回合之间不会来回切换
+//   3. 档位策略为查表，调用方把各自的状态映射为需求档位
+#define CPU_MHZ_FULL    160
+#define CPU_MHZ_LOW     80        // 无线工作要求不低于80MHz
+
+enum CpuDemand : uint8_t {
+    CPU_DEMAND_IDLE,          // 菜单、锥桶空闲：低频，允许浅睡
+    CPU_DEMAND_ACTIVE,        // 布防、配对、换信道：传感器和无线中断不能被浅睡延迟
+    CPU_DEMAND_TIMING,        // 计时中：满频
+    CPU_DEMAND_COUNT
+};
+
+struct CpuPolicy {
+    uint16_t cpuMhz;
+    bool lightSleep;          // 允许空闲时自动浅睡
+    uint32_t holdMs;          // 需求低于本档持续多久后降档
+};
+
+const CpuPolicy& cpuPolicyFor(CpuDemand demand);
+const char* cpuDemandName(CpuDemand demand);
+
+class CpuGovernor {
+public:
+    CpuGovernor();
+
+    // 开始统计；开机时为满频，按计时档对待
+    void begin(uint64_t nowUs);
+
+    // 主循环调用：返回true时调用方按policy()切换，再用recordSwitch()记下耗时
+    bool update(CpuDemand demand, uint64_t nowUs);
+    void recordSwitch(uint32_t us);
+    // 把当前档位的停留时间计到nowUs，不影响降档等待
+    void advance(uint64_t nowUs);
+
+    CpuDemand level() const { return current; }
+    const CpuPolicy& policy() const { return cpuPolicyFor(current); }
+
+    // 各档位累计停留时间（截至最近一次update）
+    uint64_t residencyUs(CpuDemand level) const;
+    uint64_t sessionUs() const { return lastUs - startUs; }
+    uint32_t transitions() const { return switches; }
+    uint32_t switchMaxUs() const { return maxSwitchUs; }
+    uint32_t switchAverageUs() const { return switches ? (uint32_t)(totalSwitchUs / switches) : 0; }
+
+private:
+    CpuDemand current;
+    bool lowering;            // 需求低于当前档位，等待保持时间
+    uint64_t lowerSinceUs;
+    CpuDemand lowerTarget;
+    uint64_t startUs;
+    uint64_t lastUs;
+    uint64_t residency[CPU_DEMAND_COUNT];
+    uint32_t switches;
+    uint32_t maxSwitchUs;
+    uint64_t totalSwitchUs;
+};
+
+#ifdef ARDUINO
+// 配置电源管理；返回是否启用了自动浅睡，启用时调用方再配置唤醒源
+bool cpuGovernorBegin();
+// 主循环调用：按需求切换档位，切换后更新能耗模型的CPU电流
+void cpuGovernorService(CpuDemand demand);
+// 串口命令 "cpu"：每档一行 "cpu,<名称>,<秒>,<‰>"，之后为切换次数和耗时，不是该命令时返回false
+bool cpuHandleCommand(const char* command);
+
+extern CpuGovernor cpuGovernor;
+#endif
+
+#endif // CPU_GOVERNOR_H
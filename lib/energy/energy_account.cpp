@@ -0,0 +1,233 @@
+#include "energy_account.h"
+#include <string.h>
+
+// 1µAh = 3600s × 10^6µs
+static const uint64_t kUaUsPerUah = 3600000000ULL;
+
+EnergyAccount::EnergyAccount(const EnergyCoefficients& coefficients) : model(coefficients), cpuFullClock(true) {
+    memset(rate, 0, sizeof(rate));
+    begin(0);
+}
+
+EnergyCoefficients EnergyAccount::defaultCoefficients() {
+    // ESP32-C3 160MHz（降频系数为80MHz）、WiFi常开（无调制解调器休眠），WS2812B，SSD1306
+    EnergyCoefficients c;
+    c.cpuActiveUa = 24000;
+    c.cpuIdleUa = 14000;
+    c.cpuActiveLowUa = 17000;
+    c.cpuIdleLowUa = 11000;
+    c.radioListenUa = 60000;
+    c.radioTxUa = 220000;
+    c.txFrameUs = 400;
+    c.txByteUs = 8;
+    c.ledIdleUa = 1000;
+    c.ledChannelUa = 20000;
+    c.oledOnUa = 2500;
+    c.oledFullUa = 18000;
+    c.buzzerUa = 30000;
+    return c;
+}
+
+const char* EnergyAccount::railName(EnergyRail rail) {
+    static const char* const names[ENERGY_RAIL_COUNT] = {"cpu", "radio_rx", "radio_tx", "leds", "oled", "buzzer"};
+    return rail < ENERGY_RAIL_COUNT ? names[rail] : "?";
+}
+
+// 串口可修改的系数
+struct CoefficientEntry {
+    const char* name;
+    uint32_t EnergyCoefficients::*field;
+};
+
+static const CoefficientEntry kCoefficients[] = {
+    {"cpu_active", &EnergyCoefficients::cpuActiveUa},
+    {"cpu_idle", &EnergyCoefficients::cpuIdleUa},
+    {"cpu_active_low", &EnergyCoefficients::cpuActiveLowUa},
+    {"cpu_idle_low", &EnergyCoefficients::cpuIdleLowUa},
+    {"radio_listen", &EnergyCoefficients::radioListenUa},
+    {"radio_tx", &EnergyCoefficients::radioTxUa},
+    {"tx_frame_us", &EnergyCoefficients::txFrameUs},
+    {"tx_byte_us", &EnergyCoefficients::txByteUs},
+    {"led_idle", &EnergyCoefficients::ledIdleUa},
+    {"led_channel", &EnergyCoefficients::ledChannelUa},
+    {"oled_on", &EnergyCoefficients::oledOnUa},
+    {"oled_full", &EnergyCoefficients::oledFullUa},
+    {"buzzer", &EnergyCoefficients::buzzerUa},
+};
+static const uint8_t kCoefficientCount = sizeof(kCoefficients) / sizeof(kCoefficients[0]);
+
+uint8_t EnergyAccount::coefficientCount() {
+    return kCoefficientCount;
+}
+
+const char* EnergyAccount::coefficientName(uint8_t index) {
+    return index < kCoefficientCount ? kCoefficients[index].name : "?";
+}
+
+uint32_t EnergyAccount::coefficient(uint8_t index) const {
+    return index < kCoefficientCount ? model.*kCoefficients[index].field : 0;
+}
+
+bool EnergyAccount::setCoefficient(const char* name, uint32_t value) {
+    for (uint8_t i = 0; i < kCoefficientCount; i++) {
+        if (strcmp(name, kCoefficients[i].name) == 0) {
+            model.*kCoefficients[i].field = value;
+            // 持续状态的电流在下一次set*时按新系数计算，CPU空闲电流立即生效
+            rate[ENERGY_CPU] = cpuIdleRate();
+            return true;
+        }
+    }
+    return false;
+}
+
+void EnergyAccount::begin(uint64_t nowUs) {
+    startUs = nowUs;
+    lastUs = nowUs;
+    memset(charge, 0, sizeof(charge));
+    pendingBusyUs = 0;
+    cpuBusyUs = 0;
+    rate[ENERGY_CPU] = cpuIdleRate();
+}
+
+void EnergyAccount::advance(uint64_t nowUs) {
+    if (nowUs <= lastUs) {
+        return;
+    }
+    uint64_t elapsed = nowUs - lastUs;
+    lastUs = nowUs;
+
+    // CPU：忙时间按运行电流，其余按空闲电流
+    uint64_t busy = pendingBusyUs < elapsed ? pendingBusyUs : elapsed;
+    pendingBusyUs -= busy;
+    cpuBusyUs += busy;
+    charge[ENERGY_CPU] += busy * cpuActiveRate() + (elapsed - busy) * cpuIdleRate();
+
+    for (uint8_t rail = ENERGY_RADIO_RX; rail < ENERGY_RAIL_COUNT; rail++) {
+        charge[rail] += elapsed * rate[rail];
+    }
+}
+
+void EnergyAccount::setRadio(uint64_t nowUs, bool on) {
+    advance(nowUs);
+    rate[ENERGY_RADIO_RX] = on ? model.radioListenUa : 0;
+}
+
+void EnergyAccount::setCpuClock(uint64_t nowUs, bool full) {
+    advance(nowUs);
+    cpuFullClock = full;
+    rate[ENERGY_CPU] = cpuIdleRate();
+}
+
+void EnergyAccount::setLeds(uint64_t nowUs, uint16_t count, uint32_t channelSum, uint8_t brightness) {
+    advance(nowUs);
+    rate[ENERGY_LEDS] = count * model.ledIdleUa +
+                        (uint32_t)((uint64_t)channelSum * model.ledChannelUa * brightness / (255UL * 255UL));
+}
+
+void EnergyAccount::setOled(uint64_t nowUs, bool on, uint16_t litPermille) {
+    advance(nowUs);
+    rate[ENERGY_OLED] = on ? model.oledOnUa + model.oledFullUa * litPermille / 1000 : 0;
+}
+
+void EnergyAccount::addTx(uint32_t frames, uint32_t bytes) {
+    uint64_t airtimeUs = (uint64_t)frames * model.txFrameUs + (uint64_t)bytes * model.txByteUs;
+    charge[ENERGY_RADIO_TX] += airtimeUs * model.radioTxUa;
+}
+
+void EnergyAccount::addBuzzer(uint32_t ms) {
+    charge[ENERGY_BUZZER] += (uint64_t)ms * 1000 * model.buzzerUa;
+}
+
+uint32_t EnergyAccount::microAmpHours(EnergyRail rail) const {
+    return rail < ENERGY_RAIL_COUNT ? (uint32_t)(charge[rail] / kUaUsPerUah) : 0;
+}
+
+uint32_t EnergyAccount::totalMicroAmpHours() const {
+    uint64_t total = 0;
+    for (uint8_t rail = 0; rail < ENERGY_RAIL_COUNT; rail++) {
+        total += charge[rail];
+    }
+    return (uint32_t)(total / kUaUsPerUah);
+}
+
+uint32_t EnergyAccount::averageMicroAmps() const {
+    uint64_t elapsed = sessionUs();
+    if (elapsed == 0) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (uint8_t rail = 0; rail < ENERGY_RAIL_COUNT; rail++) {
+        total += charge[rail];
+    }
+    return (uint32_t)(total / elapsed);
+}
+
+uint32_t EnergyAccount::projectedMinutes(uint32_t remainingMah) const {
+    uint32_t average = averageMicroAmps();
+    if (average == 0) {
+        return 0;
+    }
+    // mAh × 1000 / µA = 小时
+    return (uint32_t)((uint64_t)remainingMah * 1000 * 60 / average);
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <stdlib.h>
+#include "clock.h"
+
+EnergyAccount energyAccount(EnergyAccount::defaultCoefficients());
+
+void energyPrintReport(const EnergyAccount& account, uint32_t remainingMah) {
+    uint32_t total = account.totalMicroAmpHours();
+    uint16_t cpu = account.cpuActivePermille();
+    Serial.printf("能耗统计: 会话 %lu 秒, CPU运行 %u.%u%%\n",
+                  (unsigned long)(account.sessionUs() / 1000000ULL), cpu / 10, cpu % 10);
+    for (uint8_t rail = 0; rail < ENERGY_RAIL_COUNT; rail++) {
+        uint32_t used = account.microAmpHours((EnergyRail)rail);
+        Serial.printf("energy,%s,%lu,%lu\n", EnergyAccount::railName((EnergyRail)rail), (unsigned long)used,
+                      (unsigned long)(total ? (uint64_t)used * 1000 / total : 0));
+    }
+    Serial.printf("energy,total,%lu,1000\n", (unsigned long)total);
+    Serial.printf("energy,average_ua,%lu\n", (unsigned long)account.averageMicroAmps());
+    Serial.printf("energy,projected_min,%lu\n", (unsigned long)account.projectedMinutes(remainingMah));
+}
+
+bool energyHandleCommand(EnergyAccount& account, const char* command, uint32_t remainingMah) {
+    if (strncmp(command, "energy", 6) != 0 || (command[6] != '\0' && command[6] != ' ')) {
+        return false;
+    }
+    const char* args = command[6] ? command + 7 : command + 6;
+    account.advance(Clock::nowUs());
+
+    if (*args == '\0') {
+        energyPrintReport(account, remainingMah);
+    } else if (strcmp(args, "reset") == 0) {
+        account.begin(Clock::nowUs());
+        Serial.println("能耗统计已清零");
+    } else if (strcmp(args, "coef") == 0) {
+        for (uint8_t i = 0; i < EnergyAccount::coefficientCount(); i++) {
+            Serial.printf("coef,%s,%lu\n", EnergyAccount::coefficientName(i), (unsigned long)account.coefficient(i));
+        }
+    } else if (strncmp(args, "coef ", 5) == 0) {
+        // energy coef <名称> <值>
+        char name[16];
+        const char* value = strchr(args + 5, ' ');
+        size_t length = value ? (size_t)(value - (args + 5)) : 0;
+        if (length == 0 || length >= sizeof(name)) {
+            Serial.println("用法: energy coef <名称> <值>");
+            return true;
+        }
+        memcpy(name, args + 5, length);
+        name[length] = '\0';
+        if (account.setCoefficient(name, strtoul(value + 1, nullptr, 10))) {
+            Serial.printf("系数 %s = %s\n", name, value + 1);
+        } else {
+            Serial.printf("未知系数: %s\n", name);
+        }
+    } else {
+        Serial.println("用法: energy | energy reset | energy coef [名称 值]");
+    }
+    return true;
+}
+#endif
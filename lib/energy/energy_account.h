@@ -0,0 +1,106 @@
+#ifndef ENERGY_ACCOUNT_H
+#define ENERGY_ACCOUNT_H
+
+#include <stdint.h>
+
+// 能耗估算 - 按各子系统已知的活动积分估算电流，得到本会话各部分耗电和续航预测
+//   持续状态（LED、OLED、无线监听）在变化时调用set*，之前的状态按时长积分
+//   事件（发射、蜂鸣、CPU忙时间）累加后在advance()时计入
+// 电量单位：µA·µs 累计，输出换算为µAh
+enum EnergyRail : uint8_t {
+    ENERGY_CPU,
+    ENERGY_RADIO_RX,      // 无线开启时的接收监听
+    ENERGY_RADIO_TX,      // 发射时相对监听的增量
+    ENERGY_LEDS,
+    ENERGY_OLED,
+    ENERGY_BUZZER,
+    ENERGY_RAIL_COUNT
+};
+
+// 模型系数（µA、µs），默认值见defaultCoefficients()，可按实测修改
+struct EnergyCoefficients {
+    uint32_t cpuActiveUa;         // CPU运行
+    uint32_t cpuIdleUa;           // 主循环delay期间
+    uint32_t cpuActiveLowUa;      // 降频运行（cpu_governor.h）
+    uint32_t cpuIdleLowUa;        // 降频时delay期间
+    uint32_t radioListenUa;       // 无线开启、接收监听
+    uint32_t radioTxUa;           // 发射时相对监听的增量（满功率）
+    uint32_t txFrameUs;           // 每帧固定空口时间：前导码、MAC头、链路层应答
+    uint32_t txByteUs;            // 每字节空口时间（1Mbps为8）
+    uint32_t ledIdleUa;           // 每颗LED熄灭时
+    uint32_t ledChannelUa;        // 单通道满亮度
+    uint32_t oledOnUa;            // 显示开启、全黑
+    uint32_t oledFullUa;          // 像素全亮时相对全黑的增量
+    uint32_t buzzerUa;
+};
+
+class EnergyAccount {
+public:
+    explicit EnergyAccount(const EnergyCoefficients& coefficients);
+
+    static EnergyCoefficients defaultCoefficients();
+    static const char* railName(EnergyRail rail);
+
+    void setCoefficients(const EnergyCoefficients& value) { model = value; }
+    const EnergyCoefficients& coefficients() const { return model; }
+    // 按名称修改单个系数（串口命令用），名称见coefficientName()
+    bool setCoefficient(const char* name, uint32_t value);
+    static uint8_t coefficientCount();
+    static const char* coefficientName(uint8_t index);
+    uint32_t coefficient(uint8_t index) const;
+
+    // 开始新会话，清零累计值（当前持续状态保留）
+    void begin(uint64_t nowUs);
+
+    // 持续状态
+    void setRadio(uint64_t nowUs, bool on);
+    void setLeds(uint64_t nowUs, uint16_t count, uint32_t channelSum, uint8_t brightness);
+    void setOled(uint64_t nowUs, bool on, uint16_t litPermille);
+    // CPU时钟档位：满频或降频，之前的时间按原档位的电流积分
+    void setCpuClock(uint64_t nowUs, bool full);
+
+    // 事件
+    void addCpuBusy(uint32_t us) { pendingBusyUs += us; }
+    void addTx(uint32_t frames, uint32_t bytes);
+    void addBuzzer(uint32_t ms);
+
+    // 把持续状态积分到nowUs
+    void advance(uint64_t nowUs);
+
+    uint64_t sessionUs() const { return lastUs - startUs; }
+    // CPU运行时间占比（‰）
+    uint16_t cpuActivePermille() const { return sessionUs() ? (uint16_t)(cpuBusyUs * 1000 / sessionUs()) : 0; }
+    uint32_t microAmpHours(EnergyRail rail) const;
+    uint32_t totalMicroAmpHours() const;
+    // 本会话平均电流
+    uint32_t averageMicroAmps() const;
+    // 按平均电流，剩余remainingMah可用的分钟数
+    uint32_t projectedMinutes(uint32_t remainingMah) const;
+
+    // 当前持续状态的瞬时电流（不含事件）
+    uint32_t steadyMicroAmps(EnergyRail rail) const { return rate[rail]; }
+
+private:
+    EnergyCoefficients model;
+    uint64_t startUs;
+    uint64_t lastUs;
+    uint64_t charge[ENERGY_RAIL_COUNT];     // µA·µs
+    uint32_t rate[ENERGY_RAIL_COUNT];       // 持续状态的电流，µA（CPU按空闲电流）
+    uint64_t pendingBusyUs;
+    uint64_t cpuBusyUs;
+    bool cpuFullClock;
+
+    uint32_t cpuActiveRate() const { return cpuFullClock ? model.cpuActiveUa : model.cpuActiveLowUa; }
+    uint32_t cpuIdleRate() const { return cpuFullClock ? model.cpuIdleUa : model.cpuIdleLowUa; }
+};
+
+#ifdef ARDUINO
+// 串口导出：每个子系统一行 "energy,<名称>,<µAh>,<‰>"，之后为合计、平均电流和续航预测
+void energyPrintReport(const EnergyAccount& account, uint32_t remainingMah);
+// 串口命令 "energy" / "energy reset" / "energy coef [名称 值]"，不是能耗命令时返回false
+bool energyHandleCommand(EnergyAccount& account, const char* command, uint32_t remainingMah);
+
+extern EnergyAccount energyAccount;
+#endif
+
+#endif // ENERGY_ACCOUNT_H
@@ -0,0 +1,147 @@
+#ifndef HAL_ADC_IMPACT_H
+#define HAL_ADC_IMPACT_H
+
+#include <Arduino.h>
+#include <esp_adc/adc_continuous.h>
+#include "clock.h"
+#include "impact_detector.h"
+#include "trace_capture.h"
+
+// 模拟冲击传感器（连续DMA采样）- 与GpioTriggerInput接口一致，可直接替换
+//   ADC以SampleRateHz连续采样，每FrameSamples个采样一帧；poll()取出已完成的帧交给ImpactDetector
+//   采样时刻由帧完成中断的时间戳反推，冲击时间精确到采样，与主循环何时poll无关
+#define ADC_IMPACT_BLOCK_BUDGET_US 500   // 每帧DSP处理时间上限，超出时计数
+
+template <uint8_t Pin, uint32_t RefractoryMs, uint32_t SampleRateHz = 8000, uint16_t FrameSamples = 128>
+class AdcImpactInput {
+public:
+    static_assert(1000000UL % SampleRateHz == 0, "采样间隔必须为整数微秒");
+    static constexpr uint32_t sampleRateHz = SampleRateHz;
+    static constexpr uint32_t periodUs = 1000000UL / SampleRateHz;
+    static constexpr uint32_t frameUs = periodUs * FrameSamples;
+    static constexpr uint32_t frameBytes = FrameSamples * SOC_ADC_DIGI_RESULT_BYTES;
+
+    bool begin() {
+        detector.setConfig(ImpactDetector::defaultConfig(RefractoryMs * 1000UL));
+
+        adc_unit_t unit;
+        adc_channel_t channel;
+        if (adc_continuous_io_to_channel(Pin, &unit, &channel) != ESP_OK) {
+            Serial.printf("GPIO%d不支持ADC\n", Pin);
+            return false;
+        }
+
+        adc_continuous_handle_cfg_t handleConfig = {};
+        handleConfig.max_store_buf_size = frameBytes * 4;
+        handleConfig.conv_frame_size = frameBytes;
+        if (adc_continuous_new_handle(&handleConfig, &handle) != ESP_OK) {
+            Serial.println("ADC连续采样初始化失败");
+            return false;
+        }
+
+        adc_digi_pattern_config_t pattern = {};
+        pattern.atten = ADC_ATTEN_DB_12;
+        pattern.channel = channel;
+        pattern.unit = unit;
+        pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+        adc_continuous_config_t config = {};
+        config.pattern_num = 1;
+        config.adc_pattern = &pattern;
+        config.sample_freq_hz = SampleRateHz;
+        config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+        config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+        adc_continuous_evt_cbs_t callbacks = {};
+        callbacks.on_conv_done = onFrameDone;
+        if (adc_continuous_config(handle, &config) != ESP_OK ||
+            adc_continuous_register_event_callbacks(handle, &callbacks, this) != ESP_OK ||
+            adc_continuous_start(handle) != ESP_OK) {
+            Serial.println("ADC连续采样启动失败");
+            return false;
+        }
+        Serial.printf("模拟冲击传感器: GPIO%d, %luHz, 每帧%d个采样\n", Pin, (unsigned long)SampleRateHz, FrameSamples);
+        return true;
+    }
+
+    // 处理所有已完成的帧，返回是否检测到冲击
+    bool poll(uint64_t nowUs) {
+        (void)nowUs;
+        uint8_t raw[frameBytes];
+        uint32_t length = 0;
+        while (handle && adc_continuous_read(handle, raw, frameBytes, &length, 0) == ESP_OK) {
+            uint16_t count = 0;
+            for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+                const adc_digi_output_data_t* result = reinterpret_cast<const adc_digi_output_data_t*>(&raw[i]);
+                samples[count++] = result->type2.data;
+            }
+
+            // 第framesRead帧的结束时刻：最近一次帧完成中断的时间减去其后已完成的帧数
+            uint32_t done;
+            uint64_t doneUs;
+            do {
+                done = framesDone;
+                doneUs = lastFrameDoneUs;
+            } while (done != framesDone);
+            // 驱动缓冲区溢出丢帧后重新对齐到最新完成的帧
+            if (done - framesRead > 4) {
+                framesRead = done - 1;
+            }
+            framesRead++;
+            uint64_t frameEndUs = doneUs - (uint64_t)(done - framesRead) * frameUs;
+
+            uint64_t firstUs = frameEndUs - (uint64_t)count * periodUs;
+            traceCapture.recordSamples(samples, count, firstUs, periodUs);
+
+            uint64_t startUs = Clock::nowUs();
+            detector.process(samples, count, firstUs, periodUs);
+            uint32_t spentUs = (uint32_t)(Clock::nowUs() - startUs);
+            if (spentUs > maxBlockUs) {
+                maxBlockUs = spentUs;
+            }
+            if (spentUs > ADC_IMPACT_BLOCK_BUDGET_US) {
+                overBudget++;
+            }
+        }
+
+        ImpactEvent event;
+        bool fired = false;
+        while (detector.nextEvent(event)) {
+            lastEvent = event;
+            fired = true;
+        }
+        return fired;
+    }
+
+    // 与开关量传感器保持一致：HIGH表示静止，冲击期间为LOW
+    bool level() const { return !detector.isActive(); }
+    bool previousLevel() const { return level(); }
+    uint64_t lastTriggerMicros() const { return lastEvent.atUs; }
+    uint32_t rejectedEdges() const { return detector.rejected(); }
+    uint8_t strength() const { return lastEvent.strength; }
+    const ImpactEvent& lastImpact() const { return lastEvent; }
+    const ImpactDetector& dsp() const { return detector; }
+    uint32_t maxBlockMicros() const { return maxBlockUs; }
+    uint32_t blocksOverBudget() const { return overBudget; }
+
+private:
+    adc_continuous_handle_t handle = nullptr;
+    ImpactDetector detector;
+    ImpactEvent lastEvent = {};
+    uint16_t samples[FrameSamples];
+
+    volatile uint32_t framesDone = 0;
+    volatile uint64_t lastFrameDoneUs = 0;
+    uint32_t framesRead = 0;
+    uint32_t maxBlockUs = 0;
+    uint32_t overBudget = 0;
+
+    static bool IRAM_ATTR onFrameDone(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void* arg) {
+        AdcImpactInput* self = static_cast<AdcImpactInput*>(arg);
+        self->lastFrameDoneUs = Clock::nowUs();
+        self->framesDone = self->framesDone + 1;
+        return false;
+    }
+};
+
+#endif // HAL_ADC_IMPACT_H
@@ -0,0 +1,57 @@
+#ifndef HAL_ARDUINO_H
+#define HAL_ARDUINO_H
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include "hal_led_strip.h"
+#include "hal_buzzer.h"
+#include "hal_trigger_input.h"
+
+// 设备后端 - 引脚与LED数量为模板参数，主从机由同一组件实例化
+
+// WS2812B灯带（FastLED）
+template <uint8_t Pin, uint16_t Count>
+class FastLedStrip : public LedStrip<FastLedStrip<Pin, Count>, Count> {
+public:
+    void begin(uint8_t brightness) {
+        // 亮度、伽马和限流都在基类输出级中完成，FastLED按原值输出
+        FastLED.addLeds<NEOPIXEL, Pin>(pixels, Count);
+        FastLED.setBrightness(255);
+        this->setBrightness(brightness);
+        this->clear();
+        this->show();
+    }
+
+    // 后端钩子
+    void writePixel(uint16_t index, uint32_t color) { pixels[index] = CRGB(color); }
+    void flush() { FastLED.show(); }
+
+private:
+    CRGB pixels[Count];
+};
+
+// 无源蜂鸣器（tone）
+template <uint8_t Pin>
+class ToneBuzzer : public Buzzer<ToneBuzzer<Pin>> {
+public:
+    void begin() { pinMode(Pin, OUTPUT); }
+
+    // 后端钩子
+    void startTone(uint16_t frequency, uint16_t durationMs) { tone(Pin, frequency, durationMs); }
+    void pause(uint32_t ms) { delay(ms); }
+};
+
+// 常闭开关量传感器（内部上拉）
+template <uint8_t Pin, uint32_t DebounceMs>
+class GpioTriggerInput : public TriggerInput<GpioTriggerInput<Pin, DebounceMs>, DebounceMs> {
+public:
+    bool begin() {
+        pinMode(Pin, INPUT_PULLUP);
+        return true;
+    }
+
+    // 后端钩子
+    bool readLevel() { return digitalRead(Pin) == HIGH; }
+};
+
+#endif // HAL_ARDUINO_H
@@ -0,0 +1,53 @@
+#ifndef HAL_BUZZER_H
+#define HAL_BUZZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 音符：gapMs为本音结束到下一音开始的间隔
+struct BuzzerNote {
+    uint16_t frequency;
+    uint16_t durationMs;
+    uint16_t gapMs;
+};
+
+// 主从机共用的提示音（短音不阻塞，多音提示在音符之间等待）
+static constexpr BuzzerNote TUNE_START[]     = {{1000, 200, 0}};
+static constexpr BuzzerNote TUNE_COMPLETE[]  = {{2000, 200, 0}};
+static constexpr BuzzerNote TUNE_ERROR[]     = {{400, 500, 0}};
+static constexpr BuzzerNote TUNE_ALERT[]     = {{1500, 100, 0}};
+static constexpr BuzzerNote TUNE_TRIGGER[]   = {{2000, 150, 0}, {2500, 100, 0}};
+static constexpr BuzzerNote TUNE_CONNECTED[] = {{800, 100, 50}, {1000, 100, 50}, {1200, 200, 0}};
+
+// 蜂鸣器策略基类 (CRTP)
+//   后端需提供: startTone(frequency, durationMs)（异步发声）/ pause(ms)
+template <class Derived>
+class Buzzer {
+public:
+    void beep(uint16_t frequency, uint16_t durationMs) {
+        self().startTone(frequency, durationMs);
+        toneMs += durationMs;
+    }
+
+    // 累计发声时长（能耗估算用）
+    uint32_t playedMs() const { return toneMs; }
+
+    void play(const BuzzerNote* tune, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            beep(tune[i].frequency, tune[i].durationMs);
+            if (i + 1 < count) {
+                self().pause(tune[i].durationMs + tune[i].gapMs);
+            }
+        }
+    }
+
+    template <size_t N>
+    void play(const BuzzerNote (&tune)[N]) { play(tune, N); }
+
+private:
+    uint32_t toneMs = 0;
+
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+#endif // HAL_BUZZER_H
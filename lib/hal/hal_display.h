@@ -0,0 +1,143 @@
+#ifndef HAL_DISPLAY_H
+#define HAL_DISPLAY_H
+
+#include <stdint.h>
+
+// 显示屏电源状态：点亮 -> 调暗 -> 面板关闭（显存保留）
+enum DisplayPowerState : uint8_t {
+    DISPLAY_ACTIVE,
+    DISPLAY_DIM,
+    DISPLAY_OFF
+};
+
+// 无操作多久后调暗/关闭面板（ms），0为不进入该状态
+struct DisplayIdleTimeouts {
+    uint32_t dimMs;
+    uint32_t offMs;
+};
+
+#define DISPLAY_CONTRAST_FULL   255
+#define DISPLAY_CONTRAST_DIM    16
+
+// 显示屏策略基类 (CRTP) - 尺寸为模板参数，绘制仍使用后端驱动自身的接口
+//   后端需提供: start() / clearFrame() / sendFrame() / powerSave(bool) / contrast(uint8_t)
+//              frameData() / frameSize()（帧缓冲，用于跳过内容未变的刷新）
+//   wake()只记录活动，I2C命令都在service()中发出，可在触发检测路径上调用
+template <class Derived, uint16_t Width, uint16_t Height>
+class Display {
+public:
+    static constexpr uint16_t width = Width;
+    static constexpr uint16_t height = Height;
+
+    bool begin() { return self().start(); }
+    void clear() { self().clearFrame(); }
+
+    // 发送帧缓冲：内容与上次发送相同则跳过；面板关闭时只记下，唤醒时从保留的帧缓冲补发
+    void flush() {
+        uint32_t hash = frameHash();
+        if (hash == sentHash && !framePending) {
+            skipped++;
+            return;
+        }
+        if (state == DISPLAY_OFF) {
+            framePending = true;
+            return;
+        }
+        self().sendFrame();
+        sentHash = hash;
+        framePending = false;
+    }
+
+    void setPower(bool on) {
+        if (on) {
+            apply(DISPLAY_ACTIVE);
+        } else {
+            apply(DISPLAY_OFF);
+        }
+    }
+    bool isOn() const { return state != DISPLAY_OFF; }
+    DisplayPowerState powerState() const { return state; }
+    uint8_t contrastLevel() const { return state == DISPLAY_DIM ? DISPLAY_CONTRAST_DIM : DISPLAY_CONTRAST_FULL; }
+    // 因内容未变而跳过的刷新次数
+    uint32_t skippedFrames() const { return skipped; }
+
+    // 按当前系统状态设置空闲超时，计时从最近一次活动算起
+    void setIdleTimeouts(const DisplayIdleTimeouts& timeouts) { idle = timeouts; }
+
+    // 记录一次活动（按键、触发、无线事件），下次service()时恢复点亮
+    void wake(uint64_t nowUs) {
+        lastActivityUs = nowUs;
+        wakeRequested = true;
+    }
+
+    // 主循环调用：处理唤醒请求和空闲超时，返回本次是否改变了电源状态
+    bool service(uint64_t nowUs) {
+        DisplayPowerState target = state;
+        if (wakeRequested) {
+            wakeRequested = false;
+            target = DISPLAY_ACTIVE;
+        } else {
+            uint64_t idleMs = (nowUs - lastActivityUs) / 1000;
+            if (idle.offMs && idleMs >= idle.offMs) {
+                target = DISPLAY_OFF;
+            } else if (idle.dimMs && idleMs >= idle.dimMs) {
+                target = DISPLAY_DIM;
+            }
+            // 超时只会让面板更暗，变亮只由活动触发
+            if (target < state) {
+                target = state;
+            }
+        }
+        if (target == state) {
+            return false;
+        }
+        apply(target);
+        return true;
+    }
+
+    // 给定像素宽度的内容水平居中时的起始x坐标
+    static int16_t centerX(int16_t contentWidth) {
+        return contentWidth >= Width ? 0 : (Width - contentWidth) / 2;
+    }
+
+private:
+    DisplayPowerState state = DISPLAY_ACTIVE;
+    DisplayIdleTimeouts idle = {0, 0};
+    uint64_t lastActivityUs = 0;
+    bool wakeRequested = false;
+    bool framePending = false;
+    uint32_t sentHash = 0;
+    uint32_t skipped = 0;
+
+    void apply(DisplayPowerState target) {
+        DisplayPowerState previous = state;
+        state = target;
+        if (target == DISPLAY_OFF) {
+            self().powerSave(true);
+            return;
+        }
+        self().contrast(contrastLevel());
+        if (previous == DISPLAY_OFF) {
+            // 面板关闭时显存保留，只有期间内容变化时才补发一帧
+            self().powerSave(false);
+            if (framePending) {
+                flush();
+            }
+        }
+    }
+
+    // FNV-1a，1KB帧缓冲约几十微秒，远小于I2C发送一帧的时间
+    uint32_t frameHash() {
+        const uint8_t* data = self().frameData();
+        uint16_t size = self().frameSize();
+        uint32_t hash = 2166136261u;
+        for (uint16_t i = 0; i < size; i++) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+#endif // HAL_DISPLAY_H
@@ -0,0 +1,78 @@
+#ifndef HAL_HOST_H
+#define HAL_HOST_H
+
+#include <string.h>
+#include "hal_led_strip.h"
+#include "hal_buzzer.h"
+#include "hal_trigger_input.h"
+#include "hal_display.h"
+
+// 主机测试后端 - 记录输出，输入由测试直接设置
+
+template <uint16_t Count>
+class HostLedStrip : public LedStrip<HostLedStrip<Count>, Count> {
+public:
+    uint32_t pixels[Count] = {0};
+    uint32_t shown[Count] = {0};     // 最近一次刷新时的颜色
+    uint32_t showCount = 0;
+
+    // 后端钩子（收到的是输出级处理后的颜色）
+    void writePixel(uint16_t index, uint32_t color) { pixels[index] = color; }
+    void flush() {
+        memcpy(shown, pixels, sizeof(pixels));
+        showCount++;
+    }
+};
+
+#define HOST_BUZZER_MAX_NOTES 16
+
+class HostBuzzer : public Buzzer<HostBuzzer> {
+public:
+    struct Tone {
+        uint16_t frequency;
+        uint16_t durationMs;
+        uint32_t atMs;               // 相对第一次发声的虚拟时间
+    };
+
+    Tone tones[HOST_BUZZER_MAX_NOTES];
+    uint8_t toneCount = 0;
+    uint32_t elapsedMs = 0;          // pause()累计的虚拟时间
+
+    // 后端钩子
+    void startTone(uint16_t frequency, uint16_t durationMs) {
+        if (toneCount < HOST_BUZZER_MAX_NOTES) {
+            tones[toneCount++] = {frequency, durationMs, elapsedMs};
+        }
+    }
+    void pause(uint32_t ms) { elapsedMs += ms; }
+};
+
+template <uint32_t DebounceMs>
+class HostTriggerInput : public TriggerInput<HostTriggerInput<DebounceMs>, DebounceMs> {
+public:
+    bool input = true;               // 常闭传感器静止时为高电平
+
+    // 后端钩子
+    bool readLevel() { return input; }
+};
+
+template <uint16_t Width, uint16_t Height>
+class HostDisplay : public Display<HostDisplay<Width, Height>, Width, Height> {
+public:
+    bool started = false;
+    bool powered = true;
+    uint8_t contrastSet = 255;
+    uint32_t frames = 0;
+    uint8_t buffer[Width * Height / 8] = {0};
+
+    // 后端钩子
+    bool start() { return started = true; }
+    void clearFrame() { memset(buffer, 0, sizeof(buffer)); }
+    void sendFrame() { frames++; }
+    void powerSave(bool enable) { powered = !enable; }
+    void contrast(uint8_t level) { contrastSet = level; }
+    const uint8_t* frameData() { return buffer; }
+    uint16_t frameSize() { return sizeof(buffer); }
+};
+
+#endif // HAL_HOST_H
@@ -0,0 +1,146 @@
+#ifndef HAL_LED_STRIP_H
+#define HAL_LED_STRIP_H
+
+#include <stdint.h>
+#include "led_gamma.h"
+
+// LED灯带策略基类 (CRTP) - 通用效果只写一次，后端在编译期绑定，没有虚函数调用
+//   后端需提供: writePixel(index, 0xRRGGBB)（输出值）/ flush()
+//   set/fill只改基类中的逻辑颜色；show()时经输出级写给后端：
+//     伽马校正 -> 用户亮度 -> 电流预算限制，按整数逐像素一次算出
+#define LED_CHANNEL_FULL_MA     20    // WS2812B单通道满亮度电流
+#define LED_IDLE_MA             1     // 每颗LED熄灭时的静态电流
+#define LED_BUDGET_UNLIMITED    0
+template <class Derived, uint16_t Count>
+class LedStrip {
+public:
+    static constexpr uint16_t count = Count;
+
+    void set(int index, uint32_t color) {
+        if (index >= 0 && index < Count) {
+            frame[index] = color;
+        }
+    }
+
+    void fill(uint32_t color) {
+        for (uint16_t i = 0; i < Count; i++) {
+            frame[i] = color;
+        }
+    }
+
+    void clear() { fill(0); }
+    uint32_t pixel(uint16_t index) const { return index < Count ? frame[index] : 0; }
+
+    // 输出级设置：亮度0-255，伽马校正，整条灯带的电流上限（mA，0为不限）
+    void setBrightness(uint8_t level) { brightness = level; }
+    void setGamma(bool enabled) { gamma = enabled; }
+    void setCurrentBudget(uint16_t milliamps) { budgetMa = milliamps; }
+    uint8_t brightnessLevel() const { return brightness; }
+
+    void show() {
+        // 第一遍：伽马后的通道和，即亮度为255时的需求
+        uint32_t demand = 0;
+        for (uint16_t i = 0; i < Count; i++) {
+            uint32_t color = frame[i];
+            demand += corrected(color >> 16) + corrected(color >> 8) + corrected(color);
+        }
+
+        // 亮度与限流合成一个Q16系数（向上取整，亮度255时为恒等）；限流时按系数截断，估算电流不超过预算
+        uint32_t factor = (((uint32_t)brightness << 16) + 254) / 255;
+        uint32_t wanted = (uint32_t)((uint64_t)demand * factor >> 16);
+        uint32_t allowed = channelBudget();
+        limited = wanted > allowed;
+        if (limited) {
+            factor = (uint32_t)((uint64_t)factor * allowed / wanted);
+        }
+
+        // 第二遍：逐像素 伽马 × 系数，写给后端
+        uint32_t channels = 0;
+        for (uint16_t i = 0; i < Count; i++) {
+            uint32_t color = frame[i];
+            uint32_t r = corrected(color >> 16) * factor >> 16;
+            uint32_t g = corrected(color >> 8) * factor >> 16;
+            uint32_t b = corrected(color) * factor >> 16;
+            channels += r + g + b;
+            self().writePixel(i, (r << 16) | (g << 8) | b);
+        }
+        outputChannels = channels;
+        self().flush();
+    }
+
+    // 最近一次输出的通道和（PWM占空比之和，满亮度单通道为255）
+    uint32_t outputChannelTotal() const { return outputChannels; }
+    // 最近一次输出是否被电流预算压低
+    bool wasLimited() const { return limited; }
+
+    // 按最近一次输出估算的灯带电流（mA）
+    uint16_t drawMilliamps() const {
+        return (uint16_t)(Count * LED_IDLE_MA + outputChannels * LED_CHANNEL_FULL_MA / 255);
+    }
+
+    // 进度条：点亮前percent%的LED，其余熄灭，并立即刷新
+    void progress(int percent, uint32_t color) {
+        if (percent < 0) {
+            percent = 0;
+        } else if (percent > 100) {
+            percent = 100;
+        }
+        uint16_t lit = (uint16_t)((uint32_t)Count * percent / 100);
+        for (uint16_t i = 0; i < Count; i++) {
+            frame[i] = i < lit ? color : 0;
+        }
+        show();
+    }
+
+    // 呼吸效果：每50ms亮度步进一次并刷新，返回本次是否刷新
+    bool breathe(uint32_t color, uint64_t nowUs) {
+        if (nowUs - breathUs < 50000ULL) {
+            return false;
+        }
+        breathUs = nowUs;
+        breathLevel += breathStep;
+        if (breathLevel >= 255 || breathLevel <= 0) {
+            breathStep = -breathStep;
+        }
+        fill(scale(color, (uint8_t)breathLevel));
+        show();
+        return true;
+    }
+
+    // 按0-255比例缩放各颜色通道
+    static uint32_t scale(uint32_t color, uint8_t level) {
+        uint32_t r = ((color >> 16) & 0xFF) * level / 255;
+        uint32_t g = ((color >> 8) & 0xFF) * level / 255;
+        uint32_t b = (color & 0xFF) * level / 255;
+        return (r << 16) | (g << 8) | b;
+    }
+
+private:
+    uint32_t frame[Count] = {0};
+    uint8_t brightness = 255;
+    bool gamma = false;
+    uint16_t budgetMa = LED_BUDGET_UNLIMITED;
+    uint32_t outputChannels = 0;
+    bool limited = false;
+    uint64_t breathUs = 0;
+    int16_t breathLevel = 0;
+    int8_t breathStep = 5;
+
+    uint32_t corrected(uint32_t channel) const {
+        channel &= 0xFF;
+        return gamma ? kLedGamma[channel] : channel;
+    }
+
+    // 预算扣除静态电流后允许的输出通道和
+    uint32_t channelBudget() const {
+        if (budgetMa == LED_BUDGET_UNLIMITED) {
+            return UINT32_MAX;
+        }
+        uint32_t idle = Count * LED_IDLE_MA;
+        return budgetMa > idle ? (uint32_t)(budgetMa - idle) * 255 / LED_CHANNEL_FULL_MA : 0;
+    }
+
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+#endif // HAL_LED_STRIP_H
@@ -0,0 +1,50 @@
+#ifndef HAL_TRIGGER_INPUT_H
+#define HAL_TRIGGER_INPUT_H
+
+#include <stdint.h>
+
+// 触发输入策略基类 (CRTP) - 常闭开关量震动传感器，正常为高电平，HIGH->LOW下降沿为一次触发
+//   后端需提供: readLevel()
+template <class Derived, uint32_t DebounceMs>
+class TriggerInput {
+public:
+    static constexpr uint32_t defaultDebounceMs = DebounceMs;
+
+    // 采样一次，返回是否产生了通过防抖的触发
+    bool poll(uint64_t nowUs) {
+        bool level = self().readLevel();
+        bool fired = false;
+        if (lastLevel && !level) {
+            if (!triggered || nowUs - lastTriggerUs > debounceUs) {
+                triggered = true;
+                lastTriggerUs = nowUs;
+                fired = true;
+            } else {
+                rejected++;
+            }
+        }
+        lastLevel = level;
+        return fired;
+    }
+
+    // 运行时调整防抖时间（离线回放扫描参数时使用）
+    void setDebounceMs(uint32_t ms) { debounceUs = ms * 1000ULL; }
+    uint32_t debounceMs() const { return (uint32_t)(debounceUs / 1000); }
+
+    bool level() { return self().readLevel(); }
+    bool previousLevel() const { return lastLevel; }
+    uint64_t lastTriggerMicros() const { return lastTriggerUs; }
+    // 被防抖拒绝的下降沿计数
+    uint32_t rejectedEdges() const { return rejected; }
+
+private:
+    bool lastLevel = true;
+    bool triggered = false;
+    uint64_t lastTriggerUs = 0;
+    uint32_t rejected = 0;
+    uint64_t debounceUs = DebounceMs * 1000ULL;
+
+    Derived& self() { return static_cast<Derived&>(*this); }
+};
+
+#endif // HAL_TRIGGER_INPUT_H
@@ -0,0 +1,46 @@
+#ifndef HAL_U8G2_H
+#define HAL_U8G2_H
+
+#include <U8g2lib.h>
+#include "hal_display.h"
+
+// SSD1306 128x64 I2C OLED（U8g2全缓冲模式），只有主机使用
+template <uint8_t SclPin, uint8_t SdaPin>
+class U8g2Display : public Display<U8g2Display<SclPin, SdaPin>, 128, 64> {
+public:
+    U8g2Display() : u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE, /* clock=*/ SclPin, /* data=*/ SdaPin) {}
+
+    // 绘制直接使用U8g2接口
+    U8G2& driver() { return u8g2; }
+
+    // 帧缓冲中点亮像素的比例（‰），用于估算OLED电流
+    uint16_t litPermille() {
+        const uint8_t* buffer = u8g2.getBufferPtr();
+        uint16_t bytes = u8g2.getBufferTileWidth() * u8g2.getBufferTileHeight() * 8;
+        uint32_t lit = 0;
+        for (uint16_t i = 0; i < bytes; i++) {
+            lit += __builtin_popcount(buffer[i]);
+        }
+        return bytes ? (uint16_t)(lit * 1000 / (bytes * 8UL)) : 0;
+    }
+
+    // 后端钩子
+    bool start() {
+        if (!u8g2.begin()) {
+            return false;
+        }
+        u8g2.enableUTF8Print();
+        return true;
+    }
+    void clearFrame() { u8g2.clearBuffer(); }
+    void sendFrame() { u8g2.sendBuffer(); }
+    void powerSave(bool enable) { u8g2.setPowerSave(enable ? 1 : 0); }
+    void contrast(uint8_t level) { u8g2.setContrast(level); }
+    const uint8_t* frameData() { return u8g2.getBufferPtr(); }
+    uint16_t frameSize() { return u8g2.getBufferTileWidth() * u8g2.getBufferTileHeight() * 8; }
+
+private:
+    U8G2_SSD1306_128X64_NONAME_F_HW_I2C u8g2;
+};
+
+#endif // HAL_U8G2_H
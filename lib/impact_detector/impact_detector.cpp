@@ -0,0 +1,134 @@
+#include "impact_detector.h"
+
+ImpactDetector::ImpactDetector() : config(defaultConfig(200000)) {
+    reset();
+}
+
+ImpactDetectorConfig ImpactDetector::defaultConfig(uint32_t refractoryUs) {
+    ImpactDetectorConfig c;
+    c.dcShift = 10;
+    c.attackShift = 1;
+    c.releaseShift = 6;
+    c.floorShift = 11;
+    c.thresholdQ4 = 64;         // 4倍噪声底（约12dB）
+    c.minThreshold = 24;
+    c.peakWindow = 160;
+    c.warmupSamples = 512;
+    c.refractoryUs = refractoryUs;
+    return c;
+}
+
+void ImpactDetector::reset() {
+    dc = 0;
+    env = 0;
+    floor_ = 0;
+    samplesSeen = 0;
+    armed = false;
+    rearmed = true;
+    hasImpact = false;
+    armedSamples = 0;
+    peakQ8 = 0;
+    floorAtCrossing = 0;
+    crossingUs = 0;
+    lastImpactUs = 0;
+    rejectedCrossings = 0;
+    eventHead = 0;
+    eventTail = 0;
+}
+
+int32_t ImpactDetector::thresholdQ8() const {
+    int32_t threshold = (int32_t)(((int64_t)floor_ * config.thresholdQ4) >> 4);
+    int32_t minimum = (int32_t)config.minThreshold << 8;
+    return threshold > minimum ? threshold : minimum;
+}
+
+void ImpactDetector::process(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs) {
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t x = samples[i] & ((1 << IMPACT_ADC_BITS) - 1);
+
+        // 第一个采样直接作为基线，避免上电瞬态
+        if (samplesSeen == 0) {
+            dc = x << 8;
+        }
+        dc += ((x << 8) - dc) >> config.dcShift;
+
+        int32_t rect = x - (dc >> 8);
+        if (rect < 0) {
+            rect = -rect;
+        }
+        int32_t target = rect << 8;
+        env += (target - env) >> (target > env ? config.attackShift : config.releaseShift);
+
+        if (samplesSeen < config.warmupSamples) {
+            floor_ += (env - floor_) >> 4;
+            samplesSeen++;
+            continue;
+        }
+        samplesSeen++;
+
+        int32_t threshold = thresholdQ8();
+        if (armed) {
+            if (env > peakQ8) {
+                peakQ8 = env;
+            }
+            armedSamples++;
+            if (armedSamples >= config.peakWindow || env < threshold / 2) {
+                publish();
+            }
+            continue;
+        }
+
+        if (!rearmed) {
+            // 等包络回落到释放阈值以下才允许下一次触发
+            if (env < threshold / 2) {
+                rearmed = true;
+            }
+            continue;
+        }
+
+        if (env >= threshold) {
+            uint64_t atUs = firstUs + (uint64_t)i * periodUs;
+            if (hasImpact && atUs - lastImpactUs < config.refractoryUs) {
+                rejectedCrossings++;
+                rearmed = false;
+                continue;
+            }
+            armed = true;
+            armedSamples = 0;
+            peakQ8 = env;
+            floorAtCrossing = floor_;
+            crossingUs = atUs;
+            continue;
+        }
+
+        // 只在空闲时更新噪声底，冲击本身不会抬高阈值
+        floor_ += (env - floor_) >> config.floorShift;
+    }
+}
+
+void ImpactDetector::publish() {
+    armed = false;
+    rearmed = false;
+    hasImpact = true;
+    lastImpactUs = crossingUs;
+
+    if ((uint8_t)(eventHead - eventTail) >= IMPACT_EVENT_QUEUE_SIZE) {
+        eventTail++;            // 队列满时丢弃最旧的事件
+    }
+    ImpactEvent& event = events[eventHead & (IMPACT_EVENT_QUEUE_SIZE - 1)];
+    event.atUs = crossingUs;
+    event.peak = (uint16_t)(peakQ8 >> 8);
+    event.noiseFloor = (uint16_t)(floorAtCrossing >> 8);
+    uint32_t strength = (uint32_t)event.peak * 100 / (1 << (IMPACT_ADC_BITS - 1));
+    event.strength = strength > 100 ? 100 : (uint8_t)strength;
+    eventHead++;
+}
+
+bool ImpactDetector::nextEvent(ImpactEvent& event) {
+    if (eventTail == eventHead) {
+        return false;
+    }
+    event = events[eventTail & (IMPACT_EVENT_QUEUE_SIZE - 1)];
+    eventTail++;
+    return true;
+}
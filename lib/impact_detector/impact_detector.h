@@ -0,0 +1,81 @@
+#ifndef IMPACT_DETECTOR_H
+#define IMPACT_DETECTOR_H
+
+#include <stdint.h>
+
+// 模拟冲击传感器检测 - 全部为整数定点运算，每个采样只做移位和加减
+//   1. 直流基线：IIR低通跟踪传感器静态电平并从采样中减去
+//   2. 包络：整流后快升慢降的IIR
+//   3. 噪声底：空闲时慢速跟踪包络，阈值为噪声底的固定倍数（不低于最小阈值）
+//   4. 包络上穿阈值的采样即为冲击时刻，之后在峰值窗口内取峰值作为力度
+// 内部状态为Q8定点（低8位为小数）
+
+#define IMPACT_ADC_BITS         12
+#define IMPACT_EVENT_QUEUE_SIZE 4     // 2的幂
+
+struct ImpactDetectorConfig {
+    uint8_t dcShift;            // 直流基线时间常数 = 2^dcShift 个采样
+    uint8_t attackShift;        // 包络上升
+    uint8_t releaseShift;       // 包络下降
+    uint8_t floorShift;         // 噪声底跟踪
+    uint16_t thresholdQ4;       // 阈值 = 噪声底 * thresholdQ4 / 16
+    uint16_t minThreshold;      // 最小阈值（ADC计数）
+    uint16_t peakWindow;        // 上穿后取峰值的采样数
+    uint16_t warmupSamples;     // 启动后只跟踪不检测的采样数
+    uint32_t refractoryUs;      // 两次冲击的最小间隔（防抖）
+};
+
+struct ImpactEvent {
+    uint64_t atUs;              // 包络上穿阈值的采样时刻
+    uint16_t peak;              // 包络峰值（ADC计数，已去直流）
+    uint16_t noiseFloor;        // 上穿时的噪声底（ADC计数）
+    uint8_t strength;           // 力度 0-100，按半量程换算
+};
+
+class ImpactDetector {
+public:
+    ImpactDetector();
+
+    static ImpactDetectorConfig defaultConfig(uint32_t refractoryUs);
+    void setConfig(const ImpactDetectorConfig& config) { this->config = config; }
+    void reset();
+
+    // 处理一块连续采样：firstUs为第一个采样的时刻，periodUs为采样间隔
+    void process(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs);
+
+    bool nextEvent(ImpactEvent& event);
+    uint32_t rejected() const { return rejectedCrossings; }
+    bool isActive() const { return armed || !rearmed; }
+
+    uint16_t envelope() const { return (uint16_t)(env >> 8); }
+    uint16_t noiseFloor() const { return (uint16_t)(floor_ >> 8); }
+    uint16_t threshold() const { return (uint16_t)(thresholdQ8() >> 8); }
+    uint16_t baseline() const { return (uint16_t)(dc >> 8); }
+
+private:
+    ImpactDetectorConfig config;
+
+    int32_t dc;                 // Q8
+    int32_t env;                // Q8
+    int32_t floor_;             // Q8
+    uint32_t samplesSeen;
+
+    bool armed;                 // 已上穿，正在取峰值
+    bool rearmed;               // 包络已回落到释放阈值以下，可以再次触发
+    bool hasImpact;
+    uint16_t armedSamples;
+    int32_t peakQ8;
+    int32_t floorAtCrossing;
+    uint64_t crossingUs;
+    uint64_t lastImpactUs;
+    uint32_t rejectedCrossings;
+
+    ImpactEvent events[IMPACT_EVENT_QUEUE_SIZE];
+    uint8_t eventHead;
+    uint8_t eventTail;
+
+    int32_t thresholdQ8() const;
+    void publish();
+};
+
+#endif // IMPACT_DETECTOR_H
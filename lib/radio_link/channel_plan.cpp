@@ -0,0 +1,229 @@
+#include "channel_plan.h"
+#include <string.h>
+
+// 20MHz信道中心相隔5MHz，相距4个信道以内都有重叠；按距离递减计入拥塞（/8）
+static const uint8_t kOverlapWeight[4] = {8, 6, 3, 1};
+
+ChannelSurvey::ChannelSurvey() {
+    reset();
+}
+
+void ChannelSurvey::reset() {
+    for (uint8_t channel = 0; channel <= CHANNEL_MAX; channel++) {
+        airtimeUs[channel] = 0;
+        frames[channel] = 0;
+        dwellUs[channel] = 0;
+    }
+}
+
+void ChannelSurvey::addFrame(uint8_t channel, int8_t rssi, uint16_t length) {
+    if (channel < CHANNEL_MIN || channel > CHANNEL_MAX) {
+        return;
+    }
+    // 前导约50us，负载按平均约4Mbps估计；很弱的帧干扰小，减半计入
+    uint32_t airtime = 50 + length * 2;
+    if (rssi < -85) {
+        airtime /= 2;
+    }
+    airtimeUs[channel] += airtime;
+    frames[channel]++;
+}
+
+void ChannelSurvey::setDwell(uint8_t channel, uint32_t dwell) {
+    if (channel >= CHANNEL_MIN && channel <= CHANNEL_MAX) {
+        dwellUs[channel] = dwell;
+    }
+}
+
+uint32_t ChannelSurvey::occupancy(uint8_t channel) const {
+    if (channel < CHANNEL_MIN || channel > CHANNEL_MAX || dwellUs[channel] == 0) {
+        return 0;
+    }
+    uint32_t permille = (uint32_t)((uint64_t)airtimeUs[channel] * 1000 / dwellUs[channel]);
+    return permille > 1000 ? 1000 : permille;
+}
+
+uint32_t ChannelSurvey::congestion(uint8_t channel) const {
+    uint32_t total = 0;
+    for (int offset = -3; offset <= 3; offset++) {
+        int neighbour = channel + offset;
+        if (neighbour >= CHANNEL_MIN && neighbour <= CHANNEL_MAX) {
+            total += occupancy(neighbour) * kOverlapWeight[offset < 0 ? -offset : offset];
+        }
+    }
+    return total / 8;
+}
+
+uint8_t ChannelSurvey::best() const {
+    // 拥塞相同时优先1/6/11（互不重叠），再取较小的信道号
+    uint8_t bestChannel = CHANNEL_MIN;
+    uint32_t bestScore = UINT32_MAX;
+    bool bestPreferred = false;
+    for (uint8_t channel = CHANNEL_MIN; channel <= CHANNEL_MAX; channel++) {
+        uint32_t score = congestion(channel);
+        bool preferred = channel == 1 || channel == 6 || channel == 11;
+        if (score < bestScore || (score == bestScore && preferred && !bestPreferred)) {
+            bestChannel = channel;
+            bestScore = score;
+            bestPreferred = preferred;
+        }
+    }
+    return bestChannel;
+}
+
+bool ChannelSurvey::shouldSwitch(uint8_t current, uint8_t& target) const {
+    target = best();
+    if (target == current) {
+        return false;
+    }
+    // 差别不大时不换，避免信道来回跳
+    return congestion(target) * 100 < congestion(current) * CHANNEL_SWITCH_MARGIN_PCT;
+}
+
+// ---------------------------------------------------------------------------
+
+LinkProbe::LinkProbe()
+    : repliedMask(0), nextUs(0), intervalUs(0), count(0), issued(0), active(false) {
+    memset(sentAtUs, 0, sizeof(sentAtUs));
+    memset(rttUs, 0, sizeof(rttUs));
+}
+
+void LinkProbe::begin(uint64_t nowUs, uint8_t probes, uint32_t interval) {
+    count = probes > LINK_PROBE_MAX ? LINK_PROBE_MAX : probes;
+    intervalUs = interval;
+    nextUs = nowUs;
+    issued = 0;
+    repliedMask = 0;
+    active = true;
+}
+
+bool LinkProbe::due(uint64_t nowUs, uint8_t& sequence) {
+    if (!active || issued >= count || nowUs < nextUs) {
+        return false;
+    }
+    sequence = issued;
+    sentAtUs[issued++] = nowUs;
+    nextUs = nowUs + intervalUs;
+    return true;
+}
+
+void LinkProbe::onReply(uint8_t sequence, uint64_t nowUs) {
+    if (!active || sequence >= issued || (repliedMask & (1u << sequence))) {
+        return;
+    }
+    uint64_t rtt = nowUs - sentAtUs[sequence];
+    if (rtt > LINK_PROBE_TIMEOUT_US) {
+        return;
+    }
+    rttUs[sequence] = (uint32_t)rtt;
+    repliedMask |= 1u << sequence;
+}
+
+bool LinkProbe::done(uint64_t nowUs) const {
+    return active && issued >= count && (count == 0 || nowUs - sentAtUs[count - 1] >= LINK_PROBE_TIMEOUT_US);
+}
+
+LinkStats LinkProbe::result() const {
+    LinkStats stats = {issued, 0, 0, 0};
+    uint64_t total = 0;
+    for (uint8_t i = 0; i < issued; i++) {
+        if (repliedMask & (1u << i)) {
+            stats.received++;
+            total += rttUs[i];
+            if (rttUs[i] > stats.rttMaxUs) {
+                stats.rttMaxUs = rttUs[i];
+            }
+        }
+    }
+    stats.rttAvgUs = stats.received ? (uint32_t)(total / stats.received) : 0;
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+
+ChannelSwitchCoordinator::ChannelSwitchCoordinator()
+    : switchAtUs(0), nextAnnounceUs(0), ackedMask(0), heardMask(0), expectedMask(0),
+      fromChannel(0), toChannel(0), currentState(CHSW_IDLE) {}
+
+void ChannelSwitchCoordinator::begin(uint8_t from, uint8_t to, uint16_t coneMask, uint64_t nowUs) {
+    fromChannel = from;
+    toChannel = to;
+    expectedMask = coneMask;
+    ackedMask = 0;
+    heardMask = 0;
+    switchAtUs = nowUs + CHANNEL_SWITCH_LEAD_US;
+    nextAnnounceUs = nowUs;
+    currentState = CHSW_ANNOUNCING;
+}
+
+bool ChannelSwitchCoordinator::announceDue(uint64_t nowUs) {
+    // 收齐应答后不再重发；最后一次通知要留出送达的时间
+    if (currentState != CHSW_ANNOUNCING || ackedMask == expectedMask || nowUs < nextAnnounceUs ||
+        nowUs + CHANNEL_ANNOUNCE_INTERVAL_US / 2 >= switchAtUs) {
+        return false;
+    }
+    nextAnnounceUs = nowUs + CHANNEL_ANNOUNCE_INTERVAL_US;
+    return true;
+}
+
+uint16_t ChannelSwitchCoordinator::remainingMs(uint64_t nowUs) const {
+    return nowUs >= switchAtUs ? 0 : (uint16_t)((switchAtUs - nowUs) / 1000);
+}
+
+void ChannelSwitchCoordinator::onAck(uint8_t coneId) {
+    if (currentState == CHSW_ANNOUNCING && coneId < 16) {
+        ackedMask |= (uint16_t)(1u << coneId);
+    }
+}
+
+void ChannelSwitchCoordinator::onPeerHeard(uint8_t coneId) {
+    if (currentState == CHSW_VERIFYING && coneId < 16) {
+        heardMask |= (uint16_t)(1u << coneId);
+    }
+}
+
+ChannelSwitchState ChannelSwitchCoordinator::update(uint64_t nowUs) {
+    switch (currentState) {
+        case CHSW_ANNOUNCING:
+            if (nowUs >= switchAtUs) {
+                // 有锥桶未应答时不切换，否则它会被留在旧信道
+                currentState = ackedMask == expectedMask ? CHSW_VERIFYING : CHSW_ABORTED;
+            }
+            break;
+        case CHSW_VERIFYING:
+            if ((heardMask & expectedMask) == expectedMask) {
+                currentState = CHSW_DONE;
+            } else if (nowUs - switchAtUs >= CHANNEL_VERIFY_US) {
+                currentState = CHSW_FAILED;
+            }
+            break;
+        default:
+            break;
+    }
+    return currentState;
+}
+
+// ---------------------------------------------------------------------------
+
+ChannelFollower::ChannelFollower(uint8_t rendezvous)
+    : switchAtUs(0), pendingChannel(0), rendezvousChannel(rendezvous) {}
+
+void ChannelFollower::schedule(uint8_t channel, uint64_t atUs) {
+    if (channel >= CHANNEL_MIN && channel <= CHANNEL_MAX) {
+        pendingChannel = channel;
+        switchAtUs = atUs;
+    }
+}
+
+bool ChannelFollower::switchDue(uint64_t nowUs, uint8_t& channel) {
+    if (pendingChannel == 0 || nowUs < switchAtUs) {
+        return false;
+    }
+    channel = pendingChannel;
+    pendingChannel = 0;
+    return true;
+}
+
+bool ChannelFollower::fallbackDue(uint8_t current, uint32_t silentUs) const {
+    return current != rendezvousChannel && pendingChannel == 0 && silentUs >= CHANNEL_LOST_US;
+}
@@ -0,0 +1,144 @@
+#ifndef CHANNEL_PLAN_H
+#define CHANNEL_PLAN_H
+
+#include <stdint.h>
+
+// 信道选择与协调换信道
+//   1. 主机在会话开始时逐信道监听，按占空时间（含相邻信道的重叠）估计拥塞，选最空闲的信道
+//   2. 主机广播换信道通知，锥桶应答后双方在同一时刻切换；未应答则不切换
+//   3. 切换后对端未出现，或长时间收不到对端消息时，各自回到约定信道重新会合
+//   4. 切换前后各做一次往返探测，记录丢包率和往返时延
+#define CHANNEL_MIN                 1
+#define CHANNEL_MAX                 13
+#define CHANNEL_DWELL_US            60000     // 每个信道的监听时长
+#define CHANNEL_SWITCH_MARGIN_PCT   70        // 新信道拥塞需低于当前信道的该比例才切换
+#define CHANNEL_SWITCH_LEAD_US      400000    // 通知到切换的提前量
+#define CHANNEL_ANNOUNCE_INTERVAL_US 60000    // 未收齐应答时重发通知的间隔
+#define CHANNEL_VERIFY_US           1500000   // 切换后等待对端出现的时长
+#define CHANNEL_LOST_US             10000000  // 不在约定信道上且收不到对端的时长（长于心跳超时），超过后回约定信道
+
+// 信道调查：在当前监听信道上统计帧的占空时间
+class ChannelSurvey {
+public:
+    ChannelSurvey();
+
+    void reset();
+    // 混杂模式回调中调用（WiFi任务上下文）
+    void addFrame(uint8_t channel, int8_t rssi, uint16_t length);
+    void setDwell(uint8_t channel, uint32_t dwellUs);
+
+    // 本信道占空率（千分比）
+    uint32_t occupancy(uint8_t channel) const;
+    // 计入相邻信道重叠后的拥塞度（千分比，越小越好）
+    uint32_t congestion(uint8_t channel) const;
+    uint8_t best() const;
+    // 最佳信道明显优于当前信道时返回true
+    bool shouldSwitch(uint8_t current, uint8_t& target) const;
+
+private:
+    volatile uint32_t airtimeUs[CHANNEL_MAX + 1];
+    volatile uint16_t frames[CHANNEL_MAX + 1];
+    uint32_t dwellUs[CHANNEL_MAX + 1];
+};
+
+// 往返探测结果
+struct LinkStats {
+    uint8_t sent;
+    uint8_t received;
+    uint32_t rttAvgUs;
+    uint32_t rttMaxUs;
+
+    uint8_t lossPercent() const { return sent ? (uint8_t)((sent - received) * 100 / sent) : 0; }
+};
+
+#define LINK_PROBE_MAX      32
+#define LINK_PROBE_TIMEOUT_US 100000    // 超过该时间未收到回应视为丢失
+
+// 往返探测：按固定间隔发送带序号的探测，统计回应
+class LinkProbe {
+public:
+    LinkProbe();
+
+    void begin(uint64_t nowUs, uint8_t count, uint32_t intervalUs);
+    // 到期时返回true和本次序号
+    bool due(uint64_t nowUs, uint8_t& sequence);
+    // 回应可能在ESP-NOW回调中到达，nowUs由调用方取
+    void onReply(uint8_t sequence, uint64_t nowUs);
+    bool running() const { return active; }
+    // 全部发出且最后一个探测已超时
+    bool done(uint64_t nowUs) const;
+    LinkStats result() const;
+
+private:
+    uint64_t sentAtUs[LINK_PROBE_MAX];
+    uint32_t rttUs[LINK_PROBE_MAX];
+    volatile uint32_t repliedMask;
+    uint64_t nextUs;
+    uint32_t intervalUs;
+    uint8_t count;
+    uint8_t issued;
+    bool active;
+};
+
+enum ChannelSwitchState {
+    CHSW_IDLE,
+    CHSW_ANNOUNCING,      // 通知中，等待应答
+    CHSW_VERIFYING,       // 已切换，等待对端在新信道出现
+    CHSW_DONE,
+    CHSW_ABORTED,         // 到切换时刻仍有锥桶未应答，留在原信道
+    CHSW_FAILED           // 切换后对端未出现，回约定信道
+};
+
+// 主机侧协调：通知 -> 收齐应答 -> 同时切换 -> 确认对端
+class ChannelSwitchCoordinator {
+public:
+    ChannelSwitchCoordinator();
+
+    void begin(uint8_t from, uint8_t to, uint16_t coneMask, uint64_t nowUs);
+    // 是否该发（重发）通知
+    bool announceDue(uint64_t nowUs);
+    // 通知中携带的剩余时间（毫秒）
+    uint16_t remainingMs(uint64_t nowUs) const;
+    void onAck(uint8_t coneId);
+    // 新信道上收到锥桶消息
+    void onPeerHeard(uint8_t coneId);
+    // 推进状态；进入VERIFYING的那次调用返回时应切换到target()
+    ChannelSwitchState update(uint64_t nowUs);
+
+    ChannelSwitchState state() const { return currentState; }
+    uint8_t source() const { return fromChannel; }
+    uint8_t target() const { return toChannel; }
+    uint16_t acked() const { return ackedMask; }
+
+private:
+    uint64_t switchAtUs;
+    uint64_t nextAnnounceUs;
+    volatile uint16_t ackedMask;
+    volatile uint16_t heardMask;
+    uint16_t expectedMask;
+    uint8_t fromChannel;
+    uint8_t toChannel;
+    ChannelSwitchState currentState;
+};
+
+// 锥桶侧：按通知的时刻切换，长时间失联时回约定信道
+class ChannelFollower {
+public:
+    explicit ChannelFollower(uint8_t rendezvous);
+
+    void schedule(uint8_t channel, uint64_t switchAtUs);
+    // 到切换时刻返回true和目标信道
+    bool switchDue(uint64_t nowUs, uint8_t& channel);
+    // 已排定、尚未到切换时刻
+    bool pending() const { return pendingChannel != 0; }
+    // 不在约定信道且失联超过CHANNEL_LOST_US时返回true，调用方切回约定信道
+    bool fallbackDue(uint8_t current, uint32_t silentUs) const;
+    uint8_t rendezvous() const { return rendezvousChannel; }
+
+private:
+    uint64_t switchAtUs;
+    uint8_t pendingChannel;
+    uint8_t rendezvousChannel;
+};
+
+#endif // CHANNEL_PLAN_H
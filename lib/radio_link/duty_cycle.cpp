@@ -0,0 +1,206 @@
+#include "duty_cycle.h"
+
+static int64_t floorDiv(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+uint32_t dutyPackSchedule(const DutySchedule& schedule) {
+    uint32_t data = schedule.periodMs | ((uint32_t)(schedule.windowMs & 0x0FFF) << 16);
+    if (schedule.ackRequest) {
+        data |= DUTY_FLAG_ACK_REQUEST;
+    }
+    if (schedule.epochGrid) {
+        data |= DUTY_FLAG_EPOCH_GRID;
+    }
+    if (schedule.alwaysOn) {
+        data |= DUTY_FLAG_ALWAYS_ON;
+    }
+    return data;
+}
+
+DutySchedule dutyUnpackSchedule(uint32_t data) {
+    DutySchedule schedule;
+    schedule.periodMs = (uint16_t)(data & 0xFFFF);
+    schedule.windowMs = (uint16_t)((data >> 16) & 0x0FFF);
+    schedule.ackRequest = (data & DUTY_FLAG_ACK_REQUEST) != 0;
+    schedule.epochGrid = (data & DUTY_FLAG_EPOCH_GRID) != 0;
+    schedule.alwaysOn = (data & DUTY_FLAG_ALWAYS_ON) != 0;
+    return schedule;
+}
+
+uint32_t dutyPhaseUs(int64_t gridUs, uint16_t periodMs) {
+    int64_t periodUs = (int64_t)periodMs * 1000;
+    return (uint32_t)(gridUs - floorDiv(gridUs, periodUs) * periodUs);
+}
+
+// ==================== 主机 ====================
+
+DutyCycleLeader::DutyCycleLeader(uint16_t periodMs, uint16_t windowMs)
+    : periodMs(periodMs), windowMs(windowMs), wantAlwaysOn(false) {
+    reset();
+    resetStats();
+}
+
+void DutyCycleLeader::reset() {
+    peerCycling = false;
+    wakePending = false;
+    armedUs = 0;
+    lastBeaconWindow = -1;
+    lastBeaconAlwaysOn = false;
+}
+
+void DutyCycleLeader::resetStats() {
+    counters.wakes = 0;
+    counters.maxUs = 0;
+    counters.totalUs = 0;
+}
+
+void DutyCycleLeader::setArmed(bool armed, uint64_t nowUs) {
+    if (armed == wantAlwaysOn) {
+        return;
+    }
+    wantAlwaysOn = armed;
+    // 只有锥桶正在占空时才有唤醒延迟
+    wakePending = armed && peerCycling;
+    armedUs = nowUs;
+}
+
+bool DutyCycleLeader::beaconDue(int64_t gridUs) {
+    if (!windowOpen(gridUs)) {
+        return false;
+    }
+    // 双方都常开时不需要信标
+    if (wantAlwaysOn && !peerCycling) {
+        return false;
+    }
+    int64_t window = floorDiv(gridUs, (int64_t)periodMs * 1000);
+    if (window == lastBeaconWindow && wantAlwaysOn == lastBeaconAlwaysOn) {
+        return false;
+    }
+    lastBeaconWindow = window;
+    lastBeaconAlwaysOn = wantAlwaysOn;
+    return true;
+}
+
+uint32_t DutyCycleLeader::beaconData(bool epochGrid) {
+    DutySchedule schedule;
+    schedule.periodMs = periodMs;
+    schedule.windowMs = windowMs;
+    schedule.alwaysOn = wantAlwaysOn;
+    schedule.epochGrid = epochGrid;
+    // 锥桶实际模式与要求不同时请求应答
+    schedule.ackRequest = peerCycling == wantAlwaysOn;
+    return dutyPackSchedule(schedule);
+}
+
+void DutyCycleLeader::onAck(bool alwaysOn, uint64_t nowUs) {
+    peerCycling = !alwaysOn;
+    if (alwaysOn && wakePending) {
+        wakePending = false;
+        uint32_t latencyUs = (uint32_t)(nowUs - armedUs);
+        counters.wakes++;
+        counters.totalUs += latencyUs;
+        if (latencyUs > counters.maxUs) {
+            counters.maxUs = latencyUs;
+        }
+    }
+}
+
+bool DutyCycleLeader::windowOpen(int64_t gridUs) const {
+    return dutyPhaseUs(gridUs, periodMs) < (uint32_t)windowMs * 1000;
+}
+
+// ==================== 锥桶 ====================
+
+DutyCycleFollower::DutyCycleFollower() {
+    reset();
+}
+
+void DutyCycleFollower::reset() {
+    period = DUTY_PERIOD_MS;
+    window = DUTY_WINDOW_MS;
+    scheduled = false;
+    aligned = false;
+    lost = false;
+    localHold = false;
+    ackRequested = false;
+    reportedCycling = false;
+    anchorUs = 0;
+    lastBeaconWindow = 0;
+    missedTotal = 0;
+}
+
+void DutyCycleFollower::onBeacon(uint32_t data, int64_t localUs, int64_t epochUs) {
+    DutySchedule schedule = dutyUnpackSchedule(data);
+    if (schedule.periodMs == 0 || schedule.windowMs >= schedule.periodMs) {
+        return;
+    }
+    period = schedule.periodMs;
+    window = schedule.windowMs;
+    scheduled = !schedule.alwaysOn;
+    if (schedule.ackRequest) {
+        ackRequested = true;
+    }
+
+    // 墙钟对齐不受信标在主机队列中等待的影响；未授时时按到达时刻估计窗口起点
+    if (schedule.epochGrid && epochUs >= 0) {
+        anchorUs = localUs - dutyPhaseUs(epochUs, period);
+    } else {
+        anchorUs = localUs - DUTY_BEACON_LATENCY_US;
+    }
+    aligned = true;
+    lost = false;
+    lastBeaconWindow = windowIndex(localUs);
+}
+
+int64_t DutyCycleFollower::windowIndex(int64_t localUs) const {
+    // 窗口k覆盖 [起点-余量, 起点+窗口+余量]
+    return floorDiv(localUs - anchorUs + DUTY_GUARD_US, (int64_t)period * 1000);
+}
+
+void DutyCycleFollower::update(int64_t localUs) {
+    if (!aligned) {
+        return;
+    }
+    // 已结束的最后一个窗口
+    int64_t ended = floorDiv(localUs - anchorUs - (int64_t)window * 1000 - DUTY_GUARD_US, (int64_t)period * 1000);
+    if (!scheduled || lost || localHold) {
+        // 不按窗口接收时不计错过
+        if (ended > lastBeaconWindow) {
+            lastBeaconWindow = ended;
+        }
+        return;
+    }
+    if (ended - lastBeaconWindow >= DUTY_MISSED_BEACONS_MAX) {
+        missedTotal += (uint32_t)(ended - lastBeaconWindow);
+        lost = true;
+    }
+}
+
+bool DutyCycleFollower::listening(int64_t localUs) const {
+    if (!cycling()) {
+        return true;
+    }
+    uint32_t periodUs = (uint32_t)period * 1000;
+    uint32_t phase = dutyPhaseUs(localUs - anchorUs, period);
+    return phase < (uint32_t)window * 1000 + DUTY_GUARD_US || phase >= periodUs - DUTY_GUARD_US;
+}
+
+int64_t DutyCycleFollower::nextListenUs(int64_t localUs) const {
+    if (listening(localUs)) {
+        return localUs;
+    }
+    uint32_t phase = dutyPhaseUs(localUs - anchorUs, period);
+    return localUs - phase + (int64_t)period * 1000 - DUTY_GUARD_US;
+}
+
+bool DutyCycleFollower::takeAckDue() {
+    bool now = cycling();
+    if (!ackRequested && now == reportedCycling) {
+        return false;
+    }
+    ackRequested = false;
+    reportedCycling = now;
+    return true;
+}
@@ -0,0 +1,135 @@
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <stdint.h>
+
+// 无线占空比 - 锥桶空闲时只在主机排定的监听窗口打开接收，训练布防时全程常开
+//   1. 窗口网格：网格时间整除周期的时刻为窗口起点；主机墙钟有效时网格时间为Unix微秒，否则为主机本地时钟
+//   2. 主机在每个窗口开始时广播信标（周期、窗口、模式）；锥桶墙钟已授时则按墙钟对齐窗口，
+//      不受信标排队延迟影响，否则按信标到达时刻对齐
+//   3. 锥桶确认进入占空模式后，主机窗口外的发送全部保持到下一窗口
+//   4. 布防时主机在当前窗口立即（或下一窗口）发出常开信标，锥桶确认即解除保持，延迟上限约一个周期
+//   5. 锥桶本地需要常开（未连接、训练中）或连续错过信标时改为常开，并主动告知主机
+#define DUTY_PERIOD_MS          1000
+#define DUTY_WINDOW_MS          20
+#define DUTY_GUARD_US           2000      // 窗口两侧余量：授时误差、晶振漂移和射频启动
+#define DUTY_BEACON_LATENCY_US  500       // 信标从发出到接收回调的估计延迟
+#define DUTY_MISSED_BEACONS_MAX 3         // 连续错过的信标数，达到后回到常开
+
+// 信标data字段：0-15位周期ms，16-27位窗口ms，29位请求应答，30位网格为墙钟，31位常开
+#define DUTY_FLAG_ACK_REQUEST   0x20000000u
+#define DUTY_FLAG_EPOCH_GRID    0x40000000u
+#define DUTY_FLAG_ALWAYS_ON     0x80000000u
+
+// 应答data字段：锥桶当前实际模式
+#define DUTY_ACK_CYCLING        0
+#define DUTY_ACK_ALWAYS_ON      1
+
+struct DutySchedule {
+    uint16_t periodMs;
+    uint16_t windowMs;
+    bool alwaysOn;
+    bool epochGrid;
+    bool ackRequest;
+};
+
+uint32_t dutyPackSchedule(const DutySchedule& schedule);
+DutySchedule dutyUnpackSchedule(uint32_t data);
+
+// 网格时间在所在周期内的偏移（微秒）
+uint32_t dutyPhaseUs(int64_t gridUs, uint16_t periodMs);
+
+// 布防到锥桶确认常开的延迟
+struct DutyLatencyStats {
+    uint32_t wakes;
+    uint32_t maxUs;
+    uint64_t totalUs;
+
+    uint32_t averageUs() const { return wakes ? (uint32_t)(totalUs / wakes) : 0; }
+};
+
+// 主机：决定锥桶模式、发信标、在窗口外保持发送
+class DutyCycleLeader {
+public:
+    explicit DutyCycleLeader(uint16_t periodMs = DUTY_PERIOD_MS, uint16_t windowMs = DUTY_WINDOW_MS);
+
+    // 锥桶断开：之后按常开对待，不保持发送
+    void reset();
+    void resetStats();
+
+    // 是否需要锥桶常开（训练布防、配对、换信道等）
+    void setArmed(bool armed, uint64_t nowUs);
+    // 主循环调用：本次是否应发出信标（每个窗口一次，窗口内要求的模式变化时立即补发）
+    bool beaconDue(int64_t gridUs);
+    // 信标内容，beaconDue()返回true后取
+    uint32_t beaconData(bool epochGrid);
+    // 锥桶应答的实际模式
+    void onAck(bool alwaysOn, uint64_t nowUs);
+
+    bool windowOpen(int64_t gridUs) const;
+    // 锥桶处于占空模式且不在窗口内：发送应保持到下一窗口
+    bool holdTraffic(int64_t gridUs) const { return peerCycling && !windowOpen(gridUs); }
+    bool peerIsCycling() const { return peerCycling; }
+    bool armed() const { return wantAlwaysOn; }
+
+    // 空闲时命令的最长等待：一个周期加窗口
+    uint32_t latencyBoundUs() const { return ((uint32_t)periodMs + windowMs) * 1000; }
+    const DutyLatencyStats& latency() const { return counters; }
+
+private:
+    uint16_t periodMs;
+    uint16_t windowMs;
+    bool wantAlwaysOn;
+    bool peerCycling;
+    bool wakePending;         // 已布防、等待锥桶确认常开
+    uint64_t armedUs;
+    int64_t lastBeaconWindow;
+    bool lastBeaconAlwaysOn;
+    DutyLatencyStats counters;
+};
+
+// 锥桶：按信标排程开关接收
+class DutyCycleFollower {
+public:
+    DutyCycleFollower();
+
+    void reset();
+
+    // 收到信标；localUs为到达时的本地时间，epochUs为同一时刻的墙钟时间（未授时为负）
+    void onBeacon(uint32_t data, int64_t localUs, int64_t epochUs);
+    // 本地需要常开（未连接、训练中、换信道）
+    void setLocalHold(bool hold) { localHold = hold; }
+    // 主循环调用：统计错过的信标，连续错过时回到常开
+    void update(int64_t localUs);
+
+    // 此刻是否应打开接收
+    bool listening(int64_t localUs) const;
+    // 实际处于占空模式（按信标占空且无本地常开原因）
+    bool cycling() const { return scheduled && aligned && !lost && !localHold; }
+    // 下一次打开接收的本地时间；常开时返回localUs
+    int64_t nextListenUs(int64_t localUs) const;
+
+    // 模式与上次告知主机的不同，或信标请求应答时返回true，并记为已告知
+    bool takeAckDue();
+
+    uint16_t periodMs() const { return period; }
+    uint16_t windowMs() const { return window; }
+    uint32_t missedBeacons() const { return missedTotal; }
+
+private:
+    uint16_t period;
+    uint16_t window;
+    bool scheduled;           // 最近的信标要求占空
+    bool aligned;
+    bool lost;                // 连续错过信标
+    bool localHold;
+    bool ackRequested;
+    bool reportedCycling;
+    int64_t anchorUs;         // 某个窗口起点的本地时间
+    int64_t lastBeaconWindow;
+    uint32_t missedTotal;
+
+    int64_t windowIndex(int64_t localUs) const;
+};
+
+#endif // DUTY_CYCLE_H
@@ -0,0 +1,52 @@
+#ifndef ESPNOW_TRANSPORT_H
+#define ESPNOW_TRANSPORT_H
+
+#include <Arduino.h>
+#include <esp_now.h>
+#include <esp_wifi.h>
+#include "tx_scheduler.h"
+#include "tx_power.h"
+
+// ESP-NOW发送后端：驱动缓冲区满时交由调度器退避重试
+// 给定功率控制器时，发送前按目标对端设置发射功率
+class EspNowTransport : public TxTransport {
+public:
+    explicit EspNowTransport(TxPowerController* power = nullptr)
+        : power(power), appliedLevel(0), frames(0), bytes(0) {}
+
+    TxSendResult send(const uint8_t* mac, const uint8_t* data, uint8_t length) override {
+        int8_t level = TXP_LEVEL_MAX;
+        if (power) {
+            level = power->levelFor(mac);
+            if (level != appliedLevel && esp_wifi_set_max_tx_power(level) == ESP_OK) {
+                appliedLevel = level;
+            }
+        }
+        esp_err_t result = esp_now_send(mac, data, length);
+        if (result == ESP_OK) {
+            frames++;
+            bytes += length;
+            if (power) {
+                power->onSent(level);
+            }
+            return TX_SEND_OK;
+        }
+        if (result == ESP_ERR_ESPNOW_NO_MEM) {
+            return TX_SEND_BUSY;
+        }
+        Serial.printf("ESP-NOW发送失败: %d (命令 0x%02X)\n", result, data[0]);
+        return TX_SEND_FAILED;
+    }
+
+    // 已交给驱动的帧数和字节数（能耗估算用）
+    uint32_t framesSent() const { return frames; }
+    uint32_t bytesSent() const { return bytes; }
+
+private:
+    TxPowerController* power;
+    int8_t appliedLevel;      // 最近一次设置成功的功率，避免每帧都调用驱动
+    uint32_t frames;
+    uint32_t bytes;
+};
+
+#endif // ESPNOW_TRANSPORT_H
@@ -0,0 +1,117 @@
+#include "group_command.h"
+#include <string.h>
+
+uint8_t groupEncode(const GroupCommandHeader& header, const GroupTarget* targets, uint8_t* out) {
+    memcpy(out, &header, sizeof(header));
+    uint8_t length = sizeof(header);
+    for (uint8_t cone = 0; cone < GROUP_MAX_CONES; cone++) {
+        if (header.targetMask & (1u << cone)) {
+            memcpy(out + length, &targets[cone], sizeof(GroupTarget));
+            length += sizeof(GroupTarget);
+        }
+    }
+    return length;
+}
+
+bool groupDecode(const uint8_t* data, int length, uint8_t coneId,
+                 GroupCommandHeader& header, GroupTarget& target) {
+    if (length < (int)sizeof(header) || coneId >= GROUP_MAX_CONES) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    uint8_t targets = 0;
+    for (uint16_t mask = header.targetMask; mask; mask &= mask - 1) {
+        targets++;
+    }
+    if (length != (int)(sizeof(header) + targets * sizeof(GroupTarget))) {
+        return false;
+    }
+    if (!(header.targetMask & (1u << coneId))) {
+        return false;
+    }
+
+    // 本锥桶之前的置位数即参数序号
+    uint8_t index = 0;
+    for (uint8_t cone = 0; cone < coneId; cone++) {
+        if (header.targetMask & (1u << cone)) {
+            index++;
+        }
+    }
+    memcpy(&target, data + sizeof(header) + index * sizeof(GroupTarget), sizeof(GroupTarget));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+GroupCommandReceiver::GroupCommandReceiver(uint8_t coneId)
+    : coneId(coneId), hasAction(false), seen(false), lastSequence(0) {
+    memset(&action, 0, sizeof(action));
+}
+
+GroupReceiveResult GroupCommandReceiver::receive(const uint8_t* data, int length, uint64_t nowUs,
+                                                 int64_t clockOffsetUs, bool clockValid) {
+    GroupCommandHeader header;
+    GroupTarget target;
+    if (!groupDecode(data, length, coneId, header, target)) {
+        return GROUP_RX_IGNORED;
+    }
+    if (seen && header.sequence == lastSequence) {
+        return GROUP_RX_DUPLICATE;
+    }
+    seen = true;
+    lastSequence = header.sequence;
+
+    action.target = target;
+    action.sequence = header.sequence;
+    action.applyAtUs = nowUs;
+    action.scheduled = false;
+    hasAction = true;
+
+    if (header.mode != GROUP_APPLY_AT || !clockValid) {
+        return GROUP_RX_IMMEDIATE;
+    }
+    int64_t localUs = header.goEpochUs - clockOffsetUs;
+    action.scheduled = true;
+    if (localUs <= (int64_t)nowUs) {
+        return GROUP_RX_LATE;
+    }
+    action.applyAtUs = (uint64_t)localUs;
+    return GROUP_RX_SCHEDULED;
+}
+
+bool GroupCommandReceiver::take(uint64_t nowUs, GroupAction& out) {
+    if (!hasAction || nowUs < action.applyAtUs) {
+        return false;
+    }
+    out = action;
+    hasAction = false;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+GroupSkewTracker::GroupSkewTracker()
+    : currentSequence(0), expectedMask(0), reportedMask(0), minLateness(0), maxLateness(0) {}
+
+void GroupSkewTracker::begin(uint16_t sequence, uint16_t targetMask) {
+    currentSequence = sequence;
+    expectedMask = targetMask;
+    reportedMask = 0;
+    minLateness = 0;
+    maxLateness = 0;
+}
+
+bool GroupSkewTracker::record(uint16_t sequence, uint8_t coneId, int32_t latenessUs) {
+    if (sequence != currentSequence || coneId >= GROUP_MAX_CONES || !(expectedMask & (1u << coneId))) {
+        return false;
+    }
+    if (!reportedMask || latenessUs < minLateness) {
+        minLateness = latenessUs;
+    }
+    if (!reportedMask || latenessUs > maxLateness) {
+        maxLateness = latenessUs;
+    }
+    reportedMask |= 1u << coneId;
+    return true;
+}
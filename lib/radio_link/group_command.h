@@ -0,0 +1,143 @@
+#ifndef GROUP_COMMAND_H
+#define GROUP_COMMAND_H
+
+#include <stdint.h>
+
+// 组命令 - 一条广播同时点亮/布防多个锥桶
+//   帧中带目标位图和每个目标的参数，只有被寻址的锥桶执行
+//   定时模式下帧中为主机墙钟的执行时刻，各锥桶按授时换算到本地时钟，在同一毫秒内执行
+//
+// 帧格式 (小端):
+//   command u8 | mode u8 | sequence u16 | targetMask u16 | reserved u16 | goEpochUs i64
+//   | 位图中每个置位的锥桶依次一个 GroupTarget (按锥桶号升序)
+#define GROUP_MAX_CONES     16
+#define GROUP_GO_LEAD_US    100000    // 定时执行提前量：覆盖排队、重复广播和各锥桶的主循环周期
+#define GROUP_REPEAT        2         // 广播重复次数，接收方按序号去重
+#define GROUP_SPIN_US       15000     // 距执行时刻小于该值时忙等到点（主循环周期10ms）
+
+enum GroupMode {
+    GROUP_APPLY_NOW = 0,      // 收到即执行
+    GROUP_APPLY_AT = 1        // 在goEpochUs执行
+};
+
+enum GroupFlags {
+    GROUP_FLAG_LIGHT = 0x01,  // 按颜色和效果设置灯光
+    GROUP_FLAG_ARM = 0x02,    // 开始计时，等待触发
+    GROUP_FLAG_DISARM = 0x04, // 停止计时，回到空闲
+    GROUP_FLAG_REPORT = 0x08  // 执行后回报执行时刻偏差
+};
+
+enum GroupEffect {
+    GROUP_EFFECT_OFF,
+    GROUP_EFFECT_SOLID,
+    GROUP_EFFECT_BREATHE
+};
+
+struct GroupTarget {
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+    uint8_t effect;
+    uint8_t flags;
+};
+
+struct GroupCommandHeader {
+    uint8_t command;
+    uint8_t mode;
+    uint16_t sequence;
+    uint16_t targetMask;
+    uint16_t reserved;
+    int64_t goEpochUs;
+};
+
+static_assert(sizeof(GroupTarget) == 5, "GroupTarget必须为5字节");
+static_assert(sizeof(GroupCommandHeader) == 16, "组命令帧头必须为16字节");
+
+#define GROUP_FRAME_MAX_BYTES (sizeof(GroupCommandHeader) + GROUP_MAX_CONES * sizeof(GroupTarget))
+
+// 编码组命令帧，targets按锥桶号索引，返回帧长度
+uint8_t groupEncode(const GroupCommandHeader& header, const GroupTarget* targets, uint8_t* out);
+
+// 解码并取出本锥桶的参数；帧格式错误或未寻址本锥桶时返回false
+bool groupDecode(const uint8_t* data, int length, uint8_t coneId,
+                 GroupCommandHeader& header, GroupTarget& target);
+
+static inline uint32_t groupColor(const GroupTarget& target) {
+    return ((uint32_t)target.red << 16) | ((uint32_t)target.green << 8) | target.blue;
+}
+
+// 执行回报放在message_t.data中：高16位序号，低16位执行时刻偏差（微秒，饱和到±32ms）
+static inline uint32_t groupPackReport(uint16_t sequence, int32_t latenessUs) {
+    if (latenessUs > 32767) latenessUs = 32767;
+    if (latenessUs < -32768) latenessUs = -32768;
+    return ((uint32_t)sequence << 16) | (uint16_t)(int16_t)latenessUs;
+}
+static inline uint16_t groupReportSequence(uint32_t data) { return (uint16_t)(data >> 16); }
+static inline int32_t groupReportLateness(uint32_t data) { return (int16_t)(data & 0xFFFF); }
+
+struct GroupAction {
+    GroupTarget target;
+    uint16_t sequence;
+    uint64_t applyAtUs;       // 本地Clock时间
+    bool scheduled;
+};
+
+enum GroupReceiveResult {
+    GROUP_RX_IGNORED,         // 格式错误或未寻址本锥桶
+    GROUP_RX_DUPLICATE,       // 重复广播
+    GROUP_RX_IMMEDIATE,       // 立即执行
+    GROUP_RX_SCHEDULED,       // 已按执行时刻排定
+    GROUP_RX_LATE             // 到达时已过执行时刻，立即执行
+};
+
+// 组命令接收 - 去重并把执行时刻换算到本地时钟，只保留最新的一条待执行命令
+class GroupCommandReceiver {
+public:
+    explicit GroupCommandReceiver(uint8_t coneId);
+    // 角色在运行时确定的固件按角色改用对应锥桶号
+    void setConeId(uint8_t id) { coneId = id; }
+
+    // clockOffsetUs = 墙钟微秒 - 本地Clock微秒；clockValid为false时定时命令收到即执行
+    GroupReceiveResult receive(const uint8_t* data, int length, uint64_t nowUs,
+                               int64_t clockOffsetUs, bool clockValid);
+
+    bool pending() const { return hasAction; }
+    uint64_t dueAtUs() const { return action.applyAtUs; }
+    // 取出已到执行时刻的命令
+    bool take(uint64_t nowUs, GroupAction& out);
+    void cancel() { hasAction = false; }
+
+private:
+    uint8_t coneId;
+    GroupAction action;
+    bool hasAction;
+    bool seen;
+    uint16_t lastSequence;
+};
+
+// 统计各锥桶执行时刻偏差，得到锥桶间的最大时差
+class GroupSkewTracker {
+public:
+    GroupSkewTracker();
+
+    void begin(uint16_t sequence, uint16_t targetMask);
+    // 不属于当前命令的回报返回false
+    bool record(uint16_t sequence, uint8_t coneId, int32_t latenessUs);
+
+    bool complete() const { return expectedMask != 0 && reportedMask == expectedMask; }
+    uint16_t sequence() const { return currentSequence; }
+    uint16_t reported() const { return reportedMask; }
+    uint16_t expected() const { return expectedMask; }
+    int32_t earliestUs() const { return minLateness; }
+    int32_t latestUs() const { return maxLateness; }
+    int32_t skewUs() const { return reportedMask ? maxLateness - minLateness : 0; }
+
+private:
+    uint16_t currentSequence;
+    uint16_t expectedMask;
+    uint16_t reportedMask;
+    int32_t minLateness;
+    int32_t maxLateness;
+};
+
+#endif // GROUP_COMMAND_H
@@ -0,0 +1,131 @@
+#include "peer_cache.h"
+#include "crc32.h"
+#include <string.h>
+
+#define PEER_CACHE_VERSION 1
+
+PeerCache::PeerCache() : peerCount(0) {
+    memset(peers, 0, sizeof(peers));
+}
+
+void PeerCache::remember(const uint8_t* mac, int8_t rssi) {
+    KnownPeer peer = {};
+    int index = indexOf(mac);
+    if (index >= 0) {
+        peer = peers[index];
+    } else {
+        memcpy(peer.mac, mac, 6);
+        index = peerCount < PEER_CACHE_SIZE ? peerCount++ : PEER_CACHE_SIZE - 1;
+    }
+    peer.rssi = rssi;
+    if (peer.connects < 255) {
+        peer.connects++;
+    }
+
+    // 前面的依次后移，新记录放在最前
+    memmove(&peers[1], &peers[0], index * sizeof(KnownPeer));
+    peers[0] = peer;
+}
+
+bool PeerCache::forget(const uint8_t* mac) {
+    int index = indexOf(mac);
+    if (index < 0) {
+        return false;
+    }
+    memmove(&peers[index], &peers[index + 1], (peerCount - index - 1) * sizeof(KnownPeer));
+    peerCount--;
+    return true;
+}
+
+int PeerCache::indexOf(const uint8_t* mac) const {
+    for (uint8_t i = 0; i < peerCount; i++) {
+        if (memcmp(peers[i].mac, mac, 6) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+size_t PeerCache::encode(uint8_t* out, size_t capacity) const {
+    size_t length = 4 + peerCount * 8 + 4;
+    if (capacity < length) {
+        return 0;
+    }
+    out[0] = 'P';
+    out[1] = 'C';
+    out[2] = PEER_CACHE_VERSION;
+    out[3] = peerCount;
+    for (uint8_t i = 0; i < peerCount; i++) {
+        uint8_t* entry = out + 4 + i * 8;
+        memcpy(entry, peers[i].mac, 6);
+        entry[6] = (uint8_t)peers[i].rssi;
+        entry[7] = peers[i].connects;
+    }
+    uint32_t crc = crc32Update(0, out, length - 4);
+    memcpy(out + length - 4, &crc, 4);
+    return length;
+}
+
+bool PeerCache::decode(const uint8_t* data, size_t length) {
+    if (length < 8 || data[0] != 'P' || data[1] != 'C' || data[2] != PEER_CACHE_VERSION ||
+        data[3] > PEER_CACHE_SIZE || length != (size_t)(4 + data[3] * 8 + 4)) {
+        return false;
+    }
+    uint32_t crc;
+    memcpy(&crc, data + length - 4, 4);
+    if (crc != crc32Update(0, data, length - 4)) {
+        return false;
+    }
+
+    peerCount = data[3];
+    for (uint8_t i = 0; i < peerCount; i++) {
+        const uint8_t* entry = data + 4 + i * 8;
+        memcpy(peers[i].mac, entry, 6);
+        peers[i].rssi = (int8_t)entry[6];
+        peers[i].connects = entry[7];
+    }
+    return true;
+}
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Preferences.h>
+
+bool peerCacheLoad(PeerCache& cache) {
+    Preferences prefs;
+    if (!prefs.begin(PEER_CACHE_NVS_NAMESPACE, true)) {
+        return false;
+    }
+    uint8_t blob[PEER_CACHE_BLOB_SIZE];
+    size_t size = prefs.getBytesLength(PEER_CACHE_NVS_KEY);
+    if (size == 0 || size > sizeof(blob)) {
+        prefs.end();
+        return false;
+    }
+    size = prefs.getBytes(PEER_CACHE_NVS_KEY, blob, size);
+    prefs.end();
+
+    if (!cache.decode(blob, size)) {
+        Serial.println("已知对端缓存无效，忽略");
+        return false;
+    }
+    Serial.printf("已知对端缓存: %d 个设备\n", cache.count());
+    return true;
+}
+
+bool peerCacheSave(const PeerCache& cache) {
+    uint8_t blob[PEER_CACHE_BLOB_SIZE];
+    size_t size = cache.encode(blob, sizeof(blob));
+    Preferences prefs;
+    if (size == 0 || !prefs.begin(PEER_CACHE_NVS_NAMESPACE, false)) {
+        Serial.println("已知对端缓存: 打开NVS失败");
+        return false;
+    }
+    bool ok = prefs.putBytes(PEER_CACHE_NVS_KEY, blob, size) == size;
+    prefs.end();
+    if (!ok) {
+        Serial.println("已知对端缓存: 写入NVS失败");
+    }
+    return ok;
+}
+#endif
@@ -0,0 +1,50 @@
+#ifndef PEER_CACHE_H
+#define PEER_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 已知对端缓存 - 配对成功的设备按最近使用排序保存在NVS中
+//   开机时直接向缓存中的对端发探测，无需扫描即可重连
+#define PEER_CACHE_SIZE         4
+#define PEER_CACHE_NVS_NAMESPACE "agility"   // 与设置共用命名空间
+#define PEER_CACHE_NVS_KEY      "peers"
+#define PEER_CACHE_BLOB_SIZE    (4 + PEER_CACHE_SIZE * 8 + 4)
+
+struct KnownPeer {
+    uint8_t mac[6];
+    int8_t rssi;              // 最近一次连接时的信号强度
+    uint8_t connects;         // 连接次数（饱和到255）
+};
+
+class PeerCache {
+public:
+    PeerCache();
+
+    void clear() { peerCount = 0; }
+    // 记入或更新对端并移到最前；缓存满时淘汰最久未用的
+    void remember(const uint8_t* mac, int8_t rssi);
+    bool forget(const uint8_t* mac);
+    // 返回排名（0为最近使用），不在缓存中返回-1
+    int indexOf(const uint8_t* mac) const;
+    bool contains(const uint8_t* mac) const { return indexOf(mac) >= 0; }
+
+    uint8_t count() const { return peerCount; }
+    const KnownPeer& at(uint8_t index) const { return peers[index]; }
+
+    // 编码格式: 'P' 'C' 版本 数量 | 每个对端 mac[6] rssi connects | CRC32
+    size_t encode(uint8_t* out, size_t capacity) const;
+    bool decode(const uint8_t* data, size_t length);
+
+private:
+    KnownPeer peers[PEER_CACHE_SIZE];
+    uint8_t peerCount;
+};
+
+#ifdef ARDUINO
+// 读写失败时返回false
+bool peerCacheLoad(PeerCache& cache);
+bool peerCacheSave(const PeerCache& cache);
+#endif
+
+#endif // PEER_CACHE_H
@@ -0,0 +1,78 @@
+#include "peer_discovery.h"
+
+ProbeSchedule::ProbeSchedule()
+    : startUs(0), nextUs(0), windowUs(0), intervalUs(0), jitterUs(0),
+      randomState(1), probes(0), running(false) {}
+
+void ProbeSchedule::begin(uint64_t nowUs, uint32_t interval, uint32_t jitter, uint64_t window, uint32_t seed) {
+    startUs = nowUs;
+    nextUs = nowUs;
+    windowUs = window;
+    intervalUs = interval;
+    jitterUs = jitter;
+    randomState = seed ? seed : 1;
+    probes = 0;
+    running = true;
+}
+
+bool ProbeSchedule::due(uint64_t nowUs) {
+    if (!running || nowUs < nextUs) {
+        return false;
+    }
+    if (expired(nowUs)) {
+        running = false;
+        return false;
+    }
+    probes++;
+    nextUs = nowUs + intervalUs + (jitterUs ? nextRandom() % jitterUs : 0);
+    return true;
+}
+
+uint32_t ProbeSchedule::nextRandom() {
+    // xorshift32，种子取自本机MAC，各锥桶的抖动序列不同
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+// ---------------------------------------------------------------------------
+
+PeerDiscovery::PeerDiscovery() : currentState(DISCOVERY_IDLE), firstResponseUs(0) {}
+
+void PeerDiscovery::begin(uint64_t nowUs, uint32_t seed) {
+    schedule.begin(nowUs, DISCOVERY_PROBE_INTERVAL_US, DISCOVERY_PROBE_JITTER_US, DISCOVERY_SCAN_US, seed);
+    currentState = DISCOVERY_PROBING;
+    firstResponseUs = 0;
+}
+
+void PeerDiscovery::stop() {
+    schedule.stop();
+    currentState = DISCOVERY_IDLE;
+}
+
+bool PeerDiscovery::probeDue(uint64_t nowUs) {
+    // 收集应答期间继续探测，让同时上电的其他锥桶也能被发现
+    if (currentState != DISCOVERY_PROBING && currentState != DISCOVERY_SETTLING) {
+        return false;
+    }
+    return schedule.due(nowUs);
+}
+
+void PeerDiscovery::onResponse(uint64_t nowUs) {
+    if (currentState == DISCOVERY_PROBING) {
+        currentState = DISCOVERY_SETTLING;
+        firstResponseUs = nowUs;
+    }
+}
+
+DiscoveryState PeerDiscovery::update(uint64_t nowUs) {
+    if (currentState == DISCOVERY_SETTLING && nowUs - firstResponseUs >= DISCOVERY_SETTLE_US) {
+        schedule.stop();
+        currentState = DISCOVERY_DONE;
+    } else if (currentState == DISCOVERY_PROBING && schedule.expired(nowUs)) {
+        schedule.stop();
+        currentState = DISCOVERY_EMPTY;
+    }
+    return currentState;
+}
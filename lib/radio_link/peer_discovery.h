@@ -0,0 +1,71 @@
+#ifndef PEER_DISCOVERY_H
+#define PEER_DISCOVERY_H
+
+#include <stdint.h>
+
+// 主动发现 - 按带随机抖动的间隔重复发探测，不再发一次后被动等待
+//   抖动避免多个锥桶同时上电时探测帧一直互相碰撞
+#define DISCOVERY_PROBE_INTERVAL_US  80000    // 配对探测间隔
+#define DISCOVERY_PROBE_JITTER_US    40000    // 探测间隔的随机抖动范围
+#define DISCOVERY_SETTLE_US          150000   // 首个应答后继续收集的时间，用于按信号强度排序
+#define DISCOVERY_SCAN_US            5000000  // 无应答时的扫描时长上限
+#define RECONNECT_PROBE_INTERVAL_US  50000    // 开机重连探测间隔
+#define RECONNECT_PROBE_JITTER_US    30000
+#define RECONNECT_WINDOW_US          3000000  // 开机快速重连时长，之后按常规心跳间隔重试
+
+// 探测计划：开始后立即到期一次，之后每次间隔 interval + [0, jitter)
+class ProbeSchedule {
+public:
+    ProbeSchedule();
+
+    void begin(uint64_t nowUs, uint32_t intervalUs, uint32_t jitterUs, uint64_t windowUs, uint32_t seed);
+    void stop() { running = false; }
+    // 到期时返回true并排定下一次
+    bool due(uint64_t nowUs);
+    bool active() const { return running; }
+    bool expired(uint64_t nowUs) const { return nowUs - startUs >= windowUs; }
+    uint16_t sent() const { return probes; }
+
+private:
+    uint32_t nextRandom();
+
+    uint64_t startUs;
+    uint64_t nextUs;
+    uint64_t windowUs;
+    uint32_t intervalUs;
+    uint32_t jitterUs;
+    uint32_t randomState;
+    uint16_t probes;
+    bool running;
+};
+
+enum DiscoveryState {
+    DISCOVERY_IDLE,
+    DISCOVERY_PROBING,        // 探测中，尚无应答
+    DISCOVERY_SETTLING,       // 已有应答，短暂收集其他应答
+    DISCOVERY_DONE,           // 有应答，可按信号强度选择
+    DISCOVERY_EMPTY           // 扫描时长内无应答
+};
+
+// 配对扫描：有兼容设备应答后很快结束，不等满扫描时长
+class PeerDiscovery {
+public:
+    PeerDiscovery();
+
+    void begin(uint64_t nowUs, uint32_t seed);
+    void stop();
+    // 是否该发下一个探测
+    bool probeDue(uint64_t nowUs);
+    // 收到兼容设备应答
+    void onResponse(uint64_t nowUs);
+    DiscoveryState update(uint64_t nowUs);
+    DiscoveryState state() const { return currentState; }
+    uint16_t probesSent() const { return schedule.sent(); }
+
+private:
+    ProbeSchedule schedule;
+    DiscoveryState currentState;
+    uint64_t firstResponseUs;
+};
+
+#endif // PEER_DISCOVERY_H
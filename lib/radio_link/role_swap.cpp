@@ -0,0 +1,143 @@
+#include "role_swap.h"
+#include <string.h>
+
+bool roleSwapDecode(const uint8_t* data, int length, uint8_t command, RoleSwapFrame& frame) {
+    if (length != (int)sizeof(RoleSwapFrame) || data[0] != command) {
+        return false;
+    }
+    memcpy(&frame, data, sizeof(frame));
+    return frame.phase >= ROLE_SWAP_REQUEST && frame.phase <= ROLE_SWAP_CANCEL;
+}
+
+RoleSwap::RoleSwap(uint8_t command) : command(command), sequence(0) {
+    begin(false);
+}
+
+void RoleSwap::begin(bool isMaster) {
+    master = isMaster;
+    wanted = false;
+    offering = false;
+    roleChanged = false;
+    offerStartUs = 0;
+    lastSendUs = 0;
+    acceptedValid = false;
+    acceptedSequence = 0;
+    acceptedUs = 0;
+    memset(&adoptedSession, 0, sizeof(adoptedSession));
+    swapCount = 0;
+    failureCount = 0;
+    lastLatencyUs = 0;
+}
+
+void RoleSwap::fill(RoleSwapFrame& frame, uint8_t phase, uint8_t seq) const {
+    memset(&frame, 0, sizeof(frame));
+    frame.command = command;
+    frame.phase = phase;
+    frame.sequence = seq;
+}
+
+bool RoleSwap::poll(uint64_t nowUs, bool betweenRounds, const RoleSwapSession& session, RoleSwapFrame& out) {
+    if (acceptedValid && nowUs - acceptedUs >= ROLE_SWAP_PROBATION_US) {
+        acceptedValid = false;
+    }
+
+    if (!master) {
+        if (!wanted) {
+            return false;
+        }
+        wanted = false;
+        fill(out, ROLE_SWAP_REQUEST, 0);
+        return true;
+    }
+
+    if (offering) {
+        if (!betweenRounds) {
+            // 对端在收到OFFER前已开始回合（会回DECLINE），本回合结束后重新发起
+            offering = false;
+            wanted = true;
+            return false;
+        }
+        if (nowUs - offerStartUs >= ROLE_SWAP_TIMEOUT_US) {
+            offering = false;
+            failureCount++;
+            fill(out, ROLE_SWAP_CANCEL, sequence);
+            return true;
+        }
+        if (nowUs - lastSendUs < ROLE_SWAP_RETRY_US) {
+            return false;
+        }
+    } else {
+        if (!wanted || !betweenRounds) {
+            return false;
+        }
+        wanted = false;
+        offering = true;
+        sequence++;
+        offerStartUs = nowUs;
+    }
+    lastSendUs = nowUs;
+    fill(out, ROLE_SWAP_OFFER, sequence);
+    out.session = session;
+    return true;
+}
+
+bool RoleSwap::receive(const RoleSwapFrame& frame, uint64_t nowUs, bool betweenRounds, RoleSwapFrame& reply) {
+    bool recentAccept = acceptedValid && frame.sequence == acceptedSequence &&
+                        nowUs - acceptedUs < ROLE_SWAP_PROBATION_US;
+    switch (frame.phase) {
+        case ROLE_SWAP_REQUEST:
+            if (master) {
+                wanted = true;
+            }
+            return false;
+
+        case ROLE_SWAP_OFFER:
+            if (master) {
+                // 本机的ACCEPT丢失，对端重发：重复应答
+                if (recentAccept) {
+                    fill(reply, ROLE_SWAP_ACCEPT, frame.sequence);
+                    return true;
+                }
+                return false;
+            }
+            if (!betweenRounds) {
+                fill(reply, ROLE_SWAP_DECLINE, frame.sequence);
+                return true;
+            }
+            adoptedSession = frame.session;
+            master = true;
+            wanted = false;
+            roleChanged = true;
+            acceptedValid = true;
+            acceptedSequence = frame.sequence;
+            acceptedUs = nowUs;
+            fill(reply, ROLE_SWAP_ACCEPT, frame.sequence);
+            return true;
+
+        case ROLE_SWAP_ACCEPT:
+            if (master && offering && frame.sequence == sequence) {
+                offering = false;
+                master = false;
+                roleChanged = true;
+                swapCount++;
+                lastLatencyUs = (uint32_t)(nowUs - offerStartUs);
+            }
+            return false;
+
+        case ROLE_SWAP_DECLINE:
+            if (master && offering && frame.sequence == sequence) {
+                offering = false;
+                wanted = true;
+            }
+            return false;
+
+        case ROLE_SWAP_CANCEL:
+            if (master && recentAccept) {
+                master = false;
+                roleChanged = true;
+                acceptedValid = false;
+            }
+            return false;
+    }
+    return false;
+}
@@ -0,0 +1,106 @@
+#ifndef ROLE_SWAP_H
+#define ROLE_SWAP_H
+
+#include <stdint.h>
+
+// 主从角色交换 - 折返跑时由另一台设备作为起点，课程状态随一帧交给新主机
+//   1. 任一方请求：主机本机直接排队，从机发REQUEST给主机
+//   2. 主机在回合之间发出OFFER，帧中带课程快照和训练设置，未应答时按间隔重发（序号不变）
+//   3. 从机未发出开始信号时采用快照、切换为主机并回ACCEPT；已发出则回DECLINE，
+//      主机照常计完该回合后再交换，不丢回合
+//   4. 主机收到ACCEPT即切换为从机；新主机对重发的OFFER按序号重复应答
+//   5. 超时未收到应答时主机发CANCEL，已切换的对端据此退回从机
+//
+// 帧格式 (小端, 24字节):
+//   command u8 | phase u8 | sequence u8 | reserved u8
+//   | rounds u16 | alertSeconds u16 | totalTicks u32 | elapsedMs u32 | lastTicks u32
+//   | ledColor u8 | ledBrightness u8 | flags u8 | reserved u8
+#define ROLE_SWAP_RETRY_US      15000     // OFFER重发间隔（主循环周期10ms）
+#define ROLE_SWAP_TIMEOUT_US    200000    // 超时放弃并发CANCEL
+#define ROLE_SWAP_PROBATION_US  500000    // 新主机在此期间接受CANCEL
+
+enum RoleSwapPhase : uint8_t {
+    ROLE_SWAP_REQUEST = 1,    // 从机请求主机发起交换
+    ROLE_SWAP_OFFER,          // 主机发出，带课程快照
+    ROLE_SWAP_ACCEPT,         // 从机已切换为主机
+    ROLE_SWAP_DECLINE,        // 从机回合进行中
+    ROLE_SWAP_CANCEL          // 主机超时放弃
+};
+
+#define ROLE_SWAP_FLAG_SOUND    0x01
+
+// 交接的课程状态与训练设置（用时单位0.1ms）
+struct RoleSwapSession {
+    uint16_t rounds;
+    uint16_t alertSeconds;
+    uint32_t totalTicks;
+    uint32_t elapsedMs;       // 课程已进行时长
+    uint32_t lastTicks;       // 上一回合用时
+    uint8_t ledColor;
+    uint8_t ledBrightness;
+    uint8_t flags;
+    uint8_t reserved;
+};
+
+struct RoleSwapFrame {
+    uint8_t command;
+    uint8_t phase;
+    uint8_t sequence;
+    uint8_t reserved;
+    RoleSwapSession session;
+};
+
+static_assert(sizeof(RoleSwapSession) == 20, "RoleSwapSession必须为20字节");
+static_assert(sizeof(RoleSwapFrame) == 24, "角色交换帧必须为24字节");
+
+// 长度、命令号或阶段不对时返回false
+bool roleSwapDecode(const uint8_t* data, int length, uint8_t command, RoleSwapFrame& frame);
+
+class RoleSwap {
+public:
+    // command为帧首字节的命令号（与message_t共用）
+    explicit RoleSwap(uint8_t command);
+
+    void begin(bool master);
+    bool isMaster() const { return master; }
+
+    // 请求交换，主机在下一个回合间隙发出，从机在下次poll时发REQUEST
+    void request() { wanted = true; }
+    bool requested() const { return wanted || offering; }
+
+    // 主循环调用：betweenRounds为本机是否在回合之间，session为本机当前课程状态（主机用）
+    // 返回true时发送out
+    bool poll(uint64_t nowUs, bool betweenRounds, const RoleSwapSession& session, RoleSwapFrame& out);
+    // 收到对端帧，betweenRounds同上；返回true时发送reply
+    bool receive(const RoleSwapFrame& frame, uint64_t nowUs, bool betweenRounds, RoleSwapFrame& reply);
+
+    // 角色变化后返回true一次；切换为主机时adopted有效
+    bool takeRoleChanged() { bool changed = roleChanged; roleChanged = false; return changed; }
+    const RoleSwapSession& adopted() const { return adoptedSession; }
+
+    uint32_t swaps() const { return swapCount; }
+    uint32_t failures() const { return failureCount; }
+    // 最近一次交换从首次发出OFFER到收到ACCEPT的时间
+    uint32_t lastSwapUs() const { return lastLatencyUs; }
+
+private:
+    uint8_t command;
+    bool master;
+    bool wanted;
+    bool offering;
+    bool roleChanged;
+    uint8_t sequence;
+    uint64_t offerStartUs;
+    uint64_t lastSendUs;
+    bool acceptedValid;       // 新主机：最近接受的交换仍可被重复应答或取消
+    uint8_t acceptedSequence;
+    uint64_t acceptedUs;
+    RoleSwapSession adoptedSession;
+    uint32_t swapCount;
+    uint32_t failureCount;
+    uint32_t lastLatencyUs;
+
+    void fill(RoleSwapFrame& frame, uint8_t phase, uint8_t seq) const;
+};
+
+#endif // ROLE_SWAP_H
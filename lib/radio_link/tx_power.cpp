@@ -0,0 +1,165 @@
+#include "tx_power.h"
+#include <string.h>
+
+static const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+TxPowerController::TxPowerController() {
+#ifdef ARDUINO
+    tableMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+    reset();
+}
+
+void TxPowerController::lock() const {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&tableMux);
+#endif
+}
+
+void TxPowerController::unlock() const {
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&tableMux);
+#endif
+}
+
+void TxPowerController::reset() {
+    lock();
+    memset(table, 0, sizeof(table));
+    peers = 0;
+    memset(&counters, 0, sizeof(counters));
+    unlock();
+}
+
+void TxPowerController::resetStats() {
+    lock();
+    memset(&counters, 0, sizeof(counters));
+    unlock();
+}
+
+TxPowerStats TxPowerController::stats() const {
+    lock();
+    TxPowerStats snapshot = counters;
+    unlock();
+    return snapshot;
+}
+
+TxPowerController::Peer* TxPowerController::find(const uint8_t* mac) {
+    for (uint8_t i = 0; i < peers; i++) {
+        if (memcmp(table[i].mac, mac, 6) == 0) {
+            return &table[i];
+        }
+    }
+    return nullptr;
+}
+
+const TxPowerController::Peer* TxPowerController::find(const uint8_t* mac) const {
+    return const_cast<TxPowerController*>(this)->find(mac);
+}
+
+TxPowerController::Peer* TxPowerController::findOrAdd(const uint8_t* mac, uint64_t nowUs) {
+    Peer* peer = find(mac);
+    if (peer || memcmp(mac, kBroadcast, 6) == 0) {
+        return peer;
+    }
+    if (peers < TXP_MAX_PEERS) {
+        peer = &table[peers++];
+    } else {
+        // 表满时替换最久未调整的对端
+        peer = &table[0];
+        for (uint8_t i = 1; i < peers; i++) {
+            if (table[i].lastChangeUs < peer->lastChangeUs) {
+                peer = &table[i];
+            }
+        }
+    }
+    memcpy(peer->mac, mac, 6);
+    peer->level = TXP_LEVEL_MAX;
+    peer->failures = 0;
+    peer->settled = true;
+    peer->lastChangeUs = nowUs;
+    peer->holdUntilUs = 0;
+    return peer;
+}
+
+int8_t TxPowerController::levelFor(const uint8_t* mac) const {
+    int8_t level = TXP_LEVEL_MAX;
+    lock();
+    if (memcmp(mac, kBroadcast, 6) == 0) {
+        // 广播要让所有对端都收到
+        if (peers > 0) {
+            level = TXP_LEVEL_MIN;
+            for (uint8_t i = 0; i < peers; i++) {
+                if (table[i].level > level) {
+                    level = table[i].level;
+                }
+            }
+        }
+    } else {
+        const Peer* peer = find(mac);
+        if (peer) {
+            level = peer->level;
+        }
+    }
+    unlock();
+    return level;
+}
+
+void TxPowerController::onFeedback(const uint8_t* mac, int8_t rssiAtPeer, uint64_t nowUs) {
+    lock();
+    Peer* peer = findOrAdd(mac, nowUs);
+    if (!peer) {
+        unlock();
+        return;
+    }
+    if (!peer->settled) {
+        peer->settled = true;
+        unlock();
+        return;
+    }
+
+    if (rssiAtPeer < TXP_TARGET_RSSI && peer->level < TXP_LEVEL_MAX) {
+        // 余量不足：升一级
+        peer->level = peer->level + TXP_STEP > TXP_LEVEL_MAX ? TXP_LEVEL_MAX : peer->level + TXP_STEP;
+        peer->lastChangeUs = nowUs;
+        peer->settled = false;
+        counters.stepsUp++;
+    } else if (rssiAtPeer >= TXP_TARGET_RSSI + TXP_BAND_DB && peer->level > TXP_LEVEL_MIN &&
+               nowUs >= peer->holdUntilUs && nowUs - peer->lastChangeUs >= TXP_DOWN_INTERVAL_US) {
+        // 余量充足：降一级，降后的接收强度不低于目标
+        peer->level = peer->level - TXP_STEP < TXP_LEVEL_MIN ? TXP_LEVEL_MIN : peer->level - TXP_STEP;
+        peer->lastChangeUs = nowUs;
+        peer->settled = false;
+        counters.stepsDown++;
+    }
+    unlock();
+}
+
+void TxPowerController::onDelivery(const uint8_t* mac, bool delivered, uint64_t nowUs) {
+    lock();
+    Peer* peer = find(mac);
+    if (!peer) {
+        unlock();
+        return;
+    }
+    if (delivered) {
+        peer->failures = 0;
+        unlock();
+        return;
+    }
+    if (++peer->failures >= TXP_LOSS_SNAP && peer->level < TXP_LEVEL_MAX) {
+        peer->level = TXP_LEVEL_MAX;
+        peer->failures = 0;
+        peer->lastChangeUs = nowUs;
+        peer->holdUntilUs = nowUs + TXP_HOLDOFF_US;
+        peer->settled = false;
+        counters.snaps++;
+    }
+    unlock();
+}
+
+void TxPowerController::onSent(int8_t level) {
+    lock();
+    counters.frames++;
+    counters.levelSum += (uint8_t)level;
+    unlock();
+}
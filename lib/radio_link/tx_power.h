@@ -0,0 +1,90 @@
+#ifndef TX_POWER_H
+#define TX_POWER_H
+
+#include <stdint.h>
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#endif
+
+// 发射功率闭环控制 - 每个对端单独一个功率等级
+//   1. 对端在心跳/应答中回报它收到本机帧的RSSI，高于目标余量时逐级降功率
+//   2. 功率改变后的第一个回报可能来自改变前发出的帧，丢弃；两次降功率至少间隔TXP_DOWN_INTERVAL_US
+//   3. 连续发送失败时立即回到最大功率，之后一段时间内不再降
+//   4. 发送前按目标对端设置功率；广播取各对端中的最大值
+//   5. 回报和发送完成来自ESP-NOW回调，与主循环的发送并发：对端表和统计由临界区保护
+// 功率单位与esp_wifi_set_max_tx_power相同：0.25dBm
+#define TXP_MAX_PEERS           4
+#define TXP_LEVEL_MIN           8         // 2dBm
+#define TXP_LEVEL_MAX           80        // 20dBm (ESP32-C3上限)
+#define TXP_STEP                8         // 每步2dB
+#define TXP_TARGET_RSSI         -72       // 对端接收强度目标：约20dB余量（1Mbps灵敏度约-92dBm）
+#define TXP_BAND_DB             6         // 高于目标该值以上才降功率
+#define TXP_DOWN_INTERVAL_US    1000000
+#define TXP_LOSS_SNAP           2         // 连续失败次数，达到后回到最大功率
+#define TXP_HOLDOFF_US          10000000  // 回到最大功率后暂停降功率的时长
+
+// 心跳data字段：低8位原有内容，8-15位为回报的RSSI，第16位表示带有回报
+static inline uint32_t txPowerPackFeedback(uint8_t low, int8_t rssi) {
+    return rssi == 0 ? low : (uint32_t)low | ((uint32_t)(uint8_t)rssi << 8) | 0x10000u;
+}
+static inline bool txPowerHasFeedback(uint32_t data) { return (data & 0x10000u) != 0; }
+static inline int8_t txPowerFeedbackRssi(uint32_t data) { return (int8_t)((data >> 8) & 0xFF); }
+
+struct TxPowerStats {
+    uint32_t frames;          // 本会话发出的帧数
+    uint32_t levelSum;        // 各帧功率等级之和
+    uint16_t stepsDown;
+    uint16_t stepsUp;
+    uint16_t snaps;           // 因丢包回到最大功率的次数
+
+    // 平均发射功率（dBm*10）
+    int32_t averageDeciDbm() const { return frames ? (int32_t)(levelSum * 10 / frames / 4) : TXP_LEVEL_MAX * 10 / 4; }
+};
+
+class TxPowerController {
+public:
+    TxPowerController();
+
+    // 清空对端和统计（新会话）
+    void reset();
+    void resetStats();
+
+    // 发送前取目标对端的功率等级；未知对端和广播用最大值/各对端最大值
+    int8_t levelFor(const uint8_t* mac) const;
+    // 对端回报的本机帧接收强度
+    void onFeedback(const uint8_t* mac, int8_t rssiAtPeer, uint64_t nowUs);
+    // 发送完成回调：是否收到MAC层应答
+    void onDelivery(const uint8_t* mac, bool delivered, uint64_t nowUs);
+    // 记录实际发出的一帧
+    void onSent(int8_t level);
+
+    // 返回快照：统计在发送完成回调中也会更新
+    TxPowerStats stats() const;
+    uint8_t peerCount() const { return peers; }
+
+private:
+    struct Peer {
+        uint8_t mac[6];
+        int8_t level;
+        uint8_t failures;         // 连续发送失败次数
+        bool settled;             // 功率改变后是否已丢弃过一个回报
+        uint64_t lastChangeUs;
+        uint64_t holdUntilUs;
+    };
+
+    Peer* find(const uint8_t* mac);
+    const Peer* find(const uint8_t* mac) const;
+    Peer* findOrAdd(const uint8_t* mac, uint64_t nowUs);
+
+    void lock() const;
+    void unlock() const;
+
+    Peer table[TXP_MAX_PEERS];
+    uint8_t peers;
+    TxPowerStats counters;
+#ifdef ARDUINO
+    mutable portMUX_TYPE tableMux;
+#endif
+};
+
+#endif // TX_POWER_H
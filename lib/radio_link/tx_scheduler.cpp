@@ -0,0 +1,237 @@
+#include "tx_scheduler.h"
+#include <string.h>
+#include "clock.h"
+
+// 各优先级的最长排队时间，0表示不过期；过期的状态类消息已无意义，不再占用空口
+static const uint32_t kMaxAgeUs[TX_PRIO_COUNT] = {
+    0,          // 计时
+    2000000,    // 控制
+    1000000,    // 状态上报
+    1000000     // 心跳
+};
+
+TxScheduler::TxScheduler(TxTransport& transport, uint8_t maxInFlight)
+    : transport(transport), maxInFlight(maxInFlight ? maxInFlight : 1),
+      count(0), nextOrder(0), issued(0), completed(0), undelivered(0),
+      lastCompleted(0), lastProgressUs(0), retryAtUs(0), held(false), servicing(false) {
+#ifdef ARDUINO
+    queueMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+    memset(frames, 0, sizeof(frames));
+    memset(&counters, 0, sizeof(counters));
+}
+
+// 主循环与接收回调（WiFi任务）共用队列；主机测试中为单线程，不需要加锁
+void TxScheduler::lock() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&queueMux);
+#endif
+}
+
+void TxScheduler::unlock() {
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&queueMux);
+#endif
+}
+
+bool TxScheduler::enqueue(const uint8_t* mac, const void* data, uint8_t length,
+                          TxPriority priority, uint8_t coalesceKey) {
+    lock();
+    Frame* frame = nullptr;
+    if (coalesceKey != 0) {
+        for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+            if (frames[i].used && !frames[i].sending && frames[i].coalesceKey == coalesceKey &&
+                memcmp(frames[i].mac, mac, 6) == 0) {
+                // 保留原排队位置，内容换成最新的
+                frame = &frames[i];
+                counters.coalesced++;
+                break;
+            }
+        }
+    }
+    if (!frame) {
+        frame = slotFor(priority);
+        if (!frame) {
+            counters.rejected++;
+            unlock();
+            return false;
+        }
+        frame->used = true;
+        frame->order = nextOrder++;
+        count++;
+    }
+
+    memcpy(frame->mac, mac, 6);
+    memcpy(frame->data, data, length);
+    frame->length = length;
+    frame->priority = priority;
+    frame->coalesceKey = coalesceKey;
+    frame->enqueuedUs = Clock::nowUs();
+    unlock();
+
+    service();
+    return true;
+}
+
+void TxScheduler::service() {
+    lock();
+    if (servicing) {
+        unlock();
+        return;
+    }
+    uint64_t now = Clock::nowUs();
+
+    uint32_t done = completed;
+    if (done != lastCompleted) {
+        lastCompleted = done;
+        lastProgressUs = now;
+    }
+    int32_t flying = (int32_t)(issued - done);
+    if (flying < 0) {
+        issued = done;
+        flying = 0;
+    }
+    if (flying > 0 && now - lastProgressUs > TX_COMPLETE_TIMEOUT_US) {
+        counters.timeouts += flying;
+        issued = done;
+        flying = 0;
+    }
+
+    if (held) {
+        unlock();
+        return;
+    }
+
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        Frame& frame = frames[i];
+        uint32_t maxAge = kMaxAgeUs[frame.priority];
+        if (frame.used && maxAge != 0 && now - frame.enqueuedUs > maxAge) {
+            counters.expired++;
+            drop(frame);
+        }
+    }
+
+    if ((int64_t)(now - retryAtUs) < 0) {
+        unlock();
+        return;
+    }
+
+    servicing = true;
+    Frame* frame;
+    while ((frame = next()) != nullptr) {
+        // 队首帧受名额限制时，优先级更低的帧同样不能发
+        int32_t limit = frame->priority == TX_PRIO_TIMING || maxInFlight == 1 ? maxInFlight : maxInFlight - 1;
+        if (flying >= limit) {
+            break;
+        }
+
+        // esp_now_send不能在临界区内调用；发送期间该帧不会被入队改动
+        frame->sending = true;
+        unlock();
+        TxSendResult result = transport.send(frame->mac, frame->data, frame->length);
+        lock();
+        frame->sending = false;
+        if (result == TX_SEND_BUSY) {
+            counters.busy++;
+            retryAtUs = now + TX_BUSY_BACKOFF_US;
+            break;
+        }
+        if (result == TX_SEND_OK) {
+            issued++;
+            flying++;
+            lastProgressUs = now;
+            counters.sent++;
+            uint32_t waitUs = (uint32_t)(now - frame->enqueuedUs);
+            if (waitUs > counters.maxWaitUs[frame->priority]) {
+                counters.maxWaitUs[frame->priority] = waitUs;
+            }
+        } else {
+            counters.failed++;
+        }
+        drop(*frame);
+    }
+    servicing = false;
+    unlock();
+}
+
+void TxScheduler::onSendComplete(bool delivered) {
+    if (!delivered) {
+        undelivered = undelivered + 1;
+    }
+    completed = completed + 1;
+}
+
+void TxScheduler::setHold(bool hold) {
+    lock();
+    if (held && !hold) {
+        // 保持是有意的等待，不计入排队过期
+        uint64_t now = Clock::nowUs();
+        for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+            if (frames[i].used) {
+                frames[i].enqueuedUs = now;
+            }
+        }
+    }
+    held = hold;
+    unlock();
+}
+
+uint8_t TxScheduler::inFlight() const {
+    int32_t flying = (int32_t)(issued - completed);
+    return flying > 0 ? (uint8_t)flying : 0;
+}
+
+void TxScheduler::clear() {
+    lock();
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        // 正在发送的帧由service()发完后释放
+        if (frames[i].used && !frames[i].sending) {
+            drop(frames[i]);
+        }
+    }
+    unlock();
+}
+
+TxScheduler::Frame* TxScheduler::next() {
+    Frame* best = nullptr;
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        Frame& frame = frames[i];
+        if (!frame.used || frame.sending) {
+            continue;
+        }
+        if (!best || frame.priority < best->priority ||
+            (frame.priority == best->priority && (int32_t)(frame.order - best->order) < 0)) {
+            best = &frame;
+        }
+    }
+    return best;
+}
+
+TxScheduler::Frame* TxScheduler::slotFor(uint8_t priority) {
+    Frame* victim = nullptr;
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        Frame& frame = frames[i];
+        if (frame.sending) {
+            continue;
+        }
+        if (!frame.used) {
+            return &frame;
+        }
+        // 优先级最低者中最新入队的
+        if (!victim || frame.priority > victim->priority ||
+            (frame.priority == victim->priority && (int32_t)(frame.order - victim->order) > 0)) {
+            victim = &frame;
+        }
+    }
+    if (!victim || victim->priority <= priority) {
+        return nullptr;
+    }
+    counters.evicted++;
+    drop(*victim);
+    return victim;
+}
+
+void TxScheduler::drop(Frame& frame) {
+    frame.used = false;
+    count--;
+}
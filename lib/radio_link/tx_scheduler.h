@@ -0,0 +1,125 @@
+#ifndef TX_SCHEDULER_H
+#define TX_SCHEDULER_H
+
+#include <stdint.h>
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#endif
+
+// 发送调度 - 所有无线消息经优先级队列发出，按发送完成回调控制在途帧数
+//   1. 同一优先级先进先出，高优先级总是先发
+//   2. 计时类消息独占一个在途名额：其它消息最多占用 maxInFlight-1 个，计时消息不会排在心跳之后
+//   3. 可合并的消息（心跳、授时等）入队时替换队列中同一目标的旧帧
+//   4. 队列满时挤掉优先级最低的最新帧；过期的低优先级帧在发出前丢弃
+//   5. 驱动缓冲区满 (NO_MEM) 时保留该帧，退避后重试
+//   6. 保持期间（锥桶接收关闭）只入队不发送，也不过期；解除时排队时间从解除时刻算起
+//   7. 可在ESP-NOW接收回调中入队：队列由临界区保护，发送调用在临界区之外；
+//      另一上下文正在发送时入队只排队，由正在运行的service()或下一轮主循环发出
+
+#define TX_QUEUE_SIZE           12
+#define TX_FRAME_MAX_BYTES      250       // ESP-NOW单帧上限
+#define TX_MAX_IN_FLIGHT        2
+#define TX_BUSY_BACKOFF_US      2000      // 驱动缓冲区满后的重试间隔
+#define TX_COMPLETE_TIMEOUT_US  50000     // 超过该时间未收到发送回调视为丢失，释放名额
+
+enum TxPriority {
+    TX_PRIO_TIMING,       // 计时关键：开始/完成信号、授时
+    TX_PRIO_CONTROL,      // 控制：配对、重置、授时请求
+    TX_PRIO_TELEMETRY,    // 状态上报
+    TX_PRIO_HEARTBEAT,    // 心跳及应答
+    TX_PRIO_COUNT
+};
+
+enum TxSendResult {
+    TX_SEND_OK,
+    TX_SEND_BUSY,         // 暂时无法发送，稍后重试
+    TX_SEND_FAILED        // 发送失败，丢弃该帧
+};
+
+// 发送接口 - 设备上由ESP-NOW实现，主机测试中由模拟信道实现
+class TxTransport {
+public:
+    virtual ~TxTransport() {}
+    virtual TxSendResult send(const uint8_t* mac, const uint8_t* data, uint8_t length) = 0;
+};
+
+struct TxStats {
+    uint32_t sent;
+    uint32_t coalesced;       // 被新帧替换
+    uint32_t evicted;         // 队列满时被更高优先级挤掉
+    uint32_t rejected;        // 队列满且无可挤掉的帧
+    uint32_t expired;         // 排队超时
+    uint32_t busy;            // 驱动缓冲区满
+    uint32_t failed;          // 发送调用失败
+    uint32_t timeouts;        // 未收到发送回调
+    uint32_t maxWaitUs[TX_PRIO_COUNT];  // 各优先级入队到发出的最长等待
+};
+
+class TxScheduler {
+public:
+    explicit TxScheduler(TxTransport& transport, uint8_t maxInFlight = TX_MAX_IN_FLIGHT);
+
+    // 入队并立即尝试发送；coalesceKey非0时替换队列中同一目标、同一键的未发送帧（主循环和接收回调均可调用）
+    bool enqueue(const uint8_t* mac, const void* data, uint8_t length,
+                 TxPriority priority, uint8_t coalesceKey = 0);
+
+    // 主循环调用：丢弃过期帧，在名额内按优先级发出
+    void service();
+
+    // 发送完成回调中调用（WiFi任务上下文，只更新计数）
+    void onSendComplete(bool delivered);
+
+    // 暂停/恢复发送（占空模式下锥桶的监听窗口之外）
+    void setHold(bool hold);
+    bool holding() const { return held; }
+
+    uint8_t inFlight() const;
+    uint8_t queued() const { return count; }
+    uint32_t deliveryFailures() const { return undelivered; }
+    const TxStats& stats() const { return counters; }
+    void clear();
+
+private:
+    struct Frame {
+        uint8_t mac[6];
+        uint8_t data[TX_FRAME_MAX_BYTES];
+        uint8_t length;
+        uint8_t priority;
+        uint8_t coalesceKey;
+        bool used;
+        bool sending;             // 正在临界区外发送，不可替换、挤掉或复用
+        uint32_t order;
+        uint64_t enqueuedUs;
+    };
+
+    TxTransport& transport;
+    uint8_t maxInFlight;
+
+    Frame frames[TX_QUEUE_SIZE];
+    uint8_t count;
+    uint32_t nextOrder;
+
+    uint32_t issued;                  // 主循环写
+    volatile uint32_t completed;      // 发送回调写
+    volatile uint32_t undelivered;
+    uint32_t lastCompleted;
+    uint64_t lastProgressUs;          // 最近一次发出或完成的时刻
+    uint64_t retryAtUs;
+    bool held;
+    bool servicing;                   // 已有上下文在service()中
+#ifdef ARDUINO
+    portMUX_TYPE queueMux;
+#endif
+
+    TxStats counters;
+
+    void lock();
+    void unlock();
+    Frame* next();
+    Frame* slotFor(uint8_t priority);
+    void drop(Frame& frame);
+};
+
+extern TxScheduler radioTx;
+
+#endif // TX_SCHEDULER_H
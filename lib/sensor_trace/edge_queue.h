@@ -0,0 +1,53 @@
+#ifndef EDGE_QUEUE_H
+#define EDGE_QUEUE_H
+
+#include <stdint.h>
+
+// 带时间戳的电平边沿
+struct Edge {
+    uint64_t atUs;
+    bool level;
+};
+
+// 单生产者（中断）单消费者（主循环）边沿队列，无锁
+//   head只由中断写，tail只由主循环写；满时丢弃新边沿并计数
+template <uint32_t Size>
+class EdgeQueue {
+public:
+    static_assert((Size & (Size - 1)) == 0, "边沿队列长度必须为2的幂");
+
+    EdgeQueue() : head(0), tail(0), overflows(0) {}
+
+    // 由中断调用，强制内联到中断处理函数中
+    inline __attribute__((always_inline)) bool push(uint64_t atUs, bool level) {
+        uint32_t h = head;
+        if (h - tail >= Size) {
+            overflows++;
+            return false;
+        }
+        edges[h & (Size - 1)] = {atUs, level};
+        __atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    bool pop(Edge& edge) {
+        uint32_t t = tail;
+        if (t == __atomic_load_n(&head, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        edge = edges[t & (Size - 1)];
+        tail = t + 1;
+        return true;
+    }
+
+    void clear() { tail = __atomic_load_n(&head, __ATOMIC_ACQUIRE); }
+    uint32_t dropped() const { return overflows; }
+
+private:
+    Edge edges[Size];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t overflows;
+};
+
+#endif // EDGE_QUEUE_H
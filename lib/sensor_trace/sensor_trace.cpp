@@ -0,0 +1,345 @@
+#include "sensor_trace.h"
+#include <string.h>
+#include "crc32.h"
+
+#define TRACE_VARINT_MAX_BYTES 10
+
+static uint8_t putVarint(uint8_t* out, uint64_t value) {
+    uint8_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool getVarint(const uint8_t* data, uint16_t length, uint16_t& offset, uint64_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 64 && offset < length; shift += 7) {
+        uint8_t byte = data[offset++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// TraceWriter
+
+TraceWriter::TraceWriter(uint8_t* ring, uint32_t ringSize)
+    : ring(ring), ringSize(ringSize), head(0), tail(0),
+      active(false), traceKind(TRACE_KIND_NONE), length(0), chunkType(0),
+      lastEdgeUs(0), chunksDropped(0), bytesWritten(0) {}
+
+void TraceWriter::start(TraceKind kind, uint32_t sampleRateHz, uint32_t debounceMs) {
+    head = tail = 0;
+    active = true;
+    traceKind = kind;
+    length = 0;
+    chunkType = 0;
+    lastEdgeUs = 0;
+    chunksDropped = 0;
+    bytesWritten = 0;
+
+    uint8_t header[12] = {TRACE_FORMAT_VERSION, (uint8_t)kind, 0, 0};
+    memcpy(header + 4, &sampleRateHz, 4);
+    memcpy(header + 8, &debounceMs, 4);
+    beginChunk(TRACE_CHUNK_HEADER);
+    put(header, sizeof(header));
+    commitChunk();
+}
+
+void TraceWriter::recordEdge(uint64_t atUs, bool level) {
+    if (!active) {
+        return;
+    }
+    if (chunkType != TRACE_CHUNK_EDGES || length + TRACE_VARINT_MAX_BYTES > TRACE_CHUNK_MAX_PAYLOAD) {
+        commitChunk();
+        beginChunk(TRACE_CHUNK_EDGES);
+        put(&atUs, 8);
+        lastEdgeUs = atUs;
+    }
+    uint64_t delta = atUs - lastEdgeUs;
+    length += putVarint(payload + length, (delta << 1) | (level ? 1 : 0));
+    lastEdgeUs = atUs;
+}
+
+void TraceWriter::recordSamples(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs) {
+    if (!active || count == 0) {
+        return;
+    }
+    commitChunk();
+
+    uint16_t period = (uint16_t)periodUs;
+    uint16_t i = 0;
+    while (i < count) {
+        uint64_t startUs = firstUs + (uint64_t)i * periodUs;
+        beginChunk(TRACE_CHUNK_SAMPLES);
+        put(&startUs, 8);
+        put(&period, 2);
+        uint16_t countOffset = length;
+        put(&i, 2);  // 数量占位，块结束时回填
+        put(&samples[i], 2);
+
+        uint16_t n = 1;
+        int32_t previous = samples[i];
+        // 12位采样的差值zigzag后至多2字节
+        while (i + n < count && length + 3 <= TRACE_CHUNK_MAX_PAYLOAD) {
+            int32_t delta = (int32_t)samples[i + n] - previous;
+            previous = samples[i + n];
+            uint32_t zigzag = (uint32_t)((delta << 1) ^ (delta >> 31));
+            length += putVarint(payload + length, zigzag);
+            n++;
+        }
+        memcpy(payload + countOffset, &n, 2);
+        commitChunk();
+        i += n;
+    }
+}
+
+void TraceWriter::flush() {
+    commitChunk();
+}
+
+void TraceWriter::stop(uint32_t droppedEdges) {
+    if (!active) {
+        return;
+    }
+    commitChunk();
+    uint8_t footer[12];
+    memcpy(footer, &droppedEdges, 4);
+    memcpy(footer + 4, &chunksDropped, 4);
+    memcpy(footer + 8, &bytesWritten, 4);
+    beginChunk(TRACE_CHUNK_END);
+    put(footer, sizeof(footer));
+    commitChunk();
+    active = false;
+}
+
+size_t TraceWriter::read(uint8_t* out, size_t maxLength) {
+    size_t n = 0;
+    while (n < maxLength && tail != head) {
+        out[n++] = ring[tail % ringSize];
+        tail++;
+    }
+    return n;
+}
+
+uint16_t TraceWriter::nextChunkBytes() const {
+    if (head == tail) {
+        return 0;
+    }
+    uint16_t payloadLength = ring[(tail + 4) % ringSize] | (ring[(tail + 5) % ringSize] << 8);
+    return TRACE_CHUNK_HEADER_BYTES + payloadLength + 4;
+}
+
+void TraceWriter::beginChunk(uint8_t type) {
+    chunkType = type;
+    length = 0;
+}
+
+void TraceWriter::put(const void* data, uint16_t size) {
+    memcpy(payload + length, data, size);
+    length += size;
+}
+
+void TraceWriter::commitChunk() {
+    if (chunkType == 0) {
+        return;
+    }
+    uint8_t header[TRACE_CHUNK_HEADER_BYTES] = {TRACE_SYNC_0, TRACE_SYNC_1, chunkType, 0,
+                                                (uint8_t)length, (uint8_t)(length >> 8)};
+    uint32_t crc = crc32Update(0, header + 2, TRACE_CHUNK_HEADER_BYTES - 2);
+    crc = crc32Update(crc, payload, length);
+    chunkType = 0;
+
+    uint32_t total = TRACE_CHUNK_HEADER_BYTES + length + 4;
+    if (ringSize - (head - tail) < total) {
+        chunksDropped++;
+        length = 0;
+        return;
+    }
+
+    const uint8_t* parts[3] = {header, payload, (const uint8_t*)&crc};
+    const uint16_t sizes[3] = {TRACE_CHUNK_HEADER_BYTES, length, 4};
+    for (int p = 0; p < 3; p++) {
+        for (uint16_t i = 0; i < sizes[p]; i++) {
+            ring[head % ringSize] = parts[p][i];
+            head++;
+        }
+    }
+    bytesWritten += total;
+    length = 0;
+}
+
+// ---------------------------------------------------------------------------
+// TraceParser
+
+TraceParser::TraceParser(const TraceCallbacks& callbacks)
+    : callbacks(callbacks), buffered(0), goodChunks(0), crcErrors(0), skipped(0) {}
+
+void TraceParser::drop(uint16_t count) {
+    memmove(buffer, buffer + count, buffered - count);
+    buffered -= count;
+}
+
+void TraceParser::feed(const uint8_t* data, size_t length) {
+    while (length > 0) {
+        size_t n = sizeof(buffer) - buffered;
+        if (n > length) {
+            n = length;
+        }
+        memcpy(buffer + buffered, data, n);
+        buffered += n;
+        data += n;
+        length -= n;
+
+        while (buffered > 0) {
+            // 对齐到同步字
+            if (buffer[0] != TRACE_SYNC_0 || (buffered > 1 && buffer[1] != TRACE_SYNC_1)) {
+                uint16_t next = 1;
+                while (next < buffered && buffer[next] != TRACE_SYNC_0) {
+                    next++;
+                }
+                skipped += next;
+                drop(next);
+                continue;
+            }
+            if (buffered < TRACE_CHUNK_HEADER_BYTES) {
+                break;
+            }
+
+            uint16_t payloadLength = buffer[4] | (buffer[5] << 8);
+            if (payloadLength > TRACE_CHUNK_MAX_PAYLOAD) {
+                skipped++;
+                drop(1);
+                continue;
+            }
+            uint16_t total = TRACE_CHUNK_HEADER_BYTES + payloadLength + 4;
+            if (buffered < total) {
+                break;
+            }
+
+            uint32_t crc;
+            memcpy(&crc, buffer + TRACE_CHUNK_HEADER_BYTES + payloadLength, 4);
+            if (crc != crc32Update(0, buffer + 2, TRACE_CHUNK_HEADER_BYTES - 2 + payloadLength) ||
+                !decode(buffer[2], buffer + TRACE_CHUNK_HEADER_BYTES, payloadLength)) {
+                // 同步字可能出现在文本或数据中，跳过一个字节继续寻找
+                crcErrors++;
+                skipped++;
+                drop(1);
+                continue;
+            }
+            goodChunks++;
+            drop(total);
+        }
+    }
+}
+
+bool TraceParser::decode(uint8_t type, const uint8_t* data, uint16_t length) {
+    switch (type) {
+        case TRACE_CHUNK_HEADER: {
+            if (length < 12) {
+                return false;
+            }
+            TraceHeader header;
+            header.version = data[0];
+            header.kind = data[1];
+            memcpy(&header.sampleRateHz, data + 4, 4);
+            memcpy(&header.debounceMs, data + 8, 4);
+            if (callbacks.onHeader) {
+                callbacks.onHeader(header, callbacks.context);
+            }
+            return true;
+        }
+        case TRACE_CHUNK_EDGES: {
+            if (length < 8) {
+                return false;
+            }
+            uint64_t atUs;
+            memcpy(&atUs, data, 8);
+            uint16_t offset = 8;
+            while (offset < length) {
+                uint64_t value;
+                if (!getVarint(data, length, offset, value)) {
+                    return false;
+                }
+                atUs += value >> 1;
+                if (callbacks.onEdge) {
+                    callbacks.onEdge(atUs, value & 1, callbacks.context);
+                }
+            }
+            return true;
+        }
+        case TRACE_CHUNK_SAMPLES: {
+            if (length < 14) {
+                return false;
+            }
+            uint64_t startUs;
+            uint16_t period, count;
+            uint16_t samples[TRACE_CHUNK_MAX_PAYLOAD];
+            memcpy(&startUs, data, 8);
+            memcpy(&period, data + 8, 2);
+            memcpy(&count, data + 10, 2);
+            memcpy(&samples[0], data + 12, 2);
+            if (count == 0 || count > TRACE_CHUNK_MAX_PAYLOAD) {
+                return false;
+            }
+            uint16_t offset = 14;
+            for (uint16_t i = 1; i < count; i++) {
+                uint64_t zigzag;
+                if (!getVarint(data, length, offset, zigzag)) {
+                    return false;
+                }
+                int32_t delta = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+                samples[i] = (uint16_t)(samples[i - 1] + delta);
+            }
+            if (callbacks.onSamples) {
+                callbacks.onSamples(samples, count, startUs, period, callbacks.context);
+            }
+            return offset == length;
+        }
+        case TRACE_CHUNK_END: {
+            if (length < 12) {
+                return false;
+            }
+            TraceFooter footer;
+            memcpy(&footer.droppedEdges, data, 4);
+            memcpy(&footer.droppedChunks, data + 4, 4);
+            memcpy(&footer.totalBytes, data + 8, 4);
+            if (callbacks.onEnd) {
+                callbacks.onEnd(footer, callbacks.context);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+TraceScore scoreHits(const uint64_t* detected, uint32_t detectedCount,
+                     const uint64_t* truth, uint32_t truthCount, uint32_t toleranceUs) {
+    TraceScore score = {detectedCount, 0, 0, 0};
+    uint32_t i = 0, j = 0;
+    while (i < detectedCount && j < truthCount) {
+        if (detected[i] + toleranceUs < truth[j]) {
+            score.falseHits++;
+            i++;
+        } else if (truth[j] + toleranceUs < detected[i]) {
+            score.missed++;
+            j++;
+        } else {
+            score.matched++;
+            i++;
+            j++;
+        }
+    }
+    score.falseHits += detectedCount - i;
+    score.missed += truthCount - j;
+    return score;
+}
@@ -0,0 +1,136 @@
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 传感器原始数据记录格式 (小端)，用于离线回放调整触发参数
+//   数据块 : 同步字 0xA5 0x5A | type u8 | reserved u8 | length u16 | payload | crc32 u32 (type..payload)
+//   串口输出中可与文本日志交错，解析时按同步字和CRC重新对齐
+//
+//   HEADER  : version u8 | kind u8 | reserved u16 | sampleRateHz u32 | debounceMs u32
+//   EDGES   : startUs u64 | 每个边沿 varint((距上一边沿的微秒 << 1) | 电平)，第一个边沿相对startUs
+//   SAMPLES : startUs u64 | periodUs u16 | count u16 | 首个采样 u16 | (count-1) 个 zigzag varint 差值
+//   END     : droppedEdges u32 | droppedChunks u32 | totalBytes u32
+#define TRACE_SYNC_0             0xA5
+#define TRACE_SYNC_1             0x5A
+#define TRACE_FORMAT_VERSION     1
+#define TRACE_CHUNK_HEADER_BYTES 6
+#define TRACE_CHUNK_MAX_PAYLOAD  240
+#define TRACE_CHUNK_MAX_BYTES    (TRACE_CHUNK_HEADER_BYTES + TRACE_CHUNK_MAX_PAYLOAD + 4)
+
+enum TraceChunkType {
+    TRACE_CHUNK_HEADER = 1,
+    TRACE_CHUNK_EDGES = 2,
+    TRACE_CHUNK_SAMPLES = 3,
+    TRACE_CHUNK_END = 4
+};
+
+enum TraceKind {
+    TRACE_KIND_NONE = 0,
+    TRACE_KIND_EDGES = 1,     // 开关量传感器的中断边沿
+    TRACE_KIND_SAMPLES = 2    // 模拟传感器的ADC采样
+};
+
+struct TraceHeader {
+    uint8_t version;
+    uint8_t kind;
+    uint32_t sampleRateHz;
+    uint32_t debounceMs;      // 记录时设备使用的防抖参数
+};
+
+struct TraceFooter {
+    uint32_t droppedEdges;
+    uint32_t droppedChunks;
+    uint32_t totalBytes;
+};
+
+// 记录器 - 在内存环形缓冲区中编码数据块，由主循环取出后写入串口
+//   缓冲区满时丢弃整块并计数，已输出的数据仍可完整解析
+class TraceWriter {
+public:
+    TraceWriter(uint8_t* ring, uint32_t ringSize);
+
+    void start(TraceKind kind, uint32_t sampleRateHz, uint32_t debounceMs);
+    void recordEdge(uint64_t atUs, bool level);
+    void recordSamples(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs);
+    // 提交未满的数据块（边沿稀疏时定期调用，降低输出延迟）
+    void flush();
+    void stop(uint32_t droppedEdges = 0);
+
+    // 取出待输出的字节，返回实际字节数
+    size_t read(uint8_t* out, size_t maxLength);
+    // 缓冲区中下一个完整数据块的字节数，为空时返回0（整块输出可避免与文本日志交错）
+    uint16_t nextChunkBytes() const;
+    uint32_t pendingBytes() const { return head - tail; }
+
+    bool isActive() const { return active; }
+    TraceKind kind() const { return traceKind; }
+    uint32_t droppedChunks() const { return chunksDropped; }
+    uint32_t totalBytes() const { return bytesWritten; }
+
+private:
+    uint8_t* ring;
+    uint32_t ringSize;
+    uint32_t head;
+    uint32_t tail;
+
+    bool active;
+    TraceKind traceKind;
+    uint8_t payload[TRACE_CHUNK_MAX_PAYLOAD];
+    uint16_t length;
+    uint8_t chunkType;
+    uint64_t lastEdgeUs;
+    uint32_t chunksDropped;
+    uint32_t bytesWritten;
+
+    void beginChunk(uint8_t type);
+    void commitChunk();
+    void put(const void* data, uint16_t size);
+};
+
+// 解析回调，未使用的可为nullptr
+struct TraceCallbacks {
+    void (*onHeader)(const TraceHeader& header, void* context);
+    void (*onEdge)(uint64_t atUs, bool level, void* context);
+    void (*onSamples)(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs, void* context);
+    void (*onEnd)(const TraceFooter& footer, void* context);
+    void* context;
+};
+
+// 流式解析器 - 可分段输入任意长度的数据，跳过非数据块字节
+class TraceParser {
+public:
+    explicit TraceParser(const TraceCallbacks& callbacks);
+
+    void feed(const uint8_t* data, size_t length);
+
+    uint32_t chunks() const { return goodChunks; }
+    uint32_t badChunks() const { return crcErrors; }
+    uint32_t skippedBytes() const { return skipped; }
+
+private:
+    TraceCallbacks callbacks;
+    uint8_t buffer[TRACE_CHUNK_MAX_BYTES];
+    uint16_t buffered;
+    uint32_t goodChunks;
+    uint32_t crcErrors;
+    uint32_t skipped;
+
+    void drop(uint16_t count);
+    bool decode(uint8_t type, const uint8_t* data, uint16_t length);
+};
+
+// 检测结果与人工标注对比（两个序列均须按时间升序）
+//   每个标注至多匹配一次容差内的检测，未匹配的检测为误触发，未匹配的标注为漏检
+struct TraceScore {
+    uint32_t detected;
+    uint32_t matched;
+    uint32_t falseHits;
+    uint32_t missed;
+};
+
+TraceScore scoreHits(const uint64_t* detected, uint32_t detectedCount,
+                     const uint64_t* truth, uint32_t truthCount, uint32_t toleranceUs);
+
+#endif // SENSOR_TRACE_H
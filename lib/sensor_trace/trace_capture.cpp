@@ -0,0 +1,122 @@
+#ifdef ARDUINO
+
+#include "trace_capture.h"
+#include <Arduino.h>
+#include <string.h>
+#include "clock.h"
+
+TraceCapture traceCapture;
+
+TraceCapture::TraceCapture()
+    : pin(0), kind(TRACE_KIND_NONE), sampleRateHz(0), debounceMs(0),
+      writer(ring, TRACE_RING_BYTES), droppedBase(0), lastFlushUs(0), commandLength(0),
+      commandHandler(nullptr) {}
+
+void TraceCapture::begin(uint8_t pin, TraceKind kind, uint32_t sampleRateHz, uint32_t debounceMs) {
+    this->pin = pin;
+    this->kind = kind;
+    this->sampleRateHz = sampleRateHz;
+    this->debounceMs = debounceMs;
+}
+
+bool TraceCapture::start() {
+    if (kind == TRACE_KIND_NONE) {
+        Serial.println("数据采集未配置传感器");
+        return false;
+    }
+    if (writer.isActive()) {
+        return true;
+    }
+
+    Serial.printf("开始采集传感器数据 (%s, 防抖%lums)\n",
+                  kind == TRACE_KIND_EDGES ? "边沿" : "采样", (unsigned long)debounceMs);
+    writer.start(kind, sampleRateHz, debounceMs);
+    lastFlushUs = Clock::nowUs();
+    if (kind == TRACE_KIND_EDGES) {
+        edges.clear();
+        droppedBase = edges.dropped();
+        // 先记录当前电平作为起点
+        writer.recordEdge(lastFlushUs, digitalRead(pin) == HIGH);
+        attachInterruptArg(digitalPinToInterrupt(pin), onEdgeISR, this, CHANGE);
+    }
+    return true;
+}
+
+void TraceCapture::stop() {
+    if (!writer.isActive()) {
+        return;
+    }
+    uint32_t dropped = 0;
+    if (kind == TRACE_KIND_EDGES) {
+        detachInterrupt(digitalPinToInterrupt(pin));
+        drainEdges();
+        dropped = edges.dropped() - droppedBase;
+    }
+    writer.stop(dropped);
+    Serial.printf("\n停止采集: %lu字节, 丢弃%lu个数据块, %lu个边沿\n",
+                  (unsigned long)writer.totalBytes(), (unsigned long)writer.droppedChunks(),
+                  (unsigned long)dropped);
+}
+
+void IRAM_ATTR TraceCapture::onEdgeISR(void* arg) {
+    TraceCapture* self = static_cast<TraceCapture*>(arg);
+    self->edges.push(Clock::nowUs(), digitalRead(self->pin) == HIGH);
+}
+
+void TraceCapture::service() {
+    readCommands();
+    if (writer.isActive()) {
+        drainEdges();
+        uint64_t now = Clock::nowUs();
+        if (now - lastFlushUs >= TRACE_FLUSH_INTERVAL_US) {
+            writer.flush();
+            lastFlushUs = now;
+        }
+    }
+    // 停止后继续输出剩余数据
+    if (writer.pendingBytes() > 0) {
+        output();
+    }
+}
+
+void TraceCapture::readCommands() {
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (c != '\n' && c != '\r') {
+            if (commandLength < TRACE_COMMAND_MAX - 1) {
+                command[commandLength++] = c;
+            }
+            continue;
+        }
+        command[commandLength] = '\0';
+        if (strcmp(command, "trace start") == 0) {
+            start();
+        } else if (strcmp(command, "trace stop") == 0) {
+            stop();
+        } else if (commandHandler && commandLength > 0) {
+            commandHandler(command);
+        }
+        commandLength = 0;
+    }
+}
+
+void TraceCapture::drainEdges() {
+    Edge edge;
+    while (edges.pop(edge)) {
+        writer.recordEdge(edge.atUs, edge.level);
+    }
+}
+
+void TraceCapture::output() {
+    uint16_t length;
+    while ((length = writer.nextChunkBytes()) > 0) {
+        // 平时不阻塞主循环；缓冲区过半时等待串口发送，避免丢块
+        if (Serial.availableForWrite() < length && writer.pendingBytes() < TRACE_RING_BYTES / 2) {
+            break;
+        }
+        writer.read(chunk, length);
+        Serial.write(chunk, length);
+    }
+}
+
+#endif // ARDUINO
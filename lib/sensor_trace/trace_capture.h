@@ -0,0 +1,68 @@
+#ifndef TRACE_CAPTURE_H
+#define TRACE_CAPTURE_H
+
+#include <stdint.h>
+#include "edge_queue.h"
+#include "sensor_trace.h"
+
+#define TRACE_RING_BYTES        16384
+#define TRACE_EDGE_QUEUE_SIZE   64
+#define TRACE_FLUSH_INTERVAL_US 100000ULL   // 边沿稀疏时最长100ms输出一次
+#define TRACE_COMMAND_MAX       48
+
+// 其他模块的串口命令，trace命令之外的整行交给它处理
+typedef void (*SerialCommandHandler)(const char* command);
+
+// 传感器数据采集 - 串口输入 "trace start" / "trace stop" 控制
+//   开关量传感器：在同一引脚上另挂CHANGE中断记录每个边沿的微秒时间戳，不影响正常检测
+//   模拟传感器：由AdcImpactInput在每帧处理时送入原始采样
+//   数据块写入内存环形缓冲区，主循环在串口发送缓冲区放得下时整块输出，与文本日志交错而不被打断
+//   8kHz采样约需10KB/s，115200波特率下会丢块（结束块中有计数），建议使用USB CDC串口
+class TraceCapture {
+public:
+    TraceCapture();
+
+    // 登记传感器参数，未调用时串口命令无效
+    void begin(uint8_t pin, TraceKind kind, uint32_t sampleRateHz, uint32_t debounceMs);
+
+    bool start();
+    void stop();
+    bool isActive() const { return writer.isActive(); }
+
+    // 模拟传感器每帧调用
+    void recordSamples(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs) {
+        if (writer.isActive()) {
+            writer.recordSamples(samples, count, firstUs, periodUs);
+        }
+    }
+
+    // 主循环调用：处理串口命令、取出边沿、输出数据
+    void service();
+    void setCommandHandler(SerialCommandHandler handler) { commandHandler = handler; }
+
+private:
+    uint8_t pin;
+    TraceKind kind;
+    uint32_t sampleRateHz;
+    uint32_t debounceMs;
+
+    uint8_t ring[TRACE_RING_BYTES];
+    uint8_t chunk[TRACE_CHUNK_MAX_BYTES];
+    TraceWriter writer;
+    EdgeQueue<TRACE_EDGE_QUEUE_SIZE> edges;
+    uint32_t droppedBase;
+    uint64_t lastFlushUs;
+
+    char command[TRACE_COMMAND_MAX];
+    uint8_t commandLength;
+    SerialCommandHandler commandHandler;
+
+    static void onEdgeISR(void* arg);
+    void readCommands();
+    void drainEdges();
+    void output();
+};
+
+extern TraceCapture traceCapture;
+
+#endif // TRACE_CAPTURE_H
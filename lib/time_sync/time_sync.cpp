@@ -0,0 +1,32 @@
+#include "time_sync.h"
+
+WallClockSync::WallClockSync()
+    : offsetUs(0), lastError(0), remoteUtcOffset(0), count(0), lastSequence(0), synced(false) {}
+
+TimeSyncResult WallClockSync::apply(const TimeSyncMessage& message, int64_t localUs) {
+    // ESP-NOW重传可能导致同一消息到达两次
+    if (synced && message.sequence == lastSequence && !(message.flags & TIME_SYNC_FLAG_SET)) {
+        return TIME_SYNC_DUPLICATE;
+    }
+    lastSequence = message.sequence;
+    remoteUtcOffset = message.utcOffset;
+    count++;
+
+    int64_t remoteUs = (int64_t)message.epochSeconds * 1000000 + message.microseconds + TIME_SYNC_LATENCY_US;
+    int64_t targetOffset = remoteUs - localUs;
+    lastError = synced ? targetOffset - offsetUs : 0;
+
+    if (!synced || (message.flags & TIME_SYNC_FLAG_SET) ||
+        lastError > TIME_SYNC_STEP_THRESHOLD_US || lastError < -TIME_SYNC_STEP_THRESHOLD_US) {
+        offsetUs = targetOffset;
+        synced = true;
+        return TIME_SYNC_STEPPED;
+    }
+
+    offsetUs += lastError / TIME_SYNC_SLEW_DIVISOR;
+    return TIME_SYNC_SLEWED;
+}
+
+int64_t WallClockSync::epochMicros(int64_t localUs) const {
+    return synced ? localUs + offsetUs : 0;
+}
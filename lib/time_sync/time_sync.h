@@ -0,0 +1,54 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdint.h>
+
+// 主机授时 - 主机广播墙钟时间，从机以本地单调时钟为基准维护偏移
+//   偏移较小时按比例逐步修正（抑制空口延迟抖动），偏移过大或用户手动设置时直接跳变
+
+#define TIME_SYNC_FLAG_SET          0x01    // 用户手动设置的时间，接收方立即跳变
+#define TIME_SYNC_LATENCY_US        500     // 估计的发送到接收回调的延迟
+#define TIME_SYNC_STEP_THRESHOLD_US 20000   // 超过该误差直接跳变
+#define TIME_SYNC_SLEW_DIVISOR      4       // 小误差每次修正1/4
+
+// 授时消息，与message_t共用首字节命令号
+struct TimeSyncMessage {
+    uint8_t command;
+    uint8_t flags;
+    uint16_t sequence;
+    uint32_t epochSeconds;
+    uint32_t microseconds;   // 秒内偏移
+    int32_t utcOffset;       // 主机时区偏移（秒）
+};
+
+enum TimeSyncResult {
+    TIME_SYNC_STEPPED,
+    TIME_SYNC_SLEWED,
+    TIME_SYNC_DUPLICATE
+};
+
+class WallClockSync {
+public:
+    WallClockSync();
+
+    // 处理一条授时消息；localUs为收到消息时的本地单调时间
+    TimeSyncResult apply(const TimeSyncMessage& message, int64_t localUs);
+
+    bool valid() const { return synced; }
+    // 本地单调时间对应的Unix时间（微秒），未同步时返回0
+    int64_t epochMicros(int64_t localUs) const;
+    // 最近一次消息到达时的误差（修正前）
+    int64_t lastErrorUs() const { return lastError; }
+    int32_t utcOffset() const { return remoteUtcOffset; }
+    uint32_t syncCount() const { return count; }
+
+private:
+    int64_t offsetUs;        // Unix时间 - 本地单调时间
+    int64_t lastError;
+    int32_t remoteUtcOffset;
+    uint32_t count;
+    uint16_t lastSequence;
+    bool synced;
+};
+
+#endif // TIME_SYNC_H
@@ -11,9 +11,23 @@
 // LED配置
 #define LED_COUNT               12    // LED数量
 #define LED_BRIGHTNESS          50    // LED亮度 (0-255)
+#define LED_GAMMA_ENABLED       true  // 输出前做伽马校正
+#define LED_CURRENT_BUDGET_MA   300   // 灯带电流上限，超出时整帧按比例压暗（0为不限）
+
+// 电池检测配置 - 电池经100k/100k分压接ADC1
+#define BATTERY_ADC_PIN         3     // 电池分压检测引脚 (GPIO3)
+#define BATTERY_DIVIDER_X100    200   // 分压比×100
+#define BATTERY_INTERNAL_MOHM   150   // 电池内阻+保护板+走线 (mΩ)
+#define BATTERY_CAPACITY_MAH    1000  // 电池容量
+#define BATTERY_SAMPLE_INTERVAL_MS 10000  // 采样间隔
+#define BATTERY_OVERSAMPLE      16    // 每次采样的ADC读数
+#define BATTERY_BASE_LOAD_MA    85    // 除LED外的平均电流（芯片+无线）
+#define ENERGY_SAMPLE_INTERVAL_MS 100   // 能耗估算的采样间隔（LED/OLED状态、发射计数）
 
 // 震动传感器配置
-#define VIBRATION_SENSOR_TYPE   0     // 0=常闭开关量传感器，1=数值传感器
+#ifndef VIBRATION_SENSOR_TYPE
+#define VIBRATION_SENSOR_TYPE   0     // 0=常闭开关量传感器，1=模拟冲击传感器（连续ADC采样）
+#endif
 #define VIBRATION_DEBOUNCE_MS   200   // 震动防抖时间 (开关量传感器需要更长防抖)
 
 // 计时配置
@@ -21,10 +35,13 @@
 #define TIMING_TIMEOUT_MS       30000 // 超时时间
 
 // ESP-NOW配置
-#define ESPNOW_CHANNEL          1     // ESP-NOW信道
+#define ESPNOW_CHANNEL          1     // 约定信道：开机及失联后在此会合，主机会话开始时可换到更空闲的信道
 #define ESPNOW_ENCRYPT          false // 是否加密
 #define DEVICE_A_MAC            {0x50, 0x78, 0x7d, 0x46, 0xd4, 0x80}  // 主机设备 COM8
 #define DEVICE_B_MAC            {0x50, 0x78, 0x7d, 0x46, 0xcc, 0x90}  // 从机设备 COM3
+#ifndef CONE_ID
+#define CONE_ID                 1     // 组命令中的锥桶号（主机0，从机从1起编号）
+#endif
 
 // 声音配置
 #define BEEP_FREQUENCY          2000  // 蜂鸣器频率
@@ -52,8 +69,8 @@ typedef struct {
     uint8_t command;
     uint8_t target_id;
     uint8_t source_id;
-    uint32_t timestamp;
-    uint32_t data;
+    uint32_t timestamp;    // 发送方Clock::stamp32()，单调时钟低32位（微秒）
+    uint32_t data;         // 用时类数据单位为0.1ms (CLOCK_TICK_US)
     uint8_t checksum;
 } message_t;
 
@@ -73,6 +90,20 @@ enum CommandType {
     CMD_VT_START_ROUND = 0x20,    // 主机发送：开始单次计时
     CMD_VT_ROUND_COMPLETE = 0x21, // 从机发送：单次完成
     CMD_VT_TRAINING_EXIT = 0x22,  // 退出训练
+    // 授时
+    CMD_TIME_SYNC = 0x30,         // 主机广播：墙钟时间 (TimeSyncMessage)
+    CMD_TIME_REQUEST = 0x31,      // 从机发送：请求立即授时
+    // 组命令
+    CMD_GROUP_COMMAND = 0x40,     // 主机广播：多锥桶灯光/布防 (group_command.h)
+    CMD_GROUP_REPORT = 0x41,      // 锥桶发送：组命令执行时刻偏差
+    CMD_LED_BRIGHTNESS = 0x42,    // 主机发送：LED亮度设置，data为0-100
+    CMD_DUTY_BEACON = 0x43,       // 主机广播：无线占空信标 (duty_cycle.h)
+    CMD_DUTY_ACK = 0x44,          // 锥桶发送：当前占空模式
+    // 信道管理
+    CMD_LINK_PING = 0x50,         // 往返探测，data为序号
+    CMD_LINK_PONG = 0x51,         // 探测回应，原样带回序号
+    CMD_CHANNEL_SWITCH = 0x52,    // 主机广播：换信道，data低8位为信道，高位为距切换的毫秒数
+    CMD_CHANNEL_SWITCH_ACK = 0x53, // 锥桶应答换信道
     CMD_ERROR = 0xFF
 };
 
@@ -2,14 +2,29 @@
 #define HARDWARE_H
 
 #include <Arduino.h>
-#include <FastLED.h>
 #include "config.h"
+#include "hal_arduino.h"
+#include "battery_gauge.h"
+#include "energy_account.h"
+
+// 硬件组件 - 与主机共用HAL，引脚和LED数量在编译期绑定
+typedef FastLedStrip<LED_PIN, LED_COUNT> StatusLeds;
+typedef ToneBuzzer<BUZZER_PIN> Beeper;
+#if VIBRATION_SENSOR_TYPE == 1
+#include "hal_adc_impact.h"
+typedef AdcImpactInput<VIBRATION_SENSOR_PIN, VIBRATION_DEBOUNCE_MS> ImpactSensor;
+#else
+typedef GpioTriggerInput<VIBRATION_SENSOR_PIN, VIBRATION_DEBOUNCE_MS> ImpactSensor;
+#endif
 
 // 从机硬件管理类 - 仅包含必要的硬件组件
 class SlaveHardwareManager {
 public:
     SlaveHardwareManager();
     bool init();
+    // 分阶段启动：传感器与蜂鸣器引脚 -> LED灯带
+    bool initCore();
+    bool initLEDs();
     void update();
     
     // LED控制
@@ -17,6 +32,8 @@ public:
     void setAllLEDs(uint32_t color);
     void clearLEDs();
     void showLEDs();
+    // 亮度0-100%，跟随主机设置并保存在NVS，下次开机沿用
+    void setLedBrightness(uint8_t percent);
     void ledBreathingEffect(uint32_t color);
     void ledProgressBar(int progress, uint32_t color);
     void ledAlertEffect();
@@ -24,6 +41,16 @@ public:
     // 震动传感器
     bool isVibrationDetected();
     int getVibrationStrength();
+    // 最近一次触发的时刻（模拟传感器为越过阈值的采样时刻）
+    uint64_t lastImpactUs() const { return sensor.lastTriggerMicros(); }
+    
+    // 电池
+    int batteryPercent() const;         // 尚未采样时为BATTERY_UNKNOWN
+    const BatteryGauge& batteryGauge() const { return battery; }
+    // 剩余可用电量：有测量时按电量，否则按容量减去本会话估算耗电
+    uint32_t remainingMah() const;
+    // 把LED和蜂鸣器的当前状态计入能耗估算
+    void sampleEnergy(EnergyAccount& account, uint64_t nowUs);
     
     // 蜂鸣器
     void beep(int frequency = BEEP_FREQUENCY, int duration = BEEP_DURATION);
@@ -38,11 +65,18 @@ public:
     void indicateVibrationDetected();
     
 private:
-    CRGB leds[LED_COUNT];
+    StatusLeds leds;
+    Beeper buzzer;
+    ImpactSensor sensor;
     unsigned long lastVibrationTime;
     unsigned long lastLEDUpdate;
+    BatteryGauge battery;
+    uint64_t lastBatterySampleUs;
+    uint32_t lastBuzzerMs;
+    uint8_t ledBrightnessPercent;
     
     void updateVibration();
+    void updateBattery();
     void updateLEDEffects();
 };
 
@@ -1,102 +1,114 @@
 #include "hardware.h"
+#include <Preferences.h>
+#include "clock.h"
+#include "trace_capture.h"
+
+#define LED_NVS_NAMESPACE   "slave"
+#define LED_NVS_KEY         "led_bright"
 
 // 全局从机硬件管理类对象
 SlaveHardwareManager slaveHardware;
 
 SlaveHardwareManager::SlaveHardwareManager() 
-    : lastVibrationTime(0), lastLEDUpdate(0) {}
+    : lastVibrationTime(0), lastLEDUpdate(0),
+      battery(BatteryConfig{BATTERY_DIVIDER_X100, BATTERY_INTERNAL_MOHM, BATTERY_CAPACITY_MAH}),
+      lastBatterySampleUs(0), lastBuzzerMs(0), ledBrightnessPercent(LED_BRIGHTNESS * 100 / 255) {}
 
 bool SlaveHardwareManager::init() {
     Serial.println("从机硬件初始化开始...");
-    
+    if (!initCore() || !initLEDs()) {
+        return false;
+    }
+    Serial.println("从机硬件初始化完成");
+    return true;
+}
+
+bool SlaveHardwareManager::initCore() {
     // 初始化震动传感器引脚 (常闭开关量传感器，使用内部上拉电阻)
-    pinMode(VIBRATION_SENSOR_PIN, INPUT_PULLUP);
-    Serial.println("震动传感器引脚初始化完成（常闭开关量传感器）");
+    if (!sensor.begin()) {
+        Serial.println("震动传感器初始化失败");
+        return false;
+    }
+    Serial.println("震动传感器初始化完成");
+#if VIBRATION_SENSOR_TYPE == 1
+    traceCapture.begin(VIBRATION_SENSOR_PIN, TRACE_KIND_SAMPLES, ImpactSensor::sampleRateHz, VIBRATION_DEBOUNCE_MS);
+#else
+    traceCapture.begin(VIBRATION_SENSOR_PIN, TRACE_KIND_EDGES, 0, VIBRATION_DEBOUNCE_MS);
+#endif
     
     // 初始化蜂鸣器引脚
-    pinMode(BUZZER_PIN, OUTPUT);
+    buzzer.begin();
     Serial.println("蜂鸣器引脚初始化完成");
+    return true;
+}
+
+bool SlaveHardwareManager::initLEDs() {
+    // 亮度沿用上次主机下发的设置
+    Preferences prefs;
+    if (prefs.begin(LED_NVS_NAMESPACE, true)) {
+        ledBrightnessPercent = prefs.getUChar(LED_NVS_KEY, ledBrightnessPercent);
+        prefs.end();
+    }
     
-    // 初始化LED
-    FastLED.addLeds<NEOPIXEL, LED_PIN>(leds, LED_COUNT);
-    FastLED.setBrightness(LED_BRIGHTNESS);
-    setAllLEDs(COLOR_BLACK);
-    showLEDs();
+    // 初始化LED（启动指示由调用方在就绪后给出，这里不再阻塞等待）；输出级做伽马校正并限制整条灯带电流
+    leds.setGamma(LED_GAMMA_ENABLED);
+    leds.setCurrentBudget(LED_CURRENT_BUDGET_MA);
+    leds.begin((ledBrightnessPercent * 255) / 100);
     Serial.println("LED灯带初始化完成");
-    
-    // 初始化完成指示
-    playStartSound();
-    setAllLEDs(COLOR_BLUE);
-    showLEDs();
-    delay(500);
-    clearLEDs();
-    showLEDs();
-    
-    Serial.println("从机硬件初始化完成");
     return true;
 }
 
 void SlaveHardwareManager::update() {
     updateVibration();
+    traceCapture.service();
     updateLEDEffects();
+    updateBattery();
 }
 
 // LED控制函数
 void SlaveHardwareManager::setLED(int index, uint32_t color) {
-    if (index >= 0 && index < LED_COUNT) {
-        leds[index] = CRGB(color);
-    }
+    leds.set(index, color);
 }
 
 void SlaveHardwareManager::setAllLEDs(uint32_t color) {
-    for (int i = 0; i < LED_COUNT; i++) {
-        leds[i] = CRGB(color);
-    }
+    leds.fill(color);
 }
 
 void SlaveHardwareManager::clearLEDs() {
-    setAllLEDs(COLOR_BLACK);
+    leds.clear();
 }
 
 void SlaveHardwareManager::showLEDs() {
-    FastLED.show();
+    leds.show();
 }
 
-void SlaveHardwareManager::ledBreathingEffect(uint32_t color) {
-    static unsigned long lastUpdate = 0;
-    static int brightness = 0;
-    static int direction = 1;
+void SlaveHardwareManager::setLedBrightness(uint8_t percent) {
+    if (percent > 100) {
+        percent = 100;
+    }
+    if (percent == ledBrightnessPercent) {
+        return;
+    }
+    ledBrightnessPercent = percent;
+    leds.setBrightness((percent * 255) / 100);
+    leds.show();
     
-    if (millis() - lastUpdate > 50) {
-        brightness += direction * 5;
-        if (brightness >= 255 || brightness <= 0) {
-            direction *= -1;
-        }
-        
-        // 应用呼吸效果
-        uint8_t r = (color >> 16) & 0xFF;
-        uint8_t g = (color >> 8) & 0xFF;
-        uint8_t b = color & 0xFF;
-        
-        r = (r * brightness) / 255;
-        g = (g * brightness) / 255;
-        b = (b * brightness) / 255;
-        
-        uint32_t breathColor = (r << 16) | (g << 8) | b;
-        setAllLEDs(breathColor);
-        showLEDs();
-        
-        lastUpdate = millis();
+    Preferences prefs;
+    if (!prefs.begin(LED_NVS_NAMESPACE, false)) {
+        Serial.println("LED亮度: 打开NVS失败");
+        return;
     }
+    prefs.putUChar(LED_NVS_KEY, percent);
+    prefs.end();
+    Serial.printf("LED亮度: %u%%\n", percent);
+}
+
+void SlaveHardwareManager::ledBreathingEffect(uint32_t color) {
+    leds.breathe(color, Clock::nowUs());
 }
 
 void SlaveHardwareManager::ledProgressBar(int progress, uint32_t color) {
-    clearLEDs();
-    int ledsToLight = (progress * LED_COUNT) / 100;
-    for (int i = 0; i < ledsToLight && i < LED_COUNT; i++) {
-        setLED(i, color);
-    }
-    showLEDs();
+    leds.progress(progress, color);
 }
 
 void SlaveHardwareManager::ledAlertEffect() {
@@ -112,80 +124,64 @@ void SlaveHardwareManager::ledAlertEffect() {
 
 // 震动传感器函数
 bool SlaveHardwareManager::isVibrationDetected() {
-    static bool lastState = HIGH;  // 常闭传感器正常状态为HIGH
-    static unsigned long lastTriggerTime = 0;
+    uint64_t now = Clock::nowUs();
+    uint32_t rejected = sensor.rejectedEdges();
+    bool lastState = sensor.previousLevel();
+    bool triggered = sensor.poll(now);
     
-    // 读取数字量状态
-    bool currentState = digitalRead(VIBRATION_SENSOR_PIN);
-    
-    // 每次都输出当前状态用于调试
-    static unsigned long lastDebugTime = 0;
-    if (millis() - lastDebugTime > 100) {  // 每100ms输出一次状态变化
+    // 每100ms输出一次状态用于调试
+    static uint64_t lastDebugTime = 0;
+    if (now - lastDebugTime > 100000ULL) {
         Serial.printf("震动检测调试: lastState=%s, currentState=%s\n", 
-                     lastState ? "HIGH" : "LOW", currentState ? "HIGH" : "LOW");
-        lastDebugTime = millis();
+                     lastState ? "HIGH" : "LOW", sensor.previousLevel() ? "HIGH" : "LOW");
+        lastDebugTime = now;
     }
     
-    // 检测从HIGH到LOW的下降沿（震动触发）
-    if (lastState == HIGH && currentState == LOW) {
-        Serial.printf("检测到边沿变化: HIGH->LOW, 防抖检查中...\n");
-        
-        // 防抖检查
-        if (millis() - lastTriggerTime > VIBRATION_DEBOUNCE_MS) {
-            lastTriggerTime = millis();
-            lastState = currentState;
-            
-            Serial.printf("*** 从机震动检测到! 传感器状态: HIGH->LOW ***\n");
-            
-            // 震动检测视觉反馈
-            indicateVibrationDetected();
-            
-            return true;
-        } else {
-            Serial.printf("防抖未通过: 距离上次触发仅 %lu ms\n", millis() - lastTriggerTime);
-        }
+    if (sensor.rejectedEdges() != rejected) {
+        Serial.printf("防抖未通过: 距离上次触发仅 %lu ms\n",
+                     (unsigned long)((now - sensor.lastTriggerMicros()) / 1000));
+    }
+    if (!triggered) {
+        return false;
     }
     
-    lastState = currentState;
-    return false;
+    Serial.printf("*** 从机震动检测到! 传感器状态: HIGH->LOW ***\n");
+    
+    // 震动检测视觉反馈
+    indicateVibrationDetected();
+    
+    return true;
 }
 
 int SlaveHardwareManager::getVibrationStrength() {
+#if VIBRATION_SENSOR_TYPE == 1
+    // 模拟传感器返回最近一次冲击的力度 (0-100)
+    return sensor.strength();
+#else
     // 对于开关量传感器，返回数字状态 (HIGH=1, LOW=0)
-    return digitalRead(VIBRATION_SENSOR_PIN) ? 1 : 0;
+    return sensor.level() ? 1 : 0;
+#endif
 }
 
-// 蜂鸣器函数
+// 蜂鸣器函数（提示音与主机共用）
 void SlaveHardwareManager::beep(int frequency, int duration) {
-    tone(BUZZER_PIN, frequency, duration);
+    buzzer.beep(frequency, duration);
 }
 
 void SlaveHardwareManager::playStartSound() {
-    beep(1000, 200);
-    delay(250);
-    beep(1200, 200);
+    buzzer.play(TUNE_START);
 }
 
 void SlaveHardwareManager::playCompleteSound() {
-    beep(1500, 300);
-    delay(100);
-    beep(1800, 200);
-    delay(100);
-    beep(2000, 300);
+    buzzer.play(TUNE_COMPLETE);
 }
 
 void SlaveHardwareManager::playErrorSound() {
-    beep(500, 500);
-    delay(100);
-    beep(400, 500);
+    buzzer.play(TUNE_ERROR);
 }
 
 void SlaveHardwareManager::playConnectedSound() {
-    beep(800, 100);
-    delay(150);
-    beep(1000, 100);
-    delay(150);
-    beep(1200, 200);
+    buzzer.play(TUNE_CONNECTED);
 }
 
 // 状态指示函数
@@ -250,10 +246,8 @@ void SlaveHardwareManager::indicateVibrationDetected() {
     setAllLEDs(COLOR_BLUE);
     showLEDs();
     
-    // 震动检测成功音效
-    beep(2000, 150);  // 更长的提示音
-    delay(100);
-    beep(2500, 100);  // 双音提示
+    // 震动检测成功音效（双音提示）
+    buzzer.play(TUNE_TRIGGER);
     
     Serial.println("震动检测指示完成");
 }
@@ -267,7 +261,7 @@ void SlaveHardwareManager::updateVibration() {
     if (millis() - lastStatusCheck >= 500) {
         lastStatusCheck = millis();
         
-        bool sensorState = digitalRead(VIBRATION_SENSOR_PIN);
+        bool sensorState = sensor.level();
         Serial.printf("震动传感器状态: %s (常闭传感器: HIGH=正常, LOW=震动)\n", 
                      sensorState ? "HIGH" : "LOW");
     }
@@ -276,4 +270,47 @@ void SlaveHardwareManager::updateVibration() {
 void SlaveHardwareManager::updateLEDEffects() {
     // 这里可以添加LED效果的更新逻辑
     // 例如呼吸效果、流水灯效果等
-}
\ No newline at end of file
+}
+
+void SlaveHardwareManager::updateBattery() {
+#if VIBRATION_SENSOR_TYPE == 1
+    // 模拟冲击传感器以连续模式占用ADC1，不能穿插单次读取
+    return;
+#else
+    if (battery.valid() && !Clock::hasElapsed(lastBatterySampleUs, BATTERY_SAMPLE_INTERVAL_MS * 1000ULL)) {
+        return;
+    }
+    lastBatterySampleUs = Clock::nowUs();
+    
+    // 负载按采样时刻的LED显示内容估算，用于补偿内阻压降
+    uint16_t loadMa = BATTERY_BASE_LOAD_MA + leds.drawMilliamps();
+    int previous = batteryPercent();
+    battery.addSample(batteryReadPinMv(BATTERY_ADC_PIN, BATTERY_OVERSAMPLE), loadMa);
+    if (battery.percent() != previous) {
+        uint32_t minutes = battery.remainingMinutes();
+        Serial.printf("电池: %u mV, %u%%, 平均负载 %u mA, 预计剩余 %lu小时%lu分\n",
+                     battery.cellMv(), battery.percent(), battery.averageLoadMa(),
+                     (unsigned long)(minutes / 60), (unsigned long)(minutes % 60));
+    }
+#endif
+}
+
+int SlaveHardwareManager::batteryPercent() const {
+    return battery.valid() ? battery.percent() : BATTERY_UNKNOWN;
+}
+
+uint32_t SlaveHardwareManager::remainingMah() const {
+    int percent = batteryPercent();
+    if (percent != BATTERY_UNKNOWN) {
+        return (uint32_t)percent * BATTERY_CAPACITY_MAH / 100;
+    }
+    uint32_t usedMah = energyAccount.totalMicroAmpHours() / 1000;
+    return usedMah < BATTERY_CAPACITY_MAH ? BATTERY_CAPACITY_MAH - usedMah : 0;
+}
+
+void SlaveHardwareManager::sampleEnergy(EnergyAccount& account, uint64_t nowUs) {
+    account.setLeds(nowUs, StatusLeds::count, leds.outputChannelTotal(), 255);
+    uint32_t played = buzzer.playedMs();
+    account.addBuzzer(played - lastBuzzerMs);
+    lastBuzzerMs = played;
+}
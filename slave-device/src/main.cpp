@@ -1,8 +1,23 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <esp_now.h>
+#include <esp_wifi.h>
 #include "config.h"
 #include "hardware.h"
+#include "boot_profile.h"
+#include "time_sync.h"
+#include "clock.h"
+#include "tx_scheduler.h"
+#include "espnow_transport.h"
+#include "group_command.h"
+#include "peer_cache.h"
+#include "peer_discovery.h"
+#include "channel_plan.h"
+#include "duty_cycle.h"
+#include "trace_capture.h"
+#include "cpu_governor.h"
+#include <sys/time.h>
+#include <esp_timer.h>
 
 // 全局变量
 SlaveState currentState = SLAVE_INIT;
@@ -10,18 +25,33 @@ DeviceRole deviceRole = ROLE_SLAVE;
 uint8_t peerAddress[6];
 bool systemInitialized = false;
 
+// 无线发送调度，所有消息经优先级队列发出；发射功率按对端回报的接收强度闭环调整
+TxPowerController txPower;
+volatile int8_t lastPeerRssi = 0;      // 最近一次收到对端帧的RSSI，随心跳/应答回报给对端
+EspNowTransport espNowTransport(&txPower);
+TxScheduler radioTx(espNowTransport);
+
 // 连接状态监控变量
 ConnectionStatus connectionStatus = CONN_DISCONNECTED;
-unsigned long lastHeartbeatSent = 0;
-unsigned long lastHeartbeatReceived = 0;
-unsigned long lastConnectionCheck = 0;
+// 时间均为Clock微秒；接收时刻在ESP-NOW回调中写入，用32位时间戳保证读写原子
+uint64_t lastHeartbeatSent = 0;
+volatile uint32_t lastHeartbeatReceived = 0;
+uint64_t lastConnectionCheck = 0;
 uint8_t connectionRetryCount = 0;
 bool waitingForHeartbeatAck = false;
 
+// 主机授时的墙钟
+WallClockSync wallClock;
+
 // 训练相关变量
-unsigned long trainingStartTime = 0;
+uint64_t trainingStartUs = 0;     // Clock微秒
 bool trainingActive = false;
 
+// 组命令：ESP-NOW回调只拷贝帧，主循环换算执行时刻并按时执行
+GroupCommandReceiver groupReceiver(CONE_ID);
+uint8_t groupFrame[GROUP_FRAME_MAX_BYTES];
+volatile uint8_t groupFrameLength = 0;
+
 // 设备配对变量
 PairingStatus pairingStatus = PAIRING_IDLE;
 DiscoveredDevice discoveredDevices[MAX_DISCOVERED_DEVICES];
@@ -29,6 +59,29 @@ uint8_t discoveredDeviceCount = 0;
 unsigned long pairingStartTime = 0;
 bool pairingModeActive = false;
 
+// 已知对端缓存与开机快速重连；配对确认在回调中只记入缓存，主循环写NVS
+PeerCache peerCache;
+ProbeSchedule reconnectProbe;
+volatile bool peerCacheDirty = false;
+
+// 信道：按主机通知的时刻切换，失联后回约定信道；通知在回调中写入，主循环排定
+uint8_t radioChannel = ESPNOW_CHANNEL;
+ChannelFollower channelFollower(ESPNOW_CHANNEL);
+volatile uint8_t channelSwitchTarget = 0;
+volatile uint16_t channelSwitchDelayMs = 0;
+volatile uint32_t channelSwitchStamp = 0;
+
+// LED亮度：主机下发的设置在回调中暂存，主循环应用并写NVS
+#define LED_BRIGHTNESS_NONE 0xFF
+volatile uint8_t pendingLedBrightness = LED_BRIGHTNESS_NONE;
+
+// 无线占空：空闲时只在主机信标排定的窗口打开接收；信标在回调中暂存，主循环对齐
+DutyCycleFollower dutyCycle;
+volatile bool dutyBeaconPending = false;
+volatile uint32_t dutyBeaconData = 0;
+volatile uint32_t dutyBeaconStamp = 0;
+bool radioListening = true;
+
 // 前向声明
 void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int len);
 void onDataSent(const uint8_t* mac, esp_now_send_status_t status);
@@ -40,49 +93,84 @@ void updateSystem();
 void updateConnectionStatus();
 void sendHeartbeat();
 void handleHeartbeat(const message_t& message);
+
+// 授时函数
+void sendTimeRequest();
+void handleTimeSync(const TimeSyncMessage& message, int64_t receivedUs);
 void checkConnectionTimeout();
 void setConnectionStatus(ConnectionStatus status);
 const char* getConnectionStatusString(ConnectionStatus status);
+void probeKnownPeer();
+void adoptKnownPeer(const uint8_t* mac);
+
+// 能耗估算函数
+void serviceEnergy();
+void onSerialCommand(const char* command);
+CpuDemand currentCpuDemand();
+
+// 信道函数
+void setRadioChannel(uint8_t channel);
+void serviceChannel();
+void replyToMaster(uint8_t command, uint32_t data);
+
+// 无线占空函数
+void serviceDutyCycle();
+void setRadioListening(bool on);
 
 // 训练处理函数
 void handleTrainingStart();
 void handleTrainingComplete();
-void sendTrainingResult(unsigned long duration);
+void sendTrainingResult(uint64_t durationUs);
 void sendStartTrainingSignal();
 
+// 组命令函数
+void serviceGroupCommand();
+void applyGroupAction(const GroupAction& action, int32_t latenessUs);
+
 // 设备配对函数
-void handlePairingMessage(const message_t& message, const uint8_t* senderMac);
+void handlePairingMessage(const message_t& message, const uint8_t* senderMac, int8_t rssi);
 void respondToPairingRequest(const uint8_t* senderMac);
+void confirmPairing(const uint8_t* senderMac, int8_t rssi);
 
 void setup() {
     Serial.begin(115200);
     Serial.println("ESP-NOW 从机设备启动中...");
+    bootProfile.begin();
     
-    // 初始化硬件
-    if (!slaveHardware.init()) {
+    // 阶段1：传感器引脚
+    if (!slaveHardware.initCore()) {
         Serial.println("硬件初始化失败!");
         currentState = SLAVE_ERROR;
         return;
     }
+    bootProfile.mark("引脚");
     
-    // 初始化WiFi
+    // 阶段2：无线（已知对端缓存用于确定主设备和开机重连）
     WiFi.mode(WIFI_STA);
-    
-    // 确定设备角色
+    energyAccount.begin(Clock::nowUs());
+    energyAccount.setRadio(Clock::nowUs(), true);
+    traceCapture.setCommandHandler(onSerialCommand);
+    peerCacheLoad(peerCache);
     determineDeviceRole();
-    
-    // 初始化ESP-NOW
     initESPNow();
+    sendTimeRequest();
+    cpuGovernorBegin();
+    bootProfile.mark("无线");
     
     // 设置状态 - 强制重置到IDLE状态
     currentState = SLAVE_IDLE;
     systemInitialized = true;
+    bootProfile.markReady();
     
+    // 阶段3：LED与启动提示（单音，tone不阻塞）
+    slaveHardware.initLEDs();
     Serial.printf("从机状态设置为: %d (SLAVE_IDLE)\n", currentState);
     slaveHardware.indicateTrainingState(currentState);
-    slaveHardware.playStartSound();
+    slaveHardware.beep(1000, 200);
+    bootProfile.mark("LED");
     
     Serial.println("从机系统初始化完成");
+    bootProfile.report();
 }
 
 void loop() {
@@ -90,16 +178,83 @@ void loop() {
         return;
     }
     
+    uint64_t loopStartUs = Clock::nowUs();
+    
     slaveHardware.update();
     
+    // 按信标开关接收，须在心跳和发送之前
+    serviceDutyCycle();
+    
     // 更新连接状态监控
     updateConnectionStatus();
     
+    // 发出排队的无线消息
+    radioTx.service();
+    
+    // 执行到点的组命令
+    serviceGroupCommand();
+    
+    // 按主机通知切换信道，失联时回约定信道
+    serviceChannel();
+    
     updateSystem();
     
+    // 按锥桶状态调整CPU频率，进入训练立即升频
+    cpuGovernorService(currentCpuDemand());
+    
+    // 本次循环的运行时间计入CPU能耗，delay期间按空闲计
+    energyAccount.addCpuBusy((uint32_t)Clock::elapsedUs(loopStartUs));
+    serviceEnergy();
+    
     delay(10); // 短暂延迟以避免过度占用CPU
 }
 
+// 能耗估算：每ENERGY_SAMPLE_INTERVAL_MS把发射计数和外设状态计入积分
+void serviceEnergy() {
+    static uint64_t lastSampleUs = 0;
+    static uint32_t lastFrames = 0;
+    static uint32_t lastBytes = 0;
+    uint64_t now = Clock::nowUs();
+    if (!Clock::hasElapsed(lastSampleUs, ENERGY_SAMPLE_INTERVAL_MS * 1000ULL)) {
+        return;
+    }
+    lastSampleUs = now;
+    
+    energyAccount.addTx(espNowTransport.framesSent() - lastFrames, espNowTransport.bytesSent() - lastBytes);
+    lastFrames = espNowTransport.framesSent();
+    lastBytes = espNowTransport.bytesSent();
+    slaveHardware.sampleEnergy(energyAccount, now);
+    energyAccount.advance(now);
+}
+
+// 锥桶状态的CPU需求档位：空闲时降频并允许在占空窗口之外浅睡
+CpuDemand currentCpuDemand() {
+    switch (currentState) {
+        case SLAVE_IDLE:
+        case SLAVE_ERROR:
+            // 配对和换信道期间无线常开，不浅睡
+            return (pairingModeActive || channelFollower.pending()) ? CPU_DEMAND_ACTIVE : CPU_DEMAND_IDLE;
+        case SLAVE_TRAINING:
+            return CPU_DEMAND_TIMING;
+        default:
+            return CPU_DEMAND_ACTIVE;
+    }
+}
+
+// trace之外的串口命令
+void onSerialCommand(const char* command) {
+    if (!energyHandleCommand(energyAccount, command, slaveHardware.remainingMah()) && !cpuHandleCommand(command)) {
+        Serial.printf("未知命令: %s\n", command);
+    }
+}
+
+// 探测抖动的随机种子：各锥桶MAC不同，抖动序列也不同
+static uint32_t localMacSeed() {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    return ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+}
+
 void determineDeviceRole() {
     uint8_t mac[6];
     WiFi.macAddress(mac);
@@ -110,7 +265,8 @@ void determineDeviceRole() {
     
     // 从机设备强制设置为SLAVE角色
     deviceRole = ROLE_SLAVE;
-    memcpy(peerAddress, deviceA, 6); // 连接到主设备
+    // 连接到主设备：优先使用最近连接的已知对端
+    memcpy(peerAddress, peerCache.count() > 0 ? peerCache.at(0).mac : deviceA, 6);
     Serial.println("设备角色: 从设备 (Slave)");
     
     Serial.print("本机MAC: ");
@@ -129,6 +285,7 @@ void determineDeviceRole() {
 }
 
 void initESPNow() {
+    setRadioChannel(ESPNOW_CHANNEL);
     if (esp_now_init() != ESP_OK) {
         Serial.println("ESP-NOW 初始化失败");
         return;
@@ -140,7 +297,7 @@ void initESPNow() {
     // 添加对等设备（主设备）
     esp_now_peer_info_t peerInfo = {};
     memcpy(peerInfo.peer_addr, peerAddress, 6);
-    peerInfo.channel = ESPNOW_CHANNEL;
+    peerInfo.channel = 0;  // 0: 跟随当前信道，换信道后无需修改对等设备
     peerInfo.encrypt = ESPNOW_ENCRYPT;
     
     if (esp_now_add_peer(&peerInfo) != ESP_OK) {
@@ -148,11 +305,19 @@ void initESPNow() {
         return;
     }
     
+    // 缓存中的其他已知对端也加入，开机探测时轮流尝试
+    for (uint8_t i = 0; i < peerCache.count(); i++) {
+        if (!esp_now_is_peer_exist(peerCache.at(i).mac)) {
+            memcpy(peerInfo.peer_addr, peerCache.at(i).mac, 6);
+            esp_now_add_peer(&peerInfo);
+        }
+    }
+    
     // 添加广播地址对等设备以接收配对请求
     uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
     esp_now_peer_info_t broadcastPeer = {};
     memcpy(broadcastPeer.peer_addr, broadcastAddr, 6);
-    broadcastPeer.channel = ESPNOW_CHANNEL;
+    broadcastPeer.channel = 0;
     broadcastPeer.encrypt = false; // 广播不加密
     
     if (esp_now_add_peer(&broadcastPeer) != ESP_OK) {
@@ -165,17 +330,56 @@ void initESPNow() {
     
     // 设置连接状态为连接中
     setConnectionStatus(CONN_CONNECTING);
-    lastConnectionCheck = millis();
+    lastConnectionCheck = Clock::nowUs();
+    lastHeartbeatReceived = Clock::stamp32();
+    
+    // 已知对端无需扫描：立即开始短间隔探测，不等第一次常规心跳
+    reconnectProbe.begin(Clock::nowUs(), RECONNECT_PROBE_INTERVAL_US, RECONNECT_PROBE_JITTER_US,
+                         RECONNECT_WINDOW_US, localMacSeed());
 }
 
 void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int len) {
+    // 授时消息格式不同，接收时刻需尽早记录
+    if (len == sizeof(TimeSyncMessage) && data[0] == CMD_TIME_SYNC) {
+        TimeSyncMessage sync;
+        int64_t receivedUs = esp_timer_get_time();
+        memcpy(&sync, data, sizeof(sync));
+        handleTimeSync(sync, receivedUs);
+        return;
+    }
+    
+    // 组命令帧长度可变；上一帧未取走时丢弃（重复广播的副本）
+    if (data[0] == CMD_GROUP_COMMAND) {
+        if (groupFrameLength == 0 && len <= (int)sizeof(groupFrame)) {
+            memcpy(groupFrame, data, len);
+            groupFrameLength = len;
+        }
+        lastHeartbeatReceived = Clock::stamp32();
+        return;
+    }
+    
     message_t message;
     memcpy(&message, data, sizeof(message_t));
     
     Serial.printf("接收到消息: 命令=%d, 数据=%d\n", message.command, message.data);
     
     // 更新最后收到消息的时间
-    lastHeartbeatReceived = millis();
+    lastHeartbeatReceived = Clock::stamp32();
+    
+    // 记录本机接收强度；对端心跳/应答中带有它收到本机帧的强度
+    if (recv_info->rx_ctrl && memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+        lastPeerRssi = recv_info->rx_ctrl->rssi;
+    }
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        txPowerHasFeedback(message.data)) {
+        txPower.onFeedback(recv_info->src_addr, txPowerFeedbackRssi(message.data), Clock::nowUs());
+    }
+    
+    // 开机重连期间已知对端先应答时改用该对端
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        connectionStatus != CONN_CONNECTED) {
+        adoptKnownPeer(recv_info->src_addr);
+    }
     
     switch (message.command) {
         case CMD_HEARTBEAT:
@@ -201,42 +405,75 @@ void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int
             
         case CMD_VT_ROUND_COMPLETE:
             // 主机发送的完成信号，重置从机状态
-            Serial.printf("收到主机完成信号，用时: %lu ms\n", message.data);
+            Serial.printf("收到主机完成信号，用时: %.1f ms\n", message.data / 10.0);
             currentState = SLAVE_IDLE;
             trainingActive = false;
             slaveHardware.indicateTrainingState(currentState);
             slaveHardware.playCompleteSound();
             break;
             
+        case CMD_LINK_PING:
+            replyToMaster(CMD_LINK_PONG, message.data);
+            break;
+            
+        case CMD_CHANNEL_SWITCH:
+            // 只跟随本机主设备；先应答，切换在主循环中按时进行
+            if (memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+                channelSwitchDelayMs = (uint16_t)(message.data >> 8);
+                channelSwitchStamp = Clock::stamp32();
+                channelSwitchTarget = (uint8_t)(message.data & 0xFF);
+                replyToMaster(CMD_CHANNEL_SWITCH_ACK, message.data & 0xFF);
+            }
+            break;
+            
+        case CMD_LED_BRIGHTNESS:
+            if (memcmp(recv_info->src_addr, peerAddress, 6) == 0 && message.data <= 100) {
+                pendingLedBrightness = (uint8_t)message.data;
+            }
+            break;
+            
+        case CMD_DUTY_BEACON:
+            // 只跟随本机主设备的信标
+            if (memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+                dutyBeaconData = message.data;
+                dutyBeaconStamp = Clock::stamp32();
+                dutyBeaconPending = true;
+            }
+            break;
+            
         case CMD_PAIRING_REQUEST:
+        case CMD_PAIRING_CONFIRM:
             // 从机设备应该始终响应配对请求，无需pairingModeActive检查
-            Serial.println("收到广播配对请求，准备响应");
-            handlePairingMessage(message, recv_info->src_addr);
+            Serial.println("收到配对消息，准备响应");
+            handlePairingMessage(message, recv_info->src_addr,
+                                 recv_info->rx_ctrl ? recv_info->rx_ctrl->rssi : 0);
             break;
     }
 }
 
 void onDataSent(const uint8_t* mac, esp_now_send_status_t status) {
-    Serial.printf("发送状态: %s\n", (status == ESP_NOW_SEND_SUCCESS) ? "成功" : "失败");
+    // WiFi任务上下文：只释放在途名额，失败次数由调度器累计
+    radioTx.onSendComplete(status == ESP_NOW_SEND_SUCCESS);
+    txPower.onDelivery(mac, status == ESP_NOW_SEND_SUCCESS, Clock::nowUs());
 }
 
 void updateSystem() {
     // 每5秒输出当前状态用于调试
-    static unsigned long lastStatusDebug = 0;
-    if (millis() - lastStatusDebug > 5000) {
+    static uint64_t lastStatusDebug = 0;
+    if (Clock::hasElapsed(lastStatusDebug, 5000000)) {
         Serial.printf("从机当前状态: %d (IDLE=%d, READY=%d, TRAINING=%d)\n", 
                      currentState, SLAVE_IDLE, SLAVE_READY, SLAVE_TRAINING);
-        lastStatusDebug = millis();
+        lastStatusDebug = Clock::nowUs();
     }
     
     // 如果从机长时间不在IDLE状态，自动重置
-    static unsigned long lastIdleTime = millis();
+    static uint64_t lastIdleTime = Clock::nowUs();
     if (currentState == SLAVE_IDLE) {
-        lastIdleTime = millis();
-    } else if (millis() - lastIdleTime > 30000) { // 30秒超时
+        lastIdleTime = Clock::nowUs();
+    } else if (Clock::hasElapsed(lastIdleTime, 30000000)) { // 30秒超时
         Serial.println("从机状态超时，重置到IDLE状态");
         currentState = SLAVE_IDLE;
-        lastIdleTime = millis();
+        lastIdleTime = Clock::nowUs();
     }
     
     switch (currentState) {
@@ -278,7 +515,7 @@ void updateSystem() {
             }
             
             // 检查训练超时
-            if (millis() - trainingStartTime > TIMING_TIMEOUT_MS) {
+            if (Clock::elapsedUs(trainingStartUs) > TIMING_TIMEOUT_MS * 1000ULL) {
                 Serial.println("训练超时");
                 currentState = SLAVE_ERROR;
                 slaveHardware.indicateTrainingState(currentState);
@@ -287,7 +524,7 @@ void updateSystem() {
             
         case SLAVE_COMPLETE:
             // 完成状态，等待一段时间后回到空闲
-            if (millis() - trainingStartTime > 5000) {
+            if (Clock::elapsedUs(trainingStartUs) > 5000000) {
                 currentState = SLAVE_IDLE;
                 slaveHardware.indicateTrainingState(currentState);
             }
@@ -302,18 +539,90 @@ void updateSystem() {
 
 // 连接状态监控函数实现
 void updateConnectionStatus() {
-    unsigned long currentTime = millis();
+    uint64_t currentTime = Clock::nowUs();
+    
+    // 开机快速重连：连接建立前按短间隔探测已知对端，之后转为常规心跳
+    if (reconnectProbe.active()) {
+        if (connectionStatus == CONN_CONNECTED) {
+            reconnectProbe.stop();
+            Serial.printf("已连接已知对端: 开机后 %lu ms, 探测 %u 次\n", millis(), reconnectProbe.sent());
+            // 保持缓存按最近连接排序
+            int index = peerCache.indexOf(peerAddress);
+            if (index > 0) {
+                peerCache.remember(peerAddress, peerCache.at(index).rssi);
+                peerCacheDirty = true;
+            }
+        } else if (reconnectProbe.due(currentTime)) {
+            probeKnownPeer();
+        }
+    }
+    if (peerCacheDirty) {
+        peerCacheDirty = false;
+        peerCacheSave(peerCache);
+    }
+    if (pendingLedBrightness != LED_BRIGHTNESS_NONE) {
+        uint8_t percent = pendingLedBrightness;
+        pendingLedBrightness = LED_BRIGHTNESS_NONE;
+        slaveHardware.setLedBrightness(percent);
+    }
     
     // 定期检查连接状态
-    if (currentTime - lastConnectionCheck >= CONNECTION_CHECK_INTERVAL) {
+    if (currentTime - lastConnectionCheck >= CONNECTION_CHECK_INTERVAL * 1000ULL) {
         lastConnectionCheck = currentTime;
         checkConnectionTimeout();
-        
-        // 发送心跳包
-        if (currentTime - lastHeartbeatSent >= HEARTBEAT_INTERVAL_MS) {
-            sendHeartbeat();
-            lastHeartbeatSent = currentTime;
+    }
+    
+    // 发送心跳包；占空时等到监听窗口再发，主机的心跳应答才能收到
+    if (currentTime - lastHeartbeatSent >= HEARTBEAT_INTERVAL_MS * 1000ULL && radioListening) {
+        sendHeartbeat();
+        if (!wallClock.valid()) {
+            sendTimeRequest();
         }
+        lastHeartbeatSent = currentTime;
+    }
+}
+
+// 无线占空处理
+void serviceDutyCycle() {
+    int64_t now = (int64_t)Clock::nowUs();
+    if (dutyBeaconPending) {
+        // 按回调记下的时刻对齐，不受主循环周期影响
+        int64_t arrivalUs = now - Clock::delta32(Clock::stamp32(), dutyBeaconStamp);
+        uint32_t data = dutyBeaconData;
+        dutyBeaconPending = false;
+        int64_t epochUs = -1;
+        if (wallClock.valid()) {
+            epochUs = wallClock.epochMicros(esp_timer_get_time() - (now - arrivalUs));
+        }
+        dutyCycle.onBeacon(data, arrivalUs, epochUs);
+    }
+    
+    // 未连接、训练中、配对或换信道时保持常开
+    dutyCycle.setLocalHold(connectionStatus != CONN_CONNECTED || currentState != SLAVE_IDLE ||
+                           pairingModeActive || channelSwitchTarget != 0 || channelFollower.pending());
+    uint32_t missedBefore = dutyCycle.missedBeacons();
+    dutyCycle.update(now);
+    if (dutyCycle.missedBeacons() != missedBefore) {
+        Serial.printf("连续错过 %lu 个信标，接收回到常开\n",
+                     (unsigned long)(dutyCycle.missedBeacons() - missedBefore));
+    }
+    if (dutyCycle.takeAckDue()) {
+        replyToMaster(CMD_DUTY_ACK, dutyCycle.cycling() ? DUTY_ACK_CYCLING : DUTY_ACK_ALWAYS_ON);
+    }
+    
+    bool listen = dutyCycle.listening(now);
+    if (listen != radioListening) {
+        radioListening = listen;
+        setRadioListening(listen);
+        energyAccount.setRadio((uint64_t)now, listen);
+    }
+}
+
+// 接收开关：未关联AP时调制解调器休眠即关闭射频，发送时驱动自动唤醒射频
+void setRadioListening(bool on) {
+    esp_err_t result = esp_wifi_set_ps(on ? WIFI_PS_NONE : WIFI_PS_MIN_MODEM);
+    if (result != ESP_OK) {
+        Serial.printf("切换接收失败: %d\n", result);
     }
 }
 
@@ -321,17 +630,18 @@ void sendHeartbeat() {
     message_t message;
     message.command = CMD_HEARTBEAT;
     message.target_id = 0; // 发送给主设备
-    message.source_id = 1; // 从设备ID
-    message.timestamp = millis();
-    message.data = connectionRetryCount;
+    message.source_id = CONE_ID; // 锥桶号，主机据此寻址组命令
+    message.timestamp = Clock::stamp32();
+    message.data = batteryPackReport(txPowerPackFeedback(connectionRetryCount, lastPeerRssi),
+                                     slaveHardware.batteryPercent());
     message.checksum = 0; // TODO: 实现校验和计算
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&message, sizeof(message));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_HEARTBEAT, CMD_HEARTBEAT);
+    if (result) {
         waitingForHeartbeatAck = true;
         Serial.printf("发送心跳包 (重试次数: %d)\n", connectionRetryCount);
     } else {
-        Serial.printf("心跳包发送失败: %d\n", result);
+        Serial.println("心跳包发送失败: 发送队列已满");
         connectionRetryCount++;
         if (connectionRetryCount >= CONNECTION_RETRY_COUNT) {
             setConnectionStatus(CONN_ERROR);
@@ -339,6 +649,116 @@ void sendHeartbeat() {
     }
 }
 
+void probeKnownPeer() {
+    // 缓存中有多个已知对端时轮流探测
+    const uint8_t* target = peerAddress;
+    if (peerCache.count() > 1) {
+        target = peerCache.at((reconnectProbe.sent() - 1) % peerCache.count()).mac;
+    }
+    
+    message_t message;
+    message.command = CMD_HEARTBEAT;
+    message.target_id = 0; // 发送给主设备
+    message.source_id = CONE_ID; // 锥桶号
+    message.timestamp = Clock::stamp32();
+    message.data = 0;
+    message.checksum = 0;
+    
+    // 探测不合并：轮流探测时每帧目标不同
+    radioTx.enqueue(target, &message, sizeof(message), TX_PRIO_CONTROL);
+}
+
+void adoptKnownPeer(const uint8_t* mac) {
+    // ESP-NOW回调上下文：只切换对端地址，缓存排序在主循环中更新
+    if (memcmp(mac, peerAddress, 6) != 0 && peerCache.contains(mac)) {
+        memcpy(peerAddress, mac, 6);
+        Serial.println("改用应答的已知主设备");
+    }
+}
+
+void setRadioChannel(uint8_t channel) {
+    if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+        Serial.printf("设置信道 %d 失败\n", channel);
+        return;
+    }
+    radioChannel = channel;
+    Serial.printf("无线信道: %d\n", channel);
+}
+
+void serviceChannel() {
+    uint64_t now = Clock::nowUs();
+    if (channelSwitchTarget != 0) {
+        // 切换时刻从收到通知时算起，不含等待主循环的时间
+        uint32_t waitedUs = (uint32_t)Clock::delta32(Clock::stamp32(), channelSwitchStamp);
+        uint8_t target = channelSwitchTarget;
+        channelSwitchTarget = 0;
+        channelFollower.schedule(target, now - waitedUs + channelSwitchDelayMs * 1000ULL);
+    }
+    
+    uint8_t channel;
+    if (channelFollower.switchDue(now, channel)) {
+        setRadioChannel(channel);
+        // 立即发心跳，主机据此确认本机已在新信道
+        sendHeartbeat();
+    } else if (channelFollower.fallbackDue(radioChannel,
+                                           (uint32_t)Clock::delta32(Clock::stamp32(), lastHeartbeatReceived))) {
+        Serial.printf("信道%d上失联，回约定信道%d\n", radioChannel, ESPNOW_CHANNEL);
+        setRadioChannel(ESPNOW_CHANNEL);
+    }
+}
+
+void replyToMaster(uint8_t command, uint32_t data) {
+    message_t message;
+    message.command = command;
+    message.target_id = 0; // 发送给主设备
+    message.source_id = CONE_ID; // 锥桶号
+    message.timestamp = Clock::stamp32();
+    message.data = data;
+    message.checksum = 0;
+    
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL);
+    if (!result) {
+        Serial.printf("回复主设备失败 (命令 0x%02X): 发送队列已满\n", command);
+    }
+}
+
+void sendTimeRequest() {
+    message_t message;
+    message.command = CMD_TIME_REQUEST;
+    message.target_id = 0; // 发送给主设备
+    message.source_id = CONE_ID; // 锥桶号
+    message.timestamp = Clock::stamp32();
+    message.data = 0;
+    message.checksum = 0;
+    
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL, CMD_TIME_REQUEST);
+    if (!result) {
+        Serial.println("授时请求发送失败: 发送队列已满");
+    }
+}
+
+void handleTimeSync(const TimeSyncMessage& message, int64_t receivedUs) {
+    TimeSyncResult result = wallClock.apply(message, receivedUs);
+    if (result == TIME_SYNC_DUPLICATE) {
+        return;
+    }
+    
+    // 同步系统时间，time()/localtime()与主机一致
+    int64_t epochUs = wallClock.epochMicros(esp_timer_get_time());
+    struct timeval now;
+    now.tv_sec = epochUs / 1000000;
+    now.tv_usec = epochUs % 1000000;
+    settimeofday(&now, nullptr);
+    
+    if (result == TIME_SYNC_STEPPED) {
+        Serial.printf("主机授时: %lu.%06lu (时区偏移 %ld 秒)%s\n",
+                      (unsigned long)now.tv_sec, (unsigned long)now.tv_usec,
+                      (long)wallClock.utcOffset(), (message.flags & TIME_SYNC_FLAG_SET) ? " [手动设置]" : "");
+    } else {
+        Serial.printf("时钟微调: 误差 %lld us\n", (long long)wallClock.lastErrorUs());
+    }
+}
+
 void handleHeartbeat(const message_t& message) {
     Serial.printf("收到心跳包，源ID: %d\n", message.source_id);
     
@@ -346,26 +766,26 @@ void handleHeartbeat(const message_t& message) {
     message_t ackMessage;
     ackMessage.command = CMD_HEARTBEAT_ACK;
     ackMessage.target_id = message.source_id;
-    ackMessage.source_id = 1; // 从设备ID
-    ackMessage.timestamp = millis();
-    ackMessage.data = 0;
+    ackMessage.source_id = CONE_ID; // 锥桶号，主机据此寻址组命令
+    ackMessage.timestamp = Clock::stamp32();
+    ackMessage.data = batteryPackReport(txPowerPackFeedback(0, lastPeerRssi), slaveHardware.batteryPercent());
     ackMessage.checksum = 0; // TODO: 实现校验和计算
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&ackMessage, sizeof(ackMessage));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &ackMessage, sizeof(ackMessage), TX_PRIO_HEARTBEAT, CMD_HEARTBEAT_ACK);
+    if (result) {
         setConnectionStatus(CONN_CONNECTED);
         Serial.println("发送心跳应答");
     } else {
-        Serial.printf("心跳应答发送失败: %d\n", result);
+        Serial.println("心跳应答发送失败: 发送队列已满");
     }
 }
 
 void checkConnectionTimeout() {
-    unsigned long currentTime = millis();
+    uint64_t currentTime = Clock::nowUs();
     
     // 检查是否超时
     if (connectionStatus == CONN_CONNECTED || connectionStatus == CONN_CONNECTING) {
-        if (currentTime - lastHeartbeatReceived > HEARTBEAT_TIMEOUT_MS) {
+        if (Clock::delta32(Clock::stamp32(), lastHeartbeatReceived) > HEARTBEAT_TIMEOUT_MS * 1000L) {
             Serial.println("连接超时，尝试重连...");
             setConnectionStatus(CONN_TIMEOUT);
             connectionRetryCount++;
@@ -381,7 +801,7 @@ void checkConnectionTimeout() {
     }
     
     // 检查心跳应答超时
-    if (waitingForHeartbeatAck && (currentTime - lastHeartbeatSent > HEARTBEAT_TIMEOUT_MS / 2)) {
+    if (waitingForHeartbeatAck && (currentTime - lastHeartbeatSent > HEARTBEAT_TIMEOUT_MS / 2 * 1000ULL)) {
         Serial.println("心跳应答超时");
         waitingForHeartbeatAck = false;
         connectionRetryCount++;
@@ -403,6 +823,17 @@ void setConnectionStatus(ConnectionStatus status) {
                      getConnectionStatusString(oldStatus),
                      getConnectionStatusString(status));
         
+        // 每次连接为一个功率统计会话，断开时输出
+        if (status == CONN_CONNECTED) {
+            txPower.resetStats();
+        } else if (oldStatus == CONN_CONNECTED) {
+            TxPowerStats power = txPower.stats();
+            int32_t avg = power.averageDeciDbm();
+            Serial.printf("发射功率: 平均 %ld.%ld dBm (%lu帧), 降 %u 次, 升 %u 次, 丢包回满 %u 次\n",
+                         (long)(avg / 10), (long)(avg % 10), (unsigned long)power.frames,
+                         power.stepsDown, power.stepsUp, power.snaps);
+        }
+        
         // 根据连接状态更新硬件指示
         slaveHardware.indicateConnectionStatus(status);
         
@@ -424,11 +855,96 @@ const char* getConnectionStatusString(ConnectionStatus status) {
     }
 }
 
+// 组命令处理
+void serviceGroupCommand() {
+    if (groupFrameLength != 0) {
+        // 墙钟与本地时钟的差，定时命令据此换算到本地时刻
+        int64_t timerUs = esp_timer_get_time();
+        uint64_t now = Clock::nowUs();
+        int64_t offsetUs = wallClock.epochMicros(timerUs) - (int64_t)now;
+        GroupReceiveResult result = groupReceiver.receive(groupFrame, groupFrameLength, now,
+                                                          offsetUs, wallClock.valid());
+        groupFrameLength = 0;
+        if (result == GROUP_RX_LATE) {
+            Serial.println("组命令到达时已过执行时刻，立即执行");
+        } else if (result == GROUP_RX_SCHEDULED) {
+            Serial.printf("组命令已排定: %llu us 后执行\n",
+                          (unsigned long long)(groupReceiver.dueAtUs() - now));
+        }
+    }
+    
+    if (!groupReceiver.pending()) {
+        return;
+    }
+    uint64_t now = Clock::nowUs();
+    uint64_t due = groupReceiver.dueAtUs();
+    if (due > now && due - now >= GROUP_SPIN_US) {
+        return;
+    }
+    // 执行时刻在下一轮主循环之前：忙等到点，执行时刻不受主循环周期影响
+    GroupAction action;
+    while (!groupReceiver.take(now, action)) {
+        now = Clock::nowUs();
+    }
+    applyGroupAction(action, (int32_t)(now - action.applyAtUs));
+}
+
+void applyGroupAction(const GroupAction& action, int32_t latenessUs) {
+    const GroupTarget& target = action.target;
+    if (target.flags & GROUP_FLAG_DISARM) {
+        currentState = SLAVE_IDLE;
+        trainingActive = false;
+        slaveHardware.indicateTrainingState(currentState);
+    }
+    if (target.flags & GROUP_FLAG_ARM) {
+        // 计时起点为统一的执行时刻，不含本机执行偏差
+        currentState = SLAVE_TRAINING;
+        trainingStartUs = action.applyAtUs;
+        trainingActive = true;
+        slaveHardware.indicateTrainingState(currentState);
+    }
+    if (target.flags & GROUP_FLAG_LIGHT) {
+        switch (target.effect) {
+            case GROUP_EFFECT_OFF:
+                slaveHardware.clearLEDs();
+                slaveHardware.showLEDs();
+                break;
+            case GROUP_EFFECT_BREATHE:
+                slaveHardware.ledBreathingEffect(groupColor(target));
+                break;
+            default:
+                slaveHardware.setAllLEDs(groupColor(target));
+                slaveHardware.showLEDs();
+                break;
+        }
+    }
+    
+    if (target.flags & GROUP_FLAG_REPORT) {
+        message_t message;
+        message.command = CMD_GROUP_REPORT;
+        message.target_id = 0;
+        message.source_id = CONE_ID;
+        message.timestamp = Clock::stamp32();
+        message.data = groupPackReport(action.sequence, latenessUs);
+        message.checksum = 0;
+        
+        bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL);
+        if (!result) {
+            Serial.println("组命令回报发送失败: 发送队列已满");
+        }
+    }
+    if (target.flags & GROUP_FLAG_ARM) {
+        slaveHardware.playStartSound();
+    }
+    Serial.printf("组命令 #%u 已执行: 偏差 %ld us%s\n", action.sequence, (long)latenessUs,
+                  action.scheduled ? "" : " (未授时，收到即执行)");
+}
+
 // 训练处理函数实现
 void handleTrainingStart() {
     if (connectionStatus == CONN_CONNECTED) {
         currentState = SLAVE_READY;
-        trainingStartTime = millis();
+        trainingStartUs = Clock::nowUs();
         trainingActive = true;
         
         Serial.println("收到训练开始命令");
@@ -447,34 +963,36 @@ void handleTrainingStart() {
 
 void handleTrainingComplete() {
     if (trainingActive) {
-        unsigned long duration = millis() - trainingStartTime;
+        // 以传感器触发时刻结束计时，不含触发反馈灯效的阻塞时间
+        uint64_t impactUs = slaveHardware.lastImpactUs();
+        uint64_t durationUs = impactUs > trainingStartUs ? impactUs - trainingStartUs : Clock::elapsedUs(trainingStartUs);
         trainingActive = false;
         currentState = SLAVE_COMPLETE;
         
-        Serial.printf("训练完成，用时: %lu毫秒\n", duration);
+        Serial.printf("训练完成，用时: %.1f毫秒\n", durationUs / 1000.0);
         
         slaveHardware.indicateVibrationDetected();
         slaveHardware.indicateTrainingState(currentState);
         
         // 发送训练结果给主设备
-        sendTrainingResult(duration);
+        sendTrainingResult(durationUs);
     }
 }
 
-void sendTrainingResult(unsigned long duration) {
+void sendTrainingResult(uint64_t durationUs) {
     message_t message;
     message.command = CMD_TASK_COMPLETE;
     message.target_id = 0; // 发送给主设备
-    message.source_id = 1; // 从设备ID
-    message.timestamp = millis();
-    message.data = duration;
+    message.source_id = CONE_ID; // 锥桶号
+    message.timestamp = Clock::stamp32();
+    message.data = Clock::toTicks(durationUs);  // 0.1ms
     message.checksum = 0; // TODO: 实现校验和计算
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&message, sizeof(message));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_TIMING);
+    if (result) {
         Serial.println("训练结果发送成功");
     } else {
-        Serial.printf("训练结果发送失败: %d\n", result);
+        Serial.println("训练结果发送失败: 发送队列已满");
     }
 }
 
@@ -482,8 +1000,8 @@ void sendStartTrainingSignal() {
     message_t message;
     message.command = CMD_VT_START_ROUND;
     message.target_id = 0; // 发送给主设备
-    message.source_id = 1; // 从设备ID
-    message.timestamp = millis();
+    message.source_id = CONE_ID; // 锥桶号
+    message.timestamp = Clock::stamp32();
     message.data = 0;
     message.checksum = 0; // TODO: 实现校验和计算
     
@@ -492,21 +1010,49 @@ void sendStartTrainingSignal() {
                   peerAddress[0], peerAddress[1], peerAddress[2], 
                   peerAddress[3], peerAddress[4], peerAddress[5]);
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&message, sizeof(message));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_TIMING);
+    if (result) {
         Serial.println("从机开始训练信号发送成功");
     } else {
-        Serial.printf("从机开始训练信号发送失败: %d\n", result);
+        Serial.println("从机开始训练信号发送失败: 发送队列已满");
     }
 }
 
 // 设备配对函数实现
-void handlePairingMessage(const message_t& message, const uint8_t* senderMac) {
+void handlePairingMessage(const message_t& message, const uint8_t* senderMac, int8_t rssi) {
     switch (message.command) {
         case CMD_PAIRING_REQUEST:
             Serial.println("收到配对请求");
             respondToPairingRequest(senderMac);
             break;
+            
+        case CMD_PAIRING_CONFIRM:
+            Serial.println("收到配对确认");
+            confirmPairing(senderMac, rssi);
+            break;
+    }
+}
+
+void confirmPairing(const uint8_t* senderMac, int8_t rssi) {
+    // 主设备选中本机：改用该主设备并回复确认，主设备据此完成配对
+    memcpy(peerAddress, senderMac, 6);
+    peerCache.remember(senderMac, rssi);
+    peerCacheDirty = true;
+    
+    message_t response;
+    response.command = CMD_PAIRING_CONFIRM;
+    response.target_id = 0; // 发送给主设备
+    response.source_id = CONE_ID; // 锥桶号
+    response.timestamp = Clock::stamp32();
+    response.data = deviceRole;
+    response.checksum = 0;
+    
+    bool result = radioTx.enqueue(senderMac, &response, sizeof(response), TX_PRIO_CONTROL);
+    if (result) {
+        setConnectionStatus(CONN_CONNECTED);
+        Serial.println("配对成功，已回复确认");
+    } else {
+        Serial.println("配对确认回复失败: 发送队列已满");
     }
 }
 
@@ -515,7 +1061,7 @@ void respondToPairingRequest(const uint8_t* senderMac) {
     if (!esp_now_is_peer_exist(senderMac)) {
         esp_now_peer_info_t senderPeer = {};
         memcpy(senderPeer.peer_addr, senderMac, 6);
-        senderPeer.channel = ESPNOW_CHANNEL;
+        senderPeer.channel = 0;
         senderPeer.encrypt = false; // 配对期间不加密
         
         esp_err_t addResult = esp_now_add_peer(&senderPeer);
@@ -531,13 +1077,13 @@ void respondToPairingRequest(const uint8_t* senderMac) {
     message_t response;
     response.command = CMD_DEVICE_INFO;
     response.target_id = 0; // 发送给主设备
-    response.source_id = 1; // 从设备ID
-    response.timestamp = millis();
+    response.source_id = CONE_ID; // 锥桶号
+    response.timestamp = Clock::stamp32();
     response.data = deviceRole; // 发送角色信息
     response.checksum = 0;
     
-    esp_err_t result = esp_now_send(senderMac, (uint8_t*)&response, sizeof(response));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(senderMac, &response, sizeof(response), TX_PRIO_CONTROL);
+    if (result) {
         Serial.println("发送设备信息回应成功");
         
         // 打印发送者MAC地址用于调试
@@ -548,6 +1094,6 @@ void respondToPairingRequest(const uint8_t* senderMac) {
         }
         Serial.println();
     } else {
-        Serial.printf("设备信息回应发送失败: %d\n", result);
+        Serial.println("设备信息回应发送失败: 发送队列已满");
     }
 }
\ No newline at end of file
@@ -1,35 +1,102 @@
 #include "ButtonManager.h"
 #include "config.h"
+#include "clock.h"
+#include <driver/gpio.h>
+#include <hal/gpio_ll.h>
+#include <esp_sleep.h>
 
 ButtonManager::ButtonManager(uint8_t buttonPin) 
-    : pin(buttonPin), button(), enabled(true),
-      debounceTicks(BUTTON_DEBOUNCE_MS), clickTicks(BUTTON_CLICK_MS), pressTicks(BUTTON_LONG_PRESS_MS) {}
+    : pin(buttonPin), enabled(true), sleepWake(false),
+      singleClickCallback(nullptr), doubleClickCallback(nullptr), longPressCallback(nullptr),
+      multiClickCallback(nullptr), duringLongPressCallback(nullptr), longPressStopCallback(nullptr) {}
 
 void ButtonManager::init() {
     // GPIO5高电平触发按钮 - 按下时为HIGH，未按下时为LOW
     // 使用内部下拉电阻，确保未按下时为LOW
-    button.setup(pin, INPUT_PULLDOWN, false); // false表示activeHigh（高电平有效）
+    pinMode(pin, INPUT_PULLDOWN);
     
-    // 设置各种时间参数
-    button.setDebounceMs(debounceTicks);
-    button.setClickMs(clickTicks);
-    button.setPressMs(pressTicks);
-    
-    // OneButton库默认支持双击，只要设置了doubleClick回调函数即可
-    Serial.printf("  双击检测已默认启用\n");
-    Serial.printf("  双击时间间隔: %d ms\n", BUTTON_DOUBLE_CLICK_MS);
+    // 上电时已按下则从按下状态开始，避免第一个松开边沿被当作点击
+    if (digitalRead(pin) == HIGH) {
+        edges.push(Clock::nowUs(), true);
+    }
+    attachInterruptArg(digitalPinToInterrupt(pin), onEdgeISR, this, CHANGE);
     
-    Serial.printf("按钮管理器初始化完成（高电平触发）\n");
+    const ButtonTiming& timing = recognizer.getTiming();
+    Serial.printf("按钮管理器初始化完成（高电平触发，中断时间戳）\n");
     Serial.printf("  引脚: GPIO%d\n", pin);
-    Serial.printf("  防抖时间: %lu ms\n", debounceTicks);
-    Serial.printf("  点击间隔: %lu ms\n", clickTicks);
-    Serial.printf("  长按时间: %lu ms\n", pressTicks);
+    Serial.printf("  防抖时间: %lu ms\n", (unsigned long)(timing.debounceUs / 1000));
+    Serial.printf("  点击间隔: %lu ms\n", (unsigned long)(timing.clickGapUs / 1000));
+    Serial.printf("  长按时间: %lu ms\n", (unsigned long)(timing.longPressUs / 1000));
+    Serial.printf("  长按重复: %lu ms\n", (unsigned long)(timing.repeatUs / 1000));
     Serial.printf("  按钮类型: 高电平触发\n");
 }
 
+void ButtonManager::enableSleepWake() {
+    // 唤醒把引脚中断改为电平触发，中断中按当前电平翻转，否则按住期间中断连续触发
+    sleepWake = true;
+    bool pressed = digitalRead(pin) == HIGH;
+    gpio_wakeup_enable((gpio_num_t)pin, buttonWakeOnHigh(pressed) ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+    Serial.println("按键可唤醒浅睡（电平翻转触发）");
+}
+
+void IRAM_ATTR ButtonManager::onEdgeISR(void* arg) {
+    ButtonManager* self = static_cast<ButtonManager*>(arg);
+    bool pressed = digitalRead(self->pin) == HIGH;
+    self->edges.push(Clock::nowUs(), pressed);
+    if (self->sleepWake) {
+        // 内联寄存器操作，可在中断中调用
+        gpio_ll_set_intr_type(&GPIO, self->pin,
+                              buttonWakeOnHigh(pressed) ? GPIO_INTR_HIGH_LEVEL : GPIO_INTR_LOW_LEVEL);
+    }
+}
+
 void ButtonManager::tick() {
-    if (enabled) {
-        button.tick();
+    // 先取当前时刻再取边沿，之后到达的边沿留给下一次tick
+    uint64_t now = Clock::nowUs();
+    ButtonEdge edge;
+    while (edges.pop(edge)) {
+        recognizer.feed(edge);
+    }
+    recognizer.update(now);
+    
+    ButtonEvent event;
+    while (recognizer.nextEvent(event)) {
+        if (enabled) {
+            dispatch(event);
+        }
+    }
+}
+
+void ButtonManager::dispatch(const ButtonEvent& event) {
+    Serial.printf("[按键] 手势=%d 次数=%d 成立于%lu ms前\n", event.gesture, event.count,
+                  (unsigned long)((Clock::nowUs() - event.atUs) / 1000));
+    
+    switch (event.gesture) {
+        case GESTURE_CLICK:
+            if (event.count == 1 && singleClickCallback) {
+                singleClickCallback();
+            } else if (event.count == 2 && doubleClickCallback) {
+                doubleClickCallback();
+            } else if (event.count >= 3 && multiClickCallback) {
+                multiClickCallback(event.count);
+            }
+            break;
+        case GESTURE_LONG_PRESS:
+            if (longPressCallback) {
+                longPressCallback();
+            }
+            break;
+        case GESTURE_HOLD_REPEAT:
+            if (duringLongPressCallback) {
+                duringLongPressCallback();
+            }
+            break;
+        case GESTURE_LONG_RELEASE:
+            if (longPressStopCallback) {
+                longPressStopCallback();
+            }
+            break;
     }
 }
 
@@ -48,45 +115,47 @@ bool ButtonManager::isEnabled() const {
 }
 
 void ButtonManager::setDebounceTicks(unsigned long ticks) {
-    debounceTicks = ticks;
-    button.setDebounceMs(ticks);
+    ButtonTiming timing = recognizer.getTiming();
+    timing.debounceUs = ticks * 1000UL;
+    recognizer.setTiming(timing);
 }
 
 void ButtonManager::setClickTicks(unsigned long ticks) {
-    clickTicks = ticks;
-    button.setClickMs(ticks);
+    ButtonTiming timing = recognizer.getTiming();
+    timing.clickGapUs = ticks * 1000UL;
+    recognizer.setTiming(timing);
 }
 
 void ButtonManager::setPressTicks(unsigned long ticks) {
-    pressTicks = ticks;
-    button.setPressMs(ticks);
+    ButtonTiming timing = recognizer.getTiming();
+    timing.longPressUs = ticks * 1000UL;
+    recognizer.setTiming(timing);
 }
 
 void ButtonManager::attachSingleClick(void (*callback)()) {
-    button.attachClick(callback);
+    singleClickCallback = callback;
 }
 
 void ButtonManager::attachDoubleClick(void (*callback)()) {
-    button.attachDoubleClick(callback);
+    doubleClickCallback = callback;
     Serial.println("双击回调函数已注册");
 }
 
 void ButtonManager::attachLongPress(void (*callback)()) {
-    button.attachLongPressStart(callback);
+    longPressCallback = callback;
 }
 
 void ButtonManager::attachMultiClick(void (*callback)(int)) {
-    // OneButton库中的attachMultiClick不支持参数
-    // 这里可以留空或者实现其他逻辑
-    Serial.println("警告：MultiClick不支持参数");
+    // 三击及以上，参数为连击次数
+    multiClickCallback = callback;
 }
 
 void ButtonManager::attachDuringLongPress(void (*callback)()) {
-    button.attachDuringLongPress(callback);
+    duringLongPressCallback = callback;
 }
 
 void ButtonManager::attachLongPressStop(void (*callback)()) {
-    button.attachLongPressStop(callback);
+    longPressStopCallback = callback;
 }
 
 bool ButtonManager::isPressed() const {
@@ -95,22 +164,22 @@ bool ButtonManager::isPressed() const {
 }
 
 bool ButtonManager::isLongPressed() const {
-    return button.isLongPressed();
+    return recognizer.isLongPressed();
 }
 
 unsigned long ButtonManager::getDebounceTicks() const {
-    return debounceTicks;
+    return recognizer.getTiming().debounceUs / 1000;
 }
 
 unsigned long ButtonManager::getClickTicks() const {
-    return clickTicks;
+    return recognizer.getTiming().clickGapUs / 1000;
 }
 
 unsigned long ButtonManager::getPressTicks() const {
-    return pressTicks;
+    return recognizer.getTiming().longPressUs / 1000;
 }
 
 void ButtonManager::reset() {
-    button.reset();
+    recognizer.reset();
     Serial.println("按钮状态已重置");
 }
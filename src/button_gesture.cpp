@@ -0,0 +1,137 @@
+#include "button_gesture.h"
+
+ButtonGestureRecognizer::ButtonGestureRecognizer()
+    : timing{BUTTON_DEBOUNCE_MS * 1000UL, BUTTON_CLICK_MS * 1000UL, BUTTON_LONG_PRESS_MS * 1000UL,
+             BUTTON_HOLD_REPEAT_MS * 1000UL, BUTTON_MAX_CLICKS},
+      eventHead(0), eventTail(0), eventOverflows(0) {
+    reset();
+}
+
+void ButtonGestureRecognizer::reset() {
+    state = STATE_IDLE;
+    clockUs = 0;
+    rawPressed = false;
+    rawSinceUs = 0;
+    stablePressed = false;
+    pressUs = 0;
+    releaseUs = 0;
+    nextRepeatUs = 0;
+    clicks = 0;
+    repeats = 0;
+    eventTail = eventHead;
+}
+
+void ButtonGestureRecognizer::feed(const ButtonEdge& edge) {
+    // 先结算该边沿之前已成立的电平变化和超时
+    advanceTo(edge.atUs);
+    if (edge.level != rawPressed) {
+        rawPressed = edge.level;
+        rawSinceUs = clockUs;
+    }
+}
+
+void ButtonGestureRecognizer::update(uint64_t nowUs) {
+    advanceTo(nowUs);
+}
+
+void ButtonGestureRecognizer::advanceTo(uint64_t atUs) {
+    // 时间只前进：读取当前时刻后才入队的边沿不会让识别器回退
+    if (atUs < clockUs) {
+        atUs = clockUs;
+    }
+    clockUs = atUs;
+
+    // 电平稳定满防抖时间才生效，生效时刻取原始边沿的时间戳
+    if (rawPressed != stablePressed && atUs - rawSinceUs >= timing.debounceUs) {
+        fireDeadlines(rawSinceUs);
+        applyStable(rawPressed, rawSinceUs);
+    }
+    fireDeadlines(atUs);
+}
+
+void ButtonGestureRecognizer::fireDeadlines(uint64_t untilUs) {
+    switch (state) {
+        case STATE_PRESSED:
+            if (untilUs - pressUs < timing.longPressUs) {
+                break;
+            }
+            // 长按前的连击不再等待，先行上报
+            if (clicks > 0) {
+                publish(GESTURE_CLICK, clicks, pressUs);
+                clicks = 0;
+            }
+            state = STATE_HOLDING;
+            repeats = 0;
+            nextRepeatUs = pressUs + timing.longPressUs + timing.repeatUs;
+            publish(GESTURE_LONG_PRESS, 1, pressUs + timing.longPressUs);
+            [[fallthrough]];
+        case STATE_HOLDING:
+            while (timing.repeatUs > 0 && untilUs >= nextRepeatUs) {
+                if (repeats < UINT8_MAX) {
+                    repeats++;
+                }
+                publish(GESTURE_HOLD_REPEAT, repeats, nextRepeatUs);
+                nextRepeatUs += timing.repeatUs;
+            }
+            break;
+        case STATE_WAIT_NEXT:
+            if (untilUs - releaseUs >= timing.clickGapUs) {
+                publish(GESTURE_CLICK, clicks, releaseUs + timing.clickGapUs);
+                clicks = 0;
+                state = STATE_IDLE;
+            }
+            break;
+        case STATE_IDLE:
+            break;
+    }
+}
+
+void ButtonGestureRecognizer::applyStable(bool pressed, uint64_t atUs) {
+    stablePressed = pressed;
+
+    if (pressed) {
+        if (state == STATE_IDLE || state == STATE_WAIT_NEXT) {
+            state = STATE_PRESSED;
+            pressUs = atUs;
+        }
+        return;
+    }
+
+    switch (state) {
+        case STATE_PRESSED:
+            clicks++;
+            releaseUs = atUs;
+            if (clicks >= timing.maxClicks) {
+                publish(GESTURE_CLICK, clicks, atUs);
+                clicks = 0;
+                state = STATE_IDLE;
+            } else {
+                state = STATE_WAIT_NEXT;
+            }
+            break;
+        case STATE_HOLDING:
+            publish(GESTURE_LONG_RELEASE, repeats, atUs);
+            state = STATE_IDLE;
+            break;
+        default:
+            break;
+    }
+}
+
+void ButtonGestureRecognizer::publish(ButtonGesture gesture, uint8_t count, uint64_t atUs) {
+    if ((uint8_t)(eventHead - eventTail) >= BUTTON_EVENT_QUEUE_SIZE) {
+        eventOverflows++;
+        return;
+    }
+    events[eventHead & (BUTTON_EVENT_QUEUE_SIZE - 1)] = {gesture, count, atUs};
+    eventHead++;
+}
+
+bool ButtonGestureRecognizer::nextEvent(ButtonEvent& event) {
+    if (eventTail == eventHead) {
+        return false;
+    }
+    event = events[eventTail & (BUTTON_EVENT_QUEUE_SIZE - 1)];
+    eventTail++;
+    return true;
+}
@@ -1,6 +1,14 @@
 #include "hardware.h"
 #include "menu.h"
 #include "time_manager.h"
+#include "training_record_store.h"
+#include "training_log.h"
+#include "littlefs_log_storage.h"
+#include "training_stats.h"
+#include "trend_plot.h"
+#include "settings_store.h"
+#include "clock.h"
+#include "trace_capture.h"
 
 // 外部函数声明
 extern const char* getPairingStatusString(PairingStatus status);
@@ -23,82 +31,173 @@ SystemSettings systemSettings = {
     .hasPairedDevice = false
 };
 
-// 训练数据存储
-static TrainingRecord trainingRecords[MAX_TRAINING_RECORDS];
-static int recordCount = 0;
+// 训练统计数据（记录本身保存在 recordStore 环形存储中）
 static TrainingStats trainingStats;
 
+// 训练日志（LittleFS持久化）
+static LittleFsLogStorage logStorage;
+TrainingLog trainingLog(logStorage);
+
 HardwareManager::HardwareManager() 
-    : u8g2(U8G2_R0, /* reset=*/ U8X8_PIN_NONE, /* clock=*/ OLED_SCL_PIN, /* data=*/ OLED_SDA_PIN),
-      lastVibrationTime(0) {}
+    : u8g2(display.driver()),
+      lastVibrationTime(0),
+      battery(BatteryConfig{BATTERY_DIVIDER_X100, BATTERY_INTERNAL_MOHM, BATTERY_CAPACITY_MAH}),
+      lastBatterySampleUs(0),
+      lastBuzzerMs(0) {
+    clearConeBatteries();
+}
 
 bool HardwareManager::init() {
+    if (!initCore() || !initOutputs()) {
+        return false;
+    }
+    initializeTrainingData();
+    return true;
+}
+
+bool HardwareManager::initCore() {
     // 初始化按钮引脚 - GPIO5高电平触发按钮，使用内部下拉电阻
     pinMode(BUTTON_PIN, INPUT_PULLDOWN);
     Serial.println("按钮引脚初始化完成（高电平触发）");
     
     // 初始化震动传感器引脚 (常闭开关量传感器，使用内部上拉电阻)
-    pinMode(VIBRATION_SENSOR_PIN, INPUT_PULLUP);
-    Serial.println("震动传感器引脚初始化完成（常闭开关量传感器）");
+    if (!sensor.begin()) {
+        Serial.println("震动传感器初始化失败");
+        return false;
+    }
+    Serial.println("震动传感器初始化完成");
+#if VIBRATION_SENSOR_TYPE == 1
+    traceCapture.begin(VIBRATION_SENSOR_PIN, TRACE_KIND_SAMPLES, ImpactSensor::sampleRateHz, VIBRATION_DEBOUNCE_MS);
+#else
+    traceCapture.begin(VIBRATION_SENSOR_PIN, TRACE_KIND_EDGES, 0, VIBRATION_DEBOUNCE_MS);
+#endif
     
     // 初始化蜂鸣器引脚
-    pinMode(BUZZER_PIN, OUTPUT);
+    buzzer.begin();
     Serial.println("蜂鸣器引脚初始化完成");
     
-    // 初始化LED
-    FastLED.addLeds<NEOPIXEL, LED_PIN>(leds, LED_COUNT);
-    FastLED.setBrightness(LED_BRIGHTNESS);
-    setAllLEDs(COLOR_BLACK);
-    showLEDs();
-    Serial.println("LED初始化完成");
+    // 加载持久化设置（需在确定设备角色之前完成）
+    loadSettings();
+    
+    return true;
+}
 
+bool HardwareManager::initOutputs() {
+    // 初始化LED，亮度沿用已加载的设置；输出级做伽马校正并限制整条灯带电流
+    leds.setGamma(LED_GAMMA_ENABLED);
+    leds.setCurrentBudget(LED_CURRENT_BUDGET_MA);
+    leds.begin((systemSettings.ledBrightness * 255) / 100);
+    Serial.println("LED初始化完成");
+    
     // 初始化显示屏
-    u8g2.begin();
-    u8g2.enableUTF8Print();
+    if (!display.begin()) {
+        Serial.println("显示屏初始化失败");
+        return false;
+    }
     displayInit();
     Serial.println("显示屏初始化完成");
-
-    // 初始化训练数据
-    initializeTrainingData();
     
     return true;
 }
 
 void HardwareManager::update() {
     updateVibration();
+    traceCapture.service();
+    updateBattery();
 }
 
-void HardwareManager::setLED(int index, uint32_t color) {
-    if (index >= 0 && index < LED_COUNT) {
-        leds[index] = color;
+void HardwareManager::updateBattery() {
+#if VIBRATION_SENSOR_TYPE == 1
+    // 模拟冲击传感器以连续模式占用ADC1，不能穿插单次读取
+    return;
+#else
+    if (battery.valid() && !Clock::hasElapsed(lastBatterySampleUs, BATTERY_SAMPLE_INTERVAL_MS * 1000ULL)) {
+        return;
     }
+    lastBatterySampleUs = Clock::nowUs();
+    
+    // 负载按采样时刻的LED显示内容估算，用于补偿内阻压降
+    uint16_t loadMa = BATTERY_BASE_LOAD_MA + leds.drawMilliamps();
+    int previous = batteryPercent();
+    battery.addSample(batteryReadPinMv(BATTERY_ADC_PIN, BATTERY_OVERSAMPLE), loadMa);
+    if (battery.percent() != previous) {
+        uint32_t minutes = battery.remainingMinutes();
+        Serial.printf("电池: %u mV, %u%%, 平均负载 %u mA, 预计剩余 %lu小时%lu分\n",
+                     battery.cellMv(), battery.percent(), battery.averageLoadMa(),
+                     (unsigned long)(minutes / 60), (unsigned long)(minutes % 60));
+    }
+#endif
 }
 
-void HardwareManager::setAllLEDs(uint32_t color) {
-    for (int i = 0; i < LED_COUNT; ++i) {
-        setLED(i, color);
+int HardwareManager::batteryPercent() const {
+    return battery.valid() ? battery.percent() : BATTERY_UNKNOWN;
+}
+
+uint32_t HardwareManager::remainingMah() const {
+    int percent = batteryPercent();
+    if (percent != BATTERY_UNKNOWN) {
+        return (uint32_t)percent * BATTERY_CAPACITY_MAH / 100;
+    }
+    uint32_t usedMah = energyAccount.totalMicroAmpHours() / 1000;
+    return usedMah < BATTERY_CAPACITY_MAH ? BATTERY_CAPACITY_MAH - usedMah : 0;
+}
+
+void HardwareManager::sampleEnergy(EnergyAccount& account, uint64_t nowUs) {
+    account.setLeds(nowUs, StatusLeds::count, leds.outputChannelTotal(), 255);
+    // OLED电流随对比度（段驱动电流）变化
+    account.setOled(nowUs, display.isOn(), display.litPermille() * display.contrastLevel() / DISPLAY_CONTRAST_FULL);
+    uint32_t played = buzzer.playedMs();
+    account.addBuzzer(played - lastBuzzerMs);
+    lastBuzzerMs = played;
+}
+
+void HardwareManager::setConeBattery(uint8_t cone, int percent) {
+    if (cone < BATTERY_SHOWN_CONES) {
+        coneBatteries[cone] = (int8_t)percent;
+    }
+}
+
+void HardwareManager::clearConeBatteries() {
+    for (uint8_t i = 0; i < BATTERY_SHOWN_CONES; i++) {
+        coneBatteries[i] = BATTERY_UNKNOWN;
+    }
+}
+
+int HardwareManager::coneBattery(uint8_t cone) const {
+    if (cone == CONE_ID) {
+        return batteryPercent();
     }
+    return cone < BATTERY_SHOWN_CONES ? coneBatteries[cone] : BATTERY_UNKNOWN;
+}
+
+void HardwareManager::setLED(int index, uint32_t color) {
+    leds.set(index, color);
+}
+
+void HardwareManager::setAllLEDs(uint32_t color) {
+    leds.fill(color);
 }
 
 void HardwareManager::clearLEDs() {
-    setAllLEDs(COLOR_BLACK);
+    leds.clear();
 }
 
 void HardwareManager::showLEDs() {
-    FastLED.show();
+    leds.show();
+}
+
+void HardwareManager::setLedBrightness(uint8_t percent) {
+    // 亮度在输出级生效，重新输出当前画面使更改立即可见
+    leds.setBrightness((percent * 255) / 100);
+    leds.show();
 }
 
 void HardwareManager::ledProgressBar(int progress, uint32_t color) {
-    int filled = (LED_COUNT * progress) / 100;
-    setAllLEDs(COLOR_BLACK);
-    for (int i = 0; i < filled; ++i) {
-        setLED(i, color);
-    }
-    showLEDs();
+    leds.progress(progress, color);
 }
 
 void HardwareManager::ledBreathingEffect(uint32_t color) {
-    // 呼吸灯效果
+    leds.breathe(color, Clock::nowUs());
 }
 
 void HardwareManager::ledAlertEffect() {
@@ -111,73 +210,98 @@ void HardwareManager::ledAlertEffect() {
 }
 
 bool HardwareManager::isVibrationDetected() {
-    static bool lastState = HIGH;  // 常闭传感器正常状态为HIGH
-    static unsigned long lastTriggerTime = 0;
-    
-    // 读取数字量状态
-    bool currentState = digitalRead(VIBRATION_SENSOR_PIN);
-    
-    // 每次都输出当前状态用于调试
-    static unsigned long lastDebugTime = 0;
-    if (millis() - lastDebugTime > 100) {  // 每100ms输出一次状态变化
+    uint64_t now = Clock::nowUs();
+    uint32_t rejected = sensor.rejectedEdges();
+    bool lastState = sensor.previousLevel();
+    bool triggered = sensor.poll(now);
+    
+    // 每100ms输出一次状态用于调试
+    static uint64_t lastDebugTime = 0;
+    if (now - lastDebugTime > 100000ULL) {
         Serial.printf("主机震动检测调试: lastState=%s, currentState=%s\n", 
-                     lastState ? "HIGH" : "LOW", currentState ? "HIGH" : "LOW");
-        lastDebugTime = millis();
+                     lastState ? "HIGH" : "LOW", sensor.previousLevel() ? "HIGH" : "LOW");
+        lastDebugTime = now;
     }
     
-    // 检测从HIGH到LOW的下降沿（震动触发）
-    if (lastState == HIGH && currentState == LOW) {
-        Serial.printf("主机检测到边沿变化: HIGH->LOW, 防抖检查中...\n");
-        
-        // 防抖检查
-        if (millis() - lastTriggerTime > VIBRATION_DEBOUNCE_MS) {
-            lastTriggerTime = millis();
-            lastState = currentState;
-            
-            Serial.printf("*** 主机震动检测到! 传感器状态: HIGH->LOW ***\n");
-            
-            // 震动检测视觉反馈
-            setAllLEDs(COLOR_RED);
-            showLEDs();
-            playStartSound();
-            delay(100);
-            clearLEDs();
-            showLEDs();
-            
-            return true;
-        } else {
-            Serial.printf("主机防抖未通过: 距离上次触发仅 %lu ms\n", millis() - lastTriggerTime);
-        }
+    if (sensor.rejectedEdges() != rejected) {
+        Serial.printf("主机防抖未通过: 距离上次触发仅 %lu ms\n",
+                     (unsigned long)((now - sensor.lastTriggerMicros()) / 1000));
+    }
+    if (!triggered) {
+        return false;
     }
     
-    lastState = currentState;
-    return false;
+    Serial.printf("*** 主机震动检测到! 传感器状态: HIGH->LOW ***\n");
+    wakeDisplay();
+    
+    // 震动检测视觉反馈
+    setAllLEDs(COLOR_RED);
+    showLEDs();
+    playStartSound();
+    delay(100);
+    clearLEDs();
+    showLEDs();
+    
+    return true;
 }
 
 int HardwareManager::getVibrationStrength() {
+#if VIBRATION_SENSOR_TYPE == 1
+    // 模拟传感器返回最近一次冲击的力度 (0-100)
+    return sensor.strength();
+#else
     // 对于开关量传感器，返回数字状态 (HIGH=1, LOW=0)
-    return digitalRead(VIBRATION_SENSOR_PIN) ? 1 : 0;
+    return sensor.level() ? 1 : 0;
+#endif
 }
 
 
 void HardwareManager::beep(int frequency, int duration) {
-    tone(BUZZER_PIN, frequency, duration);
+    buzzer.beep(frequency, duration);
 }
 
 void HardwareManager::playStartSound() {
-    beep(1000, 200);
+    buzzer.play(TUNE_START);
 }
 
 void HardwareManager::playCompleteSound() {
-    beep(2000, 200);
+    buzzer.play(TUNE_COMPLETE);
 }
 
 void HardwareManager::playErrorSound() {
-    beep(400, 500);
+    buzzer.play(TUNE_ERROR);
 }
 
 void HardwareManager::playAlertSound() {
-    beep(1500, 100);
+    buzzer.play(TUNE_ALERT);
+}
+
+// 各系统状态下的显示屏空闲超时（ms，0为不进入）
+//   计时中只调暗不关闭：调暗/恢复只是一条对比度命令，唤醒时不会在触发检测的循环里补发整帧
+static const DisplayIdleTimeouts kDisplayIdleTimeouts[STATE_COUNT] = {
+    {0, 0},             // STATE_INIT
+    {30000, 120000},    // STATE_MENU
+    {20000, 90000},     // STATE_READY
+    {15000, 0},         // STATE_TRAINING
+    {15000, 0},         // STATE_TIMING
+    {20000, 60000},     // STATE_COMPLETE
+    {0, 0},             // STATE_ERROR
+};
+
+bool HardwareManager::wakeDisplay() {
+    // 只记录活动，I2C命令在serviceDisplay()中发出
+    bool wasOff = display.powerState() == DISPLAY_OFF;
+    display.wake(Clock::nowUs());
+    return wasOff;
+}
+
+void HardwareManager::serviceDisplay(SystemState state, bool timingRound) {
+    display.setIdleTimeouts(kDisplayIdleTimeouts[timingRound ? STATE_TIMING : state]);
+    if (display.service(Clock::nowUs())) {
+        static const char* const names[] = {"点亮", "调暗", "关闭"};
+        Serial.printf("显示屏: %s (跳过未变帧 %lu)\n", names[display.powerState()],
+                     (unsigned long)display.skippedFrames());
+    }
 }
 
 void HardwareManager::displayInit() {
@@ -196,12 +320,12 @@ void HardwareManager::displayText(const char* text, int x, int y, int size) {
     // 如果x为负值，表示需要居中显示
     if (x < 0) {
         int textWidth = u8g2.getUTF8Width(text);
-        x = (128 - textWidth) / 2;  // 128是OLED屏幕宽度
+        x = (OledDisplay::width - textWidth) / 2;
     }
     
     u8g2.setCursor(x, y);
     u8g2.print(text);
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::displayTextCentered(const char* text, int y) {
@@ -209,11 +333,11 @@ void HardwareManager::displayTextCentered(const char* text, int y) {
     
     // 自动计算居中位置
     int textWidth = u8g2.getUTF8Width(text);
-    int x = (128 - textWidth) / 2;
+    int x = (OledDisplay::width - textWidth) / 2;
     
     u8g2.setCursor(x, y);
     u8g2.print(text);
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::displayMainMenu(const char* items[], int selectedIndex, int itemCount) {
@@ -222,9 +346,10 @@ void HardwareManager::displayMainMenu(const char* items[], int selectedIndex, in
     // 显示主标题 - 居中显示
     const char* title = "智能训练锥";
     int titleWidth = u8g2.getUTF8Width(title);
-    int titleX = (128 - titleWidth) / 2;  // 128是OLED屏幕宽度
+    int titleX = (OledDisplay::width - titleWidth) / 2;
     u8g2.setCursor(titleX, 12);
     u8g2.print(title);
+    drawConeBatteries();
     
     // 显示菜单选项，居中显示
     for (int i = 0; i < itemCount; ++i) {
@@ -236,7 +361,7 @@ void HardwareManager::displayMainMenu(const char* items[], int selectedIndex, in
         
         // 计算文本宽度用于居中
         int textWidth = u8g2.getUTF8Width(menuText);
-        int textX = (128 - textWidth) / 2;
+        int textX = (OledDisplay::width - textWidth) / 2;
         
         if (i == selectedIndex) {
             // 选中项的特殊显示效果
@@ -251,7 +376,24 @@ void HardwareManager::displayMainMenu(const char* items[], int selectedIndex, in
             u8g2.print(menuText);
         }
     }
-    u8g2.sendBuffer();
+    display.flush();
+}
+
+// 标题两侧的小字电量：锥桶0、1在左，2、3在右，未知的不显示
+void HardwareManager::drawConeBatteries() {
+    u8g2.setFont(u8g2_font_4x6_tf);
+    for (uint8_t cone = 0; cone < BATTERY_SHOWN_CONES; cone++) {
+        int percent = coneBattery(cone);
+        if (percent == BATTERY_UNKNOWN) {
+            continue;
+        }
+        char text[8];
+        snprintf(text, sizeof(text), "%u:%d%%", cone, percent);
+        int x = cone < 2 ? 0 : OledDisplay::width - u8g2.getStrWidth(text);
+        u8g2.setCursor(x, 6 + (cone % 2) * 7);
+        u8g2.print(text);
+    }
+    u8g2.setFont(u8g2_font_wqy12_t_gb2312a);
 }
 
 void HardwareManager::displayMenu(const char* items[], int selectedIndex, int itemCount) {
@@ -272,7 +414,7 @@ void HardwareManager::displayMenu(const char* items[], int selectedIndex, int it
             u8g2.print(items[i]);
         }
     }
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::displayTimer(unsigned long time) {
@@ -285,27 +427,27 @@ void HardwareManager::displayStatus(const char* status) {
     displayText(status, -1, 35);  // 使用-1表示居中显示
 }
 
-void HardwareManager::displayResult(unsigned long time, const char* result) {
+void HardwareManager::displayResult(uint32_t ticks, const char* result) {
     displayClear();
     
-    // 显示时间 - 居中
+    // 显示时间 - 居中，0.1ms分辨率
     char buf[32];
-    sprintf(buf, "时间: %.3f 秒", time / 1000.0);
+    sprintf(buf, "时间: %.4f 秒", ticks / 10000.0);
     int timeWidth = u8g2.getUTF8Width(buf);
-    int timeX = (128 - timeWidth) / 2;
+    int timeX = (OledDisplay::width - timeWidth) / 2;
     u8g2.setCursor(timeX, 20);
     u8g2.print(buf);
     
     // 显示结果 - 居中
     int resultWidth = u8g2.getUTF8Width(result);
-    int resultX = (128 - resultWidth) / 2;
+    int resultX = (OledDisplay::width - resultWidth) / 2;
     u8g2.setCursor(resultX, 40);
     u8g2.print(result);
     
     // 添加装饰线
     u8g2.drawHLine(10, 50, 108);
     
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::updateVibration() {
@@ -330,7 +472,7 @@ void HardwareManager::displayTrainingStatus(unsigned long totalTime, unsigned lo
     u8g2.setFont(u8g2_font_wqy12_t_gb2312a);
     const char* title = "训练中...";
     int titleWidth = u8g2.getUTF8Width(title);
-    u8g2.setCursor((128 - titleWidth) / 2, 12);
+    u8g2.setCursor((OledDisplay::width - titleWidth) / 2, 12);
     u8g2.print(title);
     
     // 实时训练状态指示器 - 闪烁圆点
@@ -350,7 +492,7 @@ void HardwareManager::displayTrainingStatus(unsigned long totalTime, unsigned lo
     unsigned long totalSeconds = totalTime / 1000;
     sprintf(totalBuf, "总时长: %02lu:%02lu:%02lu", totalSeconds / 3600, (totalSeconds % 3600) / 60, totalSeconds % 60);
     int totalWidth = u8g2.getUTF8Width(totalBuf);
-    u8g2.setCursor((128 - totalWidth) / 2, 28);
+    u8g2.setCursor((OledDisplay::width - totalWidth) / 2, 28);
     u8g2.print(totalBuf);
     
     // 上次用时显示 - 居中对齐
@@ -361,7 +503,7 @@ void HardwareManager::displayTrainingStatus(unsigned long totalTime, unsigned lo
         sprintf(lastBuf, "上次: --.-秒");
     }
     int lastWidth = u8g2.getUTF8Width(lastBuf);
-    u8g2.setCursor((128 - lastWidth) / 2, 40);
+    u8g2.setCursor((OledDisplay::width - lastWidth) / 2, 40);
     u8g2.print(lastBuf);
     
     // 动画进度条 - 居中
@@ -370,7 +512,7 @@ void HardwareManager::displayTrainingStatus(unsigned long totalTime, unsigned lo
     
     // 进度条背景 - 居中对齐
     int progressBarWidth = 100;
-    int progressBarX = (128 - progressBarWidth) / 2;
+    int progressBarX = (OledDisplay::width - progressBarWidth) / 2;
     u8g2.drawFrame(progressBarX, 47, progressBarWidth, 8);
     
     // 动态进度条 - 基于训练时长的活跃度
@@ -392,11 +534,11 @@ void HardwareManager::displayTrainingStatus(unsigned long totalTime, unsigned lo
     u8g2.setFont(u8g2_font_5x7_tf);
     const char* statusText = "等待运动检测...";
     int statusWidth = u8g2.getUTF8Width(statusText);
-    u8g2.setCursor((128 - statusWidth) / 2, 63);
+    u8g2.setCursor((OledDisplay::width - statusWidth) / 2, 63);
     u8g2.print(statusText);
     
     u8g2.setFont(u8g2_font_wqy12_t_gb2312a); // 恢复默认字体
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::displayTrainingDetailedStatus(float currentTime, int sessionCount, bool isConnected, int batteryLevel, int signalStrength, bool isMaster) {
@@ -407,14 +549,14 @@ void HardwareManager::displayTrainingDetailedStatus(float currentTime, int sessi
     char timeStr[16];
     sprintf(timeStr, "%.3f", currentTime);
     int timeWidth = u8g2.getStrWidth(timeStr);
-    u8g2.setCursor((128 - timeWidth) / 2, 25);
+    u8g2.setCursor((OledDisplay::width - timeWidth) / 2, 25);
     u8g2.print(timeStr);
     
     // "秒" 字 - 小字体，居中
     u8g2.setFont(u8g2_font_6x10_tf);
     const char* unit = "秒";
     int unitWidth = u8g2.getUTF8Width(unit);
-    u8g2.setCursor((128 - unitWidth) / 2, 37);
+    u8g2.setCursor((OledDisplay::width - unitWidth) / 2, 37);
     u8g2.print(unit);
     
     // 状态栏信息
@@ -424,24 +566,30 @@ void HardwareManager::displayTrainingDetailedStatus(float currentTime, int sessi
     // 设备角色居中显示
     const char* role = isMaster ? "MASTER" : "SLAVE";
     int roleWidth = u8g2.getStrWidth(role);
-    u8g2.setCursor((128 - roleWidth) / 2, 50);
+    u8g2.setCursor((OledDisplay::width - roleWidth) / 2, 50);
     u8g2.print(role);
     
     // 连接状态
     const char* connStatus = isConnected ? "连接OK" : "未连接";
     int connWidth = u8g2.getUTF8Width(connStatus);
-    u8g2.setCursor(128 - connWidth - 5, 50);
+    u8g2.setCursor(OledDisplay::width - connWidth - 5, 50);
     u8g2.print(connStatus);
     
-    // 电池电量显示
+    // 电池电量显示（未测得时只画外框）
     u8g2.drawFrame(10, 57, 20, 6);
-    int batteryBarWidth = (batteryLevel * 18) / 100;
-    u8g2.drawBox(11, 58, batteryBarWidth, 4);
+    if (batteryLevel != BATTERY_UNKNOWN) {
+        int batteryBarWidth = (batteryLevel * 18) / 100;
+        u8g2.drawBox(11, 58, batteryBarWidth, 4);
+    }
     
     // 电池电量百分比
     u8g2.setFont(u8g2_font_4x6_tf);
     u8g2.setCursor(35, 62);
-    u8g2.printf("%d%%", batteryLevel);
+    if (batteryLevel != BATTERY_UNKNOWN) {
+        u8g2.printf("%d%%", batteryLevel);
+    } else {
+        u8g2.print("--");
+    }
     
     // 信号强度指示器
     u8g2.setFont(u8g2_font_6x10_tf);
@@ -461,70 +609,65 @@ void HardwareManager::displayTrainingDetailedStatus(float currentTime, int sessi
     u8g2.print("WiFi");
     
     u8g2.setFont(u8g2_font_wqy12_t_gb2312a); // 恢复默认字体
-    u8g2.sendBuffer();
+    display.flush();
 }
 
-void HardwareManager::displayHistoryData() {
-    displayClear();
+void HardwareManager::displayHistoryData(HistoryRange range) {
+    static const uint16_t rangeDays[HISTORY_RANGE_COUNT] = {7, 30, 90};
+    static const char* rangeLabels[HISTORY_RANGE_COUNT] = {"7天", "30天", "90天"};
+    uint16_t days = rangeDays[range];
     
-    // 标题：训练统计 (居中显示)  
-    const char* title = "训练统计";
-    int titleWidth = u8g2.getUTF8Width(title);
-    u8g2.setCursor((128 - titleWidth) / 2, 12);
-    u8g2.print(title);
-    
-    // 计算统计数据
-    calculateTrainingStats();
-    
-    // 使用小字体显示统计数据
-    u8g2.setFont(u8g2_font_6x10_tf);
-    
-    // 总时长显示 (格式: HH:MM:SS) - 左对齐
-    uint32_t totalHours = trainingStats.totalTrainingTime / 3600000;
-    uint32_t totalMinutes = (trainingStats.totalTrainingTime % 3600000) / 60000;
-    uint32_t totalSeconds = (trainingStats.totalTrainingTime % 60000) / 1000;
+    // 所有数据来自statsEngine的日统计桶，切换范围不扫描原始记录
+    uint32_t today = timeManager.isTimeValid() ? statsEngine.dayOf((uint32_t)timeManager.getUnixTime())
+                                               : statsEngine.latestDay();
+    StatsRange summary;
+    StatsTrend trend;
+    statsEngine.range(today, days, summary);
+    statsEngine.trend(today, days, trend);
     
-    u8g2.setCursor(10, 28);
-    u8g2.printf("总时长: %02lu:%02lu:%02lu", totalHours, totalMinutes, totalSeconds);
-    
-    // 平均时间显示 (格式: X.XXXs) - 同行右侧
-    u8g2.setCursor(10, 40);
-    if (trainingStats.averageTime > 0) {
-        u8g2.printf("平均: %.3fs", trainingStats.averageTime / 1000.0);
-    } else {
-        u8g2.print("平均: --.-s");
-    }
-    
-    // 本周进步显示 (带箭头图标) - 左对齐
-    u8g2.setCursor(10, 52);
-    const char* progressIcon = trainingStats.progressIncreasing ? "↑" : "↓";
-    u8g2.printf("本周进步: %s%.1f%%", progressIcon, abs((int)trainingStats.weeklyProgress) / 100.0);
-    
-    // 绘制简单趋势图 (折线图) - 原始位置
-    // 模拟8个数据点的趋势线
-    int graphPoints[][2] = {{10,58}, {25,56}, {40,53}, {55,51}, {70,49}, {85,46}, {100,44}, {115,41}};
+    displayClear();
     
-    // 绘制折线
-    for (int i = 0; i < 7; i++) {
-        u8g2.drawLine(graphPoints[i][0], graphPoints[i][1], graphPoints[i+1][0], graphPoints[i+1][1]);
+    // 标题与范围
+    u8g2.setCursor(0, 12);
+    u8g2.print("训练统计");
+    int labelWidth = u8g2.getUTF8Width(rangeLabels[range]);
+    u8g2.setCursor(OledDisplay::width - labelWidth, 12);
+    u8g2.print(rangeLabels[range]);
+    
+    if (summary.completed == 0) {
+        const char* empty = "暂无数据";
+        u8g2.setCursor((OledDisplay::width - u8g2.getUTF8Width(empty)) / 2, 42);
+        u8g2.print(empty);
+        display.flush();
+        return;
     }
     
-    // 绘制数据点
-    for (int i = 0; i < 8; i++) {
-        u8g2.drawDisc(graphPoints[i][0], graphPoints[i][1], 1);
-    }
+    // 范围内平均与最佳用时
+    u8g2.setCursor(0, 26);
+    u8g2.printf("平均%.2fs 最佳%.2fs", summary.meanMs / 1000.0, summary.bestMs / 1000.0);
     
-    // 坐标轴
-    u8g2.drawHLine(10, 63, 108);
+    // 每日中位数折线，直接光栅化到帧缓冲区
+    const PlotArea area = {22, 31, 105, 26};
+    FrameBuffer fb = {u8g2.getBufferPtr(), OledDisplay::width, OledDisplay::height};
+    uint32_t minMs = 0, maxMs = 0;
+    plotTrend(fb, area, trend.medianMs, trend.count, &minMs, &maxMs);
+    plotLine(fb, area.x, area.y + area.height, area.x + area.width - 1, area.y + area.height);
     
-    // 底部标签 - 原始位置
+    // 纵轴标注（秒）
     u8g2.setFont(u8g2_font_4x6_tf);
-    u8g2.setCursor(58, 63);
-    u8g2.print("本周趋势");
-    
+    u8g2.setCursor(0, area.y + 5);
+    u8g2.printf("%.1fs", maxMs / 1000.0);
+    u8g2.setCursor(0, area.y + area.height);
+    u8g2.printf("%.1fs", minMs / 1000.0);
+    u8g2.setCursor(area.x, 64);
+    if (trend.daysPerPoint > 1) {
+        u8g2.printf("median/%dd", trend.daysPerPoint);
+    } else {
+        u8g2.print("median/day");
+    }
     u8g2.setFont(u8g2_font_wqy12_t_gb2312a); // 恢复默认字体
     
-    u8g2.sendBuffer();
+    display.flush();
 }
 
 void HardwareManager::displaySystemSettings() {
@@ -549,7 +692,7 @@ void HardwareManager::displaySystemSettings() {
     u8g2.setCursor(5, 60);
     u8g2.print("灯环: [ 红 ] [ 绿 ] [ 蓝 ] [ 黄 ]");
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.println("系统设置页面");
 #endif
@@ -565,7 +708,7 @@ void HardwareManager::displaySystemSettingsMenu(int selectedIndex) {
     // 显示标题
     const char* title = "系统设置";
     int titleWidth = u8g2.getUTF8Width(title);
-    int titleX = (128 - titleWidth) / 2;
+    int titleX = (OledDisplay::width - titleWidth) / 2;
     u8g2.setCursor(titleX, 12);
     u8g2.print(title);
     
@@ -583,6 +726,7 @@ void HardwareManager::displaySystemSettingsMenu(int selectedIndex) {
         "日期时间",
         "达标提醒",
         "设备配对",
+        "能耗统计",
         "返回"
     };
     
@@ -604,7 +748,7 @@ void HardwareManager::displaySystemSettingsMenu(int selectedIndex) {
         
         // 计算文本宽度用于居中
         int textWidth = u8g2.getUTF8Width(settingsItems[itemIndex]);
-        int textX = (128 - textWidth) / 2;
+        int textX = (OledDisplay::width - textWidth) / 2;
         
         if (itemIndex == selectedIndex) {
             // 选中项背景 - 根据文本宽度调整背景框
@@ -647,7 +791,7 @@ void HardwareManager::displaySystemSettingsMenu(int selectedIndex) {
         u8g2.printf("%d/%d", selectedIndex + 1, SETTING_ITEM_COUNT);
     }
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.println("系统设置菜单");
 #endif
@@ -663,7 +807,7 @@ void HardwareManager::displaySystemSettingsDetail(SettingsItems item, int value)
                 // 标题居中
                 const char* title = "声音设置";
                 int titleWidth = u8g2.getUTF8Width(title);
-                int titleX = (128 - titleWidth) / 2;
+                int titleX = (OledDisplay::width - titleWidth) / 2;
                 u8g2.setCursor(titleX, 12);
                 u8g2.print(title);
                 
@@ -696,12 +840,16 @@ void HardwareManager::displaySystemSettingsDetail(SettingsItems item, int value)
             displayAlertDurationAdjustment(systemSettings.alertDuration);
             return;
             
+        case SETTING_ENERGY_REPORT:
+            displayEnergyReport(energyAccount);
+            return;
+            
         case SETTING_DEVICE_PAIRING:
             {
                 // 标题居中
                 const char* title = "设备配对";
                 int titleWidth = u8g2.getUTF8Width(title);
-                int titleX = (128 - titleWidth) / 2;
+                int titleX = (OledDisplay::width - titleWidth) / 2;
                 u8g2.setCursor(titleX, 12);
                 u8g2.print(title);
                 
@@ -727,12 +875,52 @@ void HardwareManager::displaySystemSettingsDetail(SettingsItems item, int value)
             break;
     }
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.println("设置详情页面");
 #endif
 }
 
+// 能耗统计页：各子系统本会话耗电(mAh)、平均电流和续航预测
+void HardwareManager::displayEnergyReport(const EnergyAccount& account) {
+#ifdef FORCE_MASTER_ROLE
+    displayClear();
+    
+    const char* title = "能耗统计";
+    int titleWidth = u8g2.getUTF8Width(title);
+    u8g2.setCursor((OledDisplay::width - titleWidth) / 2, 12);
+    u8g2.print(title);
+    
+    // 两列三行：各子系统mAh
+    static const char* const labels[ENERGY_RAIL_COUNT] = {"CPU", "RX", "TX", "LED", "OLED", "BUZ"};
+    u8g2.setFont(u8g2_font_5x7_tf);
+    for (uint8_t rail = 0; rail < ENERGY_RAIL_COUNT; rail++) {
+        uint32_t used = account.microAmpHours((EnergyRail)rail);
+        u8g2.setCursor((rail % 2) * 64 + 2, 22 + (rail / 2) * 8);
+        u8g2.printf("%-4s%4lu.%lu", labels[rail], (unsigned long)(used / 1000), (unsigned long)(used % 1000 / 100));
+    }
+    
+    // 合计、平均电流和按当前电量的续航预测
+    uint32_t total = account.totalMicroAmpHours();
+    uint32_t minutes = account.projectedMinutes(remainingMah());
+    u8g2.setCursor(2, 48);
+    u8g2.printf("SUM %lu.%lumAh AVG %lumA", (unsigned long)(total / 1000), (unsigned long)(total % 1000 / 100),
+                (unsigned long)(account.averageMicroAmps() / 1000));
+    u8g2.setCursor(2, 56);
+    u8g2.printf("LEFT %luh%02lum  T %lumin", (unsigned long)(minutes / 60), (unsigned long)(minutes % 60),
+                (unsigned long)(account.sessionUs() / 60000000ULL));
+    
+    u8g2.setFont(u8g2_font_4x6_tf);
+    u8g2.setCursor(2, 63);
+    u8g2.print("CLICK:REFRESH  DOUBLE:RESET");
+    
+    u8g2.setFont(u8g2_font_wqy12_t_gb2312a); // 恢复默认字体
+    display.flush();
+#else
+    Serial.println("能耗统计页面");
+#endif
+}
+
 void HardwareManager::displayLedColorSelection(LedColorOption selectedColor) {
 #ifdef FORCE_MASTER_ROLE
     displayClear();
@@ -740,7 +928,7 @@ void HardwareManager::displayLedColorSelection(LedColorOption selectedColor) {
     // 标题居中
     const char* title = "LED颜色";
     int titleWidth = u8g2.getUTF8Width(title);
-    int titleX = (128 - titleWidth) / 2;
+    int titleX = (OledDisplay::width - titleWidth) / 2;
     u8g2.setCursor(titleX, 12);
     u8g2.print(title);
     
@@ -773,7 +961,7 @@ void HardwareManager::displayLedColorSelection(LedColorOption selectedColor) {
     u8g2.setCursor(5, 63);
     u8g2.printf("当前: %s", getLedColorName(selectedColor));
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.println("LED颜色选择页面");
 #endif
@@ -800,7 +988,7 @@ void HardwareManager::displayBrightnessAdjustment(int brightness) {
     u8g2.printf("%d%%", brightness);
     
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.printf("LED亮度调节: %d%%\n", brightness);
 #endif
@@ -827,7 +1015,7 @@ void HardwareManager::displayDateTimeAdjustment(int year, int month, int day, in
     u8g2.setCursor(5, 55);
     u8g2.printf("NTP: %s", timeManager.isTimeValid() ? "已同步" : "未同步");
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.printf("当前时间: %s\n", timeManager.formatTime("%Y-%m-%d %H:%M:%S").c_str());
 #endif
@@ -850,7 +1038,7 @@ void HardwareManager::displayAlertDurationAdjustment(int duration) {
     u8g2.print("连续训练达标时长");
     
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.printf("达标提醒时长: %d 秒\n", duration);
 #endif
@@ -898,7 +1086,7 @@ void HardwareManager::displayDevicePairing(PairingStatus status, DiscoveredDevic
             break;
     }
     
-    u8g2.sendBuffer();
+    display.flush();
 #else
     Serial.printf("设备配对状态: %s\n", getPairingStatusString(status));
     if (status == PAIRING_FOUND_DEVICE && deviceCount > 0) {
@@ -913,9 +1101,7 @@ void HardwareManager::displayDevicePairing(PairingStatus status, DiscoveredDevic
 
 void HardwareManager::initializeSettings() {
     // 初始化系统设置为默认值
-    systemSettings.soundEnabled = DEFAULT_SOUND_ENABLED;
-    systemSettings.ledColor = DEFAULT_LED_COLOR;
-    systemSettings.ledBrightness = DEFAULT_LED_BRIGHTNESS;
+    settingsApplyDefaults(systemSettings);
     
     // 使用时间管理器获取当前时间
     if (timeManager.isTimeValid()) {
@@ -929,8 +1115,6 @@ void HardwareManager::initializeSettings() {
         systemSettings.minute = 0;
     }
     
-    systemSettings.alertDuration = DEFAULT_ALERT_DURATION;
-    
     Serial.println("系统设置初始化完成");
     Serial.printf("当前时间: %04d-%02d-%02d %02d:%02d\n", 
                   systemSettings.year, systemSettings.month, systemSettings.day, 
@@ -938,13 +1122,20 @@ void HardwareManager::initializeSettings() {
 }
 
 void HardwareManager::saveSettings() {
-    // 这里可以添加保存到EEPROM或文件系统的代码
-    Serial.println("系统设置已保存");
+    // 立即提交到NVS（内容未变化时不写入）
+    settingsStore.commit(systemSettings);
 }
 
 void HardwareManager::loadSettings() {
-    // 这里可以添加从EEPROM或文件系统加载的代码
-    Serial.println("系统设置已加载");
+    // 启动时加载一次，之后只在修改时保存
+    initializeSettings();
+    settingsStore.load(systemSettings);
+    
+    setLedBrightness(systemSettings.ledBrightness);
+    Serial.printf("系统设置已加载: 声音=%s, 颜色=%s, 亮度=%d%%, 提醒=%d秒, 配对=%s\n",
+                  systemSettings.soundEnabled ? "开" : "关", getLedColorName(systemSettings.ledColor),
+                  systemSettings.ledBrightness, systemSettings.alertDuration,
+                  systemSettings.hasPairedDevice ? "是" : "否");
 }
 
 SystemSettings* HardwareManager::getSettings() {
@@ -994,229 +1185,167 @@ bool HardwareManager::isButtonLongPressed() {
 }
 
 // 训练数据管理函数实现
-void HardwareManager::addTrainingRecord(uint32_t duration, uint8_t mode, bool completed) {
-    // 如果记录已满，移除最旧的记录
-    if (recordCount >= MAX_TRAINING_RECORDS) {
-        for (int i = 0; i < MAX_TRAINING_RECORDS - 1; i++) {
-            trainingRecords[i] = trainingRecords[i + 1];
-        }
-        recordCount = MAX_TRAINING_RECORDS - 1;
-    }
-    
-    // 添加新记录
-    trainingRecords[recordCount].timestamp = millis();
-    trainingRecords[recordCount].duration = duration;
-    trainingRecords[recordCount].mode = mode;
-    trainingRecords[recordCount].completed = completed;
-    recordCount++;
-    
-    Serial.printf("添加训练记录: 时长=%lums, 模式=%d, 完成=%s\n", 
-                  duration, mode, completed ? "是" : "否");
+void HardwareManager::addTrainingRecord(uint64_t durationUs, uint8_t mode, bool completed) {
+    // 使用壁钟时间标记记录，环形存储满后自动覆盖最旧记录
+    uint8_t flags = 0;
+    if (completed) flags |= RECORD_FLAG_COMPLETED;
+    if (timeManager.isTimeValid()) flags |= RECORD_FLAG_CLOCK_VALID;
+    
+    PackedTrainingRecord record = TrainingRecordStore::pack((uint32_t)timeManager.getUnixTime(), durationUs, mode, flags);
+    recordStore.append(record);
+    statsEngine.add(record, trainingLog.append(record));
+    
+    Serial.printf("添加训练记录: 时长=%.1fms, 模式=%d, 完成=%s (共%lu条)\n", 
+                  TrainingRecordStore::durationUs(record) / 1000.0, mode, completed ? "是" : "否", recordStore.size());
 }
 
 void HardwareManager::calculateTrainingStats() {
-    trainingStats.totalTrainingTime = 0;
-    trainingStats.totalSessions = 0;
-    trainingStats.averageTime = 0;
-    trainingStats.bestTime = UINT32_MAX;
-    
-    // 统计总时长、总次数、最佳时间
-    uint32_t completedCount = 0;
-    uint32_t totalCompletedTime = 0;
-    
-    for (int i = 0; i < recordCount; i++) {
-        trainingStats.totalSessions++;
-        trainingStats.totalTrainingTime += trainingRecords[i].duration;
-        
-        if (trainingRecords[i].completed) {
-            completedCount++;
-            totalCompletedTime += trainingRecords[i].duration;
-            
-            if (trainingRecords[i].duration < trainingStats.bestTime) {
-                trainingStats.bestTime = trainingRecords[i].duration;
-            }
-        }
-    }
-    
-    // 计算平均时间（仅完成的训练）
-    if (completedCount > 0) {
-        trainingStats.averageTime = totalCompletedTime / completedCount;
+    // 统计由statsEngine随每条记录增量维护，这里只读取汇总，与记录数量无关
+    const StatsTotals& totals = statsEngine.totals();
+    trainingStats.totalTrainingTime = totals.totalMs > UINT32_MAX ? UINT32_MAX : (uint32_t)totals.totalMs;
+    trainingStats.totalSessions = totals.rounds;
+    trainingStats.averageTime = statsEngine.meanMs();
+    trainingStats.bestTime = totals.completed > 0 ? totals.bestMs : UINT32_MAX;
+    trainingStats.weeklyProgress = 0;
+    trainingStats.progressIncreasing = false;
+    
+    // 以今天（壁钟无效时以最近有记录的日期）为终点的日历日
+    uint32_t today = timeManager.isTimeValid() ? statsEngine.dayOf((uint32_t)timeManager.getUnixTime())
+                                               : statsEngine.latestDay();
+    
+    // 本周进步：最近7天与之前7天的平均用时对比
+    StatsRange thisWeek, lastWeek;
+    statsEngine.range(today, 7, thisWeek);
+    statsEngine.range(today > 7 ? today - 7 : 0, 7, lastWeek);
+    if (thisWeek.completed > 0 && lastWeek.completed > 0 && lastWeek.meanMs > 0) {
+        // 时间减少表示进步
+        int32_t improvement = ((int32_t)lastWeek.meanMs - (int32_t)thisWeek.meanMs) * 10000 / (int32_t)lastWeek.meanMs;
+        trainingStats.weeklyProgress = abs(improvement);
+        trainingStats.progressIncreasing = improvement > 0;
     }
     
-    // 计算本周进步 (简化版，使用最近几次的数据)
-    if (recordCount >= 4) {
-        uint32_t oldAvg = 0, newAvg = 0;
-        int oldCount = 0, newCount = 0;
-        
-        // 前半部分作为"旧"数据
-        for (int i = 0; i < recordCount / 2; i++) {
-            if (trainingRecords[i].completed) {
-                oldAvg += trainingRecords[i].duration;
-                oldCount++;
-            }
-        }
-        
-        // 后半部分作为"新"数据
-        for (int i = recordCount / 2; i < recordCount; i++) {
-            if (trainingRecords[i].completed) {
-                newAvg += trainingRecords[i].duration;
-                newCount++;
-            }
-        }
-        
-        if (oldCount > 0 && newCount > 0) {
-            oldAvg /= oldCount;
-            newAvg /= newCount;
-            
-            if (oldAvg > 0) {
-                // 时间减少表示进步
-                int32_t improvement = ((int32_t)oldAvg - (int32_t)newAvg) * 10000 / oldAvg;
-                trainingStats.weeklyProgress = abs(improvement);
-                trainingStats.progressIncreasing = improvement > 0;
-            }
+    // 最近7个日历日的平均用时，最早的一天在前
+    for (int i = 0; i < 7; i++) {
+        uint32_t day = today >= (uint32_t)(6 - i) ? today - (6 - i) : 0;
+        const StatsDayBucket* bucket = statsEngine.day(day);
+        if (bucket && bucket->completed > 0) {
+            trainingStats.weeklyTrend[i] = (uint32_t)(bucket->mean + 0.5f);
+        } else {
+            // 当天没有完成的训练，使用总平均时间
+            trainingStats.weeklyTrend[i] = trainingStats.averageTime > 0 ? 
+                                          trainingStats.averageTime : 3000;
         }
     }
+}
+
+TrainingStats* HardwareManager::getTrainingStats() {
+    return &trainingStats;
+}
+
+// 日志回放回调：快照之后的记录计入统计；最近的单次训练记录载入内存，课程汇总记录只保留在日志中
+static void loadLoggedRecord(const PackedTrainingRecord& record, uint32_t sequence, void* context) {
+    uint32_t recordFrom = *(const uint32_t*)context;
+    uint8_t flags = record.packed >> RECORD_FLAGS_SHIFT;
     
-    // 计算真实的每日平均时间趋势（基于训练记录数据）
-    // 将训练记录分成7组，每组代表一天的平均表现
-    int recordsPerDay = recordCount / 7;
-    if (recordsPerDay == 0) recordsPerDay = 1; // 至少1条记录
-    
-    for (int day = 0; day < 7; day++) {
-        uint32_t dayTotal = 0;
-        int dayCount = 0;
-        int startIdx = day * recordsPerDay;
-        int endIdx = (day == 6) ? recordCount : (day + 1) * recordsPerDay;
-        
-        // 计算该天的平均完成时间（仅统计已完成的训练）
-        for (int i = startIdx; i < endIdx && i < recordCount; i++) {
-            if (trainingRecords[i].completed) {
-                dayTotal += trainingRecords[i].duration;
-                dayCount++;
-            }
-        }
-        
-        if (dayCount > 0) {
-            trainingStats.weeklyTrend[day] = dayTotal / dayCount;
-        } else {
-            // 如果当天没有完成的训练，使用总平均时间
-            trainingStats.weeklyTrend[day] = trainingStats.averageTime > 0 ? 
-                                            trainingStats.averageTime : 3000;
-        }
+    statsEngine.add(record, sequence);
+    if (sequence >= recordFrom && !(flags & RECORD_FLAG_SESSION)) {
+        recordStore.append(record);
     }
 }
 
-void HardwareManager::drawTrendGraph() {
-#ifdef FORCE_MASTER_ROLE
-    // 图表区域：x=10-118, y=52-58 (6像素高度)
-    const int graphX = 10;
-    const int graphY = 52;
-    const int graphWidth = 108;
-    const int graphHeight = 6;
-    const int pointCount = WEEKLY_TREND_POINTS;
-    
-    // 找到最大和最小值用于缩放
-    uint32_t minVal = UINT32_MAX, maxVal = 0;
-    for (int i = 0; i < pointCount && i < 7; i++) {
-        if (trainingStats.weeklyTrend[i] < minVal) minVal = trainingStats.weeklyTrend[i];
-        if (trainingStats.weeklyTrend[i] > maxVal) maxVal = trainingStats.weeklyTrend[i];
+// 统计快照读写缓冲区
+static uint8_t statsSnapshotBuffer[STATS_SNAPSHOT_BYTES];
+
+static bool loadStatsSnapshot() {
+    File file = LittleFS.open(STATS_SNAPSHOT_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    size_t size = file.read(statsSnapshotBuffer, sizeof(statsSnapshotBuffer));
+    file.close();
+    return statsEngine.loadSnapshot(statsSnapshotBuffer, size);
+}
+
+static void saveStatsSnapshot() {
+    size_t size = statsEngine.saveSnapshot(statsSnapshotBuffer, sizeof(statsSnapshotBuffer));
+    if (size == 0) {
+        return;
     }
     
-    if (maxVal == minVal) maxVal = minVal + 1; // 避免除零
+    // 先写临时文件再改名，断电时保留旧快照
+    File file = LittleFS.open(STATS_SNAPSHOT_PATH ".tmp", "w");
+    if (!file) {
+        return;
+    }
+    bool ok = file.write(statsSnapshotBuffer, size) == size;
+    file.close();
+    if (!ok || !LittleFS.rename(STATS_SNAPSHOT_PATH ".tmp", STATS_SNAPSHOT_PATH)) {
+        Serial.println("统计快照保存失败");
+    }
+}
+
+void HardwareManager::initializeTrainingData() {
+    recordStore.clear();
+    memset(&trainingStats, 0, sizeof(TrainingStats));
     
-    // 绘制数据点和连线
-    int prevX = -1, prevY = -1;
-    for (int i = 0; i < pointCount && i < 7; i++) {
-        int x = graphX + (i * graphWidth) / (pointCount - 1);
-        int y = graphY + graphHeight - ((trainingStats.weeklyTrend[i] - minVal) * graphHeight) / (maxVal - minVal);
-        
-        // 绘制数据点
-        u8g2.drawPixel(x, y);
-        u8g2.drawPixel(x-1, y);
-        u8g2.drawPixel(x+1, y);
-        u8g2.drawPixel(x, y-1);
-        u8g2.drawPixel(x, y+1);
+    statsEngine.reset();
+    statsEngine.setUtcOffset(timeManager.getTimezoneOffset());
+    
+    unsigned long scanStart = micros();
+    if (trainingLog.begin()) {
+        const LogScanReport& scan = trainingLog.lastScan();
+        Serial.printf("训练日志扫描: %d段 (段尾索引%d, 逐块校验%d, 删除%d), 修复%lu字节, 读取%lu字节, 用时%luus\n",
+                      scan.segments, scan.sealedSegments, scan.scannedSegments, scan.removedSegments,
+                      scan.repairedBytes, scan.bytesRead, micros() - scanStart);
         
-        // 绘制连线
-        if (prevX >= 0) {
-            u8g2.drawLine(prevX, prevY, x, y);
+        // 快照超前于日志（日志被修复截断或清除）时作废，从日志重建统计
+        uint32_t next = trainingLog.nextSequence();
+        if (!loadStatsSnapshot() || statsEngine.nextSequence() > next) {
+            statsEngine.reset();
+            Serial.println("统计快照无效，从训练日志重建统计");
         }
         
-        prevX = x;
-        prevY = y;
+        // 一次遍历：回放快照之后的记录，并载入最近的记录到内存环形存储
+        unsigned long replayStart = micros();
+        uint32_t statsFrom = statsEngine.nextSequence();
+        uint32_t recordFrom = next > recordStore.capacity() ? next - recordStore.capacity() : 0;
+        trainingLog.forEach(statsFrom < recordFrom ? statsFrom : recordFrom, loadLoggedRecord, &recordFrom);
+        Serial.printf("统计回放: %lu条, 用时%luus\n", next - statsFrom, micros() - replayStart);
+    } else {
+        Serial.println("训练日志初始化失败，本次记录不会持久化");
     }
     
-    // 绘制底部基线
-    u8g2.drawLine(graphX, graphY + graphHeight, graphX + graphWidth, graphY + graphHeight);
-#endif
-}
-
-TrainingStats* HardwareManager::getTrainingStats() {
-    return &trainingStats;
+    Serial.printf("训练数据初始化完成，记录容量: %lu条 (%d字节)，已载入%lu条\n", 
+                  recordStore.capacity(), TRAINING_RECORD_RAM_BUDGET, recordStore.size());
 }
 
-void HardwareManager::initializeTrainingData() {
-    recordCount = 0;
-    memset(&trainingStats, 0, sizeof(TrainingStats));
+void HardwareManager::addSessionRecord(uint64_t totalDurationUs, uint8_t mode) {
+    uint8_t flags = RECORD_FLAG_COMPLETED | RECORD_FLAG_SESSION;
+    if (timeManager.isTimeValid()) flags |= RECORD_FLAG_CLOCK_VALID;
     
-    // 创建更真实的最近一周训练数据
-    createWeeklyTrainingData();
-    
-    Serial.println("训练数据初始化完成，已添加一周模拟数据");
+    PackedTrainingRecord record = TrainingRecordStore::pack((uint32_t)timeManager.getUnixTime(), totalDurationUs, mode, flags);
+    statsEngine.add(record, trainingLog.append(record));
 }
 
-void HardwareManager::createWeeklyTrainingData() {
-    // 获取当前时间戳（毫秒）
-    uint32_t currentTime = millis();
-    uint32_t oneDay = 24 * 60 * 60 * 1000; // 一天的毫秒数
-    
-    // 创建最近7天的训练数据，模拟真实的训练模式
-    // 第7天前（周一）- 较慢的训练时间，刚开始训练
-    addTrainingRecord(3200, 0, true);  // 3.2秒 完成
-    addTrainingRecord(3800, 0, true);  // 3.8秒 完成
-    addTrainingRecord(4100, 0, false); // 4.1秒 未完成（超时）
-    
-    // 第6天前（周二）- 稍有进步
-    addTrainingRecord(2900, 0, true);  // 2.9秒 完成
-    addTrainingRecord(3400, 0, true);  // 3.4秒 完成
-    addTrainingRecord(3600, 0, true);  // 3.6秒 完成
-    addTrainingRecord(4200, 0, false); // 4.2秒 未完成
-    
-    // 第5天前（周三）- 持续改善
-    addTrainingRecord(2700, 0, true);  // 2.7秒 完成
-    addTrainingRecord(2800, 0, true);  // 2.8秒 完成
-    addTrainingRecord(3100, 0, true);  // 3.1秒 完成
-    addTrainingRecord(3300, 0, true);  // 3.3秒 完成
-    
-    // 第4天前（周四）- 最佳表现日
-    addTrainingRecord(2400, 0, true);  // 2.4秒 完成（个人最佳）
-    addTrainingRecord(2600, 0, true);  // 2.6秒 完成
-    addTrainingRecord(2500, 0, true);  // 2.5秒 完成
-    addTrainingRecord(2800, 0, true);  // 2.8秒 完成
-    addTrainingRecord(3000, 0, true);  // 3.0秒 完成
-    
-    // 第3天前（周五）- 保持稳定
-    addTrainingRecord(2650, 0, true);  // 2.65秒 完成
-    addTrainingRecord(2720, 0, true);  // 2.72秒 完成
-    addTrainingRecord(2890, 0, true);  // 2.89秒 完成
-    
-    // 第2天前（周六）- 疲劳期，成绩略有下降
-    addTrainingRecord(2950, 0, true);  // 2.95秒 完成
-    addTrainingRecord(3150, 0, true);  // 3.15秒 完成
-    addTrainingRecord(3450, 0, true);  // 3.45秒 完成
-    addTrainingRecord(3800, 0, false); // 3.8秒 未完成
-    
-    // 第1天前（周日）- 休息后恢复
-    addTrainingRecord(2750, 0, true);  // 2.75秒 完成
-    addTrainingRecord(2820, 0, true);  // 2.82秒 完成
-    addTrainingRecord(2680, 0, true);  // 2.68秒 完成
-    addTrainingRecord(2930, 0, true);  // 2.93秒 完成
-    
-    // 今天 - 继续保持良好状态
-    addTrainingRecord(2580, 0, true);  // 2.58秒 完成
-    addTrainingRecord(2690, 0, true);  // 2.69秒 完成
+void HardwareManager::flushTrainingLog() {
+    uint16_t pending = trainingLog.pendingRecords();
+    if (pending == 0) {
+        return;
+    }
     
-    Serial.printf("已创建 %d 条模拟训练记录\n", recordCount);
+    unsigned long flushStart = micros();
+    if (trainingLog.flush()) {
+        // 统计快照与日志同步保存，下次启动无需回放已落盘的记录
+        saveStatsSnapshot();
+        Serial.printf("训练日志落盘: %d条 (含统计快照), 用时%luus\n", pending, micros() - flushStart);
+    } else {
+        Serial.printf("训练日志落盘失败，%d条记录待重试\n", pending);
+    }
 }
 
-
+void HardwareManager::serviceTrainingLog(bool idle) {
+    // 批次达到阈值时，只在不计时的间隙落盘，避免闪存写入影响计时
+    if (idle && trainingLog.needsFlush()) {
+        flushTrainingLog();
+    }
+}
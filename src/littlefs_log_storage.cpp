@@ -0,0 +1,110 @@
+#include "littlefs_log_storage.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// LittleFS.begin()的默认VFS挂载点
+#define LITTLEFS_MOUNT_POINT "/littlefs"
+
+LittleFsLogStorage::LittleFsLogStorage(const char* directory) : directory(directory) {}
+
+bool LittleFsLogStorage::begin() {
+    // 首次使用或分区损坏时格式化
+    if (!LittleFS.begin(true)) {
+        Serial.println("LittleFS挂载失败");
+        return false;
+    }
+    if (!LittleFS.exists(directory) && !LittleFS.mkdir(directory)) {
+        Serial.printf("创建日志目录失败: %s\n", directory);
+        return false;
+    }
+    return true;
+}
+
+void LittleFsLogStorage::segmentPath(uint32_t id, char* path, size_t pathSize) {
+    snprintf(path, pathSize, "%s/%08lx.seg", directory, (unsigned long)id);
+}
+
+int LittleFsLogStorage::listSegments(uint32_t* ids, int maxIds) {
+    File dir = LittleFS.open(directory);
+    if (!dir || !dir.isDirectory()) {
+        return 0;
+    }
+
+    int count = 0;
+    File entry = dir.openNextFile();
+    while (entry && count < maxIds) {
+        const char* name = entry.name();
+        const char* slash = strrchr(name, '/');
+        if (slash) {
+            name = slash + 1;
+        }
+
+        char* end = nullptr;
+        unsigned long id = strtoul(name, &end, 16);
+        if (end == name + 8 && strcmp(end, ".seg") == 0) {
+            ids[count++] = id;
+        }
+        entry.close();
+        entry = dir.openNextFile();
+    }
+    dir.close();
+    return count;
+}
+
+int32_t LittleFsLogStorage::segmentSize(uint32_t id) {
+    char path[32];
+    segmentPath(id, path, sizeof(path));
+
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return -1;
+    }
+    int32_t size = file.size();
+    file.close();
+    return size;
+}
+
+int32_t LittleFsLogStorage::read(uint32_t id, uint32_t offset, void* buffer, uint32_t length) {
+    char path[32];
+    segmentPath(id, path, sizeof(path));
+
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return -1;
+    }
+    int32_t result = -1;
+    if (file.seek(offset)) {
+        result = file.read((uint8_t*)buffer, length);
+    }
+    file.close();
+    return result;
+}
+
+bool LittleFsLogStorage::append(uint32_t id, const void* data, uint32_t length) {
+    char path[32];
+    segmentPath(id, path, sizeof(path));
+
+    // 关闭文件时LittleFS提交元数据，之前断电则本次写入整体丢弃
+    File file = LittleFS.open(path, "a");
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write((const uint8_t*)data, length);
+    file.close();
+    return written == length;
+}
+
+bool LittleFsLogStorage::truncate(uint32_t id, uint32_t size) {
+    // fs::File没有截断接口，通过VFS挂载点直接调用truncate
+    char path[48];
+    int prefix = snprintf(path, sizeof(path), "%s", LITTLEFS_MOUNT_POINT);
+    segmentPath(id, path + prefix, sizeof(path) - prefix);
+    return ::truncate(path, size) == 0;
+}
+
+bool LittleFsLogStorage::remove(uint32_t id) {
+    char path[32];
+    segmentPath(id, path, sizeof(path));
+    return LittleFS.remove(path);
+}
@@ -1,34 +1,118 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <esp_now.h>
+#include <esp_wifi.h>
 #include "config.h"
 #include "hardware.h"
 #include "menu.h"
 #include "vibration_training.h"
 #include "ButtonManager.h"
 #include "time_manager.h"
+#include "system_state_manager.h"
+#include "settings_store.h"
+#include "boot_profile.h"
+#include "time_sync.h"
+#include "clock.h"
+#include "tx_scheduler.h"
+#include "espnow_transport.h"
+#include "group_command.h"
+#include "peer_cache.h"
+#include "peer_discovery.h"
+#include "channel_plan.h"
+#include "duty_cycle.h"
+#include "trace_capture.h"
+#include "cpu_governor.h"
+#include "role_swap.h"
 
 // 全局变量
-SystemState currentState = STATE_INIT;
 DeviceRole deviceRole = ROLE_UNDEFINED;
 uint8_t peerAddress[6];
 bool systemInitialized = false;
 
+// 无线发送调度，所有消息经优先级队列发出；发射功率按对端回报的接收强度闭环调整
+TxPowerController txPower;
+volatile int8_t lastPeerRssi = 0;      // 最近一次收到对端帧的RSSI，随心跳/应答回报给对端
+EspNowTransport espNowTransport(&txPower);
+TxScheduler radioTx(espNowTransport);
+static uint8_t deferredInitStep = 0;
+
 // 连接状态监控变量
 ConnectionStatus connectionStatus = CONN_DISCONNECTED;
-unsigned long lastHeartbeatSent = 0;
-unsigned long lastHeartbeatReceived = 0;
-unsigned long lastConnectionCheck = 0;
+// 时间均为Clock微秒；接收时刻在ESP-NOW回调中写入，用32位时间戳保证读写原子
+uint64_t lastHeartbeatSent = 0;
+volatile uint32_t lastHeartbeatReceived = 0;
+uint64_t lastConnectionCheck = 0;
 uint8_t connectionRetryCount = 0;
 bool waitingForHeartbeatAck = false;
 
+// 授时广播序号
+uint16_t timeSyncSequence = 0;
+// 待发的授时：窗口外未能发出的（保留设置时间等标志）和接收回调中收到的授时请求，只在主循环中发出
+volatile bool timeSyncPending = false;
+uint8_t timeSyncPendingFlags = 0;
+
+// 组命令：主机自身也是0号锥桶，与其他锥桶按同一执行时刻执行
+uint16_t groupSequence = 0;
+GroupCommandReceiver groupReceiver(CONE_ID);
+GroupSkewTracker groupSkew;
+// 各锥桶的执行回报，在ESP-NOW回调中写入，主循环取出
+volatile uint32_t groupReports[GROUP_MAX_CONES];
+volatile bool groupReportReady[GROUP_MAX_CONES];
+// 双设备训练：主机单击后等待锥桶常开再广播开始
+bool dualStartPending = false;
+// 对端锥桶号，随对端心跳/应答更新，组命令按它寻址
+volatile uint8_t peerConeId = 1;
+// 本机为从机时收到的组命令帧，主循环取走后清零长度
+uint8_t groupFrame[GROUP_FRAME_MAX_BYTES];
+volatile uint8_t groupFrameLength = 0;
+volatile uint32_t groupFrameStamp = 0;
+
 // 设备配对变量
 PairingStatus pairingStatus = PAIRING_IDLE;
 DiscoveredDevice discoveredDevices[MAX_DISCOVERED_DEVICES];
 uint8_t discoveredDeviceCount = 0;
 uint8_t selectedDeviceIndex = 0;
 unsigned long pairingStartTime = 0;
+unsigned long pairingStatusTime = 0;     // 进入当前配对状态的时刻
+PairingStatus lastPairingStatus = PAIRING_IDLE;
 bool pairingModeActive = false;
+PeerDiscovery peerDiscovery;
+
+// 已知对端缓存与开机快速重连
+PeerCache peerCache;
+ProbeSchedule reconnectProbe;
+
+// 信道管理：会话开始（首次连接）时探测链路、调查各信道并协调换信道
+enum ChannelTask {
+    CHTASK_IDLE,
+    CHTASK_PROBE_BEFORE,      // 换信道前的往返探测
+    CHTASK_SURVEY,            // 逐信道监听
+    CHTASK_SWITCH,            // 通知锥桶并切换
+    CHTASK_PROBE_AFTER        // 换信道后的往返探测
+};
+#define CHANNEL_PROBE_COUNT       20
+#define CHANNEL_PROBE_INTERVAL_US 20000
+uint8_t radioChannel = ESPNOW_CHANNEL;
+ChannelTask channelTask = CHTASK_IDLE;
+bool channelSurveyPending = true;
+ChannelSurvey channelSurvey;
+ChannelSwitchCoordinator channelSwitch;
+ChannelFollower channelRendezvous(ESPNOW_CHANNEL);
+LinkProbe linkProbe;
+LinkStats linkBefore;
+volatile uint8_t surveyChannel = 0;           // 混杂模式回调读取
+uint64_t surveyDwellStartUs = 0;
+
+// 锥桶无线占空：菜单空闲时锥桶只在信标窗口接收，窗口外的发送保持到下一窗口；应答在回调中暂存
+DutyCycleLeader dutyLeader;
+volatile bool dutyAckPending = false;
+volatile uint8_t dutyAckMode = DUTY_ACK_ALWAYS_ON;
+volatile uint32_t dutyAckStamp = 0;
+
+// 主从角色交换：折返跑换方向时由另一台设备计时，交换帧在回调中暂存，主循环在回合之间处理
+RoleSwap roleSwap(CMD_ROLE_SWITCH);
+RoleSwapFrame roleSwapInbox;
+volatile bool roleSwapInboxFull = false;
 unsigned long lastPairingDisplayUpdate = 0;
 PairingStatus lastDisplayedPairingStatus = PAIRING_IDLE;
 
@@ -40,26 +124,52 @@ void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int
 void onDataSent(const uint8_t* mac, esp_now_send_status_t status);
 void initESPNow();
 void determineDeviceRole();
-void startTraining();
-void returnToMenu();
 void handleVibrationTraining();
-void handleDualTraining();
+void serviceDualStart();
 void updateSystem();
 
 // 连接状态监控函数
 void updateConnectionStatus();
 void sendHeartbeat();
+void sendLedBrightness();
 void handleHeartbeat(const message_t& message);
 void checkConnectionTimeout();
 void setConnectionStatus(ConnectionStatus status);
 const char* getConnectionStatusString(ConnectionStatus status);
+void probeKnownPeer();
+void adoptKnownPeer(const uint8_t* mac);
+
+// 能耗估算函数
+void serviceEnergy();
+void onSerialCommand(const char* command);
+CpuDemand currentCpuDemand();
+
+// 信道管理函数
+void setRadioChannel(uint8_t channel);
+void serviceChannelPlan();
+
+// 无线占空函数
+void serviceDutyCycle();
+
+// 角色交换函数
+void serviceRoleSwap();
+void requestRoleSwap();
+
+// 授时函数
+bool ensureBroadcastPeer();
+void sendTimeSync(uint8_t flags = 0);
+bool sendGroupCommand(uint16_t targetMask, const GroupTarget* targets);
+void serviceGroupCommand();
+uint8_t localConeId();
 
 // 设备配对函数
 void startDevicePairing();
 void stopDevicePairing();
 void updatePairingProcess();
 void sendPairingRequest(const uint8_t* targetMac);
-void handlePairingMessage(const message_t& message, const uint8_t* senderMac);
+void sendPairingProbe();
+void handlePairingMessage(const message_t& message, const uint8_t* senderMac, int8_t rssi);
+void rankDiscoveredDevices();
 void addDiscoveredDevice(const uint8_t* mac, int8_t rssi);
 void displayPairingStatus();
 void updatePairingDisplay(bool checkUpdateNeeded = true);
@@ -74,49 +184,83 @@ void onLongPress();
 void setup() {
     Serial.begin(115200);
     Serial.println("ESP-NOW 双子星敏捷锥启动中...");
+    bootProfile.begin();
+    
+    // 初始化状态管理器
+    stateManager.init();
     
-    // 初始化硬件
-    if (!hardware.init()) {
+    // 阶段1：引脚与设置（设置中的配对信息用于确定角色）
+    if (!hardware.initCore()) {
         Serial.println("硬件初始化失败!");
-        currentState = STATE_ERROR;
+        stateManager.postEvent(EVT_FAULT);
+        stateManager.update();
         return;
     }
+    bootProfile.mark("引脚/设置");
     
-    // 初始化WiFi
+    // 阶段2：无线（已知对端缓存用于确定对端和开机重连）
     WiFi.mode(WIFI_STA);
-    
-    // 确定设备角色
+    energyAccount.begin(Clock::nowUs());
+    energyAccount.setRadio(Clock::nowUs(), true);
+    traceCapture.setCommandHandler(onSerialCommand);
+    peerCacheLoad(peerCache);
     determineDeviceRole();
-    
-    // 初始化ESP-NOW
     initESPNow();
+    bootProfile.mark("无线");
     
-    // 初始化菜单
-    menu.init();
-    
-// 初始化时间管理器
-    if (!timeManager.init()) {
-        Serial.println("时间管理器初始化失败!");
-    } else {
-        Serial.println("时间管理器初始化成功!");
-        timeManager.printTimeInfo();
-    }
-
-    // 初始化按键管理器
+    // 阶段3：按键
     buttonManager.init();
     buttonManager.attachSingleClick(onSingleClick);
     buttonManager.attachDoubleClick(onDoubleClick);
     buttonManager.attachLongPress(onLongPress);
+    // 启用了自动浅睡时按键可唤醒
+    if (cpuGovernorBegin()) {
+        buttonManager.enableSleepWake();
+    }
     Serial.println("按键管理器初始化完成");
+    bootProfile.mark("按键");
+    bootProfile.markReady();
+    
+    // 阶段4：LED与显示屏，菜单需在处理按键前显示
+    if (!hardware.initOutputs()) {
+        Serial.println("硬件初始化失败!");
+        stateManager.postEvent(EVT_FAULT);
+        stateManager.update();
+        return;
+    }
+    menu.init();
+    bootProfile.mark("显示/菜单");
     
     // 设置状态
-    currentState = STATE_MENU;
+    stateManager.postEvent(EVT_INIT_DONE);
     systemInitialized = true;
     
-    hardware.displayStatus("系统已就绪");
     hardware.playStartSound();
     
-    Serial.println("系统初始化完成");
+    Serial.println("系统初始化完成，训练数据与时钟延后加载");
+}
+
+// 延后初始化 - 每次loop执行一步，避免扫描闪存等耗时操作推迟可触发时间
+//   全部步骤在前几次loop内完成，早于任何一轮训练结束写入记录
+static void runDeferredInit() {
+    switch (deferredInitStep) {
+        case 0:
+            if (!timeManager.init()) {
+                Serial.println("时间管理器初始化失败!");
+            } else {
+                timeManager.printTimeInfo();
+            }
+            bootProfile.mark("时钟");
+            break;
+        case 1:
+            hardware.initializeTrainingData();
+            bootProfile.mark("训练日志");
+            bootProfile.report();
+            break;
+        default:
+            return;
+    }
+    deferredInitStep++;
 }
 
 void loop() {
@@ -124,24 +268,119 @@ void loop() {
         return;
     }
     
+    uint64_t loopStartUs = Clock::nowUs();
+    
+    runDeferredInit();
+    
     hardware.update();
     
     // 更新按键管理器
     buttonManager.tick();
     
+    // 信标与窗口外保持，须在心跳和发送之前
+    serviceDutyCycle();
+    
     // 更新连接状态监控
     updateConnectionStatus();
     
+    // 发出排队的无线消息
+    radioTx.service();
+    
+    // 执行到点的组命令并统计锥桶间偏差
+    serviceGroupCommand();
+    
+    // 信道调查与换信道
+    serviceChannelPlan();
+    
     // 更新配对流程
     if (pairingModeActive) {
         updatePairingProcess();
     }
     
+    // 回合之间交换主从角色，须在本轮触发检测之前
+    serviceRoleSwap();
+    
+    // 分派按键、连接和ESP-NOW回调投递的状态事件
+    stateManager.update();
+    
     updateSystem();
     
+    // 按本轮分派后的状态调整CPU频率，进入计时立即升频
+    cpuGovernorService(currentCpuDemand());
+    
+    // 显示屏唤醒与空闲调暗，放在本轮触发检测之后
+    hardware.serviceDisplay(stateManager.getCurrentState(), vibrationTraining.isTimingRound());
+    
+    // 训练日志批次落盘（计时中不写闪存）
+    hardware.serviceTrainingLog(!vibrationTraining.isTimingRound());
+    
+    // 合并提交设置修改
+    settingsStore.update(*hardware.getSettings());
+    
+    // 本次循环的运行时间计入CPU能耗，delay期间按空闲计
+    energyAccount.addCpuBusy((uint32_t)Clock::elapsedUs(loopStartUs));
+    serviceEnergy();
+    
     delay(10); // 短暂延迟以避免过度占用CPU
 }
 
+// 能耗估算：每ENERGY_SAMPLE_INTERVAL_MS把发射计数和外设状态计入积分
+void serviceEnergy() {
+    static uint64_t lastSampleUs = 0;
+    static uint32_t lastFrames = 0;
+    static uint32_t lastBytes = 0;
+    uint64_t now = Clock::nowUs();
+    if (!Clock::hasElapsed(lastSampleUs, ENERGY_SAMPLE_INTERVAL_MS * 1000ULL)) {
+        return;
+    }
+    lastSampleUs = now;
+    
+    energyAccount.addTx(espNowTransport.framesSent() - lastFrames, espNowTransport.bytesSent() - lastBytes);
+    lastFrames = espNowTransport.framesSent();
+    lastBytes = espNowTransport.bytesSent();
+    hardware.sampleEnergy(energyAccount, now);
+    energyAccount.advance(now);
+}
+
+// 各系统状态的CPU需求档位
+static const CpuDemand kStateCpuDemand[STATE_COUNT] = {
+    CPU_DEMAND_ACTIVE,    // INIT
+    CPU_DEMAND_IDLE,      // MENU
+    CPU_DEMAND_ACTIVE,    // READY：已布防，触发中断不能被浅睡延迟
+    CPU_DEMAND_ACTIVE,    // TRAINING
+    CPU_DEMAND_TIMING,    // TIMING
+    CPU_DEMAND_ACTIVE,    // COMPLETE
+    CPU_DEMAND_IDLE,      // ERROR
+};
+
+CpuDemand currentCpuDemand() {
+    if (vibrationTraining.isTimingRound()) {
+        return CPU_DEMAND_TIMING;
+    }
+    CpuDemand demand = kStateCpuDemand[stateManager.getCurrentState()];
+    // 菜单中配对和信道调查依赖无线回调
+    if (demand == CPU_DEMAND_IDLE && (pairingModeActive || channelTask != CHTASK_IDLE)) {
+        demand = CPU_DEMAND_ACTIVE;
+    }
+    return demand;
+}
+
+// trace之外的串口命令
+void onSerialCommand(const char* command) {
+    if (strcmp(command, "swap") == 0) {
+        requestRoleSwap();
+    } else if (!energyHandleCommand(energyAccount, command, hardware.remainingMah()) && !cpuHandleCommand(command)) {
+        Serial.printf("未知命令: %s\n", command);
+    }
+}
+
+// 探测抖动的随机种子：各锥桶MAC不同，抖动序列也不同
+static uint32_t localMacSeed() {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    return ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+}
+
 void determineDeviceRole() {
     uint8_t mac[6];
     WiFi.macAddress(mac);
@@ -184,12 +423,12 @@ void determineDeviceRole() {
         memcpy(peerAddress, deviceA, 6);
         Serial.println("设备角色: 从设备 (Slave) - 自动识别");
     } else {
-        // 检查是否有保存的配对设备
+        // 检查是否有保存的配对设备，优先使用最近连接的已知对端
         SystemSettings* settings = hardware.getSettings();
-        if (settings->hasPairedDevice) {
-            memcpy(peerAddress, settings->pairedDeviceMac, 6);
+        if (peerCache.count() > 0 || settings->hasPairedDevice) {
+            memcpy(peerAddress, peerCache.count() > 0 ? peerCache.at(0).mac : settings->pairedDeviceMac, 6);
             // 根据当前MAC确定角色（这里简化处理，实际可能需要更复杂的逻辑）
-            deviceRole = (mac[5] < settings->pairedDeviceMac[5]) ? ROLE_MASTER : ROLE_SLAVE;
+            deviceRole = (mac[5] < peerAddress[5]) ? ROLE_MASTER : ROLE_SLAVE;
             Serial.printf("设备角色: %s - 使用已保存的配对信息\n", 
                          (deviceRole == ROLE_MASTER) ? "主设备 (Master)" : "从设备 (Slave)");
         } else {
@@ -206,6 +445,7 @@ void determineDeviceRole() {
 }
 
 void initESPNow() {
+    setRadioChannel(ESPNOW_CHANNEL);
     if (esp_now_init() != ESP_OK) {
         Serial.println("ESP-NOW 初始化失败");
         return;
@@ -217,7 +457,7 @@ void initESPNow() {
     // 添加对等设备
     esp_now_peer_info_t peerInfo = {};
     memcpy(peerInfo.peer_addr, peerAddress, 6);
-    peerInfo.channel = ESPNOW_CHANNEL;
+    peerInfo.channel = 0;  // 0: 跟随当前信道，换信道后无需修改对等设备
     peerInfo.encrypt = ESPNOW_ENCRYPT;
     
     if (esp_now_add_peer(&peerInfo) != ESP_OK) {
@@ -225,21 +465,85 @@ void initESPNow() {
         return;
     }
     
+    // 缓存中的其他已知对端也加入，开机探测时轮流尝试
+    for (uint8_t i = 0; i < peerCache.count(); i++) {
+        if (!esp_now_is_peer_exist(peerCache.at(i).mac)) {
+            memcpy(peerInfo.peer_addr, peerCache.at(i).mac, 6);
+            esp_now_add_peer(&peerInfo);
+        }
+    }
+    
     Serial.println("ESP-NOW 初始化成功");
     
     // 设置连接状态为连接中
     setConnectionStatus(CONN_CONNECTING);
-    lastConnectionCheck = millis();
+    lastConnectionCheck = Clock::nowUs();
+    lastHeartbeatReceived = Clock::stamp32();
+    
+    // 已知对端无需扫描：立即开始短间隔探测，不等第一次常规心跳
+    if (deviceRole != ROLE_UNDEFINED) {
+        reconnectProbe.begin(Clock::nowUs(), RECONNECT_PROBE_INTERVAL_US, RECONNECT_PROBE_JITTER_US,
+                             RECONNECT_WINDOW_US, localMacSeed());
+    }
 }
 
 void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int len) {
+    // 角色交换帧与message_t首字节同为命令号，按长度区分
+    RoleSwapFrame swapFrame;
+    if (roleSwapDecode(data, len, CMD_ROLE_SWITCH, swapFrame)) {
+        if (memcmp(recv_info->src_addr, peerAddress, 6) == 0 && !roleSwapInboxFull) {
+            roleSwapInbox = swapFrame;
+            roleSwapInboxFull = true;
+        }
+        lastHeartbeatReceived = Clock::stamp32();
+        return;
+    }
+    
+    // 组命令帧长度可变，只有从机执行；上一帧未取走时丢弃（重复广播的副本）
+    if (data[0] == CMD_GROUP_COMMAND) {
+        if (deviceRole == ROLE_SLAVE && groupFrameLength == 0 && len <= (int)sizeof(groupFrame)) {
+            memcpy(groupFrame, data, len);
+            groupFrameStamp = Clock::stamp32();
+            groupFrameLength = len;
+        }
+        lastHeartbeatReceived = Clock::stamp32();
+        return;
+    }
+    
     message_t message;
     memcpy(&message, data, sizeof(message_t));
     
     Serial.printf("接收到消息: 命令=%d, 数据=%d\n", message.command, message.data);
     
     // 更新最后收到消息的时间
-    lastHeartbeatReceived = millis();
+    lastHeartbeatReceived = Clock::stamp32();
+    
+    // 记录本机接收强度；对端心跳/应答中带有它收到本机帧的强度
+    if (recv_info->rx_ctrl && memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+        lastPeerRssi = recv_info->rx_ctrl->rssi;
+    }
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        txPowerHasFeedback(message.data)) {
+        txPower.onFeedback(recv_info->src_addr, txPowerFeedbackRssi(message.data), Clock::nowUs());
+    }
+    // 锥桶电量随心跳/应答上报
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        batteryReportPercent(message.data) != BATTERY_UNKNOWN) {
+        hardware.setConeBattery(message.source_id, batteryReportPercent(message.data));
+    }
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        message.source_id < GROUP_MAX_CONES && memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+        peerConeId = message.source_id;
+    }
+    
+    // 开机重连期间已知对端先应答时改用该对端
+    if ((message.command == CMD_HEARTBEAT || message.command == CMD_HEARTBEAT_ACK) &&
+        connectionStatus != CONN_CONNECTED) {
+        adoptKnownPeer(recv_info->src_addr);
+    }
+    
+    // 换信道后确认锥桶已在新信道
+    channelSwitch.onPeerHeard(message.source_id);
     
     switch (message.command) {
         case CMD_HEARTBEAT:
@@ -252,33 +556,29 @@ void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int
             Serial.println("收到心跳应答，连接正常");
             break;
             
+        case CMD_TIME_REQUEST:
+            // 从机刚启动或时钟无效，主循环在下一个可发送时刻授时
+            if (deviceRole == ROLE_MASTER) {
+                timeSyncPending = true;
+            }
+            break;
+            
         case CMD_PAIRING_REQUEST:
         case CMD_PAIRING_RESPONSE:
         case CMD_PAIRING_CONFIRM:
         case CMD_DEVICE_INFO:
             if (pairingModeActive) {
-                handlePairingMessage(message, recv_info->src_addr);
-            }
-            break;
-            
-        case CMD_START_TASK:
-            if (currentState == STATE_READY && connectionStatus == CONN_CONNECTED) {
-                currentState = STATE_TIMING;
-                vibrationTraining.start();
+                handlePairingMessage(message, recv_info->src_addr,
+                                     recv_info->rx_ctrl ? recv_info->rx_ctrl->rssi : 0);
             }
             break;
             
         case CMD_TASK_COMPLETE:
-            if (currentState == STATE_TIMING) {
-                currentState = STATE_COMPLETE;
-                hardware.displayResult(message.data, "训练完成");
-                hardware.playCompleteSound();
-            }
+            stateManager.postEvent(EVT_REMOTE_COMPLETE, message.data);
             break;
             
         case CMD_RESET:
-            currentState = STATE_MENU;
-            menu.init();
+            stateManager.postEvent(EVT_REMOTE_RESET);
             break;
             
         case CMD_VT_START_ROUND:
@@ -300,11 +600,36 @@ void onDataReceived(const esp_now_recv_info* recv_info, const uint8_t* data, int
                 Serial.println("从机收到主机完成信号");
             }
             break;
+            
+        case CMD_LINK_PONG:
+            linkProbe.onReply((uint8_t)message.data, Clock::nowUs());
+            break;
+            
+        case CMD_CHANNEL_SWITCH_ACK:
+            channelSwitch.onAck(message.source_id);
+            break;
+            
+        case CMD_DUTY_ACK:
+            if (memcmp(recv_info->src_addr, peerAddress, 6) == 0) {
+                dutyAckMode = (uint8_t)message.data;
+                dutyAckStamp = Clock::stamp32();
+                dutyAckPending = true;
+            }
+            break;
+            
+        case CMD_GROUP_REPORT:
+            if (message.source_id < GROUP_MAX_CONES) {
+                groupReports[message.source_id] = message.data;
+                groupReportReady[message.source_id] = true;
+            }
+            break;
     }
 }
 
 void onDataSent(const uint8_t* mac, esp_now_send_status_t status) {
-    Serial.printf("发送状态: %s\n", (status == ESP_NOW_SEND_SUCCESS) ? "成功" : "失败");
+    // WiFi任务上下文：只释放在途名额，失败次数由调度器累计
+    radioTx.onSendComplete(status == ESP_NOW_SEND_SUCCESS);
+    txPower.onDelivery(mac, status == ESP_NOW_SEND_SUCCESS, Clock::nowUs());
 }
 
 void handleVibrationTraining() {
@@ -314,168 +639,79 @@ void handleVibrationTraining() {
         case MODE_SINGLE_TIMER:
             // 单次计时模式
             Serial.println("处理MODE_SINGLE_TIMER模式");
-            if (currentState == STATE_TIMING) {
-                vibrationTraining.update();
-                if (vibrationTraining.isCompleted()) {
-                    currentState = STATE_COMPLETE;
-                    hardware.displayResult(vibrationTraining.getElapsedTime(), "计时完成");
-                }
+            vibrationTraining.update();
+            if (vibrationTraining.isCompleted()) {
+                stateManager.postEvent(EVT_TRAINING_DONE);
             }
             break;
             
         case MODE_VIBRATION_TRAINING:
-            // 震动训练模式
-            Serial.println("处理MODE_VIBRATION_TRAINING模式");
-            if (currentState == STATE_TIMING) {
-                vibrationTraining.update();
-                if (vibrationTraining.isCompleted()) {
-                    currentState = STATE_COMPLETE;
-                }
-            }
-            break;
-            
         case MODE_DUAL_TRAINING:
-            // 双设备训练模式
-            Serial.println("处理MODE_DUAL_TRAINING模式");
-            handleDualTraining();
+            // 震动训练模式；双设备训练由组命令同时布防后按相同的主从流程计时
+            Serial.println("处理主从震动训练模式");
+            vibrationTraining.update();
+            if (vibrationTraining.isCompleted()) {
+                stateManager.postEvent(EVT_TRAINING_DONE);
+            }
             break;
     }
 }
 
-void handleDualTraining() {
-    // 双设备训练逻辑
-    if (deviceRole == ROLE_MASTER && currentState == STATE_READY && connectionStatus == CONN_CONNECTED) {
-        // 主设备发送开始信号
-        message_t message;
-        message.command = CMD_START_TASK;
-        message.target_id = 1;
-        message.source_id = 0;
-        message.timestamp = millis();
-        message.data = 0;
-        message.checksum = 0; // TODO: 实现校验和计算
-        
-        esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&message, sizeof(message));
-        if (result == ESP_OK) {
-            Serial.println("发送开始信号成功");
-            currentState = STATE_TIMING;
-            vibrationTraining.start();
-        } else {
-            Serial.println("发送开始信号失败，检查连接状态");
-            hardware.displayStatus("连接错误");
-        }
-    } else if (currentState == STATE_READY && connectionStatus != CONN_CONNECTED) {
-        hardware.displayStatus("等待连接...");
+// 双设备训练开始：主机单击后广播组命令，本机也经组命令接收在同一执行时刻布防
+void serviceDualStart() {
+    if (!dualStartPending) {
+        return;
     }
-}
-
-void updateSystem() {
-    switch (currentState) {
-        case STATE_INIT:
-            // 初始化状态
-            break;
-            
-        case STATE_MENU:
-            // 如果配对模式激活，暂停菜单更新避免显示冲突
-            if (!pairingModeActive) {
-                menu.update();
-                // 当菜单选择"开始训练"后，自动切换到准备状态
-                if (!menu.isMenuActive()) {
-                    currentState = STATE_READY;
-                    Serial.println("切换到准备状态");
-                    hardware.displayStatus("准备就绪！按键开始训练");
-                    hardware.setAllLEDs(COLOR_GREEN);
-                    hardware.showLEDs();
-                }
-            }
-            break;
-            
-        case STATE_READY:
-            if (connectionStatus == CONN_CONNECTED) {
-                hardware.displayStatus("按按钮开始");
-            } else {
-                hardware.displayStatus(getConnectionStatusString(connectionStatus));
-            }
-            break;
-            
-        case STATE_TIMING:
-            Serial.println("系统在STATE_TIMING状态，调用handleVibrationTraining()");
-            handleVibrationTraining();
-            break;
-            
-        case STATE_COMPLETE:
-            hardware.displayStatus("按按钮继续");
-            break;
-            
-        case STATE_ERROR:
-            hardware.displayStatus("系统错误");
-            hardware.setAllLEDs(COLOR_RED);
-            hardware.showLEDs();
-            break;
+    if (connectionStatus != CONN_CONNECTED) {
+        dualStartPending = false;
+        Serial.println("发送开始信号失败，检查连接状态");
+        hardware.displayStatus("连接错误");
+        return;
     }
-}
-
-void startTraining() {
-    Serial.println("=== startTraining() 被调用 ===");
-    Serial.printf("当前系统状态: %d (STATE_READY=%d)\n", currentState, STATE_READY);
-    
-    // 检查当前状态是否允许开始训练
-    if (currentState == STATE_READY) {
-        // 切换到计时状态
-        currentState = STATE_TIMING;
-        Serial.printf("系统状态切换到: %d (STATE_TIMING=%d)\n", currentState, STATE_TIMING);
-        
-        // 播放开始音效
-        if (hardware.getSettings()->soundEnabled) {
-            hardware.playStartSound();
-        }
-        
-        // 设置LED为训练颜色
-        hardware.setAllLEDs(hardware.getLedColorValue(hardware.getSettings()->ledColor));
-        hardware.showLEDs();
-        
-        // 显示训练开始界面
-        hardware.displayStatus("训练开始！");
-        
-        // 启动震动训练
-        Serial.println("调用 vibrationTraining.start()");
-        vibrationTraining.start();
-        
-        Serial.println("训练状态切换完成");
+    // 锥桶确认常开之前广播会保持到下一窗口，到达时已过执行时刻，等确认后再发
+    if (groupReceiver.pending() || dutyLeader.peerIsCycling()) {
+        return;
+    }
+    dualStartPending = false;
+    
+    // 主设备广播组命令：本机和从机同时亮绿灯并开始计时
+    GroupTarget targets[GROUP_MAX_CONES] = {};
+    const GroupTarget go = {0x00, 0xFF, 0x00, GROUP_EFFECT_SOLID,
+                            GROUP_FLAG_LIGHT | GROUP_FLAG_ARM | GROUP_FLAG_REPORT};
+    uint8_t peerCone = peerConeId;
+    targets[localConeId()] = go;
+    targets[peerCone] = go;
+    
+    if (sendGroupCommand((1u << localConeId()) | (1u << peerCone), targets)) {
+        Serial.println("发送开始信号成功");
     } else {
-        Serial.printf("当前状态不允许开始训练，当前状态: %d\n", currentState);
+        Serial.println("发送开始信号失败，检查连接状态");
+        hardware.displayStatus("连接错误");
     }
 }
 
-void returnToMenu() {
-    Serial.println("返回主菜单...");
-    
-    // 保存当前训练数据（如果有）
-    if (currentState == STATE_TIMING || currentState == STATE_COMPLETE) {
-        // 这里可以添加保存训练数据的逻辑
-        // saveTrainingData();
+void updateSystem() {
+    // 各状态的界面在进入状态时由状态管理器一次性绘制，这里只驱动计时逻辑
+    SystemState state = stateManager.getCurrentState();
+    if (state == STATE_READY) {
+        serviceDualStart();
+        return;
+    }
+    // 离开准备状态后不再发出未发的开始信号
+    dualStartPending = false;
+    if (state == STATE_TIMING) {
+        handleVibrationTraining();
     }
-    
-    // 切换到菜单状态
-    currentState = STATE_MENU;
-    
-    // 重置硬件状态
-    hardware.clearLEDs();
-    hardware.showLEDs();
-    
-    // 停止任何正在播放的音效
-    noTone(BUZZER_PIN);
-    
-    // 清理并重新初始化显示器
-    hardware.displayClear();
-    
-    // 重新初始化菜单
-    menu.init();
-    
-    Serial.println("已返回主菜单");
 }
 
 // 按键事件回调函数实现
 void onSingleClick() {
+    // 面板关闭时看不到菜单，第一次按键只点亮屏幕
+    if (hardware.wakeDisplay()) {
+        Serial.println("按键唤醒显示屏");
+        return;
+    }
+    SystemState currentState = stateManager.getCurrentState();
     Serial.printf("[%lu] 单击按键事件 - 当前状态: %d\n", millis(), currentState);
     
     // 如果在配对模式中，处理设备选择
@@ -494,14 +730,23 @@ void onSingleClick() {
             }
             break;
         case STATE_READY:
+            // 双设备训练由主机广播组命令开始，本机在执行时刻随锥桶一起布防
+            if (menu.getCurrentMode() == MODE_DUAL_TRAINING && deviceRole == ROLE_MASTER) {
+                if (!dualStartPending && !groupReceiver.pending()) {
+                    Serial.println("  -> 开始双设备训练");
+                    dualStartPending = true;
+                    hardware.displayStatus("等待锥桶就绪...");
+                }
+                break;
+            }
             // 开始训练
             Serial.println("  -> 开始训练");
-            startTraining();
+            stateManager.postEvent(EVT_START_LOCAL);
             break;
         case STATE_COMPLETE:
             // 返回菜单
             Serial.println("  -> 返回菜单");
-            returnToMenu();
+            stateManager.postEvent(EVT_BACK);
             break;
         default:
             Serial.printf("  -> 当前状态不处理单击事件: %d\n", currentState);
@@ -510,6 +755,12 @@ void onSingleClick() {
 }
 
 void onDoubleClick() {
+    // 面板关闭时看不到菜单，第一次按键只点亮屏幕
+    if (hardware.wakeDisplay()) {
+        Serial.println("按键唤醒显示屏");
+        return;
+    }
+    SystemState currentState = stateManager.getCurrentState();
     Serial.printf("[%lu] ★★★ 双击按键事件触发 ★★★ - 当前状态: %d\n", millis(), currentState);
     
     switch (currentState) {
@@ -521,6 +772,10 @@ void onDoubleClick() {
                 Serial.println("  -> 菜单未激活");
             }
             break;
+        case STATE_TIMING:
+            Serial.println("  -> 请求交换主从角色");
+            requestRoleSwap();
+            break;
         default:
             Serial.printf("  -> 当前状态不处理双击事件: %d\n", currentState);
             break;
@@ -528,6 +783,12 @@ void onDoubleClick() {
 }
 
 void onLongPress() {
+    // 面板关闭时看不到菜单，第一次按键只点亮屏幕
+    if (hardware.wakeDisplay()) {
+        Serial.println("按键唤醒显示屏");
+        return;
+    }
+    SystemState currentState = stateManager.getCurrentState();
     Serial.printf("[%lu] 长按按键事件 - 当前状态: %d\n", millis(), currentState);
     
     // 如果在配对模式中，处理设备确认选择或退出
@@ -550,6 +811,10 @@ void onLongPress() {
             if (menu.isMenuActive()) {
                 Serial.println("  -> 菜单确认");
                 menu.confirm();
+                // 菜单选择"开始训练"后切换到准备状态
+                if (!menu.isMenuActive()) {
+                    stateManager.postEvent(EVT_MENU_START);
+                }
             }
             break;
         case STATE_READY:
@@ -557,7 +822,7 @@ void onLongPress() {
         case STATE_COMPLETE:
             // 返回菜单
             Serial.println("  -> 返回菜单");
-            returnToMenu();
+            stateManager.postEvent(EVT_BACK);
             break;
         default:
             Serial.printf("  -> 当前状态不处理长按事件: %d\n", currentState);
@@ -567,18 +832,35 @@ void onLongPress() {
 
 // 连接状态监控函数实现
 void updateConnectionStatus() {
-    unsigned long currentTime = millis();
+    uint64_t currentTime = Clock::nowUs();
+    
+    // 开机快速重连：连接建立前按短间隔探测已知对端，之后转为常规心跳
+    if (reconnectProbe.active()) {
+        if (connectionStatus == CONN_CONNECTED) {
+            reconnectProbe.stop();
+            Serial.printf("已连接已知对端: 开机后 %lu ms, 探测 %u 次\n", millis(), reconnectProbe.sent());
+            // 保持缓存按最近连接排序
+            int index = peerCache.indexOf(peerAddress);
+            if (index > 0) {
+                peerCache.remember(peerAddress, peerCache.at(index).rssi);
+                peerCacheSave(peerCache);
+            }
+        } else if (reconnectProbe.due(currentTime)) {
+            probeKnownPeer();
+        }
+    }
     
     // 定期检查连接状态
-    if (currentTime - lastConnectionCheck >= CONNECTION_CHECK_INTERVAL) {
+    if (currentTime - lastConnectionCheck >= CONNECTION_CHECK_INTERVAL * 1000ULL) {
         lastConnectionCheck = currentTime;
         checkConnectionTimeout();
-        
-        // 发送心跳包
-        if (currentTime - lastHeartbeatSent >= HEARTBEAT_INTERVAL_MS) {
-            sendHeartbeat();
-            lastHeartbeatSent = currentTime;
-        }
+    }
+    
+    // 发送心跳包，主机随心跳广播授时；锥桶占空时等到监听窗口再发，授时时间戳不在队列中过时
+    if (currentTime - lastHeartbeatSent >= HEARTBEAT_INTERVAL_MS * 1000ULL && !radioTx.holding()) {
+        sendHeartbeat();
+        sendTimeSync();
+        lastHeartbeatSent = currentTime;
     }
 }
 
@@ -586,17 +868,18 @@ void sendHeartbeat() {
     message_t message;
     message.command = CMD_HEARTBEAT;
     message.target_id = (deviceRole == ROLE_MASTER) ? 1 : 0;
-    message.source_id = (deviceRole == ROLE_MASTER) ? 0 : 1;
-    message.timestamp = millis();
-    message.data = connectionRetryCount;
+    message.source_id = localConeId();
+    message.timestamp = Clock::stamp32();
+    message.data = batteryPackReport(txPowerPackFeedback(connectionRetryCount, lastPeerRssi),
+                                     hardware.batteryPercent());
     message.checksum = 0; // TODO: 实现校验和计算
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&message, sizeof(message));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_HEARTBEAT, CMD_HEARTBEAT);
+    if (result) {
         waitingForHeartbeatAck = true;
         Serial.printf("发送心跳包 (重试次数: %d)\n", connectionRetryCount);
     } else {
-        Serial.printf("心跳包发送失败: %d\n", result);
+        Serial.println("心跳包发送失败: 发送队列已满");
         connectionRetryCount++;
         if (connectionRetryCount >= CONNECTION_RETRY_COUNT) {
             setConnectionStatus(CONN_ERROR);
@@ -604,6 +887,605 @@ void sendHeartbeat() {
     }
 }
 
+void sendLedBrightness() {
+    // 锥桶亮度跟随主机设置，连接后和设置更改时下发
+    if (deviceRole != ROLE_MASTER || connectionStatus != CONN_CONNECTED) {
+        return;
+    }
+    message_t message;
+    message.command = CMD_LED_BRIGHTNESS;
+    message.target_id = 1;
+    message.source_id = 0;
+    message.timestamp = Clock::stamp32();
+    message.data = hardware.getSettings()->ledBrightness;
+    message.checksum = 0;
+    
+    radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL, CMD_LED_BRIGHTNESS);
+}
+
+void probeKnownPeer() {
+    // 缓存中有多个已知对端时轮流探测
+    const uint8_t* target = peerAddress;
+    if (peerCache.count() > 1) {
+        target = peerCache.at((reconnectProbe.sent() - 1) % peerCache.count()).mac;
+    }
+    
+    message_t message;
+    message.command = CMD_HEARTBEAT;
+    message.target_id = (deviceRole == ROLE_MASTER) ? 1 : 0;
+    message.source_id = localConeId();
+    message.timestamp = Clock::stamp32();
+    message.data = 0;
+    message.checksum = 0;
+    
+    // 探测不合并：轮流探测时每帧目标不同
+    radioTx.enqueue(target, &message, sizeof(message), TX_PRIO_CONTROL);
+}
+
+void adoptKnownPeer(const uint8_t* mac) {
+    // ESP-NOW回调上下文：只切换对端地址，缓存排序在主循环中更新
+    if (memcmp(mac, peerAddress, 6) != 0 && peerCache.contains(mac)) {
+        memcpy(peerAddress, mac, 6);
+        Serial.println("改用应答的已知对端");
+    }
+}
+
+void setRadioChannel(uint8_t channel) {
+    if (esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+        Serial.printf("设置信道 %d 失败\n", channel);
+        return;
+    }
+    radioChannel = channel;
+    Serial.printf("无线信道: %d\n", channel);
+}
+
+static void onPromiscuousFrame(void* buf, wifi_promiscuous_pkt_type_t type) {
+    // WiFi任务上下文：只累计当前监听信道的占空时间
+    const wifi_promiscuous_pkt_t* packet = (const wifi_promiscuous_pkt_t*)buf;
+    channelSurvey.addFrame(surveyChannel, packet->rx_ctrl.rssi, packet->rx_ctrl.sig_len);
+}
+
+static void sendLinkPing(uint8_t sequence) {
+    message_t message;
+    message.command = CMD_LINK_PING;
+    message.target_id = 1;
+    message.source_id = 0;
+    message.timestamp = Clock::stamp32();
+    message.data = sequence;
+    message.checksum = 0;
+    radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL);
+}
+
+static void sendChannelSwitch(uint64_t nowUs) {
+    message_t message;
+    message.command = CMD_CHANNEL_SWITCH;
+    message.target_id = 0xFF;
+    message.source_id = 0;
+    message.timestamp = Clock::stamp32();
+    message.data = channelSwitch.target() | ((uint32_t)channelSwitch.remainingMs(nowUs) << 8);
+    message.checksum = 0;
+    
+    // 广播通知所有锥桶，各自应答
+    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    if (!ensureBroadcastPeer() ||
+        !radioTx.enqueue(broadcastAddr, &message, sizeof(message), TX_PRIO_TIMING)) {
+        Serial.println("换信道通知发送失败: 发送队列已满");
+    }
+}
+
+static void logLinkStats(const char* label, uint8_t channel, const LinkStats& stats) {
+    Serial.printf("%s 信道%d: 探测 %d, 回应 %d, 丢包 %d%%, 往返 平均 %lu us / 最大 %lu us\n",
+                  label, channel, stats.sent, stats.received, stats.lossPercent(),
+                  (unsigned long)stats.rttAvgUs, (unsigned long)stats.rttMaxUs);
+}
+
+void serviceChannelPlan() {
+    uint64_t now = Clock::nowUs();
+    uint8_t sequence;
+    
+    switch (channelTask) {
+        case CHTASK_IDLE: {
+            // 不在约定信道且锥桶长时间无消息（错过换信道或已重启）：回约定信道会合
+            uint32_t silentUs = (uint32_t)Clock::delta32(Clock::stamp32(), lastHeartbeatReceived);
+            if (channelRendezvous.fallbackDue(radioChannel, silentUs)) {
+                Serial.printf("信道%d上失联，回约定信道%d\n", radioChannel, ESPNOW_CHANNEL);
+                setRadioChannel(ESPNOW_CHANNEL);
+            }
+            // 会话开始：首次连接后、菜单空闲时调查一次
+            if (channelSurveyPending && deviceRole == ROLE_MASTER && connectionStatus == CONN_CONNECTED &&
+                stateManager.getCurrentState() == STATE_MENU && !pairingModeActive) {
+                channelSurveyPending = false;
+                linkProbe.begin(now, CHANNEL_PROBE_COUNT, CHANNEL_PROBE_INTERVAL_US);
+                channelTask = CHTASK_PROBE_BEFORE;
+                Serial.println("信道调查开始");
+            }
+            break;
+        }
+            
+        case CHTASK_PROBE_BEFORE:
+            if (linkProbe.due(now, sequence)) {
+                sendLinkPing(sequence);
+            }
+            if (linkProbe.done(now)) {
+                linkBefore = linkProbe.result();
+                logLinkStats("换信道前", radioChannel, linkBefore);
+                
+                // 逐信道监听，每次主循环检查是否到了换下一个信道的时间
+                channelSurvey.reset();
+                surveyChannel = CHANNEL_MIN;
+                esp_wifi_set_promiscuous_rx_cb(onPromiscuousFrame);
+                esp_wifi_set_promiscuous(true);
+                esp_wifi_set_channel(surveyChannel, WIFI_SECOND_CHAN_NONE);
+                surveyDwellStartUs = now;
+                channelTask = CHTASK_SURVEY;
+            }
+            break;
+            
+        case CHTASK_SURVEY:
+            if (now - surveyDwellStartUs < CHANNEL_DWELL_US) {
+                break;
+            }
+            channelSurvey.setDwell(surveyChannel, (uint32_t)(now - surveyDwellStartUs));
+            if (surveyChannel < CHANNEL_MAX) {
+                surveyChannel = surveyChannel + 1;
+                esp_wifi_set_channel(surveyChannel, WIFI_SECOND_CHAN_NONE);
+                surveyDwellStartUs = now;
+                break;
+            }
+            
+            esp_wifi_set_promiscuous(false);
+            surveyChannel = 0;
+            esp_wifi_set_channel(radioChannel, WIFI_SECOND_CHAN_NONE);
+            Serial.print("信道占空(‰/拥塞):");
+            for (uint8_t channel = CHANNEL_MIN; channel <= CHANNEL_MAX; channel++) {
+                Serial.printf(" %d:%lu/%lu", channel, (unsigned long)channelSurvey.occupancy(channel),
+                              (unsigned long)channelSurvey.congestion(channel));
+            }
+            Serial.println();
+            {
+                uint8_t target;
+                if (channelSurvey.shouldSwitch(radioChannel, target)) {
+                    Serial.printf("换到较空闲的信道 %d -> %d\n", radioChannel, target);
+                    // 需要跟随换信道的锥桶：当前对端（按其心跳中的锥桶号）
+                    channelSwitch.begin(radioChannel, target, (uint16_t)(1u << peerConeId), now);
+                    channelTask = CHTASK_SWITCH;
+                } else {
+                    Serial.printf("当前信道%d无需更换\n", radioChannel);
+                    channelTask = CHTASK_IDLE;
+                }
+            }
+            break;
+            
+        case CHTASK_SWITCH: {
+            if (channelSwitch.announceDue(now)) {
+                sendChannelSwitch(now);
+            }
+            ChannelSwitchState previous = channelSwitch.state();
+            switch (channelSwitch.update(now)) {
+                case CHSW_VERIFYING:
+                    if (previous == CHSW_ANNOUNCING) {
+                        setRadioChannel(channelSwitch.target());
+                    }
+                    break;
+                case CHSW_DONE:
+                    linkProbe.begin(now, CHANNEL_PROBE_COUNT, CHANNEL_PROBE_INTERVAL_US);
+                    channelTask = CHTASK_PROBE_AFTER;
+                    break;
+                case CHSW_ABORTED:
+                    Serial.printf("有锥桶未应答换信道 (应答 0x%04X)，留在信道%d\n",
+                                  channelSwitch.acked(), radioChannel);
+                    channelTask = CHTASK_IDLE;
+                    break;
+                case CHSW_FAILED:
+                    Serial.printf("换信道后锥桶未出现，回约定信道%d\n", ESPNOW_CHANNEL);
+                    setRadioChannel(ESPNOW_CHANNEL);
+                    channelTask = CHTASK_IDLE;
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+            
+        case CHTASK_PROBE_AFTER:
+            if (linkProbe.due(now, sequence)) {
+                sendLinkPing(sequence);
+            }
+            if (linkProbe.done(now)) {
+                LinkStats after = linkProbe.result();
+                logLinkStats("换信道后", radioChannel, after);
+                Serial.printf("信道 %d -> %d: 丢包 %d%% -> %d%%, 平均往返 %lu -> %lu us\n",
+                              channelSwitch.source(), radioChannel, linkBefore.lossPercent(), after.lossPercent(),
+                              (unsigned long)linkBefore.rttAvgUs, (unsigned long)after.rttAvgUs);
+                channelTask = CHTASK_IDLE;
+            }
+            break;
+    }
+}
+
+bool ensureBroadcastPeer() {
+    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    if (esp_now_is_peer_exist(broadcastAddr)) {
+        return true;
+    }
+    
+    esp_now_peer_info_t broadcastPeer = {};
+    memcpy(broadcastPeer.peer_addr, broadcastAddr, 6);
+    broadcastPeer.channel = 0;
+    broadcastPeer.encrypt = false; // 广播通常不加密
+    
+    esp_err_t addResult = esp_now_add_peer(&broadcastPeer);
+    if (addResult != ESP_OK) {
+        Serial.printf("添加广播对等设备失败: %d\n", addResult);
+        return false;
+    }
+    Serial.println("成功添加广播对等设备");
+    return true;
+}
+
+void sendTimeSync(uint8_t flags) {
+    // 主机为授时源，一条广播同步所有锥桶
+    if (deviceRole != ROLE_MASTER || !timeManager.isTimeValid() || !ensureBroadcastPeer()) {
+        // 无法授时时不保留待发请求，主循环不反复重试
+        timeSyncPending = false;
+        timeSyncPendingFlags = 0;
+        return;
+    }
+    
+    // 窗口外保持的授时会过时，记下标志在下一窗口打开时补发
+    if (radioTx.holding()) {
+        timeSyncPending = true;
+        timeSyncPendingFlags |= flags;
+        return;
+    }
+    flags |= timeSyncPendingFlags;
+    timeSyncPending = false;
+    timeSyncPendingFlags = 0;
+    
+    TimeSyncMessage message = {};
+    message.command = CMD_TIME_SYNC;
+    message.flags = flags;
+    message.sequence = timeSyncSequence++;
+    message.utcOffset = timeManager.getTimezoneOffset();
+    
+    // 发送前最后一刻取时间，减小排队延迟
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    message.epochSeconds = now.tv_sec;
+    message.microseconds = now.tv_usec;
+    
+    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    bool result = radioTx.enqueue(broadcastAddr, &message, sizeof(message), TX_PRIO_TIMING, CMD_TIME_SYNC);
+    if (!result) {
+        Serial.println("授时广播发送失败: 发送队列已满");
+    }
+}
+
+static int64_t epochNowUs() {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return (int64_t)now.tv_sec * 1000000LL + now.tv_usec;
+}
+
+// 占空窗口网格：墙钟有效时用Unix时间，锥桶可按墙钟对齐而不依赖信标到达时刻
+static int64_t dutyGridUs(bool& epochGrid) {
+    epochGrid = timeManager.isTimeValid();
+    return epochGrid ? epochNowUs() : (int64_t)Clock::nowUs();
+}
+
+void serviceDutyCycle() {
+    uint64_t now = Clock::nowUs();
+    if (dutyAckPending) {
+        // 按回调记下的时刻计唤醒延迟
+        uint64_t ackUs = now - (uint32_t)Clock::delta32(Clock::stamp32(), dutyAckStamp);
+        bool alwaysOn = dutyAckMode == DUTY_ACK_ALWAYS_ON;
+        dutyAckPending = false;
+        uint32_t wakesBefore = dutyLeader.latency().wakes;
+        uint64_t totalBefore = dutyLeader.latency().totalUs;
+        dutyLeader.onAck(alwaysOn, ackUs);
+        if (dutyLeader.latency().wakes != wakesBefore) {
+            Serial.printf("锥桶已常开: 唤醒用时 %lu ms\n",
+                         (unsigned long)((dutyLeader.latency().totalUs - totalBefore) / 1000));
+        } else {
+            Serial.printf("锥桶接收: %s\n", alwaysOn ? "常开" : "占空");
+        }
+    }
+    
+    // 只有主机管理锥桶占空；未连接时锥桶本身保持常开
+    if (deviceRole != ROLE_MASTER || connectionStatus != CONN_CONNECTED) {
+        dutyLeader.reset();
+        radioTx.setHold(false);
+        if (timeSyncPending) {
+            sendTimeSync();
+        }
+        return;
+    }
+    
+    // 菜单空闲之外（训练、配对、信道调查与切换）都需要锥桶常开
+    bool armed = stateManager.getCurrentState() != STATE_MENU || pairingModeActive ||
+                 channelSurveyPending || channelTask != CHTASK_IDLE;
+    dutyLeader.setArmed(armed, now);
+    
+    bool epochGrid;
+    int64_t grid = dutyGridUs(epochGrid);
+    bool hold = dutyLeader.holdTraffic(grid);
+    radioTx.setHold(hold);
+    if (!hold && timeSyncPending) {
+        sendTimeSync();
+    }
+    if (dutyLeader.beaconDue(grid) && ensureBroadcastPeer()) {
+        message_t message;
+        message.command = CMD_DUTY_BEACON;
+        message.target_id = 0xFF;
+        message.source_id = 0;
+        message.timestamp = Clock::stamp32();
+        message.data = dutyLeader.beaconData(epochGrid);
+        message.checksum = 0;
+        
+        uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+        if (!radioTx.enqueue(broadcastAddr, &message, sizeof(message), TX_PRIO_TIMING, CMD_DUTY_BEACON)) {
+            Serial.println("占空信标发送失败: 发送队列已满");
+        }
+    }
+}
+
+// 主机发出的课程快照：课程计数来自训练，训练设置一并交给新主机
+static RoleSwapSession currentSwapSession() {
+    RoleSwapSession session = vibrationTraining.snapshotSession();
+    const SystemSettings* settings = hardware.getSettings();
+    session.alertSeconds = settings->alertDuration;
+    session.ledColor = settings->ledColor;
+    session.ledBrightness = settings->ledBrightness;
+    session.flags = settings->soundEnabled ? ROLE_SWAP_FLAG_SOUND : 0;
+    return session;
+}
+
+// 采用对端的训练设置，只有变化的字段才提交
+static void adoptSwapSettings(const RoleSwapSession& session) {
+    SystemSettings* settings = hardware.getSettings();
+    bool soundEnabled = (session.flags & ROLE_SWAP_FLAG_SOUND) != 0;
+    if (settings->soundEnabled != soundEnabled) {
+        settings->soundEnabled = soundEnabled;
+        settingsStore.markDirty(SETTINGS_FIELD_SOUND);
+    }
+    if (session.ledColor < LED_COLOR_COUNT && settings->ledColor != session.ledColor) {
+        settings->ledColor = (LedColorOption)session.ledColor;
+        settingsStore.markDirty(SETTINGS_FIELD_LED_COLOR);
+    }
+    if (session.ledBrightness <= 100 && settings->ledBrightness != session.ledBrightness) {
+        settings->ledBrightness = session.ledBrightness;
+        hardware.setLedBrightness(settings->ledBrightness);
+        settingsStore.markDirty(SETTINGS_FIELD_BRIGHTNESS);
+    }
+    if (session.alertSeconds > 0 && settings->alertDuration != session.alertSeconds) {
+        settings->alertDuration = session.alertSeconds;
+        settingsStore.markDirty(SETTINGS_FIELD_ALERT);
+    }
+}
+
+static void sendRoleSwapFrame(const RoleSwapFrame& frame) {
+    if (!radioTx.enqueue(peerAddress, &frame, sizeof(frame), TX_PRIO_TIMING)) {
+        Serial.println("角色交换帧发送失败: 发送队列已满");
+    }
+}
+
+void requestRoleSwap() {
+    if (menu.getCurrentMode() != MODE_VIBRATION_TRAINING || !vibrationTraining.isRunning() ||
+        deviceRole == ROLE_UNDEFINED || connectionStatus != CONN_CONNECTED) {
+        Serial.println("角色交换只在双机震动训练中可用");
+        return;
+    }
+    roleSwap.request();
+    Serial.println(vibrationTraining.isBetweenRounds() ? "请求交换主从角色" : "本回合结束后交换主从角色");
+}
+
+void serviceRoleSwap() {
+    if (deviceRole == ROLE_UNDEFINED) {
+        roleSwapInboxFull = false;
+        return;
+    }
+    // 配对重新确定了角色
+    if (roleSwap.isMaster() != (deviceRole == ROLE_MASTER)) {
+        roleSwap.begin(deviceRole == ROLE_MASTER);
+    }
+    
+    uint64_t now = Clock::nowUs();
+    bool betweenRounds = menu.getCurrentMode() == MODE_VIBRATION_TRAINING &&
+                         connectionStatus == CONN_CONNECTED && vibrationTraining.isBetweenRounds();
+    RoleSwapFrame frame;
+    if (roleSwapInboxFull) {
+        RoleSwapFrame received = roleSwapInbox;
+        roleSwapInboxFull = false;
+        if (roleSwap.receive(received, now, betweenRounds, frame)) {
+            sendRoleSwapFrame(frame);
+        }
+    }
+    
+    if (roleSwap.takeRoleChanged()) {
+        if (roleSwap.isMaster()) {
+            // 先采用设置，达标提醒按新的提醒时长接续
+            deviceRole = ROLE_MASTER;
+            adoptSwapSettings(roleSwap.adopted());
+            vibrationTraining.adoptSession(roleSwap.adopted());
+            Serial.println("角色交换: 本机成为主机（终点）");
+        } else {
+            deviceRole = ROLE_SLAVE;
+            vibrationTraining.handOverSession();
+            // 收到ACCEPT交出主机时计数增加；被CANCEL退回从机时不变
+            static uint32_t swapsLogged = 0;
+            if (roleSwap.swaps() != swapsLogged) {
+                swapsLogged = roleSwap.swaps();
+                Serial.printf("角色交换: 本机成为从机（起点），交接用时 %lu ms\n",
+                             (unsigned long)(roleSwap.lastSwapUs() / 1000));
+            } else {
+                Serial.println("角色交换: 本机成为从机（起点）");
+            }
+        }
+        hardware.playStartSound();
+    }
+    
+    if (roleSwap.poll(now, betweenRounds, currentSwapSession(), frame)) {
+        if (frame.phase == ROLE_SWAP_CANCEL) {
+            Serial.println("角色交换超时，保持本机为主机");
+        }
+        sendRoleSwapFrame(frame);
+    }
+}
+
+bool sendGroupCommand(uint16_t targetMask, const GroupTarget* targets) {
+    if (!ensureBroadcastPeer()) {
+        return false;
+    }
+    
+    // 墙钟有效时定时执行，给广播和各锥桶主循环留出提前量；否则收到即执行
+    bool clockValid = timeManager.isTimeValid();
+    int64_t epochUs = epochNowUs();
+    GroupCommandHeader header = {};
+    header.command = CMD_GROUP_COMMAND;
+    header.mode = clockValid ? GROUP_APPLY_AT : GROUP_APPLY_NOW;
+    header.sequence = ++groupSequence;
+    header.targetMask = targetMask;
+    header.goEpochUs = epochUs + GROUP_GO_LEAD_US;
+    
+    uint8_t frame[GROUP_FRAME_MAX_BYTES];
+    uint8_t length = groupEncode(header, targets, frame);
+    
+    // 重复广播，接收方按序号去重
+    uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    uint8_t queued = 0;
+    for (uint8_t i = 0; i < GROUP_REPEAT; i++) {
+        if (radioTx.enqueue(broadcastAddr, frame, length, TX_PRIO_TIMING)) {
+            queued++;
+        }
+    }
+    if (queued == 0) {
+        Serial.println("组命令发送失败: 发送队列已满");
+        return false;
+    }
+    
+    for (uint8_t cone = 0; cone < GROUP_MAX_CONES; cone++) {
+        groupReportReady[cone] = false;
+    }
+    uint16_t reportMask = 0;
+    for (uint8_t cone = 0; cone < GROUP_MAX_CONES; cone++) {
+        if ((targetMask & (1u << cone)) && (targets[cone].flags & GROUP_FLAG_REPORT)) {
+            reportMask |= 1u << cone;
+        }
+    }
+    groupSkew.begin(header.sequence, reportMask);
+    groupReceiver.receive(frame, length, Clock::nowUs(), epochUs - (int64_t)Clock::nowUs(), clockValid);
+    Serial.printf("组命令 #%u 已广播: 目标=0x%04X, %s\n", header.sequence, targetMask,
+                  clockValid ? "定时执行" : "立即执行");
+    return true;
+}
+
+// 主机直接计入偏差统计，从机回报给主机
+static void sendGroupReport(const GroupAction& action, int32_t latenessUs) {
+    if (deviceRole != ROLE_SLAVE) {
+        groupSkew.record(action.sequence, localConeId(), latenessUs);
+        return;
+    }
+    message_t message;
+    message.command = CMD_GROUP_REPORT;
+    message.target_id = 0;
+    message.source_id = localConeId();
+    message.timestamp = Clock::stamp32();
+    message.data = groupPackReport(action.sequence, latenessUs);
+    message.checksum = 0;
+    
+    if (!radioTx.enqueue(peerAddress, &message, sizeof(message), TX_PRIO_CONTROL)) {
+        Serial.println("组命令回报发送失败: 发送队列已满");
+    }
+}
+
+static void applyGroupTarget(const GroupTarget& target) {
+    if (target.flags & GROUP_FLAG_LIGHT) {
+        switch (target.effect) {
+            case GROUP_EFFECT_OFF:
+                hardware.clearLEDs();
+                hardware.showLEDs();
+                break;
+            case GROUP_EFFECT_BREATHE:
+                hardware.ledBreathingEffect(groupColor(target));
+                break;
+            default:
+                hardware.setAllLEDs(groupColor(target));
+                hardware.showLEDs();
+                break;
+        }
+    }
+    if (target.flags & GROUP_FLAG_ARM) {
+        stateManager.postEvent(EVT_START_LINKED);
+    }
+    if (target.flags & GROUP_FLAG_DISARM) {
+        stateManager.postEvent(EVT_REMOTE_RESET);
+    }
+}
+
+// 本机锥桶号：按CONE_ID，运行时成为从机而未配置锥桶号时为1
+uint8_t localConeId() {
+    if (deviceRole == ROLE_SLAVE && CONE_ID == 0) {
+        return 1;
+    }
+    return CONE_ID;
+}
+
+void serviceGroupCommand() {
+    groupReceiver.setConeId(localConeId());
+    if (groupFrameLength != 0) {
+        // 本固件作从机时不接收授时：主机在发出前GROUP_GO_LEAD_US设定执行时刻，
+        // 以收到时刻加提前量执行，与主机的偏差为排队和空中时间
+        uint64_t now = Clock::nowUs();
+        uint64_t receivedUs = now - Clock::delta32(Clock::stamp32(), groupFrameStamp);
+        GroupCommandHeader header;
+        int64_t offsetUs = 0;
+        bool timed = groupFrameLength >= sizeof(header);
+        if (timed) {
+            memcpy(&header, groupFrame, sizeof(header));
+            offsetUs = header.goEpochUs - GROUP_GO_LEAD_US - (int64_t)receivedUs;
+        }
+        GroupReceiveResult result = groupReceiver.receive(groupFrame, groupFrameLength, now, offsetUs, timed);
+        groupFrameLength = 0;
+        if (result == GROUP_RX_SCHEDULED) {
+            Serial.printf("组命令已排定: %llu us 后执行\n", (unsigned long long)(groupReceiver.dueAtUs() - now));
+        } else if (result == GROUP_RX_IMMEDIATE || result == GROUP_RX_LATE) {
+            Serial.println("组命令立即执行");
+        }
+    }
+    
+    if (groupReceiver.pending()) {
+        uint64_t now = Clock::nowUs();
+        uint64_t due = groupReceiver.dueAtUs();
+        // 执行时刻在下一轮主循环之前：忙等到点，执行时刻不受主循环周期影响
+        if (due <= now || due - now < GROUP_SPIN_US) {
+            GroupAction action;
+            while (!groupReceiver.take(now, action)) {
+                now = Clock::nowUs();
+            }
+            applyGroupTarget(action.target);
+            if (action.target.flags & GROUP_FLAG_REPORT) {
+                sendGroupReport(action, (int32_t)(now - action.applyAtUs));
+            }
+        }
+    }
+    
+    if (groupSkew.expected() == 0) {
+        return;
+    }
+    for (uint8_t cone = 0; cone < GROUP_MAX_CONES; cone++) {
+        if (groupReportReady[cone]) {
+            uint32_t report = groupReports[cone];
+            groupReportReady[cone] = false;
+            groupSkew.record(groupReportSequence(report), cone, groupReportLateness(report));
+        }
+    }
+    if (groupSkew.complete()) {
+        Serial.printf("组命令 #%u 锥桶间偏差 %ld us (最早 %ld us, 最晚 %ld us)\n", groupSkew.sequence(),
+                      (long)groupSkew.skewUs(), (long)groupSkew.earliestUs(), (long)groupSkew.latestUs());
+        groupSkew.begin(0, 0);
+    }
+}
+
 void handleHeartbeat(const message_t& message) {
     Serial.printf("收到心跳包，源ID: %d\n", message.source_id);
     
@@ -611,26 +1493,26 @@ void handleHeartbeat(const message_t& message) {
     message_t ackMessage;
     ackMessage.command = CMD_HEARTBEAT_ACK;
     ackMessage.target_id = message.source_id;
-    ackMessage.source_id = (deviceRole == ROLE_MASTER) ? 0 : 1;
-    ackMessage.timestamp = millis();
-    ackMessage.data = 0;
+    ackMessage.source_id = localConeId();
+    ackMessage.timestamp = Clock::stamp32();
+    ackMessage.data = batteryPackReport(txPowerPackFeedback(0, lastPeerRssi), hardware.batteryPercent());
     ackMessage.checksum = 0; // TODO: 实现校验和计算
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&ackMessage, sizeof(ackMessage));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &ackMessage, sizeof(ackMessage), TX_PRIO_HEARTBEAT, CMD_HEARTBEAT_ACK);
+    if (result) {
         setConnectionStatus(CONN_CONNECTED);
         Serial.println("发送心跳应答");
     } else {
-        Serial.printf("心跳应答发送失败: %d\n", result);
+        Serial.println("心跳应答发送失败: 发送队列已满");
     }
 }
 
 void checkConnectionTimeout() {
-    unsigned long currentTime = millis();
+    uint64_t currentTime = Clock::nowUs();
     
     // 检查是否超时
     if (connectionStatus == CONN_CONNECTED || connectionStatus == CONN_CONNECTING) {
-        if (currentTime - lastHeartbeatReceived > HEARTBEAT_TIMEOUT_MS) {
+        if (Clock::delta32(Clock::stamp32(), lastHeartbeatReceived) > HEARTBEAT_TIMEOUT_MS * 1000L) {
             Serial.println("连接超时，尝试重连...");
             setConnectionStatus(CONN_TIMEOUT);
             connectionRetryCount++;
@@ -646,7 +1528,7 @@ void checkConnectionTimeout() {
     }
     
     // 检查心跳应答超时
-    if (waitingForHeartbeatAck && (currentTime - lastHeartbeatSent > HEARTBEAT_TIMEOUT_MS / 2)) {
+    if (waitingForHeartbeatAck && (currentTime - lastHeartbeatSent > HEARTBEAT_TIMEOUT_MS / 2 * 1000ULL)) {
         Serial.println("心跳应答超时");
         waitingForHeartbeatAck = false;
         connectionRetryCount++;
@@ -668,11 +1550,29 @@ void setConnectionStatus(ConnectionStatus status) {
                      getConnectionStatusString(oldStatus),
                      getConnectionStatusString(status));
         
+        // 每次连接为一个功率统计会话，断开时输出
+        if (status == CONN_CONNECTED) {
+            txPower.resetStats();
+            dutyLeader.resetStats();
+        } else if (oldStatus == CONN_CONNECTED) {
+            hardware.clearConeBatteries();
+            TxPowerStats power = txPower.stats();
+            int32_t avg = power.averageDeciDbm();
+            Serial.printf("发射功率: 平均 %ld.%ld dBm (%lu帧), 降 %u 次, 升 %u 次, 丢包回满 %u 次\n",
+                         (long)(avg / 10), (long)(avg % 10), (unsigned long)power.frames,
+                         power.stepsDown, power.stepsUp, power.snaps);
+            const DutyLatencyStats& duty = dutyLeader.latency();
+            Serial.printf("锥桶占空: 唤醒 %lu 次, 平均 %lu ms, 最长 %lu ms (上限 %lu ms)\n",
+                         (unsigned long)duty.wakes, (unsigned long)(duty.averageUs() / 1000),
+                         (unsigned long)(duty.maxUs / 1000), (unsigned long)(dutyLeader.latencyBoundUs() / 1000));
+        }
+        
         // 根据连接状态更新硬件指示
         switch (status) {
             case CONN_CONNECTED:
                 connectionRetryCount = 0;
                 hardware.setAllLEDs(COLOR_GREEN);
+                sendLedBrightness();
                 break;
             case CONN_CONNECTING:
                 hardware.setAllLEDs(COLOR_YELLOW);
@@ -686,6 +1586,8 @@ void setConnectionStatus(ConnectionStatus status) {
                 break;
         }
         hardware.showLEDs();
+        
+        stateManager.postEvent(EVT_LINK_CHANGED);
     }
 }
 
@@ -710,61 +1612,52 @@ void startDevicePairing() {
     pairingModeActive = true;
     pairingStatus = PAIRING_SCANNING;
     pairingStartTime = millis();
+    pairingStatusTime = pairingStartTime;
+    lastPairingStatus = PAIRING_SCANNING;
     discoveredDeviceCount = 0;
     selectedDeviceIndex = 0;
     
     // 清空发现的设备列表
     memset(discoveredDevices, 0, sizeof(discoveredDevices));
     
-    // 开始广播配对请求
+    // 主动发现：第一个探测在下一次主循环发出，之后带抖动重复发送直到有设备应答
+    peerDiscovery.begin(Clock::nowUs(), localMacSeed());
+    
+    Serial.println("开始设备配对扫描...");
+    displayPairingStatus();
+}
+
+void sendPairingProbe() {
     message_t pairingMsg;
     pairingMsg.command = CMD_PAIRING_REQUEST;
     pairingMsg.target_id = 0xFF; // 广播
-    pairingMsg.source_id = (deviceRole == ROLE_MASTER) ? 0 : 1;
-    pairingMsg.timestamp = millis();
+    pairingMsg.source_id = localConeId();
+    pairingMsg.timestamp = Clock::stamp32();
     pairingMsg.data = 0;
     pairingMsg.checksum = 0;
     
     // 添加广播地址作为对等设备（如果尚未添加）
     uint8_t broadcastAddr[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
-    
-    // 检查是否已存在广播对等设备
-    if (!esp_now_is_peer_exist(broadcastAddr)) {
-        esp_now_peer_info_t broadcastPeer = {};
-        memcpy(broadcastPeer.peer_addr, broadcastAddr, 6);
-        broadcastPeer.channel = ESPNOW_CHANNEL;
-        broadcastPeer.encrypt = false; // 广播通常不加密
-        
-        esp_err_t addResult = esp_now_add_peer(&broadcastPeer);
-        if (addResult != ESP_OK) {
-            Serial.printf("添加广播对等设备失败: %d\n", addResult);
-        } else {
-            Serial.println("成功添加广播对等设备");
-        }
-    }
+    ensureBroadcastPeer();
     
     // 广播配对请求
-    esp_err_t broadcastResult = esp_now_send(broadcastAddr, (uint8_t*)&pairingMsg, sizeof(pairingMsg));
-    if (broadcastResult == ESP_OK) {
-        Serial.println("广播配对请求发送成功");
-    } else {
-        Serial.printf("广播配对请求发送失败: %d\n", broadcastResult);
+    bool broadcastResult = radioTx.enqueue(broadcastAddr, &pairingMsg, sizeof(pairingMsg), TX_PRIO_CONTROL);
+    if (!broadcastResult) {
+        Serial.println("广播配对请求发送失败: 发送队列已满");
     }
-    
-    Serial.println("开始设备配对扫描...");
-    displayPairingStatus();
 }
 
 void stopDevicePairing() {
     pairingModeActive = false;
     pairingStatus = PAIRING_IDLE;
+    peerDiscovery.stop();
     
     // 重置显示状态变量
     lastDisplayedPairingStatus = PAIRING_IDLE;
     lastPairingDisplayUpdate = 0;
     
     // 恢复菜单显示
-    if (currentState == STATE_MENU) {
+    if (stateManager.getCurrentState() == STATE_MENU) {
         menu.update(); // 强制刷新菜单显示
     }
     
@@ -773,29 +1666,69 @@ void stopDevicePairing() {
 
 void updatePairingProcess() {
     unsigned long currentTime = millis();
+    uint64_t nowUs = Clock::nowUs();
+    
+    // 记录进入当前状态的时刻（状态也可能在ESP-NOW回调中改变）
+    if (pairingStatus != lastPairingStatus) {
+        lastPairingStatus = pairingStatus;
+        pairingStatusTime = currentTime;
+        if (pairingStatus == PAIRING_SUCCESS) {
+            // 配对成功的设备记入已知对端缓存，下次开机直接重连
+            int8_t rssi = discoveredDeviceCount > 0 ? discoveredDevices[selectedDeviceIndex].rssi : 0;
+            peerCache.remember(peerAddress, rssi);
+            peerCacheSave(peerCache);
+            Serial.printf("配对用时 %lu ms\n", currentTime - pairingStartTime);
+        }
+    }
     
-    // 检查配对超时
-    if (currentTime - pairingStartTime > PAIRING_TIMEOUT_MS) {
-        pairingStatus = PAIRING_TIMEOUT;
-        Serial.println("配对超时");
-        displayPairingStatus();
-        delay(2000);
-        stopDevicePairing();
-        return;
+    // 检查配对超时（结果状态只等待显示结束）
+    if (pairingStatus == PAIRING_SCANNING || pairingStatus == PAIRING_FOUND_DEVICE ||
+        pairingStatus == PAIRING_CONNECTING) {
+        if (currentTime - pairingStartTime > PAIRING_TIMEOUT_MS) {
+            pairingStatus = PAIRING_TIMEOUT;
+            Serial.println("配对超时");
+            displayPairingStatus();
+            return;
+        }
     }
     
     switch (pairingStatus) {
         case PAIRING_SCANNING:
-            // 扫描阶段 - 定期发送配对请求
-            if (currentTime - pairingStartTime > PAIRING_SCAN_DURATION_MS) {
-                if (discoveredDeviceCount > 0) {
-                    pairingStatus = PAIRING_FOUND_DEVICE;
-                    Serial.printf("发现 %d 个设备\n", discoveredDeviceCount);
-                } else {
+            // 扫描阶段 - 带抖动重复探测，有设备应答后短暂收集即结束
+            if (peerDiscovery.probeDue(nowUs)) {
+                sendPairingProbe();
+            }
+            if (discoveredDeviceCount > 0) {
+                peerDiscovery.onResponse(nowUs);
+            }
+            switch (peerDiscovery.update(nowUs)) {
+                case DISCOVERY_DONE: {
+                    rankDiscoveredDevices();
+                    Serial.printf("发现 %d 个设备 (用时 %lu ms, 探测 %u 次)\n", discoveredDeviceCount,
+                                  currentTime - pairingStartTime, peerDiscovery.probesSent());
+                    // 已知设备或唯一设备直接确认，否则等待用户选择
+                    int known = -1;
+                    for (int i = 0; i < discoveredDeviceCount && known < 0; i++) {
+                        if (peerCache.contains(discoveredDevices[i].mac)) {
+                            known = i;
+                        }
+                    }
+                    if (known >= 0 || discoveredDeviceCount == 1) {
+                        selectedDeviceIndex = known >= 0 ? known : 0;
+                        sendPairingRequest(discoveredDevices[selectedDeviceIndex].mac);
+                    } else {
+                        pairingStatus = PAIRING_FOUND_DEVICE;
+                    }
+                    displayPairingStatus();
+                    break;
+                }
+                case DISCOVERY_EMPTY:
                     pairingStatus = PAIRING_FAILED;
                     Serial.println("未发现兼容设备");
-                }
-                displayPairingStatus();
+                    displayPairingStatus();
+                    break;
+                default:
+                    break;
             }
             break;
             
@@ -805,9 +1738,10 @@ void updatePairingProcess() {
             break;
             
         case PAIRING_CONNECTING:
-            // 连接阶段超时检查
-            if (currentTime - pairingStartTime > PAIRING_TIMEOUT_MS - 2000) {
+            // 等待对端确认
+            if (currentTime - pairingStatusTime > PAIRING_CONFIRM_TIMEOUT_MS) {
                 pairingStatus = PAIRING_FAILED;
+                Serial.println("对端未确认配对");
                 displayPairingStatus();
             }
             break;
@@ -815,34 +1749,51 @@ void updatePairingProcess() {
         case PAIRING_SUCCESS:
         case PAIRING_FAILED:
         case PAIRING_TIMEOUT:
-            // 显示结果后自动退出
-            if (currentTime - pairingStartTime > PAIRING_TIMEOUT_MS + 2000) {
+            // 显示结果后自动退出，不阻塞主循环
+            if (currentTime - pairingStatusTime > PAIRING_RESULT_SHOW_MS) {
                 stopDevicePairing();
             }
             break;
+            
+        default:
+            break;
     }
 }
 
+void rankDiscoveredDevices() {
+    // 按实测信号强度从强到弱排序（插入排序，设备数不超过MAX_DISCOVERED_DEVICES）
+    for (int i = 1; i < discoveredDeviceCount; i++) {
+        DiscoveredDevice device = discoveredDevices[i];
+        int j = i - 1;
+        while (j >= 0 && discoveredDevices[j].rssi < device.rssi) {
+            discoveredDevices[j + 1] = discoveredDevices[j];
+            j--;
+        }
+        discoveredDevices[j + 1] = device;
+    }
+    selectedDeviceIndex = 0;
+}
+
 void sendPairingRequest(const uint8_t* targetMac) {
     message_t pairingMsg;
     pairingMsg.command = CMD_PAIRING_CONFIRM;
     pairingMsg.target_id = 1;
-    pairingMsg.source_id = (deviceRole == ROLE_MASTER) ? 0 : 1;
-    pairingMsg.timestamp = millis();
+    pairingMsg.source_id = localConeId();
+    pairingMsg.timestamp = Clock::stamp32();
     pairingMsg.data = 0;
     pairingMsg.checksum = 0;
     
-    esp_err_t result = esp_now_send(targetMac, (uint8_t*)&pairingMsg, sizeof(pairingMsg));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(targetMac, &pairingMsg, sizeof(pairingMsg), TX_PRIO_CONTROL);
+    if (result) {
         pairingStatus = PAIRING_CONNECTING;
         Serial.println("发送配对确认");
     } else {
         pairingStatus = PAIRING_FAILED;
-        Serial.printf("配对确认发送失败: %d\n", result);
+        Serial.println("配对确认发送失败: 发送队列已满");
     }
 }
 
-void handlePairingMessage(const message_t& message, const uint8_t* senderMac) {
+void handlePairingMessage(const message_t& message, const uint8_t* senderMac, int8_t rssi) {
     switch (message.command) {
         case CMD_PAIRING_REQUEST:
             Serial.println("收到配对请求");
@@ -850,7 +1801,7 @@ void handlePairingMessage(const message_t& message, const uint8_t* senderMac) {
             if (!esp_now_is_peer_exist(senderMac)) {
                 esp_now_peer_info_t senderPeer = {};
                 memcpy(senderPeer.peer_addr, senderMac, 6);
-                senderPeer.channel = ESPNOW_CHANNEL;
+                senderPeer.channel = 0;
                 senderPeer.encrypt = false; // 配对期间不加密
                 
                 esp_err_t addResult = esp_now_add_peer(&senderPeer);
@@ -865,28 +1816,33 @@ void handlePairingMessage(const message_t& message, const uint8_t* senderMac) {
                 message_t response;
                 response.command = CMD_DEVICE_INFO;
                 response.target_id = message.source_id;
-                response.source_id = (deviceRole == ROLE_MASTER) ? 0 : 1;
-                response.timestamp = millis();
+                response.source_id = localConeId();
+                response.timestamp = Clock::stamp32();
                 response.data = deviceRole; // 发送角色信息
                 response.checksum = 0;
                 
-                esp_err_t sendResult = esp_now_send(senderMac, (uint8_t*)&response, sizeof(response));
-                if (sendResult == ESP_OK) {
+                bool sendResult = radioTx.enqueue(senderMac, &response, sizeof(response), TX_PRIO_CONTROL);
+                if (sendResult) {
                     Serial.println("发送设备信息回应成功");
                 } else {
-                    Serial.printf("发送设备信息回应失败: %d\n", sendResult);
+                    Serial.println("发送设备信息回应失败: 发送队列已满");
                 }
             }
             break;
             
         case CMD_DEVICE_INFO:
             Serial.printf("收到设备信息，角色: %d\n", message.data);
+            // 角色相同的设备不能组成一对
+            if (deviceRole != ROLE_UNDEFINED && message.data == (uint32_t)deviceRole) {
+                Serial.println("对端角色相同，忽略");
+                break;
+            }
             
             // 确保发送者已被添加为对等设备
             if (!esp_now_is_peer_exist(senderMac)) {
                 esp_now_peer_info_t senderPeer = {};
                 memcpy(senderPeer.peer_addr, senderMac, 6);
-                senderPeer.channel = ESPNOW_CHANNEL;
+                senderPeer.channel = 0;
                 senderPeer.encrypt = false; // 配对期间不加密
                 
                 esp_err_t addResult = esp_now_add_peer(&senderPeer);
@@ -897,7 +1853,7 @@ void handlePairingMessage(const message_t& message, const uint8_t* senderMac) {
                 }
             }
             
-            addDiscoveredDevice(senderMac, -50); // 假设信号强度
+            addDiscoveredDevice(senderMac, rssi);
             break;
             
         case CMD_PAIRING_CONFIRM:
@@ -1,4 +1,8 @@
 #include "menu.h"
+#include "settings_store.h"
+#include "time_manager.h"
+#include "time_sync.h"
+#include "clock.h"
 
 // 外部变量声明
 extern DeviceRole deviceRole;
@@ -16,13 +20,13 @@ const int MenuManager::menuItemCount = MENU_ITEM_COUNT;
 MenuManager::MenuManager() 
     : menuActive(true), currentMenuItem(0), currentMode(MODE_SINGLE_TIMER),
       currentMenuState(MENU_STATE_MAIN), currentSettingsItem(0),
-      currentSettingsDetail(SETTING_SOUND_TOGGLE), adjustmentValue(0) {}
+      currentSettingsDetail(SETTING_SOUND_TOGGLE), adjustmentValue(0),
+      historyRange(HISTORY_RANGE_7_DAYS) {}
 
 void MenuManager::init() {
     menuActive = true;
     currentMenuItem = 0;
     currentMenuState = MENU_STATE_MAIN;
-    hardware.initializeSettings();
     show();
 }
 
@@ -45,6 +49,9 @@ void MenuManager::show() {
         case MENU_STATE_SETTINGS_DETAIL:
             showSettingsDetail();
             break;
+        case MENU_STATE_HISTORY:
+            showHistory();
+            break;
     }
 }
 
@@ -61,6 +68,9 @@ void MenuManager::selectNext() {
         case MENU_STATE_SETTINGS_DETAIL:
             handleSettingsAdjustment(true);
             return; // 不播放导航音效
+        case MENU_STATE_HISTORY:
+            historyRange = (HistoryRange)((historyRange + 1) % HISTORY_RANGE_COUNT);
+            break;
     }
     
     show();
@@ -82,6 +92,9 @@ void MenuManager::selectPrevious() {
         case MENU_STATE_SETTINGS_DETAIL:
             handleSettingsAdjustment(false);
             return; // 不播放导航音效
+        case MENU_STATE_HISTORY:
+            historyRange = (HistoryRange)((historyRange - 1 + HISTORY_RANGE_COUNT) % HISTORY_RANGE_COUNT);
+            break;
     }
     
     show();
@@ -103,6 +116,11 @@ void MenuManager::confirm() {
         case MENU_STATE_SETTINGS_DETAIL:
             handleSettingsDetailSelection();
             break;
+        case MENU_STATE_HISTORY:
+            // 长按退出历史数据
+            currentMenuState = MENU_STATE_MAIN;
+            show();
+            break;
     }
     
     if (hardware.getSettings()->soundEnabled) {
@@ -126,6 +144,10 @@ void MenuManager::back() {
             currentMenuState = MENU_STATE_SETTINGS;
             show();
             break;
+        case MENU_STATE_HISTORY:
+            currentMenuState = MENU_STATE_MAIN;
+            show();
+            break;
     }
     
     if (hardware.getSettings()->soundEnabled) {
@@ -209,6 +231,17 @@ void MenuManager::showSettingsDetail() {
     hardware.showLEDs();
 }
 
+void MenuManager::showHistory() {
+    hardware.displayHistoryData(historyRange);
+    
+    // LED指示当前范围
+    hardware.clearLEDs();
+    for (int i = 0; i < HISTORY_RANGE_COUNT && i < LED_COUNT; i++) {
+        hardware.setLED(i, i == historyRange ? COLOR_YELLOW : 0x000010);
+    }
+    hardware.showLEDs();
+}
+
 void MenuManager::handleMenuSelection() {
     switch (currentMenuItem) {
         case MENU_START_TRAINING:
@@ -226,9 +259,10 @@ void MenuManager::handleMenuSelection() {
         case MENU_HISTORY_DATA:
             currentMode = MODE_VIBRATION_TRAINING;
             Serial.println("选择了历史数据");
-            hardware.displayHistoryData();
-            delay(3000); // 显示3秒
-            show(); // 返回主菜单
+            // 单击切换7/30/90天，长按返回主菜单
+            currentMenuState = MENU_STATE_HISTORY;
+            historyRange = HISTORY_RANGE_7_DAYS;
+            show();
             break;
             
         case MENU_SYSTEM_SETTINGS:
@@ -261,6 +295,10 @@ void MenuManager::handleSettingsSelection() {
         case SETTING_DEVICE_PAIRING:
             adjustmentValue = 0;
             break;
+        case SETTING_ENERGY_REPORT:
+            energyAccount.advance(Clock::nowUs());
+            adjustmentValue = 0;
+            break;
         default:
             adjustmentValue = 0;
             break;
@@ -287,6 +325,7 @@ void MenuManager::handleSettingsAdjustment(bool increase) {
         case SETTING_SOUND_TOGGLE:
             settings->soundEnabled = !settings->soundEnabled;
             Serial.printf("声音开关: %s\n", settings->soundEnabled ? "开启" : "关闭");
+            settingsStore.markDirty(SETTINGS_FIELD_SOUND);
             break;
             
         case SETTING_LED_COLOR:
@@ -296,6 +335,7 @@ void MenuManager::handleSettingsAdjustment(bool increase) {
                 settings->ledColor = (LedColorOption)((settings->ledColor - 1 + LED_COLOR_COUNT) % LED_COLOR_COUNT);
             }
             Serial.printf("LED颜色: %d\n", settings->ledColor);
+            settingsStore.markDirty(SETTINGS_FIELD_LED_COLOR);
             break;
             
         case SETTING_LED_BRIGHTNESS:
@@ -306,6 +346,18 @@ void MenuManager::handleSettingsAdjustment(bool increase) {
             }
             adjustmentValue = settings->ledBrightness;
             Serial.printf("LED亮度: %d\n", settings->ledBrightness);
+            settingsStore.markDirty(SETTINGS_FIELD_BRIGHTNESS);
+            break;
+            
+        case SETTING_DATE_TIME:
+            // 单键只能加减，按小时调整；修改后立即广播给所有从机
+            timeManager.adjustTime(increase ? 3600 : -3600);
+            timeManager.updateSystemSettings(settings);
+            Serial.printf("时间调整为: %s\n", timeManager.formatTime().c_str());
+            {
+                extern void sendTimeSync(uint8_t flags);
+                sendTimeSync(TIME_SYNC_FLAG_SET);
+            }
             break;
             
         case SETTING_ALERT_DURATION:
@@ -316,6 +368,7 @@ void MenuManager::handleSettingsAdjustment(bool increase) {
             }
             adjustmentValue = settings->alertDuration;
             Serial.printf("提醒时长: %d 秒\n", settings->alertDuration);
+            settingsStore.markDirty(SETTINGS_FIELD_ALERT);
             break;
             
         case SETTING_DEVICE_PAIRING:
@@ -332,6 +385,15 @@ void MenuManager::handleSettingsAdjustment(bool increase) {
             }
             break;
             
+        case SETTING_ENERGY_REPORT:
+            // 单击刷新，双击开始新的统计会话
+            energyAccount.advance(Clock::nowUs());
+            if (!increase) {
+                energyAccount.begin(Clock::nowUs());
+                Serial.println("能耗统计已清零");
+            }
+            break;
+            
         default:
             break;
     }
@@ -349,9 +411,10 @@ void MenuManager::applySettingsChange() {
 void MenuManager::updateSystemSettings() {
     SystemSettings* settings = hardware.getSettings();
     
-    // 更新LED亮度
-    int ledBrightness = (settings->ledBrightness * 255) / 100;
-    FastLED.setBrightness(ledBrightness);
+    // 更新LED亮度，并同步给锥桶
+    hardware.setLedBrightness(settings->ledBrightness);
+    extern void sendLedBrightness();
+    sendLedBrightness();
     
     // 立即显示LED更改
     show();
@@ -0,0 +1,116 @@
+#include "settings_codec.h"
+#include <string.h>
+#include "crc32.h"
+
+// 迁移表，下标为源版本；version 1 为首个持久化版本，暂无迁移
+static const SettingsMigration kSettingsMigrations[SETTINGS_SCHEMA_VERSION + 1] = {
+    nullptr,  // 0: 无效
+    nullptr,  // 1 -> 2
+};
+
+void settingsApplyDefaults(SystemSettings& settings) {
+    settings.soundEnabled = DEFAULT_SOUND_ENABLED;
+    settings.ledColor = DEFAULT_LED_COLOR;
+    settings.ledBrightness = DEFAULT_LED_BRIGHTNESS;
+    settings.alertDuration = DEFAULT_ALERT_DURATION;
+    memset(settings.pairedDeviceMac, 0, sizeof(settings.pairedDeviceMac));
+    settings.hasPairedDevice = false;
+}
+
+size_t settingsEncode(const SystemSettings& settings, uint8_t* buffer, size_t size) {
+    if (size < SETTINGS_BLOB_SIZE) {
+        return 0;
+    }
+
+    buffer[0] = SETTINGS_BLOB_MAGIC & 0xFF;
+    buffer[1] = SETTINGS_BLOB_MAGIC >> 8;
+    buffer[2] = SETTINGS_SCHEMA_VERSION;
+    buffer[3] = SETTINGS_PAYLOAD_SIZE;
+
+    uint8_t* payload = buffer + SETTINGS_HEADER_SIZE;
+    payload[SETTINGS_OFFSET_FLAGS] = (settings.soundEnabled ? 0x01 : 0) | (settings.hasPairedDevice ? 0x02 : 0);
+    payload[SETTINGS_OFFSET_LED_COLOR] = settings.ledColor;
+    payload[SETTINGS_OFFSET_BRIGHTNESS] = settings.ledBrightness;
+    payload[SETTINGS_OFFSET_ALERT] = settings.alertDuration & 0xFF;
+    payload[SETTINGS_OFFSET_ALERT + 1] = settings.alertDuration >> 8;
+    memcpy(payload + SETTINGS_OFFSET_PAIRED_MAC, settings.pairedDeviceMac, 6);
+
+    uint32_t crc = crc32Update(0, buffer, SETTINGS_HEADER_SIZE + SETTINGS_PAYLOAD_SIZE);
+    uint8_t* trailer = payload + SETTINGS_PAYLOAD_SIZE;
+    for (int i = 0; i < 4; i++) {
+        trailer[i] = crc >> (8 * i);
+    }
+    return SETTINGS_BLOB_SIZE;
+}
+
+SettingsDecodeResult settingsDecode(const uint8_t* buffer, size_t size, SystemSettings& settings) {
+    if (size < SETTINGS_HEADER_SIZE + 4) {
+        return SETTINGS_DECODE_BAD_LENGTH;
+    }
+    if ((buffer[0] | (buffer[1] << 8)) != SETTINGS_BLOB_MAGIC) {
+        return SETTINGS_DECODE_BAD_MAGIC;
+    }
+
+    uint8_t version = buffer[2];
+    uint8_t payloadSize = buffer[3];
+    if (size != (size_t)SETTINGS_HEADER_SIZE + payloadSize + 4) {
+        return SETTINGS_DECODE_BAD_LENGTH;
+    }
+
+    const uint8_t* payload = buffer + SETTINGS_HEADER_SIZE;
+    const uint8_t* trailer = payload + payloadSize;
+    uint32_t stored = trailer[0] | (trailer[1] << 8) | (trailer[2] << 16) | ((uint32_t)trailer[3] << 24);
+    if (crc32Update(0, buffer, SETTINGS_HEADER_SIZE + payloadSize) != stored) {
+        return SETTINGS_DECODE_BAD_CRC;
+    }
+    if (version == 0 || version > SETTINGS_SCHEMA_VERSION) {
+        return SETTINGS_DECODE_UNSUPPORTED;
+    }
+
+    // 只读取payload中存在的字段
+    SystemSettings decoded = settings;
+    if (payloadSize > SETTINGS_OFFSET_FLAGS) {
+        decoded.soundEnabled = payload[SETTINGS_OFFSET_FLAGS] & 0x01;
+        decoded.hasPairedDevice = (payload[SETTINGS_OFFSET_FLAGS] & 0x02) != 0;
+    }
+    if (payloadSize > SETTINGS_OFFSET_LED_COLOR) {
+        decoded.ledColor = (LedColorOption)payload[SETTINGS_OFFSET_LED_COLOR];
+    }
+    if (payloadSize > SETTINGS_OFFSET_BRIGHTNESS) {
+        decoded.ledBrightness = payload[SETTINGS_OFFSET_BRIGHTNESS];
+    }
+    if (payloadSize >= SETTINGS_OFFSET_ALERT + 2) {
+        decoded.alertDuration = payload[SETTINGS_OFFSET_ALERT] | (payload[SETTINGS_OFFSET_ALERT + 1] << 8);
+    }
+    if (payloadSize >= SETTINGS_OFFSET_PAIRED_MAC + 6) {
+        memcpy(decoded.pairedDeviceMac, payload + SETTINGS_OFFSET_PAIRED_MAC, 6);
+    } else {
+        decoded.hasPairedDevice = false;
+    }
+
+    for (uint8_t v = version; v < SETTINGS_SCHEMA_VERSION; v++) {
+        if (kSettingsMigrations[v]) {
+            kSettingsMigrations[v](decoded);
+        }
+    }
+
+    // 越界值恢复默认
+    if (decoded.ledColor >= LED_COLOR_COUNT) decoded.ledColor = DEFAULT_LED_COLOR;
+    if (decoded.ledBrightness > 100) decoded.ledBrightness = DEFAULT_LED_BRIGHTNESS;
+    if (decoded.alertDuration < 30 || decoded.alertDuration > 300) decoded.alertDuration = DEFAULT_ALERT_DURATION;
+
+    settings = decoded;
+    return version < SETTINGS_SCHEMA_VERSION ? SETTINGS_DECODE_MIGRATED : SETTINGS_DECODE_OK;
+}
+
+const char* settingsDecodeResultString(SettingsDecodeResult result) {
+    switch (result) {
+        case SETTINGS_DECODE_OK:          return "OK";
+        case SETTINGS_DECODE_MIGRATED:    return "MIGRATED";
+        case SETTINGS_DECODE_BAD_LENGTH:  return "BAD_LENGTH";
+        case SETTINGS_DECODE_BAD_MAGIC:   return "BAD_MAGIC";
+        case SETTINGS_DECODE_BAD_CRC:     return "BAD_CRC";
+        case SETTINGS_DECODE_UNSUPPORTED: return "UNSUPPORTED";
+        default:                          return "UNKNOWN";
+    }
+}
@@ -0,0 +1,85 @@
+#include "settings_store.h"
+
+SettingsStore settingsStore;
+
+SettingsStore::SettingsStore() : dirty(0), lastChangeTime(0), commitCount(0), savedSize(0) {}
+
+bool SettingsStore::load(SystemSettings& settings) {
+    Preferences prefs;
+    if (!prefs.begin(SETTINGS_NVS_NAMESPACE, true)) {
+        Serial.println("设置: NVS命名空间不存在，使用默认设置");
+        return false;
+    }
+
+    uint8_t blob[64];
+    size_t size = prefs.getBytesLength(SETTINGS_NVS_KEY);
+    if (size == 0 || size > sizeof(blob)) {
+        prefs.end();
+        Serial.println("设置: 未找到已保存的设置，使用默认设置");
+        return false;
+    }
+    size = prefs.getBytes(SETTINGS_NVS_KEY, blob, size);
+    prefs.end();
+
+    SettingsDecodeResult result = settingsDecode(blob, size, settings);
+    if (result != SETTINGS_DECODE_OK && result != SETTINGS_DECODE_MIGRATED) {
+        Serial.printf("设置: 数据无效 (%s)，使用默认设置\n", settingsDecodeResultString(result));
+        return false;
+    }
+
+    if (result == SETTINGS_DECODE_MIGRATED) {
+        // 旧版本数据迁移后按当前版本重写
+        markDirty(SETTINGS_FIELD_ALL);
+    } else if (size <= sizeof(savedBlob)) {
+        memcpy(savedBlob, blob, size);
+        savedSize = size;
+    }
+    Serial.printf("设置: 已从NVS加载 (版本%d)\n", blob[2]);
+    return true;
+}
+
+void SettingsStore::markDirty(uint16_t fields) {
+    dirty |= fields;
+    lastChangeTime = millis();
+}
+
+void SettingsStore::update(const SystemSettings& settings) {
+    if (dirty && millis() - lastChangeTime >= SETTINGS_COMMIT_DELAY) {
+        commit(settings);
+    }
+}
+
+bool SettingsStore::commit(const SystemSettings& settings) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    size_t size = settingsEncode(settings, blob, sizeof(blob));
+    uint16_t fields = dirty;
+    dirty = 0;
+
+    // 调整后又改回原值时不写闪存
+    if (size == savedSize && memcmp(blob, savedBlob, size) == 0) {
+        return true;
+    }
+
+    Preferences prefs;
+    if (!prefs.begin(SETTINGS_NVS_NAMESPACE, false)) {
+        Serial.println("设置: 打开NVS失败");
+        dirty = fields;
+        lastChangeTime = millis();
+        return false;
+    }
+    bool ok = prefs.putBytes(SETTINGS_NVS_KEY, blob, size) == size;
+    prefs.end();
+
+    if (!ok) {
+        Serial.println("设置: 写入NVS失败");
+        dirty = fields;
+        lastChangeTime = millis();
+        return false;
+    }
+
+    memcpy(savedBlob, blob, size);
+    savedSize = size;
+    commitCount++;
+    Serial.printf("设置: 已保存 (字段0x%02X, 第%lu次写入)\n", fields, commitCount);
+    return true;
+}
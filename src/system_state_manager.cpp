@@ -2,92 +2,134 @@
 #include "hardware.h"
 #include "menu.h"
 #include "vibration_training.h"
+#include "clock.h"
+
+// 外部变量声明
+extern ConnectionStatus connectionStatus;
+extern const char* getConnectionStatusString(ConnectionStatus status);
 
 // 全局系统状态管理器实例
 SystemStateManager stateManager;
 
-SystemStateManager::SystemStateManager() 
+// 动作分派表，下标为StateAction
+const SystemStateManager::ActionHandler SystemStateManager::actionHandlers[ACT_COUNT] = {
+    &SystemStateManager::actNone,
+    &SystemStateManager::actEnterMenu,
+    &SystemStateManager::actEnterReady,
+    &SystemStateManager::actRefreshReady,
+    &SystemStateManager::actStartTraining,
+    &SystemStateManager::actStartLinked,
+    &SystemStateManager::actShowResult,
+    &SystemStateManager::actShowRemoteResult,
+    &SystemStateManager::actReturnToMenu,
+    &SystemStateManager::actEnterError,
+};
+
+SystemStateManager::SystemStateManager()
     : currentState(STATE_INIT),
-      previousState(STATE_INIT),
       stateChangeTime(0),
-      stateChanged(false) {
+      queueHead(0),
+      queueTail(0),
+      droppedEvents(0),
+      queueMux(portMUX_INITIALIZER_UNLOCKED),
+      traceCount(0),
+      maxLatencyUs(0) {
 }
 
 bool SystemStateManager::init() {
     Serial.println("初始化系统状态管理器...");
-    
+
     currentState = STATE_INIT;
-    previousState = STATE_INIT;
     stateChangeTime = millis();
-    stateChanged = false;
-    
+    queueHead = 0;
+    queueTail = 0;
+    droppedEvents = 0;
+    traceCount = 0;
+    maxLatencyUs = 0;
+
     Serial.println("系统状态管理器初始化完成");
     return true;
 }
 
-void SystemStateManager::update() {
-    // 检查是否有状态变化需要处理
-    if (stateChanged) {
-        stateChanged = false;
-        onStateChange(previousState, currentState);
-    }
-    
-    // TODO: 重新实现按键事件处理逻辑
-    /*
-    ButtonEvent event = buttonManager.getEvent();
-    if (event != BUTTON_NONE) {
-        handleButtonEvent(event);
-        buttonManager.clearEvent();
+bool SystemStateManager::postEvent(SystemEvent event, uint32_t payload) {
+    bool queued = false;
+
+    portENTER_CRITICAL(&queueMux);
+    uint8_t next = (queueHead + 1) & (STATE_EVENT_QUEUE_SIZE - 1);
+    if (next != queueTail) {
+        eventQueue[queueHead].event = event;
+        eventQueue[queueHead].payload = payload;
+        eventQueue[queueHead].postedUs = micros();
+        queueHead = next;
+        queued = true;
+    } else {
+        droppedEvents++;
     }
-    */
-}
+    portEXIT_CRITICAL(&queueMux);
 
-SystemState SystemStateManager::getCurrentState() {
-    return currentState;
+    return queued;
 }
 
-void SystemStateManager::setState(SystemState newState) {
-    if (newState != currentState) {
-        transitionTo(newState);
+bool SystemStateManager::popEvent(QueuedEvent& out) {
+    bool available = false;
+
+    portENTER_CRITICAL(&queueMux);
+    if (queueTail != queueHead) {
+        out = eventQueue[queueTail];
+        queueTail = (queueTail + 1) & (STATE_EVENT_QUEUE_SIZE - 1);
+        available = true;
     }
-}
+    portEXIT_CRITICAL(&queueMux);
 
-bool SystemStateManager::canTransitionTo(SystemState newState) {
-    return isValidTransition(currentState, newState);
+    return available;
 }
 
-void SystemStateManager::transitionTo(SystemState newState) {
-    if (!canTransitionTo(newState)) {
-        Serial.printf("无效的状态转换: %s -> %s\n", 
-                     getStateString(currentState), 
-                     getStateString(newState));
-        return;
+void SystemStateManager::update() {
+    // 只处理本次进入时已在队列中的事件，动作中新投递的事件留到下一轮
+    uint8_t pending = (queueHead - queueTail) & (STATE_EVENT_QUEUE_SIZE - 1);
+    QueuedEvent queued;
+    while (pending-- > 0 && popEvent(queued)) {
+        dispatch(queued);
     }
-    
-    SystemState oldState = currentState;
-    
-    // 退出当前状态
-    onExitState(currentState);
-    
-    // 更新状态
-    previousState = currentState;
-    currentState = newState;
-    stateChangeTime = millis();
-    stateChanged = true;
-    
-    // 进入新状态
-    onEnterState(currentState);
-    
-    // 记录状态变化
-    logStateChange(oldState, newState);
 }
 
-/*
-void SystemStateManager::handleButtonEvent(ButtonEvent event) {
-    // 暂时禁用按键事件处理
-    // TODO: 重新实现按键事件处理逻辑
+void SystemStateManager::dispatch(const QueuedEvent& queued) {
+    SystemState from = currentState;
+    const StateTransition& transition = kTransitionTable.cell[from][queued.event];
+
+    uint32_t startUs = micros();
+    uint32_t latencyUs = startUs - queued.postedUs;
+    if (latencyUs > maxLatencyUs) {
+        maxLatencyUs = latencyUs;
+    }
+
+    if (transition.next != STATE_IGNORED) {
+        // 按键、触发和无线事件都经事件分派，统一在此唤醒显示屏
+        hardware.wakeDisplay();
+        if (transition.next != from) {
+            currentState = (SystemState)transition.next;
+            stateChangeTime = millis();
+        }
+        (this->*actionHandlers[transition.action])(queued.payload);
+    }
+
+    TransitionTrace& trace = traceRing[traceCount & (STATE_TRACE_SIZE - 1)];
+    trace.timeUs = startUs;
+    trace.latencyUs = latencyUs > 0xFFFF ? 0xFFFF : latencyUs;
+    uint32_t actionUs = micros() - startUs;
+    trace.actionUs = actionUs > 0xFFFF ? 0xFFFF : actionUs;
+    trace.from = from;
+    trace.event = queued.event;
+    trace.to = transition.next;
+    trace.action = transition.action;
+    traceCount++;
+
+    if (transition.next != STATE_IGNORED && transition.next != from) {
+        Serial.printf("[状态管理器] %s -> %s (事件: %s, 延迟: %luus, 动作: %luus)\n",
+                      getStateString(from), getStateString(currentState),
+                      getEventString((SystemEvent)queued.event), latencyUs, actionUs);
+    }
 }
-*/
 
 const char* SystemStateManager::getStateString() {
     return getStateString(currentState);
@@ -98,6 +140,7 @@ const char* SystemStateManager::getStateString(SystemState state) {
         case STATE_INIT:     return "INIT";
         case STATE_MENU:     return "MENU";
         case STATE_READY:    return "READY";
+        case STATE_TRAINING: return "TRAINING";
         case STATE_TIMING:   return "TIMING";
         case STATE_COMPLETE: return "COMPLETE";
         case STATE_ERROR:    return "ERROR";
@@ -105,181 +148,123 @@ const char* SystemStateManager::getStateString(SystemState state) {
     }
 }
 
-void SystemStateManager::onStateChange(SystemState oldState, SystemState newState) {
-    Serial.printf("状态变化: %s -> %s\n", getStateString(oldState), getStateString(newState));
-    
-    // 这里可以添加全局状态变化处理逻辑
-    // 例如：更新显示、播放声音、控制LED等
-}
-
-// 菜单状态下的按键处理
-void SystemStateManager::handleClickInMenu() {
-    extern MenuManager menu;
-    if (menu.isMenuActive()) {
-        menu.selectNext();
+const char* SystemStateManager::getEventString(SystemEvent event) {
+    switch (event) {
+        case EVT_INIT_DONE:       return "INIT_DONE";
+        case EVT_MENU_START:      return "MENU_START";
+        case EVT_START_LOCAL:     return "START_LOCAL";
+        case EVT_START_LINKED:    return "START_LINKED";
+        case EVT_TRAINING_DONE:   return "TRAINING_DONE";
+        case EVT_REMOTE_COMPLETE: return "REMOTE_COMPLETE";
+        case EVT_BACK:            return "BACK";
+        case EVT_REMOTE_RESET:    return "REMOTE_RESET";
+        case EVT_LINK_CHANGED:    return "LINK_CHANGED";
+        case EVT_FAULT:           return "FAULT";
+        default:                  return "NONE";
     }
 }
 
-void SystemStateManager::handleDoubleClickInMenu() {
-    extern MenuManager menu;
-    if (menu.isMenuActive()) {
-        menu.selectPrevious();
+void SystemStateManager::dumpTrace() {
+    uint16_t count = traceCount < STATE_TRACE_SIZE ? traceCount : STATE_TRACE_SIZE;
+
+    Serial.printf("=== 状态转换跟踪 (最近%d条, 丢弃事件: %lu, 最大排队延迟: %luus) ===\n",
+                  count, droppedEvents, maxLatencyUs);
+    for (uint16_t i = traceCount - count; i != traceCount; i++) {
+        const TransitionTrace& trace = traceRing[i & (STATE_TRACE_SIZE - 1)];
+        Serial.printf("  [%lu] %s + %s -> %s (延迟: %uus, 动作: %uus)\n",
+                      trace.timeUs,
+                      getStateString((SystemState)trace.from),
+                      getEventString((SystemEvent)trace.event),
+                      trace.to == STATE_IGNORED ? "(忽略)" : getStateString((SystemState)trace.to),
+                      trace.latencyUs, trace.actionUs);
     }
 }
 
-void SystemStateManager::handleLongPressInMenu() {
-    extern MenuManager menu;
-    if (menu.isMenuActive()) {
-        menu.confirm();
-        
-        // 检查是否选择了开始训练
-        if (!menu.isMenuActive()) {
-            transitionTo(STATE_READY);
-        }
-    }
+// ==================== 转换动作 ====================
+
+void SystemStateManager::actNone(uint32_t payload) {
 }
 
-// 准备状态下的按键处理
-void SystemStateManager::handleClickInReady() {
-    // 开始训练
-    extern VibrationTrainingManager vibrationTraining;
-    vibrationTraining.start();
-    transitionTo(STATE_TIMING);
+void SystemStateManager::actEnterMenu(uint32_t payload) {
+    menu.show();
 }
 
-void SystemStateManager::handleLongPressInReady() {
-    // 返回菜单
-    extern MenuManager menu;
-    menu.init();
-    transitionTo(STATE_MENU);
+void SystemStateManager::actEnterReady(uint32_t payload) {
+    hardware.setAllLEDs(COLOR_GREEN);
+    hardware.showLEDs();
+    actRefreshReady(payload);
 }
 
-// 完成状态下的按键处理
-void SystemStateManager::handleClickInComplete() {
-    // 返回菜单
-    extern MenuManager menu;
-    menu.init();
-    transitionTo(STATE_MENU);
+void SystemStateManager::actRefreshReady(uint32_t payload) {
+    // 准备界面只在进入状态和连接状态变化时重绘
+    if (connectionStatus == CONN_CONNECTED) {
+        hardware.displayStatus("按按钮开始");
+    } else {
+        hardware.displayStatus(getConnectionStatusString(connectionStatus));
+    }
 }
 
-void SystemStateManager::handleLongPressInComplete() {
-    // 返回菜单
-    extern MenuManager menu;
-    menu.init();
-    transitionTo(STATE_MENU);
+void SystemStateManager::actStartTraining(uint32_t payload) {
+    // 播放开始音效
+    if (hardware.getSettings()->soundEnabled) {
+        hardware.playStartSound();
+    }
+
+    // 设置LED为训练颜色
+    hardware.setAllLEDs(hardware.getLedColorValue(hardware.getSettings()->ledColor));
+    hardware.showLEDs();
+
+    // 显示训练开始界面
+    hardware.displayStatus("训练开始！");
+
+    vibrationTraining.start();
 }
 
-// 计时状态下的按键处理
-void SystemStateManager::handleLongPressInTiming() {
-    // 停止训练并返回菜单
-    extern VibrationTrainingManager vibrationTraining;
-    vibrationTraining.stop();
-    
-    extern MenuManager menu;
-    menu.init();
-    transitionTo(STATE_MENU);
+void SystemStateManager::actStartLinked(uint32_t payload) {
+    vibrationTraining.start();
 }
 
-// 状态转换验证
-bool SystemStateManager::isValidTransition(SystemState from, SystemState to) {
-    // 定义允许的状态转换
-    switch (from) {
-        case STATE_INIT:
-            return (to == STATE_MENU || to == STATE_ERROR);
-            
-        case STATE_MENU:
-            return (to == STATE_READY || to == STATE_ERROR);
-            
-        case STATE_READY:
-            return (to == STATE_TIMING || to == STATE_MENU || to == STATE_ERROR);
-            
-        case STATE_TIMING:
-            return (to == STATE_COMPLETE || to == STATE_MENU || to == STATE_ERROR);
-            
-        case STATE_COMPLETE:
-            return (to == STATE_MENU || to == STATE_READY || to == STATE_ERROR);
-            
-        case STATE_ERROR:
-            return (to == STATE_MENU || to == STATE_INIT);
-            
-        default:
-            return false;
+void SystemStateManager::actShowResult(uint32_t payload) {
+    if (menu.getCurrentMode() == MODE_SINGLE_TIMER) {
+        hardware.displayResult(Clock::toTicks(vibrationTraining.getElapsedUs()), "计时完成");
+    } else {
+        hardware.displayStatus("按按钮继续");
     }
 }
 
-// 状态进入处理
-void SystemStateManager::onEnterState(SystemState state) {
-    extern HardwareManager hardware;
+void SystemStateManager::actShowRemoteResult(uint32_t payload) {
+    hardware.displayResult(payload, "训练完成");
+    hardware.playCompleteSound();
+}
+
+void SystemStateManager::actReturnToMenu(uint32_t payload) {
+    // 结束课程：写入汇总记录并落盘训练日志
+    vibrationTraining.endSession();
     
-    switch (state) {
-        case STATE_INIT:
-            Serial.println("进入初始化状态");
-            hardware.clearLEDs();
-            hardware.showLEDs();
-            break;
-            
-        case STATE_MENU:
-            Serial.println("进入菜单状态");
-            hardware.clearLEDs();
-            hardware.showLEDs();
-            break;
-            
-        case STATE_READY:
-            Serial.println("进入准备状态");
-            hardware.displayStatus("准备就绪！按键开始训练");
-            hardware.setAllLEDs(COLOR_GREEN);
-            hardware.showLEDs();
-            break;
-            
-        case STATE_TIMING:
-            Serial.println("进入计时状态");
-            hardware.displayStatus("训练中...");
-            hardware.setAllLEDs(COLOR_BLUE);
-            hardware.showLEDs();
-            if (hardware.getSettings()->soundEnabled) {
-                hardware.playStartSound();
-            }
-            break;
-            
-        case STATE_COMPLETE:
-            Serial.println("进入完成状态");
-            hardware.displayStatus("训练完成！按键继续");
-            hardware.setAllLEDs(COLOR_YELLOW);
-            hardware.showLEDs();
-            if (hardware.getSettings()->soundEnabled) {
-                hardware.playCompleteSound();
-            }
-            break;
-            
-        case STATE_ERROR:
-            Serial.println("进入错误状态");
-            hardware.displayStatus("系统错误");
-            hardware.setAllLEDs(COLOR_RED);
-            hardware.showLEDs();
-            if (hardware.getSettings()->soundEnabled) {
-                hardware.playErrorSound();
-            }
-            break;
-    }
+    // 重置硬件状态
+    hardware.clearLEDs();
+    hardware.showLEDs();
+
+    // 停止任何正在播放的音效
+    noTone(BUZZER_PIN);
+
+    // 清理并重新初始化显示器
+    hardware.displayClear();
+
+    // 重新初始化菜单
+    menu.init();
+
+    Serial.println("已返回主菜单");
 }
 
-// 状态退出处理
-void SystemStateManager::onExitState(SystemState state) {
-    switch (state) {
-        case STATE_TIMING:
-            Serial.println("退出计时状态");
-            // 停止计时相关的处理
-            break;
-            
-        default:
-            break;
+void SystemStateManager::actEnterError(uint32_t payload) {
+    hardware.displayStatus("系统错误");
+    hardware.setAllLEDs(COLOR_RED);
+    hardware.showLEDs();
+    if (hardware.getSettings()->soundEnabled) {
+        hardware.playErrorSound();
     }
-}
 
-// 记录状态变化
-void SystemStateManager::logStateChange(SystemState oldState, SystemState newState) {
-    Serial.printf("[状态管理器] %s -> %s (时间: %lu)\n", 
-                  getStateString(oldState), 
-                  getStateString(newState), 
-                  millis());
+    // 输出转换跟踪用于故障分析
+    dumpTrace();
 }
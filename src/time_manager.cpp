@@ -3,6 +3,7 @@
 TimeManager::TimeManager() : bootTime(0), timezoneOffset(0), ntpSynced(false) {}
 
 bool TimeManager::init() {
+    // 先以编译时间作为初始时间，NTP在后台同步，不阻塞启动
     setCompileTime();
     return syncWithNTP();
 }
@@ -66,6 +67,14 @@ bool TimeManager::setTime(int year, int month, int day, int hour, int minute, in
     return true;
 }
 
+void TimeManager::adjustTime(int32_t seconds) {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    now.tv_sec += seconds;
+    settimeofday(&now, nullptr);
+    bootTime += seconds;
+}
+
 struct tm TimeManager::getCurrentTime() {
     time_t t = time(nullptr);
     return *localtime(&t);
@@ -130,23 +139,23 @@ int TimeManager::getDaysInMonth(int year, int month) {
 }
 
 bool TimeManager::syncWithNTP(const char* server) {
-    Serial.printf("Connecting to NTP server: %s...\n", server);
+    // 只启动SNTP客户端，同步结果由回调通知（未联网时不会完成）
+    Serial.printf("Starting NTP sync: %s\n", server);
+    ntpSynced = false;
+    if (esp_sntp_enabled()) {
+        esp_sntp_stop();
+    }
     esp_sntp_setoperatingmode(SNTP_OPMODE_POLL);
     esp_sntp_setservername(0, server);
+    sntp_set_time_sync_notification_cb(onNtpSynced);
     esp_sntp_init();
-    time_t now = time(nullptr);
-    for (int i = 0; i < 10 && now < 24 * 3600; ++i) {
-        delay(500);
-        now = time(nullptr);
-    }
-    ntpSynced = (now >= 24 * 3600);
-    if (ntpSynced) {
-        Serial.println("NTP time sync successful.");
-        bootTime = now;
-    } else {
-        Serial.println("NTP time sync failed.");
-    }
-    return ntpSynced;
+    return true;
+}
+
+void TimeManager::onNtpSynced(struct timeval* tv) {
+    // 在lwIP任务中调用，只更新状态；启动时间按运行时长回推
+    timeManager.bootTime = tv->tv_sec - millis() / 1000;
+    timeManager.ntpSynced = true;
 }
 
 bool TimeManager::isTimeValid() {
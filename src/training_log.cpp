@@ -0,0 +1,371 @@
+#include "training_log.h"
+#include <stddef.h>
+#include <string.h>
+#include "crc32.h"
+
+// 数据块读写缓冲区（最大批次）
+alignas(4) static uint8_t blockBuffer[LOG_BLOCK_BYTES(LOG_BATCH_MAX)];
+
+static uint32_t headerCrc(const LogSegmentHeader& header) {
+    return crc32Update(0, &header, offsetof(LogSegmentHeader, crc));
+}
+
+static uint32_t trailerCrc(const LogSegmentTrailer& trailer) {
+    return crc32Update(0, &trailer, offsetof(LogSegmentTrailer, crc));
+}
+
+// 旧版本记录换算为当前格式
+static PackedTrainingRecord upgradeRecord(const PackedTrainingRecord& record, uint16_t version) {
+    if (version >= 2) {
+        return record;
+    }
+    // 版本1：用时均为毫秒
+    uint64_t durationUs = (uint64_t)(record.packed & RECORD_DURATION_MAX) * 1000;
+    uint8_t mode = (record.packed >> RECORD_MODE_SHIFT) & RECORD_MODE_MASK;
+    uint8_t flags = record.packed >> RECORD_FLAGS_SHIFT;
+    return TrainingRecordStore::pack(record.epochSeconds, durationUs, mode, flags);
+}
+
+TrainingLog::TrainingLog(LogStorage& storage, uint32_t segmentMaxBytes, uint16_t maxSegments)
+    : storage(storage),
+      segmentMaxBytes(segmentMaxBytes),
+      maxSegments(maxSegments > LOG_MAX_SEGMENTS ? LOG_MAX_SEGMENTS : maxSegments),
+      indexCount(0),
+      activeOpen(false),
+      persistedSequence(0),
+      pendingCount(0),
+      droppedRecords(0),
+      scanning(false) {
+    memset(&report, 0, sizeof(report));
+}
+
+bool TrainingLog::begin() {
+    memset(&report, 0, sizeof(report));
+    indexCount = 0;
+    activeOpen = false;
+    persistedSequence = 0;
+    pendingCount = 0;
+    droppedRecords = 0;
+
+    if (!storage.begin()) {
+        return false;
+    }
+
+    uint32_t ids[LOG_MAX_SEGMENTS * 2];
+    int idCount = storage.listSegments(ids, LOG_MAX_SEGMENTS * 2);
+
+    // 段号升序（段数很少，插入排序即可）
+    for (int i = 1; i < idCount; i++) {
+        uint32_t id = ids[i];
+        int j = i - 1;
+        while (j >= 0 && ids[j] > id) {
+            ids[j + 1] = ids[j];
+            j--;
+        }
+        ids[j + 1] = id;
+    }
+
+    scanning = true;
+    for (int i = 0; i < idCount; i++) {
+        LogSegmentInfo info;
+        if (!loadSegment(ids[i], info)) {
+            storage.remove(ids[i]);
+            report.removedSegments++;
+            continue;
+        }
+
+        // 未封存的空段只可能是最后一段，其序号接续前一段
+        if (info.recordCount == 0) {
+            info.firstSequence = persistedSequence;
+        }
+
+        // 崩溃发生在段尾写入之前：补写段尾或删除空段，保证只有最后一段可追加
+        if (indexCount > 0 && !index_[indexCount - 1].sealed) {
+            if (index_[indexCount - 1].recordCount == 0 || !sealSegment(indexCount - 1)) {
+                dropSegment(indexCount - 1);
+            }
+        }
+
+        if (indexCount >= maxSegments) {
+            dropSegment(0);
+        }
+
+        index_[indexCount++] = info;
+        persistedSequence = info.firstSequence + info.recordCount;
+    }
+    scanning = false;
+
+    // 旧格式的未封存段不能再追加当前格式的记录
+    if (indexCount > 0 && !index_[indexCount - 1].sealed && index_[indexCount - 1].version != LOG_FORMAT_VERSION) {
+        if (index_[indexCount - 1].recordCount == 0 || !sealSegment(indexCount - 1)) {
+            dropSegment(indexCount - 1);
+        }
+    }
+
+    activeOpen = indexCount > 0 && !index_[indexCount - 1].sealed;
+    report.segments = indexCount;
+    return true;
+}
+
+int32_t TrainingLog::readCounted(uint32_t id, uint32_t offset, void* buffer, uint32_t length) {
+    int32_t result = storage.read(id, offset, buffer, length);
+    if (scanning && result > 0) {
+        report.bytesRead += result;
+    }
+    return result;
+}
+
+bool TrainingLog::loadSegment(uint32_t id, LogSegmentInfo& info) {
+    int32_t size = storage.segmentSize(id);
+    if (size < (int32_t)sizeof(LogSegmentHeader)) {
+        return false;
+    }
+
+    LogSegmentHeader header;
+    if (readCounted(id, 0, &header, sizeof(header)) != sizeof(header) ||
+        header.magic != LOG_SEGMENT_MAGIC ||
+        header.version < LOG_FORMAT_MIN_VERSION || header.version > LOG_FORMAT_VERSION ||
+        header.headerSize != sizeof(LogSegmentHeader) || header.segmentId != id ||
+        header.crc != headerCrc(header)) {
+        return false;
+    }
+
+    memset(&info, 0, sizeof(info));
+    info.id = id;
+    info.size = size;
+    info.version = header.version;
+
+    // 封存段：段尾即索引，无需读取数据块
+    if (size >= (int32_t)(sizeof(LogSegmentHeader) + sizeof(LogSegmentTrailer))) {
+        LogSegmentTrailer trailer;
+        if (readCounted(id, size - sizeof(trailer), &trailer, sizeof(trailer)) == sizeof(trailer) &&
+            trailer.magic == LOG_TRAILER_MAGIC && trailer.crc == trailerCrc(trailer)) {
+            info.firstSequence = trailer.firstSequence;
+            info.recordCount = trailer.recordCount;
+            info.firstEpoch = trailer.firstEpoch;
+            info.lastEpoch = trailer.lastEpoch;
+            info.blockCount = trailer.blockCount;
+            info.dataCrc = trailer.dataCrc;
+            info.sealed = true;
+            report.sealedSegments++;
+            return true;
+        }
+    }
+
+    // 未封存段：逐块校验，截断撕裂写入
+    report.scannedSegments++;
+    uint32_t validEnd = scanBlocks(info, size, &info, nullptr, 0, nullptr);
+    if (validEnd < (uint32_t)size) {
+        if (!storage.truncate(id, validEnd)) {
+            return false;
+        }
+        report.repairedBytes += size - validEnd;
+        info.size = validEnd;
+    }
+    info.sealed = false;
+    return true;
+}
+
+uint32_t TrainingLog::scanBlocks(const LogSegmentInfo& info, uint32_t endOffset, LogSegmentInfo* rebuilt,
+                                 LogRecordCallback callback, uint32_t fromSequence, void* context) {
+    uint32_t offset = sizeof(LogSegmentHeader);
+    uint32_t expectedSequence = 0;
+    bool firstBlock = true;
+
+    while (offset + LOG_BLOCK_BYTES(1) <= endOffset) {
+        LogBlockHeader header;
+        if (readCounted(info.id, offset, &header, sizeof(header)) != sizeof(header)) break;
+        if (header.magic != LOG_BLOCK_MAGIC || header.count == 0 || header.count > LOG_BATCH_MAX) break;
+        if (!firstBlock && header.firstSequence != expectedSequence) break;
+
+        uint32_t blockBytes = LOG_BLOCK_BYTES(header.count);
+        if (offset + blockBytes > endOffset) break;
+
+        uint32_t recordBytes = header.count * sizeof(PackedTrainingRecord);
+        if (readCounted(info.id, offset + sizeof(header), blockBuffer, recordBytes + sizeof(uint32_t)) !=
+            (int32_t)(recordBytes + sizeof(uint32_t))) break;
+
+        uint32_t storedCrc;
+        memcpy(&storedCrc, blockBuffer + recordBytes, sizeof(storedCrc));
+        uint32_t crc = crc32Update(0, &header, sizeof(header));
+        crc = crc32Update(crc, blockBuffer, recordBytes);
+        if (crc != storedCrc) break;
+
+        const PackedTrainingRecord* records = (const PackedTrainingRecord*)blockBuffer;
+        if (rebuilt) {
+            if (firstBlock) {
+                rebuilt->firstSequence = header.firstSequence;
+                rebuilt->firstEpoch = records[0].epochSeconds;
+            }
+            rebuilt->lastEpoch = records[header.count - 1].epochSeconds;
+            rebuilt->recordCount += header.count;
+            rebuilt->blockCount++;
+            rebuilt->dataCrc = crc32Update(rebuilt->dataCrc, &crc, sizeof(crc));
+        }
+        if (callback) {
+            for (uint16_t i = 0; i < header.count; i++) {
+                uint32_t sequence = header.firstSequence + i;
+                if (sequence >= fromSequence) {
+                    callback(upgradeRecord(records[i], info.version), sequence, context);
+                }
+            }
+        }
+
+        expectedSequence = header.firstSequence + header.count;
+        firstBlock = false;
+        offset += blockBytes;
+    }
+
+    return offset;
+}
+
+uint32_t TrainingLog::append(const PackedTrainingRecord& record) {
+    if (pendingCount >= LOG_BATCH_MAX && !flush()) {
+        // 介质不可写时丢弃最旧的待写记录，保证训练流程不受影响
+        memmove(pending, pending + 1, (LOG_BATCH_MAX - 1) * sizeof(PackedTrainingRecord));
+        pendingCount--;
+        persistedSequence++;
+        droppedRecords++;
+    }
+
+    uint32_t sequence = nextSequence();
+    pending[pendingCount++] = record;
+    return sequence;
+}
+
+bool TrainingLog::flush() {
+    if (pendingCount == 0) {
+        return true;
+    }
+
+    uint32_t blockBytes = LOG_BLOCK_BYTES(pendingCount);
+    if (activeOpen) {
+        const LogSegmentInfo& active = index_[indexCount - 1];
+        if (active.recordCount > 0 &&
+            active.size + blockBytes + sizeof(LogSegmentTrailer) > segmentMaxBytes &&
+            !sealSegment(indexCount - 1)) {
+            return false;
+        }
+    }
+    if (!activeOpen && !openSegment()) {
+        return false;
+    }
+
+    LogSegmentInfo& info = index_[indexCount - 1];
+    uint32_t recordBytes = pendingCount * sizeof(PackedTrainingRecord);
+
+    LogBlockHeader header;
+    header.magic = LOG_BLOCK_MAGIC;
+    header.count = pendingCount;
+    header.firstSequence = persistedSequence;
+    memcpy(blockBuffer, &header, sizeof(header));
+    memcpy(blockBuffer + sizeof(header), pending, recordBytes);
+    uint32_t crc = crc32Update(0, blockBuffer, sizeof(header) + recordBytes);
+    memcpy(blockBuffer + sizeof(header) + recordBytes, &crc, sizeof(crc));
+
+    if (!storage.append(info.id, blockBuffer, blockBytes)) {
+        // 回滚可能的部分写入，待写记录保留到下次重试
+        storage.truncate(info.id, info.size);
+        return false;
+    }
+
+    if (info.recordCount == 0) {
+        info.firstSequence = persistedSequence;
+        info.firstEpoch = pending[0].epochSeconds;
+    }
+    info.lastEpoch = pending[pendingCount - 1].epochSeconds;
+    info.recordCount += pendingCount;
+    info.blockCount++;
+    info.dataCrc = crc32Update(info.dataCrc, &crc, sizeof(crc));
+    info.size += blockBytes;
+
+    persistedSequence += pendingCount;
+    pendingCount = 0;
+    return true;
+}
+
+bool TrainingLog::forEach(uint32_t fromSequence, LogRecordCallback callback, void* context) {
+    for (int i = 0; i < indexCount; i++) {
+        const LogSegmentInfo& info = index_[i];
+        if (info.firstSequence + info.recordCount <= fromSequence) {
+            continue;
+        }
+        uint32_t endOffset = info.sealed ? info.size - sizeof(LogSegmentTrailer) : info.size;
+        scanBlocks(info, endOffset, nullptr, callback, fromSequence, context);
+    }
+    return true;
+}
+
+uint32_t TrainingLog::persistedRecords() const {
+    uint32_t total = 0;
+    for (int i = 0; i < indexCount; i++) {
+        total += index_[i].recordCount;
+    }
+    return total;
+}
+
+bool TrainingLog::sealSegment(int index) {
+    LogSegmentInfo& info = index_[index];
+
+    LogSegmentTrailer trailer;
+    trailer.magic = LOG_TRAILER_MAGIC;
+    trailer.firstSequence = info.firstSequence;
+    trailer.recordCount = info.recordCount;
+    trailer.firstEpoch = info.firstEpoch;
+    trailer.lastEpoch = info.lastEpoch;
+    trailer.blockCount = info.blockCount;
+    trailer.dataCrc = info.dataCrc;
+    trailer.crc = trailerCrc(trailer);
+
+    if (!storage.append(info.id, &trailer, sizeof(trailer))) {
+        storage.truncate(info.id, info.size);
+        return false;
+    }
+
+    info.size += sizeof(trailer);
+    info.sealed = true;
+    if (index == indexCount - 1) {
+        activeOpen = false;
+    }
+    return true;
+}
+
+bool TrainingLog::openSegment() {
+    uint32_t id = indexCount > 0 ? index_[indexCount - 1].id + 1 : 1;
+
+    // 超出保留数量时删除最旧段
+    if (indexCount >= maxSegments) {
+        dropSegment(0);
+    }
+
+    LogSegmentHeader header;
+    header.magic = LOG_SEGMENT_MAGIC;
+    header.version = LOG_FORMAT_VERSION;
+    header.headerSize = sizeof(LogSegmentHeader);
+    header.segmentId = id;
+    header.crc = headerCrc(header);
+
+    if (!storage.append(id, &header, sizeof(header))) {
+        storage.remove(id);
+        return false;
+    }
+
+    LogSegmentInfo& info = index_[indexCount++];
+    memset(&info, 0, sizeof(info));
+    info.id = id;
+    info.size = sizeof(header);
+    info.firstSequence = persistedSequence;
+    info.version = LOG_FORMAT_VERSION;
+    info.sealed = false;
+    activeOpen = true;
+    return true;
+}
+
+void TrainingLog::dropSegment(int index) {
+    storage.remove(index_[index].id);
+    if (scanning) {
+        report.removedSegments++;
+    }
+    memmove(&index_[index], &index_[index + 1], (indexCount - index - 1) * sizeof(LogSegmentInfo));
+    indexCount--;
+}
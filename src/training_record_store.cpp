@@ -0,0 +1,70 @@
+#include "training_record_store.h"
+
+// 全局训练记录存储
+TrainingRecordStore recordStore;
+
+TrainingRecordStore::TrainingRecordStore() : head(0), count(0) {}
+
+uint32_t TrainingRecordStore::append(uint32_t epochSeconds, uint64_t durationUs, uint8_t mode, uint8_t flags) {
+    return append(pack(epochSeconds, durationUs, mode, flags));
+}
+
+uint32_t TrainingRecordStore::append(const PackedTrainingRecord& record) {
+    uint32_t sequence = head;
+    records[head & (TRAINING_RECORD_CAPACITY - 1)] = record;
+    head++;
+    if (count < TRAINING_RECORD_CAPACITY) {
+        count++;
+    }
+    return sequence;
+}
+
+const PackedTrainingRecord& TrainingRecordStore::rawAt(uint32_t index) const {
+    return records[(head - count + index) & (TRAINING_RECORD_CAPACITY - 1)];
+}
+
+TrainingRecord TrainingRecordStore::at(uint32_t index) const {
+    return unpack(rawAt(index));
+}
+
+void TrainingRecordStore::clear() {
+    head = 0;
+    count = 0;
+}
+
+PackedTrainingRecord TrainingRecordStore::pack(uint32_t epochSeconds, uint64_t durationUs, uint8_t mode, uint8_t flags) {
+    uint32_t unit = (flags & RECORD_FLAG_SESSION) ? RECORD_SESSION_UNIT_US : RECORD_TICK_US;
+    uint64_t duration = durationUs / unit + (durationUs % unit >= unit / 2 ? 1 : 0);
+    if (duration > RECORD_DURATION_MAX) {
+        duration = RECORD_DURATION_MAX;
+    }
+
+    PackedTrainingRecord record;
+    record.epochSeconds = epochSeconds;
+    record.packed = (uint32_t)duration
+                  | ((uint32_t)(mode & RECORD_MODE_MASK) << RECORD_MODE_SHIFT)
+                  | ((uint32_t)flags << RECORD_FLAGS_SHIFT);
+    return record;
+}
+
+uint64_t TrainingRecordStore::durationUs(const PackedTrainingRecord& record) {
+    uint8_t flags = record.packed >> RECORD_FLAGS_SHIFT;
+    uint32_t unit = (flags & RECORD_FLAG_SESSION) ? RECORD_SESSION_UNIT_US : RECORD_TICK_US;
+    return (uint64_t)(record.packed & RECORD_DURATION_MAX) * unit;
+}
+
+uint32_t TrainingRecordStore::durationMs(const PackedTrainingRecord& record) {
+    return (uint32_t)((durationUs(record) + 500) / 1000);
+}
+
+TrainingRecord TrainingRecordStore::unpack(const PackedTrainingRecord& record) {
+    uint8_t flags = record.packed >> RECORD_FLAGS_SHIFT;
+
+    TrainingRecord result;
+    result.timestamp = record.epochSeconds;
+    result.duration = (uint32_t)(durationUs(record) / RECORD_TICK_US);
+    result.mode = (record.packed >> RECORD_MODE_SHIFT) & RECORD_MODE_MASK;
+    result.completed = (flags & RECORD_FLAG_COMPLETED) != 0;
+    result.clockValid = (flags & RECORD_FLAG_CLOCK_VALID) != 0;
+    return result;
+}
@@ -0,0 +1,259 @@
+#include "training_stats.h"
+#include <math.h>
+#include <string.h>
+#include "crc32.h"
+
+// 全局统计引擎
+TrainingStatsEngine statsEngine;
+
+#define SECONDS_PER_DAY 86400L
+
+// 直方图下界250ms，每倍频4个桶，桶比约1.19
+#define HIST_BASE_MS        250UL
+#define HIST_BINS_PER_OCTAVE 4
+static const uint16_t kQuarterOctave[HIST_BINS_PER_OCTAVE] = {1000, 1189, 1414, 1682};  // 2^(i/4) * 1000
+
+TrainingStatsEngine::TrainingStatsEngine() : utcOffset(0) {
+    reset();
+}
+
+void TrainingStatsEngine::reset() {
+    memset(&body, 0, sizeof(body));
+}
+
+uint32_t TrainingStatsEngine::dayOf(uint32_t epochSeconds) const {
+    int64_t local = (int64_t)epochSeconds + utcOffset;
+    return local > 0 ? (uint32_t)(local / SECONDS_PER_DAY) : 0;
+}
+
+StatsDayBucket* TrainingStatsEngine::bucketFor(uint32_t day) {
+    // 超出窗口的旧记录只计入累计统计
+    if (day == 0 || (body.latestDay >= STATS_DAY_BUCKETS && day <= body.latestDay - STATS_DAY_BUCKETS)) {
+        return nullptr;
+    }
+
+    // 同一槽位上的旧日期已滚出窗口，直接复用
+    StatsDayBucket* bucket = &body.days[day % STATS_DAY_BUCKETS];
+    if (bucket->day != day) {
+        memset(bucket, 0, sizeof(StatsDayBucket));
+        bucket->day = day;
+    }
+    if (day > body.latestDay) {
+        body.latestDay = day;
+    }
+    return bucket;
+}
+
+void TrainingStatsEngine::add(const PackedTrainingRecord& record, uint32_t sequence) {
+    if (sequence < body.nextSequence) {
+        return;
+    }
+    body.nextSequence = sequence + 1;
+
+    uint8_t flags = record.packed >> RECORD_FLAGS_SHIFT;
+    uint32_t duration = TrainingRecordStore::durationMs(record);
+    StatsTotals& totals = body.totals;
+    StatsDayBucket* bucket = (flags & RECORD_FLAG_CLOCK_VALID) ? bucketFor(dayOf(record.epochSeconds)) : nullptr;
+
+    if (flags & RECORD_FLAG_SESSION) {
+        totals.sessions++;
+        totals.sessionMs += duration;
+        if (bucket && bucket->sessions < UINT16_MAX) {
+            bucket->sessions++;
+        }
+        return;
+    }
+
+    totals.rounds++;
+    totals.totalMs += duration;
+    if (flags & RECORD_FLAG_COMPLETED) {
+        totals.completed++;
+        if (totals.bestMs == 0 || duration < totals.bestMs) {
+            totals.bestMs = duration;
+        }
+        double delta = duration - totals.mean;
+        totals.mean += delta / totals.completed;
+        totals.m2 += delta * (duration - totals.mean);
+    }
+
+    if (!bucket || bucket->rounds == UINT16_MAX) {
+        return;
+    }
+    bucket->rounds++;
+    bucket->totalMs += duration;
+    if (flags & RECORD_FLAG_COMPLETED) {
+        bucket->completed++;
+        if (bucket->bestMs == 0 || duration < bucket->bestMs) {
+            bucket->bestMs = duration;
+        }
+        float delta = duration - bucket->mean;
+        bucket->mean += delta / bucket->completed;
+        bucket->m2 += delta * (duration - bucket->mean);
+
+        uint16_t& bin = bucket->hist[histogramBin(duration)];
+        if (bin < UINT16_MAX) {
+            bin++;
+        }
+    }
+}
+
+uint32_t TrainingStatsEngine::meanMs() const {
+    return (uint32_t)(body.totals.mean + 0.5);
+}
+
+uint32_t TrainingStatsEngine::stddevMs() const {
+    const StatsTotals& totals = body.totals;
+    return totals.completed > 1 ? (uint32_t)(sqrt(totals.m2 / (totals.completed - 1)) + 0.5) : 0;
+}
+
+const StatsDayBucket* TrainingStatsEngine::day(uint32_t day) const {
+    const StatsDayBucket& bucket = body.days[day % STATS_DAY_BUCKETS];
+    return (day != 0 && bucket.day == day) ? &bucket : nullptr;
+}
+
+void TrainingStatsEngine::range(uint32_t lastDay, uint16_t dayCount, StatsRange& out) const {
+    memset(&out, 0, sizeof(out));
+    if (dayCount > STATS_DAY_BUCKETS) {
+        dayCount = STATS_DAY_BUCKETS;
+    }
+
+    // 按Chan并行算法合并各日的均值与平方差和
+    double mean = 0;
+    double m2 = 0;
+    for (uint16_t i = 0; i < dayCount && i < lastDay; i++) {
+        const StatsDayBucket* bucket = day(lastDay - i);
+        if (!bucket) {
+            continue;
+        }
+
+        out.sessions += bucket->sessions;
+        if (bucket->rounds == 0) {
+            continue;
+        }
+        out.activeDays++;
+        out.rounds += bucket->rounds;
+        out.totalMs += bucket->totalMs;
+        if (bucket->completed == 0) {
+            continue;
+        }
+        if (out.bestMs == 0 || bucket->bestMs < out.bestMs) {
+            out.bestMs = bucket->bestMs;
+        }
+
+        uint32_t n = out.completed + bucket->completed;
+        double delta = bucket->mean - mean;
+        mean += delta * bucket->completed / n;
+        m2 += bucket->m2 + delta * delta * out.completed * bucket->completed / n;
+        out.completed = n;
+    }
+
+    out.meanMs = (uint32_t)(mean + 0.5);
+    out.stddevMs = out.completed > 1 ? (uint32_t)(sqrt(m2 / (out.completed - 1)) + 0.5) : 0;
+}
+
+void TrainingStatsEngine::trend(uint32_t lastDay, uint16_t dayCount, StatsTrend& out) const {
+    if (dayCount > STATS_DAY_BUCKETS) {
+        dayCount = STATS_DAY_BUCKETS;
+    }
+    out.daysPerPoint = (dayCount + STATS_TREND_MAX_POINTS - 1) / STATS_TREND_MAX_POINTS;
+    out.count = (dayCount + out.daysPerPoint - 1) / out.daysPerPoint;
+
+    // 每点合并daysPerPoint天的直方图后取中位数，最早的点在前
+    for (uint8_t point = 0; point < out.count; point++) {
+        uint32_t hist[STATS_HIST_BINS] = {0};
+        uint32_t newest = lastDay - (uint32_t)(out.count - 1 - point) * out.daysPerPoint;
+        for (uint8_t i = 0; i < out.daysPerPoint && i < newest; i++) {
+            const StatsDayBucket* bucket = day(newest - i);
+            if (!bucket || bucket->completed == 0) {
+                continue;
+            }
+            for (uint8_t bin = 0; bin < STATS_HIST_BINS; bin++) {
+                hist[bin] += bucket->hist[bin];
+            }
+        }
+        out.medianMs[point] = histogramMedian(hist);
+    }
+}
+
+uint8_t TrainingStatsEngine::histogramBin(uint32_t durationMs) {
+    if (durationMs >= histogramEdge(STATS_HIST_BINS - 1)) {
+        return STATS_HIST_BINS - 1;
+    }
+
+    uint8_t octave = 0;
+    while (durationMs >= (HIST_BASE_MS << (octave + 1))) {
+        octave++;
+    }
+    uint8_t bin = octave * HIST_BINS_PER_OCTAVE + HIST_BINS_PER_OCTAVE - 1;
+    while (bin > octave * HIST_BINS_PER_OCTAVE && durationMs < histogramEdge(bin)) {
+        bin--;
+    }
+    return bin;
+}
+
+uint32_t TrainingStatsEngine::histogramEdge(uint8_t bin) {
+    return (HIST_BASE_MS << (bin / HIST_BINS_PER_OCTAVE)) * kQuarterOctave[bin % HIST_BINS_PER_OCTAVE] / 1000;
+}
+
+uint32_t TrainingStatsEngine::histogramMedian(const uint32_t* hist) {
+    uint32_t total = 0;
+    for (uint8_t bin = 0; bin < STATS_HIST_BINS; bin++) {
+        total += hist[bin];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // 第rank个样本（下中位数）所在桶内按均匀分布插值
+    uint32_t rank = (total + 1) / 2;
+    uint32_t before = 0;
+    for (uint8_t bin = 0; bin < STATS_HIST_BINS; bin++) {
+        if (before + hist[bin] >= rank) {
+            uint32_t low = histogramEdge(bin);
+            uint32_t high = histogramEdge(bin + 1);
+            return low + (uint64_t)(high - low) * (2 * (rank - before) - 1) / (2 * hist[bin]);
+        }
+        before += hist[bin];
+    }
+    return 0;
+}
+
+size_t TrainingStatsEngine::saveSnapshot(uint8_t* buffer, size_t size) const {
+    if (size < STATS_SNAPSHOT_BYTES) {
+        return 0;
+    }
+
+    StatsSnapshotHeader header;
+    header.magic = STATS_SNAPSHOT_MAGIC;
+    header.version = STATS_SNAPSHOT_VERSION;
+    header.dayBuckets = STATS_DAY_BUCKETS;
+    header.bodySize = sizeof(StatsSnapshotBody);
+    header.crc = crc32Update(0, &header, offsetof(StatsSnapshotHeader, crc));
+    header.crc = crc32Update(header.crc, &body, sizeof(body));
+
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), &body, sizeof(body));
+    return STATS_SNAPSHOT_BYTES;
+}
+
+bool TrainingStatsEngine::loadSnapshot(const uint8_t* buffer, size_t size) {
+    if (size != STATS_SNAPSHOT_BYTES) {
+        return false;
+    }
+
+    StatsSnapshotHeader header;
+    memcpy(&header, buffer, sizeof(header));
+    if (header.magic != STATS_SNAPSHOT_MAGIC || header.version != STATS_SNAPSHOT_VERSION ||
+        header.dayBuckets != STATS_DAY_BUCKETS || header.bodySize != sizeof(StatsSnapshotBody)) {
+        return false;
+    }
+
+    uint32_t crc = crc32Update(0, &header, offsetof(StatsSnapshotHeader, crc));
+    crc = crc32Update(crc, buffer + sizeof(header), sizeof(StatsSnapshotBody));
+    if (crc != header.crc) {
+        return false;
+    }
+
+    memcpy(&body, buffer + sizeof(header), sizeof(body));
+    return true;
+}
@@ -0,0 +1,85 @@
+#include "trend_plot.h"
+
+// 点数不超过该值时绘制点标记
+#define TREND_MARKER_MAX_POINTS 10
+
+void plotPixel(const FrameBuffer& fb, int x, int y) {
+    if (x < 0 || y < 0 || x >= fb.width || y >= fb.height) {
+        return;
+    }
+    fb.data[(y >> 3) * fb.width + x] |= 1 << (y & 7);
+}
+
+void plotLine(const FrameBuffer& fb, int x0, int y0, int x1, int y1) {
+    int dx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int dy = y1 > y0 ? y0 - y1 : y1 - y0;
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+
+    while (true) {
+        plotPixel(fb, x0, y0);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+int plotTrend(const FrameBuffer& fb, const PlotArea& area, const uint32_t* values, uint8_t count,
+              uint32_t* minValue, uint32_t* maxValue) {
+    uint32_t low = UINT32_MAX;
+    uint32_t high = 0;
+    int valid = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        if (values[i] == 0) continue;
+        if (values[i] < low) low = values[i];
+        if (values[i] > high) high = values[i];
+        valid++;
+    }
+    if (minValue) *minValue = valid ? low : 0;
+    if (maxValue) *maxValue = valid ? high : 0;
+    if (valid == 0) {
+        return 0;
+    }
+
+    // Q16定点比例：横向按点序号均分，纵向按数值范围缩放（单一数值时居中）
+    uint32_t span = high - low;
+    uint32_t yScale = span ? ((uint32_t)(area.height - 1) << 16) / span : 0;
+    uint32_t xStep = count > 1 ? ((uint32_t)(area.width - 1) << 16) / (count - 1) : 0;
+    int bottom = area.y + area.height - 1;
+    bool markers = count <= TREND_MARKER_MAX_POINTS;
+
+    int prevX = -1;
+    int prevY = -1;
+    for (uint8_t i = 0; i < count; i++) {
+        if (values[i] == 0) continue;
+
+        int x = area.x + (int)((i * xStep + 0x8000) >> 16);
+        int y = span ? bottom - (int)(((uint64_t)(values[i] - low) * yScale + 0x8000) >> 16)
+                     : area.y + area.height / 2;
+
+        if (prevX >= 0) {
+            plotLine(fb, prevX, prevY, x, y);
+        }
+        if (markers) {
+            plotPixel(fb, x - 1, y);
+            plotPixel(fb, x + 1, y);
+            plotPixel(fb, x, y - 1);
+            plotPixel(fb, x, y + 1);
+        }
+        plotPixel(fb, x, y);
+
+        prevX = x;
+        prevY = y;
+    }
+    return valid;
+}
@@ -1,5 +1,6 @@
 #include "vibration_training.h"
-#include <esp_now.h>
+#include "tx_scheduler.h"
+#include "clock.h"
 
 extern DeviceRole deviceRole;
 
@@ -7,9 +8,9 @@ VibrationTrainingManager vibrationTraining;
 
 VibrationTrainingManager::VibrationTrainingManager() 
     : running(false), completed(false), state(VT_STATE_IDLE),
-      singleStartTime(0), singleElapsedTime(0), trainingStartTime(0),
-      totalTrainingTime(0), elapsedTime(0), sessionCount(0), 
-      lastSessionTime(0), lastAlertTime(0), alertInterval(30000) {}
+      singleStartUs(0), singleElapsedUs(0), trainingStartUs(0),
+      totalTrainingUs(0), elapsedUs(0), sessionCount(0), sessionLogged(true),
+      lastSessionUs(0), lastAlertUs(0) {}
 
 void VibrationTrainingManager::init() {
     reset();
@@ -33,10 +34,10 @@ void VibrationTrainingManager::update() {
                 }
             } else {
                 // 每10秒输出一次非TIMING状态信息
-                static unsigned long lastNonTimingDebug = 0;
-                if (millis() - lastNonTimingDebug > 10000) {
+                static uint64_t lastNonTimingDebug = 0;
+                if (Clock::hasElapsed(lastNonTimingDebug, 10000000)) {
                     Serial.printf("主机不在TIMING状态，当前状态: %d (VT_STATE_TIMING=%d)\n", state, VT_STATE_TIMING);
-                    lastNonTimingDebug = millis();
+                    lastNonTimingDebug = Clock::nowUs();
                 }
             }
         } else if (deviceRole == ROLE_SLAVE) {
@@ -50,7 +51,7 @@ void VibrationTrainingManager::update() {
             if (state == VT_STATE_WAITING && hardware.isVibrationDetected()) {
                 Serial.println("单设备模式开始计时");
                 state = VT_STATE_TIMING;
-                singleStartTime = millis();
+                singleStartUs = hardware.lastImpactUs();
                 hardware.displayStatus("计时中...");
             } else if (state == VT_STATE_TIMING && hardware.isVibrationDetected()) {
                 Serial.println("单设备模式结束计时");
@@ -59,11 +60,11 @@ void VibrationTrainingManager::update() {
         }
         
         // 每5秒输出当前状态用于调试
-        static unsigned long lastDebugOutput = 0;
-        if (millis() - lastDebugOutput > 5000) {
+        static uint64_t lastDebugOutput = 0;
+        if (Clock::hasElapsed(lastDebugOutput, 5000000)) {
             Serial.printf("震动训练状态: running=%s, state=%d, deviceRole=%d\n", 
                          running ? "true" : "false", state, deviceRole);
-            lastDebugOutput = millis();
+            lastDebugOutput = Clock::nowUs();
         }
         
         checkTimeout();
@@ -74,11 +75,12 @@ void VibrationTrainingManager::start() {
     running = true;
     completed = false;
     state = VT_STATE_WAITING;
-    trainingStartTime = millis();
-    elapsedTime = 0;
+    trainingStartUs = Clock::nowUs();
+    elapsedUs = 0;
     sessionCount = 0;
-    totalTrainingTime = 0;
-    lastAlertTime = 0;
+    sessionLogged = false;
+    totalTrainingUs = 0;
+    lastAlertUs = 0;
     
     hardware.playStartSound();
     hardware.setAllLEDs(COLOR_GREEN);
@@ -106,9 +108,9 @@ void VibrationTrainingManager::reset() {
     running = false;
     completed = false;
     state = VT_STATE_IDLE;
-    singleStartTime = 0;
-    singleElapsedTime = 0;
-    elapsedTime = 0;
+    singleStartUs = 0;
+    singleElapsedUs = 0;
+    elapsedUs = 0;
     hardware.displayClear();
 }
 
@@ -117,18 +119,20 @@ void VibrationTrainingManager::handleMasterVibration() {
     Serial.printf("主机handleMasterVibration被调用，当前状态: %d\n", state);
     
     if (state == VT_STATE_TIMING) {
-        singleElapsedTime = millis() - singleStartTime;
+        // 以传感器触发时刻结束计时，不含检测到之后的处理延迟
+        uint64_t impactUs = hardware.lastImpactUs();
+        singleElapsedUs = impactUs > singleStartUs ? impactUs - singleStartUs : Clock::elapsedUs(singleStartUs);
         state = VT_STATE_COMPLETED;
         
         // 更新统计数据
         sessionCount++;
-        lastSessionTime = singleElapsedTime;
-        totalTrainingTime += singleElapsedTime;
+        lastSessionUs = singleElapsedUs;
+        totalTrainingUs += singleElapsedUs;
         
-        // 显示结果
+        // 显示结果（0.1ms分辨率）
         char resultText[50];
-        sprintf(resultText, "第%d次: %.3f秒", sessionCount, singleElapsedTime / 1000.0);
-        hardware.displayResult(singleElapsedTime, resultText);
+        sprintf(resultText, "第%d次: %.4f秒", sessionCount, singleElapsedUs / 1000000.0);
+        hardware.displayResult(Clock::toTicks(singleElapsedUs), resultText);
         
         // 视觉和音效反馈
         hardware.setAllLEDs(COLOR_BLUE);
@@ -136,9 +140,9 @@ void VibrationTrainingManager::handleMasterVibration() {
         hardware.playCompleteSound();
         
         // 记录训练数据
-        hardware.addTrainingRecord(singleElapsedTime, MODE_VIBRATION_TRAINING, true);
+        hardware.addTrainingRecord(singleElapsedUs, MODE_VIBRATION_TRAINING, true);
         
-        Serial.printf("主机完成第%d次，用时: %.3f秒\n", sessionCount, singleElapsedTime / 1000.0);
+        Serial.printf("主机完成第%d次，用时: %.4f秒\n", sessionCount, singleElapsedUs / 1000000.0);
         
         // 发送完成信号给从机，通知重置
         sendCompleteMessage();
@@ -155,20 +159,20 @@ void VibrationTrainingManager::handleMasterVibration() {
 }
 
 // 从机开始信号处理（收到从机发来的开始计时信号）
-void VibrationTrainingManager::handleSlaveComplete(unsigned long roundTime) {
-    Serial.printf("handleSlaveComplete 被调用，当前状态: %d, 数据: %lu\n", state, roundTime);
+void VibrationTrainingManager::handleSlaveComplete(uint32_t data) {
+    Serial.printf("handleSlaveComplete 被调用，当前状态: %d, 数据: %lu\n", state, (unsigned long)data);
     
     if (state == VT_STATE_WAITING) {
         // 主机收到从机的开始信号，开始计时
         Serial.printf("主机状态从 %d (WAITING) 切换到 %d (TIMING)\n", state, VT_STATE_TIMING);
         state = VT_STATE_TIMING;
-        singleStartTime = millis();
+        singleStartUs = Clock::nowUs();
         
         hardware.playStartSound();
         hardware.setAllLEDs(COLOR_YELLOW);
         hardware.showLEDs();
         hardware.displayStatus("计时中...触摸主机结束");
-        Serial.printf("主机开始计时，开始时间: %lu\n", singleStartTime);
+        Serial.printf("主机开始计时，开始时间: %llu us\n", (unsigned long long)singleStartUs);
         Serial.printf("主机现在应该在TIMING状态，state=%d\n", state);
     } else {
         Serial.printf("主机状态不是WAITING，当前状态: %d\n", state);
@@ -201,16 +205,16 @@ void VibrationTrainingManager::handleSlaveVibration() {
 
 void VibrationTrainingManager::updateTimer() {
     if (running) {
-        elapsedTime = millis() - trainingStartTime;
+        elapsedUs = Clock::elapsedUs(trainingStartUs);
         
         // 根据状态显示不同信息
         if (state == VT_STATE_TIMING) {
-            singleElapsedTime = millis() - singleStartTime;
+            singleElapsedUs = Clock::elapsedUs(singleStartUs);
             // 实时显示计时状态
             char timingText[50];
-            sprintf(timingText, "计时中: %.3f秒", singleElapsedTime / 1000.0);
+            sprintf(timingText, "计时中: %.3f秒", singleElapsedUs / 1000000.0);
             hardware.displayStatus(timingText);
-            Serial.printf("单次计时中: %.3f秒\n", singleElapsedTime / 1000.0);
+            Serial.printf("单次计时中: %.3f秒\n", singleElapsedUs / 1000000.0);
         } else if (state == VT_STATE_WAITING) {
             // 等待状态显示
             if (deviceRole == ROLE_MASTER) {
@@ -221,17 +225,17 @@ void VibrationTrainingManager::updateTimer() {
         }
         
         // 每5秒切换到详细状态显示
-        static unsigned long lastDetailedDisplay = 0;
-        if (millis() - lastDetailedDisplay > 5000) {
-            float currentTimeSeconds = (totalTrainingTime + elapsedTime) / 1000.0;
+        static uint64_t lastDetailedDisplay = 0;
+        if (Clock::hasElapsed(lastDetailedDisplay, 5000000)) {
+            float currentTimeSeconds = (totalTrainingUs + elapsedUs) / 1000000.0;
             bool isConnected = true; // TODO: 从实际连接状态获取
-            int batteryLevel = 80;   // TODO: 从实际电池状态获取
+            int batteryLevel = hardware.batteryPercent();
             int signalStrength = 75; // TODO: 从实际信号强度获取
             bool isMaster = (deviceRole == ROLE_MASTER);
             
             hardware.displayTrainingDetailedStatus(currentTimeSeconds, sessionCount, 
                                                  isConnected, batteryLevel, signalStrength, isMaster);
-            lastDetailedDisplay = millis();
+            lastDetailedDisplay = Clock::nowUs();
         }
         
         updateVisualFeedback();
@@ -240,13 +244,13 @@ void VibrationTrainingManager::updateTimer() {
 
 void VibrationTrainingManager::checkTimeout() {
     // 单次计时超时检查
-    if (state == VT_STATE_TIMING && singleElapsedTime >= TIMING_TIMEOUT_MS) {
+    if (state == VT_STATE_TIMING && singleElapsedUs >= TIMING_TIMEOUT_MS * 1000ULL) {
         state = VT_STATE_WAITING;
         hardware.displayStatus("Timeout - Try again");
         hardware.playErrorSound();
         
         // 记录超时的训练数据  
-        hardware.addTrainingRecord(singleElapsedTime, MODE_SINGLE_TIMER, false);
+        hardware.addTrainingRecord(singleElapsedUs, MODE_SINGLE_TIMER, false);
         
         delay(2000);
         if (deviceRole == ROLE_MASTER) {
@@ -268,17 +272,17 @@ void VibrationTrainingManager::showReadyCountdown() {
 }
 
 void VibrationTrainingManager::updateVisualFeedback() {
-    int progress = (elapsedTime * 100) / TIMING_TIMEOUT_MS;
+    int progress = (int)((elapsedUs / 1000 * 100) / TIMING_TIMEOUT_MS);
     hardware.ledProgressBar(progress, COLOR_GREEN);
 }
 
 void VibrationTrainingManager::checkAlerts() {
     // 总运动时长达标提醒
-    unsigned long currentTotalTime = totalTrainingTime + elapsedTime;
-    uint32_t alertIntervalMs = hardware.getSettings()->alertDuration * 1000;
+    uint64_t currentTotalUs = totalTrainingUs + elapsedUs;
+    uint64_t alertIntervalUs = hardware.getSettings()->alertDuration * 1000000ULL;
     
-    if (currentTotalTime - lastAlertTime >= alertIntervalMs) {
-        lastAlertTime = currentTotalTime;
+    if (currentTotalUs - lastAlertUs >= alertIntervalUs) {
+        lastAlertUs = currentTotalUs;
         hardware.playAlertSound();
         hardware.displayStatus("Time Goal Reached!");
         delay(1000);
@@ -289,11 +293,58 @@ void VibrationTrainingManager::checkAlerts() {
 void VibrationTrainingManager::exitTraining() {
     running = false;
     state = VT_STATE_IDLE;
+    endSession();
     
     displayDailyStats();
     hardware.playCompleteSound();
 }
 
+void VibrationTrainingManager::endSession() {
+    if (sessionLogged) {
+        return;
+    }
+    sessionLogged = true;
+    
+    if (sessionCount > 0) {
+        hardware.addSessionRecord(totalTrainingUs, MODE_VIBRATION_TRAINING);
+    }
+    hardware.flushTrainingLog();
+}
+
+RoleSwapSession VibrationTrainingManager::snapshotSession() const {
+    RoleSwapSession session = {};
+    session.rounds = (uint16_t)sessionCount;
+    session.totalTicks = Clock::toTicks(totalTrainingUs);
+    session.elapsedMs = (uint32_t)(Clock::elapsedUs(trainingStartUs) / 1000);
+    session.lastTicks = Clock::toTicks(lastSessionUs);
+    return session;
+}
+
+void VibrationTrainingManager::adoptSession(const RoleSwapSession& session) {
+    sessionCount = session.rounds;
+    totalTrainingUs = Clock::fromTicks(session.totalTicks);
+    lastSessionUs = Clock::fromTicks(session.lastTicks);
+    elapsedUs = session.elapsedMs * 1000ULL;
+    trainingStartUs = Clock::nowUs() - elapsedUs;
+    sessionLogged = false;
+    
+    // 达标提醒接着对端的进度，不因交换重复提醒
+    uint64_t currentTotalUs = totalTrainingUs + elapsedUs;
+    uint64_t alertIntervalUs = hardware.getSettings()->alertDuration * 1000000ULL;
+    lastAlertUs = alertIntervalUs > 0 ? currentTotalUs - currentTotalUs % alertIntervalUs : currentTotalUs;
+    
+    state = VT_STATE_WAITING;
+    hardware.displayStatus("等待从机触发...");
+    Serial.printf("接续课程: 已完成%d次, 总用时 %.4f秒\n", sessionCount, totalTrainingUs / 1000000.0);
+}
+
+void VibrationTrainingManager::handOverSession() {
+    // 本机的单次记录已在回合结束时写入，课程汇总由新主机在退出时记录
+    sessionLogged = true;
+    state = VT_STATE_WAITING;
+    hardware.displayStatus("触摸此设备开始");
+}
+
 // 发送开始计时消息给主机（从机发送）
 void VibrationTrainingManager::sendStartMessage() {
     extern uint8_t peerAddress[6];
@@ -307,37 +358,37 @@ void VibrationTrainingManager::sendStartMessage() {
     msg.command = CMD_VT_START_ROUND;
     msg.target_id = 0;  // 发送给主机
     msg.source_id = 1;  // 从机发送
-    msg.timestamp = millis();
+    msg.timestamp = Clock::stamp32();
     msg.data = 0;
     msg.checksum = 0; // TODO: 计算校验和
     
     Serial.printf("发送消息: command=%d, target_id=%d, source_id=%d\n", 
                   msg.command, msg.target_id, msg.source_id);
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&msg, sizeof(msg));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &msg, sizeof(msg), TX_PRIO_TIMING);
+    if (result) {
         Serial.println("从机发送开始计时信号成功");
     } else {
-        Serial.printf("从机发送开始计时信号失败: %d\n", result);
+        Serial.println("从机发送开始计时信号失败: 发送队列已满");
     }
 }
 
 // 从机收到主机完成信号，重置状态
-void VibrationTrainingManager::handleRoundComplete(unsigned long roundTime) {
+void VibrationTrainingManager::handleRoundComplete(uint32_t roundTicks) {
     if (state == VT_STATE_TIMING) {
         state = VT_STATE_WAITING;  // 重置到等待状态
         
         // 显示主机完成的用时
         char resultText[50];
-        sprintf(resultText, "主机用时: %.3f秒", roundTime / 1000.0);
-        hardware.displayResult(roundTime, resultText);
+        sprintf(resultText, "主机用时: %.4f秒", roundTicks / 10000.0);
+        hardware.displayResult(roundTicks, resultText);
         
         // 视觉反馈
         hardware.setAllLEDs(COLOR_GREEN);
         hardware.showLEDs();
         hardware.playCompleteSound();
         
-        Serial.printf("从机收到主机完成信号，用时: %.3f秒\n", roundTime / 1000.0);
+        Serial.printf("从机收到主机完成信号，用时: %.4f秒\n", roundTicks / 10000.0);
         
         // 等待2秒后重置显示
         delay(2000);
@@ -353,15 +404,15 @@ void VibrationTrainingManager::sendCompleteMessage() {
     msg.command = CMD_VT_ROUND_COMPLETE;
     msg.target_id = 1;  // 发送给从机
     msg.source_id = 0;  // 主机发送
-    msg.timestamp = millis();
-    msg.data = singleElapsedTime;  // 发送用时
+    msg.timestamp = Clock::stamp32();
+    msg.data = Clock::toTicks(singleElapsedUs);  // 发送用时（0.1ms）
     msg.checksum = 0; // TODO: 计算校验和
     
-    esp_err_t result = esp_now_send(peerAddress, (uint8_t*)&msg, sizeof(msg));
-    if (result == ESP_OK) {
+    bool result = radioTx.enqueue(peerAddress, &msg, sizeof(msg), TX_PRIO_TIMING);
+    if (result) {
         Serial.println("主机发送完成信号成功");
     } else {
-        Serial.printf("主机发送完成信号失败: %d\n", result);
+        Serial.println("主机发送完成信号失败: 发送队列已满");
     }
 }
 
@@ -371,7 +422,7 @@ void VibrationTrainingManager::displayDailyStats() {
     
     char statsText[100];
     sprintf(statsText, "Today's Training\nSessions: %d\nTotal Time: %.1fs", 
-            sessionCount, (totalTrainingTime + elapsedTime) / 1000.0);
+            sessionCount, (totalTrainingUs + elapsedUs) / 1000000.0);
     
     hardware.displayTextCentered(statsText, 30);
     delay(3000);
@@ -0,0 +1,102 @@
+#include <unity.h>
+#include "battery_gauge.h"
+
+// 100k/100k分压，内阻150mΩ，1000mAh
+static const BatteryConfig kConfig = {200, 150, 1000};
+
+// 开路电压为cellMv、负载loadMa时分压点上的电压
+static uint16_t pinMvFor(uint16_t cellMv, uint16_t loadMa) {
+    return (uint16_t)((cellMv - (uint32_t)loadMa * 150 / 1000) / 2);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_discharge_curve_lookup(void) {
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentFromMv(3000));
+    TEST_ASSERT_EQUAL_UINT8(0, BatteryGauge::percentFromMv(3300));
+    TEST_ASSERT_EQUAL_UINT8(50, BatteryGauge::percentFromMv(3840));
+    // 分段之间线性插值
+    TEST_ASSERT_EQUAL_UINT8(55, BatteryGauge::percentFromMv(3855));
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryGauge::percentFromMv(4200));
+    TEST_ASSERT_EQUAL_UINT8(100, BatteryGauge::percentFromMv(4350));
+}
+
+void test_load_compensation(void) {
+    TEST_ASSERT_EQUAL_UINT16(3730, BatteryGauge::compensate(3700, 200, 150));
+
+    // 同一块电池，LED全亮时带载电压更低，补偿后电量一致
+    BatteryGauge idle(kConfig);
+    BatteryGauge loaded(kConfig);
+    idle.addSample(pinMvFor(3840, 90), 90);
+    loaded.addSample(pinMvFor(3840, 800), 800);
+    TEST_ASSERT_UINT32_WITHIN(2, 3840, idle.cellMv());
+    TEST_ASSERT_UINT32_WITHIN(2, 3840, loaded.cellMv());
+    TEST_ASSERT_UINT32_WITHIN(1, idle.percent(), loaded.percent());
+
+    // 不补偿时800mA下约低120mV，电量会被低估一半
+    BatteryGauge uncompensated({200, 0, 1000});
+    uncompensated.addSample(pinMvFor(3840, 800), 800);
+    TEST_ASSERT_LESS_THAN(30, uncompensated.percent());
+}
+
+void test_percent_rises_only_past_hysteresis(void) {
+    BatteryGauge gauge(kConfig);
+    TEST_ASSERT_FALSE(gauge.valid());
+    gauge.addSample(1900, 0);
+    TEST_ASSERT_TRUE(gauge.valid());
+    TEST_ASSERT_EQUAL_UINT8(40, gauge.percent());
+
+    // 负载波动造成的小幅回升不显示
+    for (int i = 0; i < 20; i++) {
+        gauge.addSample(1904, 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(40, gauge.percent());
+
+    // 充电时明显回升
+    for (int i = 0; i < 20; i++) {
+        gauge.addSample(1915, 0);
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(43, gauge.percent());
+
+    // 下降立即跟随
+    uint8_t before = gauge.percent();
+    gauge.addSample(1880, 0);
+    TEST_ASSERT_LESS_THAN(before, gauge.percent());
+}
+
+void test_remaining_runtime(void) {
+    BatteryGauge gauge(kConfig);
+    TEST_ASSERT_EQUAL_UINT32(0, gauge.remainingMinutes());
+    gauge.addSample(pinMvFor(3840, 200), 200);
+    TEST_ASSERT_EQUAL_UINT8(50, gauge.percent());
+    TEST_ASSERT_EQUAL_UINT16(200, gauge.averageLoadMa());
+    // 500mAh / 200mA = 2.5小时
+    TEST_ASSERT_EQUAL_UINT32(150, gauge.remainingMinutes());
+
+    // 平均负载缓慢跟随
+    gauge.addSample(pinMvFor(3840, 400), 400);
+    TEST_ASSERT_EQUAL_UINT16(225, gauge.averageLoadMa());
+}
+
+void test_report_packing(void) {
+    uint32_t data = batteryPackReport(0x1C402, 73);
+    TEST_ASSERT_EQUAL_INT(73, batteryReportPercent(data));
+    TEST_ASSERT_EQUAL_UINT32(0x1C402, data & 0x00FFFFFF);
+    TEST_ASSERT_EQUAL_INT(0, batteryReportPercent(batteryPackReport(0, 0)));
+    TEST_ASSERT_EQUAL_INT(100, batteryReportPercent(batteryPackReport(0, 100)));
+    // 未测得时不改变data，旧固件的心跳也解析为未知
+    TEST_ASSERT_EQUAL_UINT32(5, batteryPackReport(5, BATTERY_UNKNOWN));
+    TEST_ASSERT_EQUAL_INT(BATTERY_UNKNOWN, batteryReportPercent(5));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_discharge_curve_lookup);
+    RUN_TEST(test_load_compensation);
+    RUN_TEST(test_percent_rises_only_past_hysteresis);
+    RUN_TEST(test_remaining_runtime);
+    RUN_TEST(test_report_packing);
+    return UNITY_END();
+}
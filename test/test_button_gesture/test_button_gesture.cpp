@@ -0,0 +1,180 @@
+#include <unity.h>
+#include "button_gesture.h"
+
+#define MS 1000ULL
+
+// 脚本化边沿序列：{时间ms, 按下}
+struct TraceStep {
+    uint32_t atMs;
+    bool pressed;
+};
+
+static ButtonGestureRecognizer recognizer;
+
+static void playTrace(const TraceStep* steps, int count) {
+    for (int i = 0; i < count; i++) {
+        recognizer.feed({steps[i].atMs * MS, steps[i].pressed});
+    }
+}
+
+static void expectEvent(ButtonGesture gesture, uint8_t count, uint32_t atMs) {
+    ButtonEvent event;
+    TEST_ASSERT_TRUE(recognizer.nextEvent(event));
+    TEST_ASSERT_EQUAL_INT(gesture, event.gesture);
+    TEST_ASSERT_EQUAL_UINT8(count, event.count);
+    TEST_ASSERT_EQUAL_UINT64(atMs * MS, event.atUs);
+}
+
+void setUp(void) {
+    recognizer.reset();
+    recognizer.setTiming({50 * MS, 400 * MS, 1000 * MS, 250 * MS, 3});
+}
+
+void tearDown(void) {}
+
+void test_single_click_with_contact_bounce(void) {
+    const TraceStep trace[] = {
+        {100, true}, {102, false}, {103, true},     // 按下抖动
+        {180, false}, {181, true}, {183, false},    // 松开抖动
+    };
+    playTrace(trace, 6);
+
+    recognizer.update(500 * MS);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+    recognizer.update(583 * MS);
+    expectEvent(GESTURE_CLICK, 1, 583);
+    TEST_ASSERT_FALSE(recognizer.isPressed());
+}
+
+void test_glitch_shorter_than_debounce_is_ignored(void) {
+    const TraceStep trace[] = {{100, true}, {120, false}};
+    playTrace(trace, 2);
+    recognizer.update(2000 * MS);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+}
+
+void test_double_and_triple_click(void) {
+    const TraceStep twice[] = {{0, true}, {80, false}, {300, true}, {380, false}};
+    playTrace(twice, 4);
+    recognizer.update(2000 * MS);
+    expectEvent(GESTURE_CLICK, 2, 780);
+
+    // 第三次松开即达到上限，立即上报，不再等待点击窗口
+    const TraceStep thrice[] = {{3000, true}, {3080, false}, {3200, true}, {3280, false}, {3400, true}, {3480, false}};
+    playTrace(thrice, 6);
+    recognizer.update(3540 * MS);
+    expectEvent(GESTURE_CLICK, 3, 3480);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+}
+
+void test_long_press_with_hold_repeat(void) {
+    const TraceStep trace[] = {{1000, true}, {2600, false}};
+    playTrace(trace, 2);
+    recognizer.update(3000 * MS);
+
+    expectEvent(GESTURE_LONG_PRESS, 1, 2000);
+    expectEvent(GESTURE_HOLD_REPEAT, 1, 2250);
+    expectEvent(GESTURE_HOLD_REPEAT, 2, 2500);
+    expectEvent(GESTURE_LONG_RELEASE, 2, 2600);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+    TEST_ASSERT_FALSE(recognizer.isLongPressed());
+}
+
+void test_late_processing_keeps_edge_timing(void) {
+    // 主循环被阻塞2秒后才处理：按边沿时间判定仍为双击，而不是两个单击或长按
+    const TraceStep trace[] = {{10, true}, {90, false}, {250, true}, {330, false}};
+    playTrace(trace, 4);
+    recognizer.update(2330 * MS);
+    expectEvent(GESTURE_CLICK, 2, 730);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+
+    // 长按在阻塞期间成立并已松开，重复事件只出现在按住的时间内
+    const TraceStep hold[] = {{5000, true}, {6300, false}};
+    playTrace(hold, 2);
+    recognizer.update(9000 * MS);
+    expectEvent(GESTURE_LONG_PRESS, 1, 6000);
+    expectEvent(GESTURE_HOLD_REPEAT, 1, 6250);
+    expectEvent(GESTURE_LONG_RELEASE, 1, 6300);
+}
+
+void test_click_then_long_press(void) {
+    const TraceStep trace[] = {{0, true}, {80, false}, {200, true}};
+    playTrace(trace, 3);
+    recognizer.update(1250 * MS);
+    expectEvent(GESTURE_CLICK, 1, 200);
+    expectEvent(GESTURE_LONG_PRESS, 1, 1200);
+    TEST_ASSERT_TRUE(recognizer.isLongPressed());
+}
+
+void test_edge_queue_order_and_overflow(void) {
+    ButtonEdgeQueue queue;
+    for (int i = 0; i < BUTTON_EDGE_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(queue.push(i * MS, (i & 1) == 0));
+    }
+    TEST_ASSERT_FALSE(queue.push(999 * MS, true));
+    TEST_ASSERT_EQUAL_UINT32(1, queue.dropped());
+
+    ButtonEdge edge;
+    for (int i = 0; i < BUTTON_EDGE_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(queue.pop(edge));
+        TEST_ASSERT_EQUAL_UINT64(i * MS, edge.atUs);
+    }
+    TEST_ASSERT_FALSE(queue.pop(edge));
+}
+
+void test_edge_after_now_does_not_rewind(void) {
+    // 在update()之后才取到的较早边沿按已推进到的时刻处理，时间不回退
+    recognizer.feed({0, true});
+    recognizer.update(100 * MS);
+    recognizer.feed({80 * MS, false});
+    recognizer.update(499 * MS);
+    TEST_ASSERT_EQUAL_UINT8(0, recognizer.pendingEvents());
+    recognizer.update(600 * MS);
+    expectEvent(GESTURE_CLICK, 1, 500);
+}
+
+void test_sleep_wake_level_flip_keeps_clicks(void) {
+    // 开启浅睡唤醒后引脚中断为电平触发：按1ms步进模拟引脚，电平与等待电平相同时进入中断，
+    // 中断记录边沿后翻转等待电平（与ButtonManager::onEdgeISR相同）
+    const TraceStep levels[] = {{100, true}, {180, false}, {300, true}, {380, false}};
+    ButtonEdgeQueue queue;
+    bool waitHigh = buttonWakeOnHigh(false);
+    bool pin = false;
+    int interrupts = 0;
+    int next = 0;
+    for (uint32_t ms = 0; ms < 1000; ms++) {
+        if (next < 4 && levels[next].atMs == ms) {
+            pin = levels[next++].pressed;
+        }
+        if (pin == waitHigh) {
+            interrupts++;
+            queue.push(ms * MS, pin);
+            waitHigh = buttonWakeOnHigh(pin);
+        }
+    }
+    // 每次电平变化只进入一次中断，按住期间不会连续触发
+    TEST_ASSERT_EQUAL_INT(4, interrupts);
+    TEST_ASSERT_EQUAL_UINT32(0, queue.dropped());
+
+    // 与tick()相同：取出边沿喂给识别器后得到双击
+    ButtonEdge edge;
+    while (queue.pop(edge)) {
+        recognizer.feed(edge);
+    }
+    recognizer.update(1000 * MS);
+    expectEvent(GESTURE_CLICK, 2, 780);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_click_with_contact_bounce);
+    RUN_TEST(test_glitch_shorter_than_debounce_is_ignored);
+    RUN_TEST(test_double_and_triple_click);
+    RUN_TEST(test_long_press_with_hold_repeat);
+    RUN_TEST(test_late_processing_keeps_edge_timing);
+    RUN_TEST(test_click_then_long_press);
+    RUN_TEST(test_edge_queue_order_and_overflow);
+    RUN_TEST(test_edge_after_now_does_not_rewind);
+    RUN_TEST(test_sleep_wake_level_flip_keeps_clicks);
+    return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include "channel_plan.h"
+
+// 在信道上按给定间隔注入长度为length的帧，持续一个监听时长
+static void fillChannel(ChannelSurvey& survey, uint8_t channel, uint32_t framesPerDwell, uint16_t length,
+                        int8_t rssi = -60) {
+    for (uint32_t i = 0; i < framesPerDwell; i++) {
+        survey.addFrame(channel, rssi, length);
+    }
+}
+
+static void finishSurvey(ChannelSurvey& survey) {
+    for (uint8_t channel = CHANNEL_MIN; channel <= CHANNEL_MAX; channel++) {
+        survey.setDwell(channel, CHANNEL_DWELL_US);
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_survey_avoids_busy_channels_and_neighbours(void) {
+    // 球场常见：1和6上有很多AP，3有一个弱的热点，13上有少量帧；10附近最空闲
+    ChannelSurvey survey;
+    fillChannel(survey, 1, 120, 300);
+    fillChannel(survey, 6, 80, 300);
+    fillChannel(survey, 3, 10, 100, -90);
+    fillChannel(survey, 13, 5, 100);
+    finishSurvey(survey);
+
+    TEST_ASSERT_GREATER_THAN(500, survey.occupancy(1));
+    TEST_ASSERT_EQUAL_UINT32(0, survey.occupancy(2));
+    TEST_ASSERT_GREATER_THAN(200, survey.congestion(2));    // 相邻信道的重叠计入拥塞
+    TEST_ASSERT_EQUAL_UINT8(10, survey.best());
+
+    uint8_t target = 0;
+    TEST_ASSERT_TRUE(survey.shouldSwitch(1, target));
+    TEST_ASSERT_EQUAL_UINT8(10, target);
+}
+
+void test_survey_keeps_channel_when_gain_is_small(void) {
+    ChannelSurvey survey;
+    fillChannel(survey, 1, 20, 200);
+    fillChannel(survey, 11, 17, 200);
+    for (uint8_t channel = 2; channel <= 10; channel++) {
+        fillChannel(survey, channel, 30, 200);
+    }
+    fillChannel(survey, 12, 30, 200);
+    fillChannel(survey, 13, 30, 200);
+    finishSurvey(survey);
+
+    uint8_t target = 0;
+    TEST_ASSERT_FALSE(survey.shouldSwitch(1, target));
+
+    // 空闲时拥塞相同，优先不重叠的信道
+    ChannelSurvey quiet;
+    finishSurvey(quiet);
+    TEST_ASSERT_EQUAL_UINT8(1, quiet.best());
+    TEST_ASSERT_FALSE(quiet.shouldSwitch(6, target));
+}
+
+void test_link_probe_loss_and_rtt(void) {
+    LinkProbe probe;
+    probe.begin(0, 10, 20000);
+    uint8_t sequence;
+    for (uint64_t now = 0; now < 300000; now += 1000) {
+        if (probe.due(now, sequence) && sequence % 5 != 4) {
+            probe.onReply(sequence, now + 2000 + sequence * 100);
+        }
+    }
+    TEST_ASSERT_TRUE(probe.done(300000));
+    LinkStats stats = probe.result();
+    TEST_ASSERT_EQUAL_UINT8(10, stats.sent);
+    TEST_ASSERT_EQUAL_UINT8(8, stats.received);
+    TEST_ASSERT_EQUAL_UINT8(20, stats.lossPercent());
+    TEST_ASSERT_EQUAL_UINT32(2800, stats.rttMaxUs);
+
+    // 超时后才到的回应和重复回应不计入
+    probe.onReply(9, 180000 + LINK_PROBE_TIMEOUT_US + 1);
+    probe.onReply(0, 10000);
+    TEST_ASSERT_EQUAL_UINT8(8, probe.result().received);
+}
+
+void test_switch_requires_every_ack(void) {
+    ChannelSwitchCoordinator coordinator;
+    coordinator.begin(1, 11, 0x0006, 0);
+    TEST_ASSERT_TRUE(coordinator.announceDue(0));
+    coordinator.onAck(1);
+    TEST_ASSERT_FALSE(coordinator.announceDue(10000));
+    TEST_ASSERT_TRUE(coordinator.announceDue(CHANNEL_ANNOUNCE_INTERVAL_US));   // 2号未应答，重发
+    TEST_ASSERT_EQUAL_INT(CHSW_ABORTED, coordinator.update(CHANNEL_SWITCH_LEAD_US));
+}
+
+void test_switch_verifies_peers_on_new_channel(void) {
+    ChannelSwitchCoordinator coordinator;
+    coordinator.begin(1, 11, 0x0002, 0);
+    coordinator.onAck(1);
+    TEST_ASSERT_FALSE(coordinator.announceDue(CHANNEL_ANNOUNCE_INTERVAL_US));  // 已收齐不再重发
+    TEST_ASSERT_EQUAL_INT(CHSW_ANNOUNCING, coordinator.update(CHANNEL_SWITCH_LEAD_US - 1));
+    TEST_ASSERT_EQUAL_INT(CHSW_VERIFYING, coordinator.update(CHANNEL_SWITCH_LEAD_US));
+    coordinator.onPeerHeard(1);
+    TEST_ASSERT_EQUAL_INT(CHSW_DONE, coordinator.update(CHANNEL_SWITCH_LEAD_US + 20000));
+
+    ChannelSwitchCoordinator silent;
+    silent.begin(1, 11, 0x0002, 0);
+    silent.onAck(1);
+    silent.update(CHANNEL_SWITCH_LEAD_US);
+    TEST_ASSERT_EQUAL_INT(CHSW_VERIFYING, silent.update(CHANNEL_SWITCH_LEAD_US + CHANNEL_VERIFY_US - 1));
+    TEST_ASSERT_EQUAL_INT(CHSW_FAILED, silent.update(CHANNEL_SWITCH_LEAD_US + CHANNEL_VERIFY_US));
+}
+
+void test_cone_follows_after_lost_announce(void) {
+    // 第一次通知丢失，重发的通知送达；通知经约3ms送达、主循环10ms
+    ChannelSwitchCoordinator master;
+    ChannelFollower cone(1);
+    uint8_t masterChannel = 1, coneChannel = 1;
+    uint64_t masterSwitchUs = 0, coneSwitchUs = 0;
+    int announces = 0;
+
+    master.begin(1, 11, 0x0002, 0);
+    for (uint64_t now = 0; now < 1000000; now += 10000) {
+        if (master.announceDue(now) && ++announces > 1) {
+            uint64_t arriveUs = now + 3000;
+            cone.schedule(master.target(), arriveUs + master.remainingMs(now) * 1000ULL - 3000);
+            master.onAck(1);
+        }
+        ChannelSwitchState before = master.state();
+        if (master.update(now) == CHSW_VERIFYING && before == CHSW_ANNOUNCING) {
+            masterChannel = master.target();
+            masterSwitchUs = now;
+        }
+        uint8_t channel;
+        if (cone.switchDue(now, channel)) {
+            coneChannel = channel;
+            coneSwitchUs = now;
+            master.onPeerHeard(1);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(2, announces);
+    TEST_ASSERT_EQUAL_INT(CHSW_DONE, master.state());
+    TEST_ASSERT_EQUAL_UINT8(11, masterChannel);
+    TEST_ASSERT_EQUAL_UINT8(11, coneChannel);
+    TEST_ASSERT_UINT32_WITHIN(10000, (uint32_t)masterSwitchUs, (uint32_t)coneSwitchUs);
+}
+
+void test_fallback_to_rendezvous_when_lost(void) {
+    ChannelFollower cone(1);
+    TEST_ASSERT_FALSE(cone.fallbackDue(1, CHANNEL_LOST_US * 2));      // 已在约定信道
+    TEST_ASSERT_FALSE(cone.fallbackDue(11, CHANNEL_LOST_US - 1));
+    TEST_ASSERT_TRUE(cone.fallbackDue(11, CHANNEL_LOST_US));
+
+    // 等待切换期间不回退
+    cone.schedule(6, 5000000);
+    TEST_ASSERT_FALSE(cone.fallbackDue(11, CHANNEL_LOST_US));
+    uint8_t channel;
+    TEST_ASSERT_FALSE(cone.switchDue(4999999, channel));
+    TEST_ASSERT_TRUE(cone.switchDue(5000000, channel));
+    TEST_ASSERT_EQUAL_UINT8(6, channel);
+    TEST_ASSERT_FALSE(cone.switchDue(6000000, channel));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_survey_avoids_busy_channels_and_neighbours);
+    RUN_TEST(test_survey_keeps_channel_when_gain_is_small);
+    RUN_TEST(test_link_probe_loss_and_rtt);
+    RUN_TEST(test_switch_requires_every_ack);
+    RUN_TEST(test_switch_verifies_peers_on_new_channel);
+    RUN_TEST(test_cone_follows_after_lost_announce);
+    RUN_TEST(test_fallback_to_rendezvous_when_lost);
+    return UNITY_END();
+}
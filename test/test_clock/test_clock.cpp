@@ -0,0 +1,85 @@
+#include <unity.h>
+#include "clock.h"
+#include "training_record_store.h"
+
+void setUp(void) {
+    Clock::setUs(0);
+}
+
+void tearDown(void) {}
+
+void test_elapsed_across_64bit_wrap(void) {
+    Clock::setUs(UINT64_MAX - 500);
+    uint64_t start = Clock::nowUs();
+
+    Clock::advanceUs(1000);
+    TEST_ASSERT_TRUE(Clock::nowUs() < start);
+    TEST_ASSERT_EQUAL_UINT64(1000, Clock::elapsedUs(start));
+    TEST_ASSERT_TRUE(Clock::hasElapsed(start, 1000));
+    TEST_ASSERT_FALSE(Clock::hasElapsed(start, 1001));
+}
+
+void test_stamp32_delta_across_32bit_wrap(void) {
+    // 32位微秒时间戳在约71.6分钟处回绕，链路超时判断必须跨越该边界
+    Clock::setUs(0xFFFFFFFFULL - 2000000);
+    uint32_t sent = Clock::stamp32();
+
+    Clock::advanceUs(5000000);
+    uint32_t now = Clock::stamp32();
+    TEST_ASSERT_TRUE(now < sent);
+    TEST_ASSERT_EQUAL_INT32(5000000, Clock::delta32(now, sent));
+    TEST_ASSERT_EQUAL_INT32(-5000000, Clock::delta32(sent, now));
+
+    // 心跳超时判断：8秒超时在边界两侧一致
+    const int32_t timeoutUs = 8000000;
+    TEST_ASSERT_FALSE(Clock::delta32(now, sent) > timeoutUs);
+    Clock::advanceUs(3000001);
+    TEST_ASSERT_TRUE(Clock::delta32(Clock::stamp32(), sent) > timeoutUs);
+}
+
+void test_ticks_round_and_saturate(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, Clock::toTicks(49));
+    TEST_ASSERT_EQUAL_UINT32(1, Clock::toTicks(50));
+    TEST_ASSERT_EQUAL_UINT32(1, Clock::toTicks(149));
+    TEST_ASSERT_EQUAL_UINT32(2, Clock::toTicks(150));
+    TEST_ASSERT_EQUAL_UINT64(1234500, Clock::fromTicks(12345));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, Clock::toTicks(UINT64_MAX));
+}
+
+void test_round_time_keeps_tenth_ms_end_to_end(void) {
+    // 计时区间跨越32位边界：开始 -> 结束 -> 消息(0.1ms) -> 记录
+    Clock::setUs(0xFFFFFFFFULL - 6000000);
+    uint64_t start = Clock::nowUs();
+    Clock::advanceUs(12345678);
+    uint64_t elapsed = Clock::elapsedUs(start);
+
+    uint32_t messageTicks = Clock::toTicks(elapsed);
+    TEST_ASSERT_EQUAL_UINT32(123457, messageTicks);
+
+    PackedTrainingRecord record = TrainingRecordStore::pack(1700000000UL, elapsed, MODE_VIBRATION_TRAINING,
+                                                            RECORD_FLAG_COMPLETED);
+    TEST_ASSERT_EQUAL_UINT64(Clock::fromTicks(messageTicks), TrainingRecordStore::durationUs(record));
+    TEST_ASSERT_EQUAL_UINT32(messageTicks, TrainingRecordStore::unpack(record).duration);
+    TEST_ASSERT_EQUAL_UINT32(12346, TrainingRecordStore::durationMs(record));
+}
+
+void test_record_units_and_limits(void) {
+    // 单次记录0.1ms单位，最长约28分钟后饱和
+    PackedTrainingRecord round = TrainingRecordStore::pack(0, 3600000000ULL, 0, RECORD_FLAG_COMPLETED);
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)RECORD_DURATION_MAX * RECORD_TICK_US, TrainingRecordStore::durationUs(round));
+
+    // 课程汇总记录毫秒单位，3小时不饱和
+    PackedTrainingRecord session = TrainingRecordStore::pack(0, 3 * 3600000000ULL, 0, RECORD_FLAG_SESSION);
+    TEST_ASSERT_EQUAL_UINT64(3 * 3600000000ULL, TrainingRecordStore::durationUs(session));
+    TEST_ASSERT_EQUAL_UINT32(108000000, TrainingRecordStore::unpack(session).duration);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_elapsed_across_64bit_wrap);
+    RUN_TEST(test_stamp32_delta_across_32bit_wrap);
+    RUN_TEST(test_ticks_round_and_saturate);
+    RUN_TEST(test_round_time_keeps_tenth_ms_end_to_end);
+    RUN_TEST(test_record_units_and_limits);
+    return UNITY_END();
+}
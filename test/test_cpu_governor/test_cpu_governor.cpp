@@ -0,0 +1,139 @@
+#include <unity.h>
+#include "cpu_governor.h"
+
+#define MS_US     1000ULL
+#define SECOND_US 1000000ULL
+
+static CpuGovernor governor;
+
+void setUp(void) {
+    governor.begin(0);
+}
+
+void tearDown(void) {}
+
+void test_policy_table(void) {
+    // 计时满频且不浅睡，空闲降频并允许浅睡
+    TEST_ASSERT_EQUAL_UINT16(CPU_MHZ_FULL, cpuPolicyFor(CPU_DEMAND_TIMING).cpuMhz);
+    TEST_ASSERT_FALSE(cpuPolicyFor(CPU_DEMAND_TIMING).lightSleep);
+    TEST_ASSERT_FALSE(cpuPolicyFor(CPU_DEMAND_ACTIVE).lightSleep);
+    TEST_ASSERT_EQUAL_UINT16(CPU_MHZ_LOW, cpuPolicyFor(CPU_DEMAND_IDLE).cpuMhz);
+    TEST_ASSERT_TRUE(cpuPolicyFor(CPU_DEMAND_IDLE).lightSleep);
+
+    // 需求越高时钟不降低，保持时间不缩短
+    for (uint8_t level = 1; level < CPU_DEMAND_COUNT; level++) {
+        const CpuPolicy& lower = cpuPolicyFor((CpuDemand)(level - 1));
+        const CpuPolicy& higher = cpuPolicyFor((CpuDemand)level);
+        TEST_ASSERT_TRUE(higher.cpuMhz >= lower.cpuMhz);
+        TEST_ASSERT_TRUE(higher.holdMs >= lower.holdMs);
+        TEST_ASSERT_TRUE(higher.holdMs > 0);
+        TEST_ASSERT_TRUE(lower.cpuMhz >= CPU_MHZ_LOW);
+    }
+    TEST_ASSERT_EQUAL_STRING("timing", cpuDemandName(CPU_DEMAND_TIMING));
+}
+
+void test_boot_at_full_clock_then_lowers_after_hold(void) {
+    TEST_ASSERT_EQUAL(CPU_DEMAND_TIMING, governor.level());
+    TEST_ASSERT_FALSE(governor.update(CPU_DEMAND_IDLE, 0));
+    TEST_ASSERT_FALSE(governor.update(CPU_DEMAND_IDLE, 2999 * MS_US));
+    TEST_ASSERT_TRUE(governor.update(CPU_DEMAND_IDLE, 3000 * MS_US));
+    TEST_ASSERT_EQUAL(CPU_DEMAND_IDLE, governor.level());
+    TEST_ASSERT_EQUAL_UINT16(CPU_MHZ_LOW, governor.policy().cpuMhz);
+}
+
+void test_raise_is_immediate(void) {
+    governor.update(CPU_DEMAND_IDLE, 0);
+    governor.update(CPU_DEMAND_IDLE, 3 * SECOND_US);
+    TEST_ASSERT_EQUAL(CPU_DEMAND_IDLE, governor.level());
+
+    TEST_ASSERT_TRUE(governor.update(CPU_DEMAND_TIMING, 3 * SECOND_US + 10 * MS_US));
+    TEST_ASSERT_EQUAL(CPU_DEMAND_TIMING, governor.level());
+    TEST_ASSERT_FALSE(governor.update(CPU_DEMAND_TIMING, 4 * SECOND_US));
+}
+
+void test_brief_dips_do_not_lower(void) {
+    // 需求在保持时间内回升，计时重新开始
+    governor.update(CPU_DEMAND_IDLE, 0);
+    governor.update(CPU_DEMAND_TIMING, 2 * SECOND_US);
+    governor.update(CPU_DEMAND_IDLE, 4 * SECOND_US);
+    TEST_ASSERT_EQUAL(CPU_DEMAND_TIMING, governor.level());
+    TEST_ASSERT_FALSE(governor.update(CPU_DEMAND_IDLE, 6 * SECOND_US));
+    TEST_ASSERT_TRUE(governor.update(CPU_DEMAND_IDLE, 7 * SECOND_US));
+}
+
+void test_lowers_to_highest_demand_seen_while_waiting(void) {
+    governor.update(CPU_DEMAND_IDLE, 0);
+    governor.update(CPU_DEMAND_ACTIVE, 1 * SECOND_US);
+    governor.update(CPU_DEMAND_IDLE, 2 * SECOND_US);
+    TEST_ASSERT_TRUE(governor.update(CPU_DEMAND_IDLE, 3 * SECOND_US));
+    TEST_ASSERT_EQUAL(CPU_DEMAND_ACTIVE, governor.level());
+
+    // 降到ACTIVE后再按ACTIVE的保持时间降到IDLE
+    TEST_ASSERT_FALSE(governor.update(CPU_DEMAND_IDLE, 4 * SECOND_US));
+    TEST_ASSERT_TRUE(governor.update(CPU_DEMAND_IDLE, 5 * SECOND_US));
+    TEST_ASSERT_EQUAL(CPU_DEMAND_IDLE, governor.level());
+}
+
+void test_training_session_does_not_thrash(void) {
+    // 菜单10秒，20个回合（计时2秒、间隔1.5秒），结束后回菜单；主循环10ms
+    uint64_t now = 0;
+    uint32_t changes = 0;
+    for (; now < 10 * SECOND_US; now += 10 * MS_US) {
+        if (governor.update(CPU_DEMAND_IDLE, now)) {
+            governor.recordSwitch(40);
+            changes++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, changes);
+
+    changes = 0;
+    for (uint32_t round = 0; round < 20; round++) {
+        for (uint64_t t = 0; t < 3500 * MS_US; t += 10 * MS_US, now += 10 * MS_US) {
+            CpuDemand demand = t < 2000 * MS_US ? CPU_DEMAND_TIMING : CPU_DEMAND_ACTIVE;
+            if (governor.update(demand, now)) {
+                governor.recordSwitch(40);
+                changes++;
+            }
+        }
+    }
+    // 只有第一次升到满频
+    TEST_ASSERT_EQUAL_UINT32(1, changes);
+
+    for (uint64_t end = now + 10 * SECOND_US; now < end; now += 10 * MS_US) {
+        if (governor.update(CPU_DEMAND_IDLE, now)) {
+            governor.recordSwitch(60);
+            changes++;
+        }
+    }
+    // 最后的回合间隔为ACTIVE：先降到ACTIVE，再降到IDLE
+    TEST_ASSERT_EQUAL_UINT32(3, changes);
+    TEST_ASSERT_EQUAL(CPU_DEMAND_IDLE, governor.level());
+    TEST_ASSERT_EQUAL_UINT32(4, governor.transitions());
+    TEST_ASSERT_EQUAL_UINT32(50, governor.switchAverageUs());
+    TEST_ASSERT_EQUAL_UINT32(60, governor.switchMaxUs());
+}
+
+void test_residency_covers_session(void) {
+    governor.update(CPU_DEMAND_IDLE, 0);
+    governor.update(CPU_DEMAND_IDLE, 3 * SECOND_US);
+    governor.update(CPU_DEMAND_IDLE, 10 * SECOND_US);
+    governor.update(CPU_DEMAND_TIMING, 12 * SECOND_US);
+    governor.update(CPU_DEMAND_TIMING, 15 * SECOND_US);
+
+    TEST_ASSERT_EQUAL_UINT64(15 * SECOND_US, governor.sessionUs());
+    TEST_ASSERT_EQUAL_UINT64(3 * SECOND_US + 3 * SECOND_US, governor.residencyUs(CPU_DEMAND_TIMING));
+    TEST_ASSERT_EQUAL_UINT64(9 * SECOND_US, governor.residencyUs(CPU_DEMAND_IDLE));
+    TEST_ASSERT_EQUAL_UINT64(0, governor.residencyUs(CPU_DEMAND_ACTIVE));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_policy_table);
+    RUN_TEST(test_boot_at_full_clock_then_lowers_after_hold);
+    RUN_TEST(test_raise_is_immediate);
+    RUN_TEST(test_brief_dips_do_not_lower);
+    RUN_TEST(test_lowers_to_highest_demand_seen_while_waiting);
+    RUN_TEST(test_training_session_does_not_thrash);
+    RUN_TEST(test_residency_covers_session);
+    return UNITY_END();
+}
@@ -0,0 +1,276 @@
+#include <unity.h>
+#include "duty_cycle.h"
+
+#define EPOCH_BASE_US   1760000000000000LL    // 主机墙钟起点
+#define SLAVE_OFFSET_US 987654321LL           // 锥桶本地时钟与主机本地时钟之差
+#define SLAVE_PPM       20                    // 锥桶晶振偏快
+#define SYNC_ERROR_US   300                   // 锥桶墙钟授时误差
+#define STEP_US         1000                  // 仿真步长，与主循环周期同量级
+#define MINUTE_US       60000000ULL
+
+static const uint32_t kIdleOnPermille = (DUTY_WINDOW_MS * 1000 + 2 * DUTY_GUARD_US) / DUTY_PERIOD_MS;
+
+static int64_t slaveLocal(uint64_t t) {
+    return SLAVE_OFFSET_US + (int64_t)t + (int64_t)(t / (1000000 / SLAVE_PPM));
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_schedule_pack_roundtrip(void) {
+    DutySchedule schedule = {1000, 20, false, true, true};
+    DutySchedule back = dutyUnpackSchedule(dutyPackSchedule(schedule));
+    TEST_ASSERT_EQUAL_UINT16(1000, back.periodMs);
+    TEST_ASSERT_EQUAL_UINT16(20, back.windowMs);
+    TEST_ASSERT_FALSE(back.alwaysOn);
+    TEST_ASSERT_TRUE(back.epochGrid);
+    TEST_ASSERT_TRUE(back.ackRequest);
+    TEST_ASSERT_EQUAL_UINT32(999999, dutyPhaseUs(-1, 1000));
+}
+
+void test_follower_aligns_on_wall_clock_despite_queued_beacon(void) {
+    DutyCycleFollower follower;
+    DutySchedule schedule = {1000, 20, false, true, false};
+    // 信标在主机队列中多等了5ms，墙钟对齐不受影响
+    int64_t local = 5000000;
+    int64_t epoch = EPOCH_BASE_US + 5000;
+    follower.onBeacon(dutyPackSchedule(schedule), local, epoch);
+    TEST_ASSERT_TRUE(follower.cycling());
+
+    int64_t windowStart = local - 5000;
+    TEST_ASSERT_TRUE(follower.listening(windowStart + 1000000 - DUTY_GUARD_US));
+    TEST_ASSERT_TRUE(follower.listening(windowStart + 1000000 + 21000));
+    TEST_ASSERT_FALSE(follower.listening(windowStart + 1000000 + 23000));
+    TEST_ASSERT_FALSE(follower.listening(windowStart + 1500000));
+    TEST_ASSERT_EQUAL_INT64(windowStart + 2000000 - DUTY_GUARD_US, follower.nextListenUs(windowStart + 1500000));
+}
+
+void test_follower_aligns_on_arrival_without_wall_clock(void) {
+    DutyCycleFollower follower;
+    DutySchedule schedule = {500, 10, false, true, false};
+    follower.onBeacon(dutyPackSchedule(schedule), 2000000, -1);
+    int64_t windowStart = 2000000 - DUTY_BEACON_LATENCY_US;
+    TEST_ASSERT_TRUE(follower.listening(windowStart + 500000 + 5000));
+    TEST_ASSERT_FALSE(follower.listening(windowStart + 500000 + 13000));
+}
+
+void test_follower_falls_back_after_missed_beacons(void) {
+    DutyCycleFollower follower;
+    DutySchedule schedule = {1000, 20, false, false, false};
+    follower.onBeacon(dutyPackSchedule(schedule), 1000000, -1);
+    TEST_ASSERT_TRUE(follower.takeAckDue());
+    TEST_ASSERT_FALSE(follower.takeAckDue());
+
+    follower.update(3100000);
+    TEST_ASSERT_TRUE(follower.cycling());
+    follower.update(4100000);
+    TEST_ASSERT_FALSE(follower.cycling());
+    TEST_ASSERT_TRUE(follower.listening(4500000));
+    TEST_ASSERT_EQUAL_UINT32(3, follower.missedBeacons());
+    // 回到常开需要告知主机，之后的信标恢复占空
+    TEST_ASSERT_TRUE(follower.takeAckDue());
+    follower.onBeacon(dutyPackSchedule(schedule), 6000000, -1);
+    TEST_ASSERT_TRUE(follower.cycling());
+}
+
+void test_follower_local_hold_keeps_radio_on(void) {
+    DutyCycleFollower follower;
+    DutySchedule schedule = {1000, 20, false, false, false};
+    follower.onBeacon(dutyPackSchedule(schedule), 1000000, -1);
+    follower.takeAckDue();
+    follower.setLocalHold(true);
+    TEST_ASSERT_TRUE(follower.listening(1500000));
+    TEST_ASSERT_TRUE(follower.takeAckDue());
+    // 本地常开期间主机不必发信标，不计错过
+    follower.update(10000000);
+    follower.setLocalHold(false);
+    follower.update(10100000);
+    TEST_ASSERT_TRUE(follower.cycling());
+}
+
+void test_leader_holds_traffic_and_measures_wake(void) {
+    DutyCycleLeader leader;
+    int64_t grid = EPOCH_BASE_US;
+    // 锥桶未确认占空前不保持
+    TEST_ASSERT_FALSE(leader.holdTraffic(grid + 500000));
+    TEST_ASSERT_TRUE(leader.beaconDue(grid));
+    TEST_ASSERT_FALSE(leader.beaconDue(grid + 1000));
+    uint32_t data = leader.beaconData(true);
+    TEST_ASSERT_TRUE((data & DUTY_FLAG_ACK_REQUEST) != 0);
+    TEST_ASSERT_FALSE((data & DUTY_FLAG_ALWAYS_ON) != 0);
+
+    leader.onAck(false, 2000);
+    TEST_ASSERT_TRUE(leader.holdTraffic(grid + 500000));
+    TEST_ASSERT_FALSE(leader.holdTraffic(grid + 1000000 + 5000));
+    TEST_ASSERT_FALSE(leader.beaconData(true) & DUTY_FLAG_ACK_REQUEST);
+
+    // 窗口外布防：下一窗口发常开信标，锥桶确认后解除保持
+    leader.setArmed(true, 400000);
+    TEST_ASSERT_FALSE(leader.beaconDue(grid + 400000));
+    TEST_ASSERT_TRUE(leader.beaconDue(grid + 1000000));
+    TEST_ASSERT_TRUE((leader.beaconData(true) & DUTY_FLAG_ALWAYS_ON) != 0);
+    leader.onAck(true, 1001500);
+    TEST_ASSERT_FALSE(leader.holdTraffic(grid + 1500000));
+    TEST_ASSERT_FALSE(leader.beaconDue(grid + 2000000));
+    TEST_ASSERT_EQUAL_UINT32(1, leader.latency().wakes);
+    TEST_ASSERT_EQUAL_UINT32(601500, leader.latency().maxUs);
+
+    // 窗口内布防时立即补发
+    leader.setArmed(false, 2000000);
+    TEST_ASSERT_TRUE(leader.beaconDue(grid + 2000000));
+    leader.onAck(false, 2001000);
+    leader.setArmed(true, 2005000);
+    TEST_ASSERT_TRUE(leader.beaconDue(grid + 2005000));
+}
+
+// ==================== 会话仿真 ====================
+
+struct Delivery {
+    bool active;
+    uint64_t atUs;
+    uint32_t data;
+    uint8_t kind;
+    uint64_t issuedUs;
+};
+
+enum { KIND_BEACON, KIND_COMMAND, KIND_ACK };
+
+struct SessionResult {
+    uint64_t steps;
+    uint64_t onSteps;
+    uint64_t armedSteps;
+    uint32_t commands;
+    uint32_t delivered;
+    uint32_t lost;
+    uint32_t maxCommandUs;
+};
+
+static bool queueDelivery(Delivery* queue, uint8_t kind, uint64_t atUs, uint32_t data, uint64_t issuedUs) {
+    for (int i = 0; i < 4; i++) {
+        if (!queue[i].active) {
+            queue[i] = {true, atUs, data, kind, issuedUs};
+            return true;
+        }
+    }
+    return false;
+}
+
+// 主机与一个锥桶的会话：每30分钟一轮训练（布防6分钟），空闲时每7分13秒主机下发一条命令
+static SessionResult runSession(DutyCycleLeader& leader, DutyCycleFollower& follower,
+                                uint64_t durationUs, bool wallClock) {
+    SessionResult result = {};
+    Delivery toSlave[4] = {};
+    Delivery toMaster[4] = {};
+    bool commandPending = false;
+    uint64_t commandIssuedUs = 0;
+
+    for (uint64_t t = 0; t < durationUs; t += STEP_US) {
+        int64_t grid = wallClock ? EPOCH_BASE_US + (int64_t)t : (int64_t)t;
+        int64_t local = slaveLocal(t);
+        int64_t slaveEpoch = wallClock ? EPOCH_BASE_US + (int64_t)t + SYNC_ERROR_US : -1;
+
+        bool armed = t % (30 * MINUTE_US) < 6 * MINUTE_US;
+        leader.setArmed(armed, t);
+        result.armedSteps += armed;
+
+        // 接收关闭时主机发出的帧丢失
+        for (int i = 0; i < 4; i++) {
+            Delivery& d = toSlave[i];
+            if (!d.active || d.atUs > t) {
+                continue;
+            }
+            d.active = false;
+            if (!follower.listening(local)) {
+                result.lost++;
+            } else if (d.kind == KIND_BEACON) {
+                follower.onBeacon(d.data, local, slaveEpoch);
+            } else {
+                result.delivered++;
+                uint32_t latency = (uint32_t)(t - d.issuedUs);
+                if (latency > result.maxCommandUs) {
+                    result.maxCommandUs = latency;
+                }
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            Delivery& d = toMaster[i];
+            if (d.active && d.atUs <= t) {
+                d.active = false;
+                leader.onAck(d.data == DUTY_ACK_ALWAYS_ON, t);
+            }
+        }
+
+        follower.update(local);
+        if (follower.takeAckDue()) {
+            queueDelivery(toMaster, KIND_ACK, t + STEP_US,
+                          follower.cycling() ? DUTY_ACK_CYCLING : DUTY_ACK_ALWAYS_ON, t);
+        }
+
+        if (leader.beaconDue(grid)) {
+            queueDelivery(toSlave, KIND_BEACON, t + STEP_US, leader.beaconData(wallClock), t);
+        }
+        if (!armed && t % (7 * MINUTE_US + 13000000) == 0) {
+            commandPending = true;
+            commandIssuedUs = t;
+            result.commands++;
+        }
+        if (commandPending && !leader.holdTraffic(grid)) {
+            commandPending = false;
+            queueDelivery(toSlave, KIND_COMMAND, t + STEP_US, 0, commandIssuedUs);
+        }
+
+        result.steps++;
+        result.onSteps += follower.listening(local);
+    }
+    return result;
+}
+
+static void checkSession(const SessionResult& result, const DutyCycleLeader& leader,
+                         const DutyCycleFollower& follower) {
+    // 预期接收占比 = 布防时间 + 空闲时间 × (窗口+两侧余量)/周期
+    uint32_t armedPermille = (uint32_t)(result.armedSteps * 1000 / result.steps);
+    uint32_t expected = armedPermille + (1000 - armedPermille) * kIdleOnPermille / 1000;
+    uint32_t measured = (uint32_t)(result.onSteps * 1000 / result.steps);
+    TEST_ASSERT_UINT32_WITHIN(3, expected, measured);
+
+    // 空闲时下发的命令全部送达，延迟不超过一个周期加窗口
+    TEST_ASSERT_GREATER_THAN(0, result.commands);
+    TEST_ASSERT_EQUAL_UINT32(result.commands, result.delivered);
+    TEST_ASSERT_EQUAL_UINT32(0, result.lost);
+    TEST_ASSERT_LESS_OR_EQUAL(leader.latencyBoundUs() + STEP_US, result.maxCommandUs);
+
+    // 每轮训练布防都在一个周期内得到锥桶确认
+    TEST_ASSERT_LESS_OR_EQUAL(leader.latencyBoundUs(), leader.latency().maxUs);
+    TEST_ASSERT_EQUAL_UINT32(0, follower.missedBeacons());
+}
+
+void test_eight_hour_session_radio_on_fraction(void) {
+    DutyCycleLeader leader;
+    DutyCycleFollower follower;
+    SessionResult result = runSession(leader, follower, 8 * 60 * MINUTE_US, true);
+    checkSession(result, leader, follower);
+    // 16轮训练，第一轮开始时锥桶尚未进入占空
+    TEST_ASSERT_EQUAL_UINT32(15, leader.latency().wakes);
+    // 布防20%，其余时间2.4%：总计约22%
+    TEST_ASSERT_UINT32_WITHIN(3, 219, (uint32_t)(result.onSteps * 1000 / result.steps));
+}
+
+void test_session_without_wall_clock_aligns_on_beacons(void) {
+    DutyCycleLeader leader;
+    DutyCycleFollower follower;
+    SessionResult result = runSession(leader, follower, 60 * MINUTE_US, false);
+    checkSession(result, leader, follower);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_schedule_pack_roundtrip);
+    RUN_TEST(test_follower_aligns_on_wall_clock_despite_queued_beacon);
+    RUN_TEST(test_follower_aligns_on_arrival_without_wall_clock);
+    RUN_TEST(test_follower_falls_back_after_missed_beacons);
+    RUN_TEST(test_follower_local_hold_keeps_radio_on);
+    RUN_TEST(test_leader_holds_traffic_and_measures_wake);
+    RUN_TEST(test_eight_hour_session_radio_on_fraction);
+    RUN_TEST(test_session_without_wall_clock_aligns_on_beacons);
+    return UNITY_END();
+}
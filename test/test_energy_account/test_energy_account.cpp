@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <string.h>
+#include "energy_account.h"
+
+#define SECOND_US 1000000ULL
+#define HOUR_US   (3600 * SECOND_US)
+
+static EnergyAccount account(EnergyAccount::defaultCoefficients());
+
+void setUp(void) {
+    account.setCoefficients(EnergyAccount::defaultCoefficients());
+    account.setCpuClock(0, true);
+    account.setRadio(0, false);
+    account.setLeds(0, 0, 0, 0);
+    account.setOled(0, false, 0);
+    account.begin(0);
+}
+
+void tearDown(void) {}
+
+void test_steady_rails_integrate_over_time(void) {
+    account.setRadio(0, true);
+    account.advance(HOUR_US);
+
+    // 1小时：监听60mA，CPU空闲14mA
+    TEST_ASSERT_EQUAL_UINT32(60000, account.microAmpHours(ENERGY_RADIO_RX));
+    TEST_ASSERT_EQUAL_UINT32(14000, account.microAmpHours(ENERGY_CPU));
+    TEST_ASSERT_EQUAL_UINT32(74000, account.totalMicroAmpHours());
+    TEST_ASSERT_EQUAL_UINT32(74000, account.averageMicroAmps());
+    TEST_ASSERT_EQUAL_UINT64(HOUR_US, account.sessionUs());
+}
+
+void test_cpu_busy_time_split(void) {
+    // 每秒忙250ms
+    for (uint32_t s = 1; s <= 3600; s++) {
+        account.addCpuBusy(250000);
+        account.advance(s * SECOND_US);
+    }
+    TEST_ASSERT_EQUAL_UINT16(250, account.cpuActivePermille());
+    // 0.25×24mA + 0.75×14mA = 16.5mA
+    TEST_ASSERT_EQUAL_UINT32(16500, account.microAmpHours(ENERGY_CPU));
+}
+
+void test_led_state_change_closes_previous_interval(void) {
+    // 12颗全白满亮度30分钟，再熄灭30分钟
+    account.setLeds(0, 12, 12 * 765, 255);
+    TEST_ASSERT_EQUAL_UINT32(732000, account.steadyMicroAmps(ENERGY_LEDS));
+    account.setLeds(HOUR_US / 2, 12, 0, 255);
+    account.advance(HOUR_US);
+    TEST_ASSERT_EQUAL_UINT32(366000 + 6000, account.microAmpHours(ENERGY_LEDS));
+
+    // 亮度减半电流约减半
+    account.setLeds(HOUR_US, 12, 12 * 765, 128);
+    TEST_ASSERT_EQUAL_UINT32(12000 + 720000 * 128 / 255, account.steadyMicroAmps(ENERGY_LEDS));
+}
+
+void test_oled_scales_with_coverage(void) {
+    account.setOled(0, true, 500);
+    TEST_ASSERT_EQUAL_UINT32(2500 + 9000, account.steadyMicroAmps(ENERGY_OLED));
+    account.setOled(0, false, 500);
+    TEST_ASSERT_EQUAL_UINT32(0, account.steadyMicroAmps(ENERGY_OLED));
+}
+
+void test_events_tx_and_buzzer(void) {
+    // 1000帧共40000字节：400ms + 320ms空口，发射增量220mA
+    account.addTx(1000, 40000);
+    TEST_ASSERT_EQUAL_UINT32(44, account.microAmpHours(ENERGY_RADIO_TX));
+    account.addBuzzer(3600000);
+    TEST_ASSERT_EQUAL_UINT32(30000, account.microAmpHours(ENERGY_BUZZER));
+}
+
+void test_projected_runtime(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, account.projectedMinutes(1000));
+    account.setRadio(0, true);
+    account.advance(HOUR_US);
+    // 740mAh / 74mA = 10小时
+    TEST_ASSERT_EQUAL_UINT32(600, account.projectedMinutes(740));
+}
+
+void test_coefficients_by_name(void) {
+    TEST_ASSERT_TRUE(account.setCoefficient("radio_listen", 30000));
+    TEST_ASSERT_FALSE(account.setCoefficient("radio", 1));
+    bool found = false;
+    for (uint8_t i = 0; i < EnergyAccount::coefficientCount(); i++) {
+        if (strcmp(EnergyAccount::coefficientName(i), "radio_listen") == 0) {
+            TEST_ASSERT_EQUAL_UINT32(30000, account.coefficient(i));
+            found = true;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+
+    account.setRadio(0, true);
+    account.advance(HOUR_US);
+    TEST_ASSERT_EQUAL_UINT32(30000, account.microAmpHours(ENERGY_RADIO_RX));
+
+    // 新会话清零累计值，持续状态保留
+    account.begin(HOUR_US);
+    account.advance(2 * HOUR_US);
+    TEST_ASSERT_EQUAL_UINT32(30000, account.microAmpHours(ENERGY_RADIO_RX));
+    TEST_ASSERT_EQUAL_UINT64(HOUR_US, account.sessionUs());
+}
+
+void test_low_clock_uses_low_coefficients(void) {
+    // 满频半小时，降频半小时，每秒都忙250ms
+    for (uint32_t s = 1; s <= 3600; s++) {
+        if (s == 1801) {
+            account.setCpuClock((s - 1) * SECOND_US, false);
+        }
+        account.addCpuBusy(250000);
+        account.advance(s * SECOND_US);
+    }
+    TEST_ASSERT_EQUAL_UINT32(11000, account.steadyMicroAmps(ENERGY_CPU));
+    // 0.5×16.5mA + 0.5×(0.25×17mA + 0.75×11mA)
+    TEST_ASSERT_EQUAL_UINT32(8250 + 6250, account.microAmpHours(ENERGY_CPU));
+    account.setCpuClock(HOUR_US, true);
+    TEST_ASSERT_EQUAL_UINT32(14000, account.steadyMicroAmps(ENERGY_CPU));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_rails_integrate_over_time);
+    RUN_TEST(test_cpu_busy_time_split);
+    RUN_TEST(test_led_state_change_closes_previous_interval);
+    RUN_TEST(test_oled_scales_with_coverage);
+    RUN_TEST(test_events_tx_and_buzzer);
+    RUN_TEST(test_projected_runtime);
+    RUN_TEST(test_coefficients_by_name);
+    RUN_TEST(test_low_clock_uses_low_coefficients);
+    return UNITY_END();
+}
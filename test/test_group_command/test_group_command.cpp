@@ -0,0 +1,155 @@
+#include <unity.h>
+#include <string.h>
+#include "group_command.h"
+
+#define CMD_GROUP 0x40
+#define CONES 8
+
+static GroupTarget targets[GROUP_MAX_CONES];
+static uint8_t frame[GROUP_FRAME_MAX_BYTES];
+
+static uint8_t buildFrame(uint16_t sequence, uint16_t mask, uint8_t mode, int64_t goEpochUs) {
+    GroupCommandHeader header = {CMD_GROUP, mode, sequence, mask, 0, goEpochUs};
+    return groupEncode(header, targets, frame);
+}
+
+void setUp(void) {
+    for (uint8_t cone = 0; cone < GROUP_MAX_CONES; cone++) {
+        targets[cone] = {cone, (uint8_t)(cone * 10), 0xFF, GROUP_EFFECT_SOLID,
+                         (uint8_t)(GROUP_FLAG_LIGHT | GROUP_FLAG_ARM)};
+    }
+}
+
+void tearDown(void) {}
+
+void test_sparse_mask_round_trip(void) {
+    // 只寻址1、4、9号锥桶：帧中只有三组参数
+    uint8_t length = buildFrame(7, 0x0212, GROUP_APPLY_NOW, 0);
+    TEST_ASSERT_EQUAL_UINT8(sizeof(GroupCommandHeader) + 3 * sizeof(GroupTarget), length);
+
+    GroupCommandHeader header;
+    GroupTarget target;
+    const uint8_t addressed[3] = {1, 4, 9};
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(groupDecode(frame, length, addressed[i], header, target));
+        TEST_ASSERT_EQUAL_UINT8(addressed[i], target.red);
+        TEST_ASSERT_EQUAL_UINT8(addressed[i] * 10, target.green);
+        TEST_ASSERT_EQUAL_UINT16(7, header.sequence);
+    }
+    TEST_ASSERT_FALSE(groupDecode(frame, length, 0, header, target));
+    TEST_ASSERT_FALSE(groupDecode(frame, length, 5, header, target));
+    // 长度与位图不符的帧丢弃
+    TEST_ASSERT_FALSE(groupDecode(frame, length - 1, 1, header, target));
+}
+
+void test_duplicate_broadcast_ignored(void) {
+    GroupCommandReceiver receiver(2);
+    uint8_t length = buildFrame(3, 0x0004, GROUP_APPLY_NOW, 0);
+    TEST_ASSERT_EQUAL_INT(GROUP_RX_IMMEDIATE, receiver.receive(frame, length, 1000, 0, true));
+    TEST_ASSERT_EQUAL_INT(GROUP_RX_DUPLICATE, receiver.receive(frame, length, 1500, 0, true));
+
+    GroupAction action;
+    TEST_ASSERT_TRUE(receiver.take(1500, action));
+    TEST_ASSERT_EQUAL_UINT64(1000, action.applyAtUs);
+    TEST_ASSERT_FALSE(action.scheduled);
+    TEST_ASSERT_FALSE(receiver.take(2000, action));
+}
+
+void test_scheduled_go_converted_to_local_clock(void) {
+    GroupCommandReceiver receiver(1);
+    const int64_t goEpochUs = 1700000000000000LL;
+    const int64_t offsetUs = 1699999990000000LL;   // 本地时钟比墙钟晚这么多
+    uint8_t length = buildFrame(1, 0x0002, GROUP_APPLY_AT, goEpochUs);
+
+    TEST_ASSERT_EQUAL_INT(GROUP_RX_SCHEDULED, receiver.receive(frame, length, 9950000, offsetUs, true));
+    TEST_ASSERT_TRUE(receiver.pending());
+    TEST_ASSERT_EQUAL_UINT64(10000000, receiver.dueAtUs());
+
+    GroupAction action;
+    TEST_ASSERT_FALSE(receiver.take(9999999, action));
+    TEST_ASSERT_TRUE(receiver.take(10000000, action));
+    TEST_ASSERT_TRUE(action.scheduled);
+}
+
+void test_late_or_unsynced_applies_immediately(void) {
+    GroupCommandReceiver late(1);
+    uint8_t length = buildFrame(1, 0x0002, GROUP_APPLY_AT, 5000000);
+    TEST_ASSERT_EQUAL_INT(GROUP_RX_LATE, late.receive(frame, length, 6000000, 0, true));
+    GroupAction action;
+    TEST_ASSERT_TRUE(late.take(6000000, action));
+
+    GroupCommandReceiver unsynced(1);
+    TEST_ASSERT_EQUAL_INT(GROUP_RX_IMMEDIATE, unsynced.receive(frame, length, 100, 0, false));
+    TEST_ASSERT_TRUE(unsynced.take(100, action));
+}
+
+void test_many_cones_apply_in_same_millisecond(void) {
+    // 8个锥桶：本地时钟起点各不相同（授时残差±300us），广播到达时刻依次相差约1ms，
+    // 主循环10ms一次；执行时刻按墙钟换算后锥桶间的时差在1ms内
+    const int64_t goEpochUs = 1700000000100000LL;
+    const int32_t syncErrorUs[CONES] = {0, 120, -80, 300, -300, 45, -150, 210};
+    uint8_t length = buildFrame(42, (1u << CONES) - 1, GROUP_APPLY_AT, goEpochUs);
+
+    GroupSkewTracker tracker;
+    tracker.begin(42, (1u << CONES) - 1);
+    int64_t appliedEpoch[CONES];
+    for (uint8_t cone = 0; cone < CONES; cone++) {
+        GroupCommandReceiver receiver(cone);
+        int64_t trueOffset = 1700000000000000LL - cone * 7000000LL;      // 墙钟 - 本地时钟
+        int64_t believedOffset = trueOffset + syncErrorUs[cone];
+        uint64_t arriveUs = (uint64_t)(goEpochUs - GROUP_GO_LEAD_US - trueOffset) + 2000 + cone * 1000;
+        TEST_ASSERT_EQUAL_INT(GROUP_RX_SCHEDULED, receiver.receive(frame, length, arriveUs, believedOffset, true));
+
+        // 主循环按10ms推进，接近时刻后忙等（每次1us）
+        uint64_t now = arriveUs;
+        while (receiver.dueAtUs() - now >= GROUP_SPIN_US) {
+            now += 10000;
+        }
+        GroupAction action;
+        while (!receiver.take(now, action)) {
+            now += 1;
+        }
+        tracker.record(42, cone, (int32_t)(now - action.applyAtUs));
+        appliedEpoch[cone] = (int64_t)now + trueOffset;
+    }
+
+    int64_t earliest = appliedEpoch[0], latest = appliedEpoch[0];
+    for (uint8_t cone = 1; cone < CONES; cone++) {
+        if (appliedEpoch[cone] < earliest) earliest = appliedEpoch[cone];
+        if (appliedEpoch[cone] > latest) latest = appliedEpoch[cone];
+    }
+    // 真实时差由授时残差决定，调度本身的偏差在微秒级
+    TEST_ASSERT_TRUE(tracker.complete());
+    TEST_ASSERT_LESS_OR_EQUAL(1, tracker.skewUs());
+    TEST_ASSERT_LESS_THAN(1000, latest - earliest);
+    TEST_ASSERT_EQUAL_INT64(600, latest - earliest);
+}
+
+void test_skew_tracker_and_report_packing(void) {
+    GroupSkewTracker tracker;
+    tracker.begin(9, 0x0007);
+    TEST_ASSERT_FALSE(tracker.record(8, 0, 10));       // 旧命令的回报
+    TEST_ASSERT_FALSE(tracker.record(9, 5, 10));       // 未寻址的锥桶
+    TEST_ASSERT_TRUE(tracker.record(9, 0, 40));
+    TEST_ASSERT_TRUE(tracker.record(9, 2, -25));
+    TEST_ASSERT_FALSE(tracker.complete());
+    TEST_ASSERT_TRUE(tracker.record(9, 1, 310));
+    TEST_ASSERT_TRUE(tracker.complete());
+    TEST_ASSERT_EQUAL_INT32(335, tracker.skewUs());
+
+    uint32_t packed = groupPackReport(0xBEEF, -1234);
+    TEST_ASSERT_EQUAL_UINT16(0xBEEF, groupReportSequence(packed));
+    TEST_ASSERT_EQUAL_INT32(-1234, groupReportLateness(packed));
+    TEST_ASSERT_EQUAL_INT32(32767, groupReportLateness(groupPackReport(1, 100000)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sparse_mask_round_trip);
+    RUN_TEST(test_duplicate_broadcast_ignored);
+    RUN_TEST(test_scheduled_go_converted_to_local_clock);
+    RUN_TEST(test_late_or_unsynced_applies_immediately);
+    RUN_TEST(test_many_cones_apply_in_same_millisecond);
+    RUN_TEST(test_skew_tracker_and_report_packing);
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+#include <unity.h>
+#include "hal_host.h"
+
+typedef HostLedStrip<12> TestLeds;
+typedef HostTriggerInput<200> TestSensor;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_led_set_ignores_out_of_range(void) {
+    TestLeds leds;
+    leds.set(-1, 0xFF0000);
+    leds.set(12, 0xFF0000);
+    leds.set(11, 0x00FF00);
+    for (int i = 0; i < 11; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, leds.pixel(i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0x00FF00, leds.pixel(11));
+    // 未刷新前不输出
+    TEST_ASSERT_EQUAL_UINT32(0, leds.showCount);
+    TEST_ASSERT_EQUAL_UINT32(0, leds.pixels[11]);
+    TEST_ASSERT_EQUAL_UINT32(0, leds.shown[11]);
+    // 默认输出级（亮度255、无伽马、不限流）原样输出
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT32(0x00FF00, leds.shown[11]);
+    TEST_ASSERT_FALSE(leds.wasLimited());
+}
+
+void test_led_progress_clamps_and_shows(void) {
+    TestLeds leds;
+    leds.fill(0x0000FF);
+    leds.progress(50, 0x00FF00);
+    TEST_ASSERT_EQUAL_UINT32(1, leds.showCount);
+    for (int i = 0; i < 12; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i < 6 ? 0x00FF00 : 0, leds.shown[i]);
+    }
+
+    leds.progress(150, 0xFF0000);
+    TEST_ASSERT_EQUAL_UINT32(0xFF0000, leds.shown[11]);
+    leds.progress(-5, 0xFF0000);
+    TEST_ASSERT_EQUAL_UINT32(0, leds.shown[0]);
+}
+
+void test_led_breathe_steps_and_scales(void) {
+    TestLeds leds;
+    TEST_ASSERT_EQUAL_UINT32(0x803F00, TestLeds::scale(0xFF7F00, 128));
+
+    TEST_ASSERT_TRUE(leds.breathe(0xFFFFFF, 50000));
+    TEST_ASSERT_EQUAL_UINT32(0x050505, leds.shown[0]);
+    // 50ms内不再刷新
+    TEST_ASSERT_FALSE(leds.breathe(0xFFFFFF, 99999));
+
+    // 升到255后反向
+    uint64_t now = 50000;
+    for (int i = 1; i < 51; i++) {
+        now += 50000;
+        leds.breathe(0xFFFFFF, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFF, leds.shown[0]);
+    leds.breathe(0xFFFFFF, now + 50000);
+    TEST_ASSERT_EQUAL_UINT32(0xFAFAFA, leds.shown[0]);
+}
+
+void test_led_draw_current_estimate(void) {
+    TestLeds leds;
+    TEST_ASSERT_EQUAL_UINT16(12 * LED_IDLE_MA, leds.drawMilliamps());
+    leds.fill(0xFFFFFF);
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT16(12 * LED_IDLE_MA + 12 * 3 * LED_CHANNEL_FULL_MA, leds.drawMilliamps());
+    // 亮度减半电流约减半，逻辑颜色不变
+    leds.setBrightness(128);
+    TEST_ASSERT_EQUAL_UINT8(128, leds.brightnessLevel());
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT32(0x808080, leds.shown[0]);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFF, leds.pixel(0));
+    TEST_ASSERT_EQUAL_UINT16(12 + 361, leds.drawMilliamps());
+    leds.progress(50, 0xFF0000);
+    TEST_ASSERT_EQUAL_UINT16(12 + 6 * LED_CHANNEL_FULL_MA * 128 / 255, leds.drawMilliamps());
+}
+
+void test_led_gamma_applied_before_brightness(void) {
+    TestLeds leds;
+    leds.setGamma(true);
+    leds.fill(0x80FF00);
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT32(((uint32_t)kLedGamma[0x80] << 16) | 0xFF00, leds.shown[0]);
+
+    // 先伽马后亮度：255经伽马仍为255，再按亮度缩放
+    leds.setBrightness(128);
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT32(((uint32_t)(kLedGamma[0x80] * 128 / 255) << 16) | 0x8000, leds.shown[0]);
+    TEST_ASSERT_EQUAL_UINT32(0x80FF00, leds.pixel(0));
+}
+
+void test_led_current_budget_limits_whole_frame(void) {
+    TestLeds leds;
+    leds.setCurrentBudget(300);
+    leds.fill(0xFFFFFF);
+    leds.show();
+    // 全白满亮度约732mA，整帧等比例压暗到预算以内
+    TEST_ASSERT_TRUE(leds.wasLimited());
+    TEST_ASSERT_LESS_OR_EQUAL(300, leds.drawMilliamps());
+    TEST_ASSERT_GREATER_THAN(290, leds.drawMilliamps());
+    TEST_ASSERT_EQUAL_UINT32(0x656565, leds.shown[0]);
+    TEST_ASSERT_EQUAL_UINT32(leds.shown[0], leds.shown[11]);
+
+    // 需求在预算以内时不受影响
+    leds.progress(25, 0x0000FF);
+    TEST_ASSERT_FALSE(leds.wasLimited());
+    TEST_ASSERT_EQUAL_UINT32(0x0000FF, leds.shown[0]);
+    TEST_ASSERT_EQUAL_UINT16(12 + 3 * LED_CHANNEL_FULL_MA, leds.drawMilliamps());
+
+    // 预算低于静态电流时全部熄灭
+    leds.setCurrentBudget(5);
+    leds.show();
+    TEST_ASSERT_EQUAL_UINT32(0, leds.outputChannelTotal());
+}
+
+void test_buzzer_plays_tune_with_gaps(void) {
+    HostBuzzer buzzer;
+    buzzer.play(TUNE_CONNECTED);
+    TEST_ASSERT_EQUAL_UINT8(3, buzzer.toneCount);
+    TEST_ASSERT_EQUAL_UINT16(800, buzzer.tones[0].frequency);
+    TEST_ASSERT_EQUAL_UINT32(0, buzzer.tones[0].atMs);
+    TEST_ASSERT_EQUAL_UINT32(150, buzzer.tones[1].atMs);
+    TEST_ASSERT_EQUAL_UINT16(1200, buzzer.tones[2].frequency);
+    TEST_ASSERT_EQUAL_UINT32(300, buzzer.tones[2].atMs);
+    // 最后一个音符之后不等待
+    TEST_ASSERT_EQUAL_UINT32(300, buzzer.elapsedMs);
+
+    buzzer.play(TUNE_START);
+    TEST_ASSERT_EQUAL_UINT8(4, buzzer.toneCount);
+    TEST_ASSERT_EQUAL_UINT32(300, buzzer.elapsedMs);
+}
+
+void test_trigger_falling_edge_with_debounce(void) {
+    TestSensor sensor;
+    // 静止高电平不触发
+    TEST_ASSERT_FALSE(sensor.poll(0));
+
+    sensor.input = false;
+    TEST_ASSERT_TRUE(sensor.poll(1000));
+    // 保持低电平不重复触发
+    TEST_ASSERT_FALSE(sensor.poll(2000));
+
+    // 防抖窗口内的第二个下降沿被拒绝
+    sensor.input = true;
+    sensor.poll(50000);
+    sensor.input = false;
+    TEST_ASSERT_FALSE(sensor.poll(150000));
+    TEST_ASSERT_EQUAL_UINT32(1, sensor.rejectedEdges());
+
+    sensor.input = true;
+    sensor.poll(190000);
+    sensor.input = false;
+    TEST_ASSERT_TRUE(sensor.poll(201001));
+    TEST_ASSERT_EQUAL_UINT64(201001, sensor.lastTriggerMicros());
+}
+
+void test_display_policy(void) {
+    HostDisplay<128, 64> display;
+    TEST_ASSERT_TRUE(display.begin());
+    display.flush();
+    display.setPower(false);
+    TEST_ASSERT_FALSE(display.powered);
+    TEST_ASSERT_EQUAL_UINT32(1, display.frames);
+    TEST_ASSERT_EQUAL_INT(44, (HostDisplay<128, 64>::centerX(40)));
+    TEST_ASSERT_EQUAL_INT(0, (HostDisplay<128, 64>::centerX(200)));
+}
+
+void test_display_skips_unchanged_frames(void) {
+    HostDisplay<128, 64> display;
+    display.begin();
+    display.buffer[0] = 0x01;
+    display.flush();
+    // 重绘相同内容不再发送
+    display.clear();
+    display.buffer[0] = 0x01;
+    display.flush();
+    TEST_ASSERT_EQUAL_UINT32(1, display.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, display.skippedFrames());
+    display.buffer[1] = 0x80;
+    display.flush();
+    TEST_ASSERT_EQUAL_UINT32(2, display.frames);
+}
+
+void test_display_idle_dim_off_and_wake(void) {
+    HostDisplay<128, 64> display;
+    display.begin();
+    display.setIdleTimeouts({20000, 60000});
+    display.wake(0);
+    display.service(0);
+    TEST_ASSERT_EQUAL(DISPLAY_ACTIVE, display.powerState());
+
+    TEST_ASSERT_FALSE(display.service(19999000));
+    TEST_ASSERT_TRUE(display.service(20000000));
+    TEST_ASSERT_EQUAL(DISPLAY_DIM, display.powerState());
+    TEST_ASSERT_EQUAL_UINT8(DISPLAY_CONTRAST_DIM, display.contrastSet);
+    TEST_ASSERT_TRUE(display.powered);
+
+    TEST_ASSERT_TRUE(display.service(60000000));
+    TEST_ASSERT_EQUAL(DISPLAY_OFF, display.powerState());
+    TEST_ASSERT_FALSE(display.powered);
+    TEST_ASSERT_FALSE(display.isOn());
+
+    // 关闭期间的刷新不发送，唤醒时从帧缓冲补发一次
+    display.buffer[0] = 0xFF;
+    display.flush();
+    display.flush();
+    TEST_ASSERT_EQUAL_UINT32(0, display.frames);
+
+    // 唤醒只记录活动，面板在service()时才打开
+    display.wake(61000000);
+    TEST_ASSERT_FALSE(display.powered);
+    TEST_ASSERT_TRUE(display.service(61000000));
+    TEST_ASSERT_TRUE(display.powered);
+    TEST_ASSERT_EQUAL_UINT8(DISPLAY_CONTRAST_FULL, display.contrastSet);
+    TEST_ASSERT_EQUAL_UINT32(1, display.frames);
+
+    // 内容未变时唤醒不重发
+    display.service(141000000);
+    TEST_ASSERT_EQUAL(DISPLAY_OFF, display.powerState());
+    display.wake(142000000);
+    display.service(142000000);
+    TEST_ASSERT_EQUAL_UINT32(1, display.frames);
+}
+
+void test_display_timeouts_never_brighten(void) {
+    HostDisplay<128, 64> display;
+    display.setIdleTimeouts({1000, 0});
+    display.service(2000000);
+    TEST_ASSERT_EQUAL(DISPLAY_DIM, display.powerState());
+    // 换成更长的超时（进入另一状态）不会自行恢复点亮，0表示不关闭
+    display.setIdleTimeouts({30000, 0});
+    TEST_ASSERT_FALSE(display.service(3600000000ULL));
+    TEST_ASSERT_EQUAL(DISPLAY_DIM, display.powerState());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_led_set_ignores_out_of_range);
+    RUN_TEST(test_led_progress_clamps_and_shows);
+    RUN_TEST(test_led_breathe_steps_and_scales);
+    RUN_TEST(test_led_draw_current_estimate);
+    RUN_TEST(test_led_gamma_applied_before_brightness);
+    RUN_TEST(test_led_current_budget_limits_whole_frame);
+    RUN_TEST(test_buzzer_plays_tune_with_gaps);
+    RUN_TEST(test_trigger_falling_edge_with_debounce);
+    RUN_TEST(test_display_policy);
+    RUN_TEST(test_display_skips_unchanged_frames);
+    RUN_TEST(test_display_idle_dim_off_and_wake);
+    RUN_TEST(test_display_timeouts_never_brighten);
+    return UNITY_END();
+}
@@ -0,0 +1,412 @@
+#ifndef IMPACT_FIXTURES_H
+#define IMPACT_FIXTURES_H
+
+#include <stdint.h>
+
+// 冲击传感器波形样本：8kHz、12位ADC原始值，直流约1.8k
+//   敲击为1.2kHz阻尼振荡（时间常数6ms），噪声为高斯白噪声，按固定种子生成，结果可复现
+
+#define FIXTURE_SAMPLE_RATE_HZ 8000
+#define FIXTURE_PERIOD_US      (1000000 / FIXTURE_SAMPLE_RATE_HZ)
+
+// 单次敲击：第600个采样起振，幅度700
+static const uint16_t kSingleHit[] = {
+    1856, 1857, 1851, 1847, 1845, 1851, 1846, 1844, 1852, 1852, 1854, 1847, 1851, 1851, 1844, 1855,
+    1854, 1864, 1853, 1852, 1859, 1854, 1857, 1851, 1854, 1858, 1857, 1854, 1848, 1856, 1854, 1857,
+    1855, 1859, 1854, 1855, 1858, 1849, 1853, 1852, 1865, 1855, 1858, 1858, 1854, 1848, 1860, 1854,
+    1859, 1849, 1854, 1862, 1863, 1850, 1850, 1856, 1860, 1858, 1858, 1852, 1860, 1863, 1855, 1850,
+    1854, 1862, 1849, 1858, 1853, 1858, 1857, 1859, 1866, 1861, 1865, 1858, 1857, 1861, 1845, 1859,
+    1860, 1853, 1862, 1857, 1848, 1859, 1855, 1858, 1860, 1867, 1861, 1860, 1863, 1852, 1867, 1856,
+    1863, 1856, 1856, 1859, 1871, 1865, 1859, 1860, 1856, 1862, 1859, 1866, 1856, 1861, 1858, 1859,
+    1866, 1863, 1866, 1869, 1869, 1856, 1866, 1855, 1863, 1873, 1863, 1862, 1865, 1864, 1864, 1860,
+    1870, 1869, 1863, 1866, 1868, 1870, 1867, 1868, 1864, 1860, 1863, 1870, 1870, 1866, 1862, 1867,
+    1874, 1872, 1862, 1865, 1859, 1860, 1867, 1866, 1871, 1872, 1870, 1873, 1864, 1861, 1869, 1880,
+    1868, 1861, 1868, 1874, 1862, 1871, 1864, 1873, 1871, 1869, 1877, 1865, 1864, 1877, 1863, 1879,
+    1867, 1863, 1868, 1868, 1869, 1867, 1873, 1856, 1865, 1867, 1877, 1858, 1867, 1863, 1865, 1872,
+    1871, 1876, 1866, 1870, 1875, 1873, 1867, 1874, 1864, 1878, 1870, 1868, 1870, 1873, 1878, 1868,
+    1867, 1872, 1865, 1861, 1873, 1867, 1875, 1864, 1855, 1871, 1870, 1877, 1872, 1871, 1872, 1868,
+    1870, 1863, 1872, 1866, 1867, 1873, 1874, 1865, 1880, 1867, 1874, 1875, 1871, 1871, 1879, 1874,
+    1872, 1861, 1866, 1876, 1871, 1865, 1867, 1868, 1873, 1872, 1875, 1866, 1875, 1867, 1869, 1879,
+    1870, 1869, 1869, 1868, 1878, 1877, 1874, 1871, 1875, 1870, 1872, 1872, 1870, 1878, 1879, 1877,
+    1860, 1879, 1873, 1868, 1870, 1876, 1876, 1874, 1870, 1870, 1874, 1869, 1865, 1867, 1869, 1871,
+    1881, 1863, 1872, 1869, 1871, 1876, 1876, 1869, 1867, 1863, 1869, 1876, 1868, 1873, 1873, 1871,
+    1875, 1869, 1865, 1863, 1874, 1867, 1867, 1873, 1865, 1878, 1872, 1866, 1865, 1874, 1863, 1865,
+    1869, 1869, 1868, 1870, 1866, 1868, 1875, 1871, 1866, 1877, 1858, 1868, 1871, 1873, 1868, 1866,
+    1871, 1867, 1870, 1853, 1869, 1863, 1872, 1871, 1871, 1865, 1869, 1865, 1868, 1866, 1862, 1877,
+    1870, 1856, 1871, 1859, 1865, 1863, 1864, 1867, 1864, 1859, 1866, 1868, 1875, 1864, 1860, 1864,
+    1869, 1861, 1862, 1868, 1865, 1866, 1862, 1861, 1863, 1864, 1863, 1867, 1867, 1867, 1867, 1860,
+    1859, 1868, 1864, 1864, 1858, 1863, 1860, 1859, 1860, 1856, 1864, 1869, 1860, 1863, 1857, 1866,
+    1872, 1856, 1861, 1870, 1864, 1863, 1852, 1861, 1867, 1869, 1865, 1859, 1858, 1852, 1856, 1867,
+    1861, 1854, 1868, 1852, 1867, 1859, 1862, 1864, 1862, 1867, 1860, 1858, 1857, 1853, 1856, 1864,
+    1864, 1866, 1873, 1863, 1861, 1852, 1858, 1870, 1861, 1858, 1860, 1849, 1854, 1851, 1847, 1862,
+    1862, 1857, 1859, 1852, 1859, 1861, 1865, 1865, 1859, 1856, 1852, 1853, 1859, 1859, 1856, 1864,
+    1859, 1856, 1855, 1856, 1851, 1850, 1857, 1852, 1854, 1861, 1854, 1861, 1854, 1862, 1856, 1845,
+    1860, 1853, 1844, 1854, 1854, 1847, 1850, 1856, 1860, 1859, 1859, 1858, 1840, 1849, 1853, 1839,
+    1856, 1856, 1848, 1850, 1847, 1851, 1851, 1851, 1846, 1853, 1849, 1855, 1852, 1843, 1843, 1850,
+    1848, 1852, 1854, 1850, 1841, 1843, 1852, 1844, 1855, 1848, 1851, 1844, 1848, 1834, 1847, 1851,
+    1844, 1844, 1848, 1848, 1844, 1851, 1839, 1853, 1840, 1843, 1853, 1842, 1838, 1847, 1842, 1841,
+    1843, 1842, 1841, 1841, 1854, 1842, 1850, 1838, 1848, 1839, 1843, 1848, 1842, 1835, 1842, 1844,
+    1847, 1839, 1842, 1844, 1835, 1843, 1839, 1846, 1843, 1842, 1831, 1842, 1841, 1838, 1840, 1836,
+    1843, 1846, 1845, 1839, 1850, 1846, 1837, 1841, 1833, 1841, 1845, 1847, 1839, 1832, 1840, 1847,
+    1841, 1847, 1844, 1848, 1843, 1837, 1842, 1853, 2232, 2516, 2260, 1656, 1230, 1316, 1814, 2322,
+    2408, 2031, 1516, 1280, 1511, 1988, 2338, 2257, 1849, 1446, 1374, 1679, 2103, 2295, 2102, 1722,
+    1438, 1502, 1825, 2149, 2216, 1968, 1623, 1470, 1618, 1937, 2153, 2109, 1846, 1581, 1529, 1723,
+    2014, 2132, 2009, 1763, 1578, 1614, 1832, 2046, 2077, 1920, 1697, 1596, 1693, 1895, 2046, 2017,
+    1840, 1661, 1625, 1759, 1949, 2030, 1954, 1771, 1658, 1689, 1819, 1966, 1988, 1895, 1742, 1671,
+    1739, 1876, 1979, 1960, 1842, 1723, 1705, 1792, 1913, 1953, 1912, 1798, 1719, 1733, 1829, 1925,
+    1941, 1870, 1766, 1721, 1766, 1852, 1922, 1908, 1826, 1749, 1742, 1799, 1892, 1921, 1879, 1806,
+    1751, 1763, 1827, 1891, 1899, 1860, 1795, 1772, 1783, 1853, 1891, 1876, 1831, 1774, 1773, 1825,
+    1870, 1896, 1870, 1808, 1783, 1789, 1831, 1865, 1867, 1857, 1810, 1786, 1801, 1844, 1865, 1870,
+    1832, 1798, 1790, 1817, 1852, 1865, 1857, 1821, 1797, 1798, 1835, 1863, 1864, 1831, 1811, 1805,
+    1812, 1845, 1855, 1857, 1833, 1797, 1803, 1820, 1841, 1850, 1853, 1823, 1812, 1805, 1819, 1845,
+    1852, 1833, 1821, 1814, 1816, 1835, 1844, 1850, 1839, 1819, 1811, 1821, 1838, 1851, 1836, 1833,
+    1810, 1818, 1836, 1850, 1841, 1839, 1835, 1823, 1811, 1835, 1854, 1834, 1835, 1811, 1827, 1822,
+    1841, 1846, 1823, 1820, 1823, 1815, 1830, 1833, 1846, 1831, 1821, 1825, 1832, 1832, 1840, 1840,
+    1829, 1819, 1826, 1827, 1828, 1842, 1837, 1830, 1821, 1825, 1834, 1839, 1833, 1829, 1830, 1827,
+    1832, 1827, 1841, 1845, 1837, 1828, 1832, 1824, 1832, 1847, 1827, 1825, 1832, 1825, 1829, 1827,
+    1841, 1829, 1831, 1823, 1836, 1833, 1835, 1841, 1834, 1827, 1828, 1833, 1840, 1827, 1832, 1833,
+    1837, 1829, 1835, 1837, 1833, 1833, 1837, 1837, 1840, 1829, 1840, 1833, 1829, 1832, 1828, 1833,
+    1840, 1823, 1829, 1839, 1833, 1839, 1828, 1835, 1822, 1831, 1839, 1842, 1844, 1835, 1831, 1834,
+    1826, 1843, 1842, 1832, 1845, 1830, 1839, 1832, 1828, 1839, 1831, 1843, 1832, 1838, 1835, 1838,
+    1834, 1842, 1841, 1838, 1837, 1848, 1834, 1836, 1842, 1838, 1830, 1838, 1837, 1834, 1840, 1833,
+    1838, 1833, 1847, 1838, 1842, 1841, 1843, 1839, 1843, 1840, 1828, 1842, 1834, 1845, 1841, 1839,
+    1828, 1830, 1835, 1839, 1834, 1851, 1844, 1841, 1837, 1840, 1840, 1840, 1842, 1846, 1833, 1843,
+    1848, 1836, 1842, 1841, 1837, 1848, 1841, 1849, 1845, 1842, 1845, 1842, 1836, 1851, 1846, 1850,
+    1835, 1850, 1849, 1844, 1834, 1845, 1842, 1844, 1845, 1841, 1845, 1846, 1853, 1845, 1858, 1840,
+    1845, 1852, 1838, 1850, 1849, 1844, 1846, 1855, 1845, 1849, 1849, 1853, 1837, 1840, 1841, 1847,
+    1851, 1852, 1847, 1856, 1848, 1852, 1845, 1853, 1845, 1855, 1854, 1859, 1847, 1844, 1854, 1851,
+};
+
+// 噪声由σ=5逐渐升至σ=30（约1200个采样），第1500个采样敲击，幅度450
+static const uint16_t kRisingNoise[] = {
+    1732, 1717, 1722, 1721, 1725, 1713, 1719, 1717, 1715, 1717, 1719, 1720, 1717, 1724, 1719, 1705,
+    1728, 1720, 1718, 1724, 1724, 1723, 1718, 1724, 1714, 1731, 1716, 1722, 1724, 1725, 1722, 1727,
+    1703, 1723, 1723, 1721, 1732, 1718, 1723, 1712, 1726, 1715, 1715, 1738, 1729, 1725, 1726, 1716,
+    1719, 1728, 1712, 1727, 1715, 1726, 1719, 1737, 1732, 1723, 1714, 1721, 1726, 1720, 1729, 1733,
+    1727, 1724, 1732, 1725, 1733, 1725, 1738, 1726, 1721, 1729, 1724, 1722, 1728, 1734, 1714, 1728,
+    1728, 1728, 1735, 1720, 1734, 1728, 1730, 1728, 1728, 1726, 1733, 1745, 1738, 1736, 1735, 1727,
+    1735, 1746, 1722, 1737, 1739, 1734, 1737, 1742, 1748, 1742, 1744, 1735, 1739, 1734, 1735, 1729,
+    1738, 1744, 1732, 1735, 1738, 1734, 1741, 1736, 1725, 1726, 1740, 1739, 1743, 1737, 1736, 1723,
+    1746, 1728, 1743, 1726, 1730, 1737, 1732, 1730, 1743, 1741, 1739, 1734, 1730, 1733, 1732, 1737,
+    1743, 1736, 1731, 1732, 1748, 1739, 1740, 1740, 1743, 1739, 1748, 1745, 1715, 1737, 1763, 1728,
+    1740, 1748, 1739, 1750, 1729, 1729, 1738, 1733, 1731, 1745, 1742, 1740, 1737, 1743, 1739, 1734,
+    1745, 1744, 1741, 1747, 1731, 1740, 1737, 1753, 1746, 1760, 1756, 1738, 1732, 1746, 1739, 1741,
+    1733, 1748, 1744, 1746, 1745, 1735, 1722, 1740, 1737, 1738, 1752, 1742, 1757, 1745, 1750, 1748,
+    1751, 1732, 1754, 1745, 1735, 1750, 1748, 1757, 1752, 1748, 1729, 1761, 1759, 1753, 1750, 1757,
+    1737, 1752, 1746, 1736, 1749, 1749, 1763, 1755, 1730, 1727, 1746, 1744, 1737, 1732, 1745, 1735,
+    1740, 1756, 1749, 1740, 1736, 1745, 1765, 1742, 1765, 1740, 1746, 1755, 1740, 1749, 1734, 1755,
+    1760, 1742, 1750, 1744, 1726, 1777, 1755, 1758, 1753, 1751, 1774, 1730, 1746, 1745, 1747, 1757,
+    1742, 1736, 1738, 1755, 1760, 1759, 1767, 1745, 1761, 1758, 1749, 1742, 1760, 1743, 1748, 1740,
+    1770, 1750, 1746, 1748, 1749, 1752, 1732, 1738, 1757, 1764, 1740, 1753, 1745, 1726, 1748, 1740,
+    1762, 1750, 1752, 1736, 1754, 1730, 1755, 1768, 1739, 1763, 1769, 1751, 1766, 1754, 1747, 1730,
+    1741, 1736, 1781, 1756, 1751, 1738, 1774, 1740, 1771, 1767, 1755, 1746, 1753, 1738, 1762, 1774,
+    1765, 1767, 1746, 1758, 1742, 1749, 1764, 1785, 1756, 1755, 1732, 1757, 1744, 1738, 1737, 1757,
+    1750, 1764, 1752, 1755, 1774, 1766, 1765, 1774, 1758, 1743, 1746, 1736, 1760, 1751, 1763, 1767,
+    1746, 1759, 1772, 1757, 1768, 1754, 1744, 1754, 1732, 1766, 1750, 1774, 1741, 1758, 1761, 1754,
+    1762, 1747, 1743, 1739, 1750, 1746, 1760, 1752, 1749, 1748, 1732, 1753, 1763, 1740, 1754, 1767,
+    1748, 1760, 1752, 1791, 1777, 1774, 1749, 1767, 1756, 1763, 1750, 1760, 1748, 1762, 1782, 1739,
+    1740, 1765, 1769, 1753, 1767, 1764, 1766, 1778, 1749, 1768, 1761, 1749, 1766, 1740, 1738, 1774,
+    1743, 1783, 1774, 1751, 1746, 1727, 1758, 1735, 1782, 1735, 1760, 1720, 1754, 1778, 1753, 1747,
+    1752, 1765, 1772, 1756, 1729, 1764, 1774, 1793, 1762, 1762, 1751, 1771, 1786, 1745, 1761, 1744,
+    1749, 1757, 1767, 1747, 1755, 1780, 1767, 1770, 1766, 1757, 1766, 1768, 1760, 1775, 1760, 1774,
+    1760, 1771, 1749, 1751, 1742, 1778, 1768, 1763, 1769, 1747, 1761, 1752, 1731, 1756, 1746, 1782,
+    1748, 1750, 1775, 1760, 1739, 1763, 1748, 1787, 1743, 1748, 1716, 1749, 1790, 1758, 1745, 1765,
+    1755, 1759, 1800, 1792, 1786, 1787, 1745, 1728, 1772, 1766, 1761, 1758, 1772, 1769, 1764, 1768,
+    1757, 1754, 1783, 1756, 1793, 1771, 1761, 1778, 1752, 1757, 1754, 1760, 1771, 1794, 1768, 1742,
+    1746, 1729, 1772, 1774, 1765, 1766, 1769, 1767, 1771, 1763, 1743, 1776, 1782, 1732, 1756, 1740,
+    1768, 1755, 1784, 1779, 1751, 1751, 1749, 1769, 1743, 1767, 1735, 1777, 1768, 1739, 1746, 1762,
+    1764, 1709, 1763, 1786, 1751, 1735, 1780, 1763, 1762, 1770, 1737, 1747, 1739, 1739, 1753, 1740,
+    1787, 1768, 1773, 1729, 1755, 1756, 1761, 1766, 1744, 1742, 1776, 1799, 1796, 1753, 1744, 1762,
+    1767, 1790, 1754, 1745, 1777, 1745, 1742, 1768, 1754, 1739, 1753, 1750, 1754, 1744, 1768, 1751,
+    1746, 1777, 1740, 1771, 1768, 1752, 1761, 1730, 1762, 1738, 1741, 1762, 1743, 1759, 1765, 1776,
+    1764, 1776, 1743, 1750, 1769, 1779, 1765, 1747, 1736, 1738, 1778, 1738, 1752, 1768, 1764, 1743,
+    1794, 1759, 1761, 1771, 1750, 1769, 1753, 1739, 1737, 1763, 1757, 1752, 1747, 1751, 1771, 1776,
+    1750, 1760, 1719, 1733, 1741, 1737, 1768, 1714, 1764, 1768, 1797, 1745, 1763, 1783, 1773, 1736,
+    1747, 1732, 1755, 1767, 1781, 1765, 1771, 1775, 1738, 1767, 1773, 1750, 1735, 1756, 1756, 1767,
+    1718, 1746, 1793, 1779, 1750, 1747, 1747, 1733, 1744, 1752, 1729, 1751, 1758, 1727, 1743, 1721,
+    1753, 1756, 1742, 1753, 1763, 1766, 1725, 1745, 1722, 1713, 1772, 1767, 1777, 1767, 1741, 1755,
+    1740, 1779, 1702, 1759, 1739, 1765, 1775, 1737, 1778, 1773, 1718, 1788, 1726, 1722, 1769, 1735,
+    1754, 1749, 1728, 1783, 1780, 1751, 1782, 1749, 1754, 1743, 1721, 1742, 1729, 1757, 1752, 1736,
+    1775, 1756, 1787, 1740, 1740, 1732, 1753, 1744, 1748, 1785, 1764, 1734, 1756, 1742, 1741, 1742,
+    1748, 1761, 1768, 1747, 1729, 1746, 1742, 1740, 1720, 1743, 1707, 1773, 1762, 1762, 1725, 1751,
+    1773, 1741, 1722, 1743, 1696, 1765, 1754, 1715, 1760, 1770, 1759, 1759, 1778, 1749, 1775, 1740,
+    1729, 1737, 1721, 1752, 1728, 1751, 1750, 1779, 1782, 1731, 1739, 1739, 1729, 1783, 1770, 1738,
+    1711, 1728, 1743, 1777, 1713, 1774, 1709, 1749, 1715, 1732, 1687, 1755, 1742, 1717, 1692, 1739,
+    1740, 1707, 1751, 1737, 1714, 1722, 1684, 1756, 1762, 1735, 1710, 1713, 1732, 1719, 1745, 1719,
+    1759, 1766, 1725, 1719, 1670, 1739, 1747, 1716, 1764, 1722, 1710, 1757, 1748, 1689, 1721, 1707,
+    1732, 1741, 1726, 1740, 1757, 1729, 1706, 1713, 1756, 1776, 1732, 1744, 1716, 1722, 1758, 1723,
+    1739, 1738, 1762, 1740, 1733, 1727, 1722, 1758, 1785, 1696, 1758, 1710, 1719, 1726, 1723, 1724,
+    1719, 1776, 1698, 1717, 1714, 1737, 1701, 1732, 1735, 1779, 1748, 1730, 1734, 1776, 1729, 1715,
+    1716, 1722, 1752, 1707, 1717, 1730, 1708, 1746, 1721, 1742, 1743, 1766, 1772, 1709, 1697, 1701,
+    1741, 1742, 1729, 1728, 1766, 1751, 1734, 1744, 1691, 1758, 1779, 1732, 1717, 1759, 1716, 1730,
+    1743, 1724, 1745, 1679, 1666, 1745, 1740, 1732, 1717, 1728, 1738, 1698, 1733, 1706, 1779, 1735,
+    1733, 1751, 1749, 1749, 1709, 1729, 1748, 1731, 1728, 1710, 1729, 1760, 1694, 1690, 1694, 1685,
+    1756, 1772, 1736, 1726, 1759, 1750, 1665, 1721, 1786, 1713, 1705, 1707, 1763, 1711, 1733, 1753,
+    1727, 1722, 1695, 1690, 1750, 1688, 1749, 1754, 1760, 1716, 1699, 1723, 1754, 1735, 1733, 1717,
+    1744, 1669, 1689, 1760, 1732, 1738, 1670, 1697, 1708, 1716, 1750, 1704, 1722, 1699, 1712, 1728,
+    1729, 1744, 1685, 1738, 1730, 1697, 1752, 1700, 1707, 1731, 1755, 1706, 1756, 1727, 1696, 1736,
+    1718, 1697, 1712, 1749, 1725, 1709, 1737, 1678, 1733, 1751, 1684, 1685, 1692, 1709, 1694, 1714,
+    1687, 1722, 1729, 1726, 1698, 1736, 1671, 1696, 1711, 1748, 1703, 1730, 1757, 1766, 1760, 1691,
+    1720, 1726, 1731, 1726, 1709, 1713, 1674, 1731, 1720, 1695, 1761, 1711, 1693, 1727, 1723, 1729,
+    1708, 1732, 1714, 1744, 1719, 1687, 1682, 1726, 1736, 1669, 1726, 1707, 1717, 1687, 1678, 1692,
+    1686, 1697, 1711, 1710, 1761, 1682, 1696, 1711, 1725, 1679, 1667, 1715, 1718, 1724, 1725, 1664,
+    1737, 1703, 1766, 1696, 1645, 1703, 1712, 1715, 1712, 1691, 1658, 1701, 1696, 1687, 1707, 1696,
+    1647, 1681, 1681, 1697, 1751, 1703, 1720, 1644, 1739, 1689, 1719, 1673, 1703, 1727, 1703, 1710,
+    1681, 1682, 1711, 1697, 1706, 1683, 1691, 1724, 1743, 1691, 1683, 1706, 1729, 1710, 1733, 1696,
+    1674, 1646, 1726, 1709, 1682, 1711, 1667, 1731, 1731, 1735, 1687, 1742, 1724, 1747, 1650, 1727,
+    1738, 1691, 1728, 1703, 1742, 1692, 1701, 1665, 1759, 1675, 1668, 1672, 1701, 1700, 1711, 1744,
+    1727, 1656, 1703, 1693, 1720, 1701, 1737, 1702, 1755, 1669, 1732, 1724, 1676, 1658, 1678, 1708,
+    1745, 1654, 1688, 1659, 1719, 1701, 1697, 1718, 1705, 1739, 1687, 1678, 1696, 1694, 1733, 1684,
+    1680, 1675, 1672, 1637, 1699, 1709, 1699, 1672, 1721, 1715, 1702, 1713, 1691, 1706, 1710, 1658,
+    1679, 1673, 1705, 1617, 1702, 1693, 1688, 1705, 1649, 1699, 1670, 1674, 1733, 1682, 1723, 1691,
+    1683, 1681, 1649, 1682, 1696, 1733, 1714, 1716, 1664, 1670, 1702, 1707, 1660, 1721, 1672, 1699,
+    1677, 1712, 1716, 1721, 1664, 1695, 1756, 1690, 1704, 1694, 1675, 1740, 1736, 1670, 1705, 1744,
+    1703, 1692, 1718, 1714, 1654, 1665, 1736, 1672, 1688, 1670, 1745, 1652, 1694, 1677, 1680, 1653,
+    1665, 1682, 1696, 1634, 1691, 1662, 1686, 1675, 1684, 1680, 1701, 1688, 1638, 1616, 1645, 1696,
+    1637, 1657, 1741, 1676, 1681, 1697, 1705, 1671, 1689, 1626, 1696, 1703, 1635, 1713, 1742, 1610,
+    1680, 1727, 1706, 1665, 1667, 1674, 1705, 1660, 1642, 1689, 1662, 1735, 1654, 1693, 1678, 1641,
+    1669, 1625, 1696, 1656, 1647, 1637, 1726, 1699, 1654, 1679, 1702, 1701, 1684, 1622, 1734, 1680,
+    1725, 1645, 1707, 1723, 1718, 1647, 1676, 1729, 1659, 1704, 1678, 1639, 1711, 1716, 1702, 1691,
+    1713, 1624, 1682, 1734, 1697, 1715, 1675, 1693, 1648, 1698, 1691, 1671, 1682, 1685, 1688, 1705,
+    1713, 1618, 1690, 1716, 1648, 1677, 1753, 1663, 1712, 1689, 1639, 1674, 1627, 1671, 1709, 1701,
+    1691, 1666, 1701, 1718, 1705, 1711, 1695, 1695, 1655, 1727, 1650, 1655, 1660, 1660, 1721, 1675,
+    1673, 1673, 1681, 1721, 1726, 1668, 1732, 1699, 1690, 1720, 1685, 1691, 1686, 1647, 1644, 1652,
+    1655, 1663, 1665, 1714, 1681, 1704, 1691, 1655, 1672, 1636, 1629, 1692, 1679, 1683, 1709, 1640,
+    1675, 1613, 1654, 1698, 1634, 1641, 1671, 1730, 1702, 1674, 1698, 1682, 1922, 2104, 1956, 1557,
+    1312, 1328, 1693, 1975, 2080, 1834, 1452, 1390, 1476, 1756, 1959, 1954, 1693, 1407, 1350, 1564,
+    1815, 1950, 1827, 1614, 1347, 1519, 1659, 1881, 1881, 1794, 1539, 1433, 1511, 1761, 1902, 1840,
+    1734, 1487, 1519, 1617, 1749, 1863, 1810, 1615, 1512, 1531, 1687, 1794, 1893, 1743, 1634, 1517,
+    1592, 1692, 1818, 1842, 1693, 1549, 1534, 1653, 1747, 1866, 1762, 1646, 1590, 1632, 1631, 1747,
+    1764, 1657, 1616, 1574, 1644, 1727, 1790, 1776, 1670, 1694, 1639, 1641, 1701, 1778, 1760, 1672,
+    1630, 1646, 1691, 1711, 1735, 1651, 1669, 1597, 1645, 1762, 1716, 1732, 1658, 1579, 1654, 1658,
+    1710, 1758, 1707, 1686, 1670, 1619, 1692, 1723, 1758, 1769, 1626, 1682, 1658, 1713, 1732, 1711,
+    1646, 1650, 1618, 1712, 1715, 1700, 1692, 1704, 1607, 1659, 1685, 1680, 1742, 1680, 1696, 1658,
+    1645, 1686, 1737, 1676, 1658, 1658, 1674, 1692, 1667, 1671, 1693, 1669, 1669, 1619, 1667, 1666,
+    1749, 1628, 1644, 1647, 1619, 1674, 1677, 1651, 1668, 1707, 1670, 1717, 1729, 1702, 1683, 1613,
+    1608, 1677, 1684, 1699, 1670, 1679, 1644, 1695, 1678, 1627, 1677, 1729, 1653, 1642, 1644, 1663,
+    1692, 1689, 1694, 1664, 1693, 1717, 1658, 1699, 1701, 1692, 1678, 1689, 1673, 1668, 1669, 1712,
+    1669, 1626, 1664, 1667, 1714, 1721, 1657, 1719, 1689, 1725, 1670, 1709, 1712, 1733, 1645, 1679,
+    1686, 1681, 1665, 1683, 1688, 1738, 1683, 1715, 1674, 1697, 1688, 1688, 1640, 1683, 1762, 1690,
+    1652, 1755, 1698, 1694, 1640, 1680, 1684, 1685, 1658, 1704, 1646, 1720, 1689, 1678, 1644, 1697,
+    1696, 1643, 1737, 1681, 1643, 1724, 1658, 1662, 1647, 1661, 1680, 1657, 1696, 1658, 1685, 1623,
+    1672, 1686, 1706, 1678, 1692, 1698, 1663, 1704, 1697, 1673, 1653, 1726, 1721, 1695, 1721, 1732,
+    1685, 1706, 1706, 1704, 1686, 1677, 1712, 1696, 1738, 1704, 1693, 1654, 1687, 1699, 1687, 1670,
+    1607, 1665, 1695, 1738, 1658, 1706, 1654, 1719, 1685, 1692, 1702, 1673, 1672, 1720, 1651, 1665,
+    1715, 1713, 1669, 1670, 1696, 1747, 1736, 1684, 1677, 1690, 1642, 1701, 1681, 1724, 1670, 1703,
+    1676, 1678, 1745, 1668, 1691, 1706, 1750, 1703, 1682, 1703, 1746, 1711, 1714, 1761, 1670, 1729,
+    1671, 1732, 1711, 1715, 1704, 1704, 1611, 1661, 1759, 1700, 1693, 1715, 1725, 1703, 1728, 1716,
+    1680, 1703, 1728, 1672, 1699, 1676, 1690, 1653, 1702, 1680, 1730, 1689, 1758, 1732, 1677, 1759,
+    1702, 1711, 1662, 1697, 1680, 1662, 1667, 1739, 1684, 1699, 1676, 1687, 1684, 1696, 1701, 1725,
+    1698, 1696, 1675, 1717, 1712, 1691, 1647, 1697, 1639, 1743, 1701, 1737, 1694, 1725, 1750, 1725,
+    1671, 1656, 1684, 1706, 1666, 1644, 1682, 1695, 1646, 1695, 1722, 1666, 1704, 1697, 1707, 1708,
+    1672, 1715, 1760, 1711, 1659, 1691, 1755, 1695, 1705, 1663, 1655, 1698, 1711, 1681, 1712, 1690,
+    1640, 1693, 1719, 1769, 1659, 1712, 1713, 1715, 1707, 1748, 1738, 1684, 1679, 1704, 1661, 1708,
+    1727, 1688, 1696, 1684, 1709, 1719, 1675, 1732, 1677, 1708, 1714, 1677, 1696, 1674, 1736, 1702,
+    1662, 1729, 1695, 1762, 1703, 1726, 1674, 1700, 1703, 1734, 1747, 1711, 1704, 1682, 1689, 1704,
+    1740, 1762, 1702, 1689, 1681, 1734, 1751, 1729, 1759, 1712, 1699, 1717, 1675, 1704, 1694, 1655,
+    1712, 1728, 1751, 1707, 1746, 1688, 1748, 1691, 1709, 1673, 1763, 1701, 1746, 1711, 1721, 1735,
+    1679, 1727, 1704, 1685, 1746, 1710, 1753, 1719, 1705, 1699, 1716, 1698, 1744, 1699, 1757, 1706,
+    1715, 1698, 1785, 1656, 1742, 1751, 1752, 1771, 1763, 1670, 1723, 1690, 1712, 1712, 1750, 1743,
+};
+
+// 第700个采样敲击，25ms后第900个采样反弹，第1700个采样再次敲击（幅度250，900Hz）
+static const uint16_t kBounceAndHit[] = {
+    1901, 1908, 1895, 1906, 1899, 1899, 1912, 1901, 1900, 1905, 1907, 1900, 1904, 1895, 1898, 1898,
+    1893, 1892, 1891, 1899, 1900, 1899, 1901, 1893, 1901, 1903, 1906, 1896, 1899, 1889, 1898, 1888,
+    1893, 1908, 1888, 1906, 1904, 1900, 1905, 1905, 1908, 1900, 1898, 1898, 1896, 1902, 1897, 1909,
+    1891, 1896, 1897, 1890, 1914, 1888, 1901, 1899, 1912, 1891, 1909, 1898, 1902, 1899, 1907, 1896,
+    1902, 1905, 1914, 1889, 1912, 1909, 1900, 1905, 1900, 1913, 1905, 1902, 1902, 1902, 1902, 1898,
+    1916, 1892, 1882, 1903, 1903, 1906, 1903, 1903, 1906, 1910, 1901, 1902, 1916, 1907, 1898, 1918,
+    1909, 1901, 1897, 1906, 1900, 1898, 1897, 1902, 1911, 1902, 1896, 1909, 1905, 1910, 1912, 1904,
+    1904, 1905, 1898, 1909, 1913, 1906, 1904, 1904, 1901, 1901, 1903, 1900, 1903, 1896, 1908, 1906,
+    1899, 1892, 1906, 1912, 1902, 1903, 1903, 1910, 1901, 1912, 1904, 1912, 1906, 1905, 1897, 1902,
+    1905, 1910, 1908, 1902, 1909, 1913, 1906, 1904, 1904, 1912, 1910, 1901, 1909, 1904, 1902, 1914,
+    1912, 1903, 1908, 1910, 1903, 1907, 1911, 1897, 1909, 1912, 1910, 1899, 1909, 1902, 1911, 1911,
+    1909, 1903, 1904, 1913, 1902, 1911, 1911, 1906, 1922, 1908, 1921, 1896, 1895, 1914, 1912, 1906,
+    1908, 1897, 1905, 1902, 1907, 1914, 1909, 1911, 1904, 1906, 1909, 1907, 1916, 1904, 1920, 1903,
+    1915, 1904, 1919, 1910, 1911, 1914, 1905, 1903, 1897, 1917, 1905, 1906, 1909, 1921, 1899, 1911,
+    1907, 1913, 1899, 1907, 1915, 1919, 1919, 1905, 1910, 1909, 1902, 1901, 1914, 1911, 1909, 1917,
+    1904, 1913, 1910, 1910, 1913, 1911, 1912, 1912, 1922, 1909, 1916, 1914, 1908, 1915, 1905, 1918,
+    1906, 1908, 1913, 1916, 1916, 1916, 1910, 1905, 1914, 1913, 1905, 1917, 1912, 1905, 1914, 1903,
+    1906, 1914, 1902, 1911, 1903, 1916, 1907, 1912, 1902, 1909, 1917, 1914, 1900, 1917, 1917, 1909,
+    1920, 1905, 1911, 1918, 1920, 1919, 1905, 1901, 1914, 1903, 1911, 1904, 1918, 1917, 1915, 1912,
+    1912, 1910, 1914, 1914, 1915, 1910, 1924, 1914, 1921, 1920, 1907, 1902, 1920, 1910, 1913, 1911,
+    1913, 1905, 1912, 1910, 1912, 1899, 1918, 1915, 1902, 1908, 1913, 1917, 1913, 1921, 1913, 1907,
+    1909, 1917, 1909, 1918, 1919, 1917, 1919, 1912, 1913, 1910, 1909, 1904, 1910, 1907, 1905, 1914,
+    1916, 1911, 1921, 1919, 1920, 1910, 1904, 1917, 1915, 1918, 1916, 1921, 1912, 1918, 1908, 1900,
+    1911, 1923, 1904, 1920, 1910, 1911, 1914, 1915, 1908, 1914, 1916, 1919, 1909, 1923, 1925, 1928,
+    1906, 1915, 1903, 1916, 1917, 1907, 1904, 1915, 1918, 1909, 1912, 1899, 1910, 1915, 1915, 1924,
+    1907, 1901, 1917, 1911, 1916, 1919, 1918, 1923, 1922, 1904, 1914, 1926, 1912, 1920, 1914, 1912,
+    1924, 1921, 1913, 1920, 1907, 1910, 1920, 1915, 1908, 1917, 1916, 1922, 1920, 1913, 1912, 1914,
+    1913, 1923, 1924, 1923, 1917, 1913, 1920, 1913, 1916, 1905, 1912, 1923, 1909, 1906, 1914, 1925,
+    1923, 1913, 1912, 1914, 1909, 1915, 1913, 1906, 1911, 1913, 1910, 1908, 1920, 1926, 1913, 1912,
+    1918, 1913, 1910, 1923, 1909, 1910, 1911, 1910, 1913, 1918, 1924, 1919, 1915, 1907, 1915, 1909,
+    1914, 1921, 1916, 1914, 1910, 1915, 1916, 1909, 1912, 1920, 1905, 1912, 1908, 1924, 1919, 1918,
+    1917, 1917, 1917, 1905, 1917, 1919, 1906, 1920, 1919, 1906, 1912, 1913, 1912, 1917, 1907, 1914,
+    1916, 1919, 1915, 1914, 1919, 1903, 1921, 1913, 1907, 1912, 1904, 1903, 1913, 1910, 1919, 1910,
+    1907, 1909, 1925, 1915, 1911, 1909, 1908, 1914, 1918, 1922, 1922, 1917, 1911, 1910, 1901, 1909,
+    1917, 1913, 1917, 1907, 1920, 1917, 1915, 1917, 1901, 1912, 1909, 1926, 1914, 1912, 1920, 1909,
+    1923, 1911, 1914, 1909, 1920, 1902, 1919, 1910, 1915, 1908, 1916, 1916, 1918, 1917, 1918, 1921,
+    1912, 1908, 1907, 1919, 1912, 1921, 1915, 1909, 1920, 1926, 1914, 1909, 1910, 1920, 1911, 1912,
+    1919, 1915, 1915, 1911, 1911, 1915, 1915, 1918, 1911, 1917, 1917, 1915, 1918, 1920, 1916, 1915,
+    1909, 1916, 1914, 1912, 1909, 1918, 1930, 1917, 1915, 1917, 1911, 1915, 1910, 1910, 1916, 1916,
+    1913, 1909, 1916, 1908, 1919, 1912, 1914, 1919, 1917, 1906, 1912, 1916, 1907, 1899, 1913, 1914,
+    1916, 1914, 1915, 1915, 1922, 1917, 1917, 1911, 1920, 1913, 1918, 1901, 1915, 1913, 1911, 1921,
+    1916, 1913, 1910, 1925, 1918, 1917, 1909, 1921, 1917, 1912, 1913, 1904, 1917, 1907, 1918, 1911,
+    1910, 1915, 1914, 1906, 1913, 1917, 1912, 1905, 1912, 1907, 1910, 1913, 1913, 1912, 1903, 1915,
+    1912, 1910, 1914, 1924, 1905, 1903, 1917, 1908, 1920, 1907, 1910, 1918, 2426, 2796, 2442, 1673,
+    1130, 1242, 1898, 2533, 2643, 2165, 1505, 1204, 1484, 2105, 2547, 2471, 1932, 1419, 1309, 1714,
+    2239, 2486, 2256, 1754, 1399, 1473, 1898, 2315, 2409, 2079, 1644, 1452, 1635, 2043, 2331, 2281,
+    1917, 1576, 1521, 1765, 2128, 2301, 2138, 1809, 1577, 1614, 1903, 2175, 2222, 2018, 1732, 1598,
+    1721, 2001, 2193, 2151, 1918, 1687, 1648, 1816, 2058, 2169, 2067, 1842, 1685, 1720, 1905, 2091,
+    2129, 1978, 1805, 1693, 1777, 1957, 2086, 2065, 1928, 1763, 1747, 1850, 2007, 2071, 2023, 1865,
+    1759, 1797, 1907, 2029, 2047, 1952, 1823, 1774, 1839, 1949, 2028, 2019, 1908, 1823, 1797, 1866,
+    1977, 2022, 1973, 1881, 1818, 1834, 1901, 1970, 2012, 1939, 1855, 1823, 1853, 1939, 1980, 1975,
+    1904, 1856, 1833, 1890, 1959, 1974, 1951, 1893, 1845, 1853, 1912, 1965, 1965, 1928, 1878, 1851,
+    1874, 1918, 1971, 1951, 1911, 1867, 1860, 1892, 1931, 1958, 1944, 1897, 1870, 1874, 1907, 1952,
+    1943, 1924, 1891, 1871, 1878, 1912, 1951, 1931, 1908, 1884, 1876, 1886, 1914, 1938, 1921, 1897,
+    1880, 1884, 1898, 1919, 1939, 1912, 1885, 1869, 1895, 1906, 1923, 1930, 1909, 1892, 1878, 1882,
+    1912, 1925, 1915, 1906, 1890, 1884, 1909, 1920, 1920, 1919, 1886, 1895, 1902, 1898, 1920, 1918,
+    1899, 1891, 1887, 1901, 2108, 2249, 2126, 1814, 1585, 1640, 1908, 2145, 2198, 2003, 1742, 1614,
+    1724, 1991, 2159, 2129, 1926, 1698, 1662, 1828, 2040, 2143, 2045, 1858, 1700, 1728, 1899, 2071,
+    2089, 1969, 1799, 1706, 1790, 1955, 2070, 2064, 1913, 1773, 1741, 1850, 1991, 2058, 1998, 1877,
+    1775, 1796, 1908, 2025, 2023, 1938, 1835, 1784, 1831, 1932, 2014, 2005, 1908, 1817, 1810, 1867,
+    1957, 2003, 1948, 1888, 1815, 1831, 1902, 1974, 1976, 1941, 1860, 1825, 1874, 1916, 1977, 1962,
+    1895, 1858, 1827, 1880, 1939, 1968, 1935, 1893, 1846, 1845, 1893, 1949, 1948, 1923, 1873, 1845,
+    1858, 1908, 1950, 1938, 1914, 1862, 1860, 1890, 1926, 1946, 1933, 1889, 1865, 1866, 1912, 1932,
+    1941, 1895, 1878, 1859, 1880, 1907, 1925, 1925, 1906, 1883, 1868, 1897, 1913, 1932, 1912, 1899,
+    1889, 1877, 1907, 1911, 1919, 1924, 1886, 1880, 1876, 1906, 1915, 1924, 1897, 1899, 1874, 1895,
+    1898, 1915, 1918, 1893, 1875, 1888, 1904, 1915, 1920, 1896, 1901, 1888, 1877, 1914, 1909, 1913,
+    1887, 1884, 1875, 1899, 1904, 1905, 1903, 1902, 1883, 1892, 1891, 1897, 1905, 1900, 1893, 1894,
+    1889, 1898, 1911, 1908, 1898, 1892, 1876, 1891, 1892, 1903, 1908, 1885, 1896, 1888, 1896, 1900,
+    1908, 1895, 1881, 1892, 1892, 1902, 1906, 1894, 1898, 1893, 1891, 1895, 1901, 1898, 1899, 1901,
+    1885, 1892, 1890, 1894, 1898, 1899, 1903, 1891, 1899, 1900, 1900, 1881, 1897, 1893, 1886, 1895,
+    1907, 1892, 1895, 1900, 1882, 1887, 1897, 1904, 1905, 1901, 1907, 1895, 1886, 1895, 1901, 1899,
+    1883, 1895, 1888, 1893, 1905, 1896, 1892, 1893, 1889, 1905, 1899, 1900, 1890, 1891, 1896, 1881,
+    1900, 1887, 1895, 1896, 1889, 1896, 1898, 1905, 1896, 1905, 1897, 1893, 1899, 1891, 1895, 1897,
+    1900, 1895, 1885, 1901, 1894, 1892, 1888, 1897, 1895, 1897, 1892, 1902, 1892, 1896, 1894, 1899,
+    1889, 1891, 1892, 1889, 1889, 1885, 1897, 1902, 1887, 1897, 1886, 1888, 1891, 1893, 1895, 1881,
+    1884, 1893, 1891, 1905, 1890, 1888, 1899, 1876, 1881, 1908, 1888, 1892, 1891, 1886, 1891, 1884,
+    1897, 1896, 1896, 1886, 1880, 1889, 1885, 1894, 1882, 1886, 1892, 1894, 1892, 1884, 1887, 1903,
+    1897, 1886, 1902, 1890, 1891, 1886, 1900, 1891, 1890, 1885, 1883, 1892, 1891, 1900, 1885, 1888,
+    1896, 1895, 1886, 1899, 1893, 1896, 1892, 1896, 1888, 1889, 1897, 1892, 1892, 1897, 1891, 1892,
+    1877, 1887, 1895, 1885, 1888, 1891, 1889, 1895, 1892, 1889, 1896, 1887, 1885, 1891, 1893, 1889,
+    1883, 1886, 1891, 1893, 1900, 1888, 1888, 1876, 1897, 1895, 1889, 1885, 1873, 1893, 1884, 1898,
+    1893, 1897, 1888, 1896, 1880, 1897, 1888, 1882, 1886, 1883, 1890, 1884, 1881, 1886, 1887, 1890,
+    1893, 1896, 1891, 1898, 1873, 1888, 1894, 1880, 1887, 1889, 1879, 1885, 1892, 1886, 1897, 1902,
+    1887, 1881, 1888, 1884, 1879, 1885, 1885, 1886, 1893, 1894, 1890, 1885, 1890, 1888, 1889, 1882,
+    1869, 1893, 1884, 1884, 1887, 1887, 1886, 1896, 1888, 1889, 1882, 1887, 1890, 1887, 1889, 1882,
+    1889, 1881, 1884, 1882, 1888, 1894, 1889, 1882, 1888, 1893, 1891, 1890, 1880, 1884, 1883, 1884,
+    1888, 1887, 1885, 1890, 1882, 1885, 1887, 1879, 1881, 1878, 1880, 1886, 1886, 1889, 1888, 1880,
+    1898, 1894, 1879, 1882, 1883, 1888, 1890, 1886, 1871, 1903, 1891, 1891, 1882, 1887, 1892, 1883,
+    1893, 1887, 1896, 1886, 1895, 1876, 1895, 1889, 1884, 1892, 1884, 1891, 1892, 1892, 1899, 1894,
+    1901, 1890, 1887, 1888, 1886, 1878, 1887, 1879, 1884, 1884, 1882, 1879, 1886, 1886, 1894, 1889,
+    1891, 1883, 1884, 1878, 1880, 1890, 1884, 1885, 1882, 1895, 1885, 1892, 1885, 1891, 1880, 1877,
+    1892, 1884, 1887, 1891, 1890, 1887, 1878, 1881, 1886, 1889, 1888, 1888, 1881, 1885, 1891, 1880,
+    1882, 1891, 1895, 1888, 1885, 1880, 1885, 1880, 1886, 1889, 1888, 1893, 1879, 1878, 1893, 1891,
+    1879, 1886, 1879, 1885, 1887, 1891, 1879, 1878, 1889, 1883, 1893, 1878, 1881, 1869, 1892, 1893,
+    1888, 1883, 1873, 1877, 1882, 1896, 1890, 1881, 1888, 1888, 1888, 1880, 1882, 1891, 1889, 1883,
+    1900, 1887, 1883, 1890, 1890, 1884, 1896, 1891, 1885, 1889, 1889, 1883, 1889, 1882, 1884, 1889,
+    1878, 1883, 1879, 1889, 1882, 1896, 1894, 1881, 1886, 1883, 1885, 1889, 1894, 1898, 1896, 1878,
+    1882, 1884, 1883, 1886, 1889, 1882, 1882, 1899, 1889, 1898, 1882, 1893, 1895, 1893, 1881, 1888,
+    1881, 1878, 1885, 1888, 1884, 1884, 1889, 1881, 1888, 1890, 1889, 1889, 1879, 1883, 1883, 1889,
+    1875, 1886, 1876, 1889, 1882, 1886, 1891, 1895, 1879, 1886, 1874, 1884, 1881, 1889, 1885, 1886,
+    1879, 1883, 1879, 1885, 1876, 1887, 1892, 1901, 1894, 1893, 1890, 1895, 1885, 1888, 1874, 1883,
+    1892, 1875, 1887, 1885, 1883, 1887, 1886, 1879, 1885, 1875, 1895, 1886, 1891, 1880, 1897, 1892,
+    1888, 1887, 1888, 1881, 1885, 1884, 1888, 1895, 1893, 1887, 1890, 1884, 1883, 1876, 1878, 1879,
+    1886, 1885, 1889, 1893, 1890, 1885, 1883, 1884, 1890, 1881, 1877, 1885, 1892, 1893, 1890, 1875,
+    1885, 1890, 1893, 1897, 1881, 1888, 1877, 1885, 1884, 1891, 1887, 1876, 1886, 1889, 1895, 1882,
+    1881, 1883, 1893, 1885, 1887, 1889, 1882, 1893, 1877, 1898, 1883, 1881, 1882, 1880, 1882, 1882,
+    1880, 1886, 1889, 1883, 2029, 2118, 2105, 1981, 1816, 1699, 1667, 1738, 1881, 2020, 2079, 2057,
+    1956, 1819, 1728, 1723, 1770, 1898, 2003, 2063, 2027, 1921, 1826, 1746, 1740, 1806, 1907, 1988,
+    2025, 2002, 1906, 1819, 1771, 1765, 1827, 1914, 1976, 2001, 1965, 1898, 1828, 1785, 1795, 1848,
+    1921, 1964, 1984, 1960, 1889, 1830, 1801, 1809, 1863, 1918, 1958, 1970, 1943, 1876, 1834, 1814,
+    1821, 1874, 1931, 1955, 1959, 1912, 1878, 1835, 1833, 1842, 1877, 1920, 1946, 1950, 1923, 1884,
+    1838, 1846, 1854, 1875, 1917, 1932, 1929, 1913, 1869, 1857, 1855, 1855, 1896, 1910, 1923, 1928,
+    1902, 1866, 1855, 1860, 1866, 1888, 1912, 1921, 1911, 1892, 1880, 1870, 1847, 1877, 1899, 1905,
+    1925, 1901, 1900, 1887, 1876, 1852, 1879, 1889, 1910, 1920, 1908, 1902, 1869, 1866, 1869, 1887,
+    1903, 1901, 1903, 1908, 1883, 1883, 1869, 1876, 1898, 1895, 1905, 1901, 1903, 1899, 1885, 1869,
+    1882, 1897, 1891, 1902, 1898, 1894, 1884, 1875, 1883, 1882, 1876, 1891, 1897, 1895, 1897, 1888,
+    1886, 1874, 1881, 1888, 1895, 1898, 1895, 1895, 1900, 1881, 1874, 1889, 1886, 1902, 1906, 1908,
+    1896, 1880, 1896, 1892, 1896, 1893, 1895, 1899, 1886, 1900, 1887, 1884, 1890, 1885, 1898, 1893,
+    1912, 1904, 1898, 1893, 1889, 1886, 1880, 1891, 1892, 1894, 1897, 1883, 1884, 1886, 1887, 1898,
+    1911, 1896, 1901, 1896, 1895, 1902, 1892, 1895, 1893, 1891, 1903, 1896, 1905, 1887, 1895, 1902,
+    1888, 1896, 1904, 1899, 1892, 1894, 1896, 1889, 1890, 1894, 1887, 1906, 1893, 1897, 1897, 1903,
+    1891, 1906, 1905, 1899, 1888, 1889, 1895, 1898, 1899, 1903, 1898, 1896, 1898, 1883, 1903, 1887,
+    1884, 1892, 1893, 1889, 1895, 1896, 1900, 1898, 1893, 1897, 1904, 1895, 1895, 1884, 1898, 1909,
+    1901, 1895, 1904, 1904, 1905, 1890, 1890, 1901, 1900, 1900, 1888, 1902, 1909, 1904, 1913, 1900,
+    1898, 1908, 1903, 1884, 1888, 1899, 1894, 1908, 1907, 1905, 1896, 1896, 1902, 1896, 1902, 1900,
+    1903, 1899, 1893, 1881, 1890, 1889, 1902, 1890, 1895, 1901, 1902, 1905, 1901, 1908, 1895, 1906,
+    1890, 1896, 1901, 1902, 1897, 1895, 1891, 1885, 1887, 1909, 1888, 1890, 1889, 1897, 1898, 1896,
+    1891, 1898, 1891, 1901, 1908, 1894, 1901, 1896, 1897, 1892, 1900, 1900, 1907, 1914, 1893, 1907,
+};
+
+// 无敲击，第200个采样起基线在75ms内缓慢上移120
+static const uint16_t kBaselineDrift[] = {
+    1800, 1804, 1796, 1803, 1808, 1804, 1813, 1793, 1801, 1795, 1794, 1799, 1803, 1804, 1805, 1819,
+    1808, 1788, 1803, 1796, 1797, 1812, 1800, 1786, 1804, 1799, 1792, 1794, 1797, 1802, 1798, 1802,
+    1817, 1796, 1796, 1800, 1811, 1797, 1814, 1792, 1794, 1802, 1796, 1798, 1806, 1809, 1804, 1801,
+    1814, 1806, 1801, 1813, 1796, 1805, 1809, 1803, 1799, 1806, 1799, 1799, 1795, 1814, 1799, 1813,
+    1807, 1802, 1809, 1806, 1805, 1793, 1805, 1811, 1808, 1812, 1816, 1808, 1820, 1792, 1803, 1784,
+    1811, 1806, 1818, 1802, 1789, 1815, 1794, 1795, 1804, 1810, 1801, 1807, 1790, 1819, 1805, 1806,
+    1810, 1807, 1807, 1798, 1805, 1809, 1814, 1805, 1807, 1809, 1811, 1808, 1804, 1802, 1815, 1809,
+    1807, 1834, 1814, 1813, 1808, 1798, 1816, 1806, 1807, 1815, 1815, 1809, 1807, 1824, 1812, 1799,
+    1813, 1808, 1807, 1813, 1809, 1823, 1809, 1809, 1817, 1803, 1816, 1807, 1817, 1801, 1811, 1795,
+    1804, 1808, 1812, 1824, 1823, 1797, 1802, 1818, 1812, 1797, 1812, 1799, 1801, 1798, 1806, 1826,
+    1811, 1807, 1828, 1805, 1807, 1806, 1812, 1806, 1820, 1806, 1813, 1810, 1802, 1801, 1808, 1790,
+    1809, 1809, 1810, 1808, 1812, 1806, 1814, 1796, 1816, 1802, 1813, 1805, 1806, 1803, 1820, 1801,
+    1800, 1811, 1811, 1810, 1802, 1804, 1817, 1801, 1814, 1815, 1811, 1800, 1826, 1812, 1812, 1808,
+    1804, 1809, 1813, 1805, 1813, 1821, 1816, 1812, 1821, 1820, 1821, 1807, 1799, 1820, 1815, 1811,
+    1818, 1811, 1810, 1830, 1803, 1822, 1824, 1830, 1818, 1821, 1809, 1817, 1800, 1813, 1817, 1817,
+    1814, 1827, 1806, 1820, 1816, 1819, 1820, 1835, 1811, 1830, 1831, 1819, 1816, 1811, 1814, 1837,
+    1804, 1825, 1816, 1837, 1825, 1811, 1818, 1824, 1824, 1815, 1821, 1820, 1827, 1826, 1826, 1819,
+    1831, 1820, 1818, 1822, 1823, 1823, 1810, 1836, 1831, 1837, 1823, 1832, 1828, 1827, 1841, 1823,
+    1832, 1814, 1832, 1827, 1820, 1824, 1812, 1820, 1830, 1808, 1838, 1837, 1824, 1818, 1819, 1820,
+    1824, 1848, 1822, 1837, 1841, 1824, 1829, 1837, 1827, 1842, 1849, 1832, 1826, 1837, 1836, 1827,
+    1832, 1834, 1838, 1843, 1830, 1824, 1821, 1849, 1831, 1832, 1855, 1844, 1853, 1834, 1830, 1832,
+    1841, 1840, 1840, 1855, 1848, 1828, 1841, 1842, 1831, 1856, 1845, 1850, 1834, 1829, 1844, 1837,
+    1834, 1838, 1841, 1840, 1838, 1843, 1863, 1849, 1836, 1857, 1837, 1828, 1830, 1824, 1850, 1832,
+    1830, 1837, 1840, 1832, 1837, 1842, 1847, 1835, 1847, 1845, 1847, 1839, 1834, 1851, 1848, 1838,
+    1838, 1850, 1860, 1847, 1865, 1847, 1847, 1849, 1854, 1833, 1847, 1856, 1833, 1848, 1852, 1860,
+    1859, 1846, 1863, 1838, 1836, 1858, 1853, 1838, 1856, 1855, 1854, 1844, 1838, 1835, 1847, 1847,
+    1845, 1844, 1856, 1840, 1843, 1865, 1844, 1845, 1858, 1836, 1863, 1840, 1844, 1840, 1843, 1845,
+    1859, 1851, 1862, 1858, 1842, 1852, 1847, 1849, 1853, 1855, 1856, 1836, 1852, 1849, 1868, 1851,
+    1853, 1854, 1860, 1845, 1853, 1853, 1854, 1852, 1850, 1855, 1844, 1868, 1855, 1841, 1853, 1863,
+    1854, 1855, 1837, 1867, 1857, 1840, 1853, 1868, 1860, 1845, 1853, 1859, 1874, 1859, 1864, 1855,
+    1858, 1850, 1848, 1847, 1854, 1869, 1858, 1868, 1865, 1860, 1855, 1877, 1869, 1870, 1880, 1872,
+    1862, 1863, 1865, 1879, 1853, 1846, 1857, 1861, 1857, 1869, 1866, 1861, 1862, 1877, 1878, 1876,
+    1859, 1872, 1853, 1848, 1877, 1870, 1869, 1875, 1877, 1866, 1866, 1869, 1871, 1866, 1854, 1885,
+    1859, 1860, 1870, 1865, 1870, 1885, 1877, 1862, 1868, 1866, 1876, 1859, 1859, 1853, 1871, 1870,
+    1873, 1874, 1858, 1864, 1859, 1878, 1875, 1856, 1872, 1869, 1869, 1874, 1864, 1866, 1864, 1864,
+    1861, 1879, 1874, 1868, 1857, 1888, 1870, 1872, 1876, 1884, 1868, 1852, 1868, 1871, 1867, 1883,
+    1868, 1874, 1865, 1878, 1867, 1879, 1874, 1874, 1875, 1860, 1869, 1875, 1870, 1883, 1881, 1868,
+    1883, 1872, 1879, 1884, 1866, 1868, 1874, 1873, 1862, 1881, 1877, 1877, 1878, 1882, 1869, 1879,
+    1873, 1873, 1870, 1886, 1857, 1871, 1883, 1875, 1872, 1886, 1870, 1876, 1881, 1874, 1874, 1879,
+    1886, 1871, 1883, 1879, 1876, 1869, 1893, 1884, 1882, 1878, 1893, 1875, 1872, 1874, 1880, 1884,
+    1865, 1884, 1884, 1890, 1879, 1894, 1898, 1878, 1880, 1890, 1892, 1883, 1892, 1871, 1891, 1887,
+    1891, 1888, 1889, 1881, 1895, 1868, 1887, 1880, 1901, 1876, 1886, 1885, 1892, 1886, 1877, 1885,
+    1896, 1893, 1881, 1877, 1877, 1886, 1886, 1885, 1883, 1889, 1899, 1896, 1885, 1895, 1887, 1899,
+    1897, 1897, 1907, 1898, 1897, 1901, 1882, 1888, 1888, 1897, 1891, 1881, 1885, 1890, 1888, 1888,
+    1880, 1893, 1882, 1889, 1888, 1890, 1904, 1890, 1890, 1873, 1886, 1896, 1891, 1900, 1892, 1901,
+    1897, 1904, 1893, 1902, 1892, 1889, 1905, 1885, 1889, 1909, 1898, 1900, 1899, 1897, 1913, 1898,
+    1909, 1898, 1892, 1896, 1899, 1919, 1894, 1902, 1887, 1904, 1898, 1903, 1901, 1896, 1901, 1901,
+    1909, 1900, 1900, 1891, 1908, 1900, 1895, 1912, 1910, 1902, 1903, 1892, 1884, 1904, 1891, 1909,
+    1901, 1906, 1900, 1908, 1911, 1906, 1911, 1911, 1904, 1892, 1911, 1901, 1898, 1892, 1892, 1917,
+    1921, 1918, 1924, 1892, 1914, 1897, 1896, 1913, 1916, 1901, 1896, 1897, 1908, 1917, 1926, 1914,
+    1902, 1902, 1911, 1915, 1894, 1912, 1905, 1917, 1897, 1918, 1922, 1922, 1923, 1911, 1911, 1901,
+    1910, 1904, 1915, 1916, 1909, 1923, 1900, 1906, 1924, 1909, 1916, 1890, 1923, 1905, 1905, 1919,
+    1911, 1897, 1921, 1903, 1908, 1906, 1907, 1907, 1908, 1907, 1931, 1913, 1916, 1906, 1925, 1915,
+    1912, 1907, 1917, 1897, 1906, 1908, 1914, 1912, 1899, 1916, 1908, 1907, 1912, 1909, 1908, 1908,
+    1917, 1912, 1913, 1906, 1921, 1913, 1906, 1920, 1901, 1906, 1918, 1908, 1909, 1909, 1912, 1916,
+    1917, 1907, 1908, 1897, 1908, 1916, 1913, 1922, 1910, 1915, 1919, 1903, 1923, 1902, 1911, 1898,
+    1911, 1905, 1921, 1897, 1917, 1916, 1917, 1921, 1920, 1906, 1918, 1907, 1908, 1911, 1910, 1909,
+    1922, 1914, 1899, 1907, 1910, 1932, 1916, 1910, 1917, 1896, 1926, 1911, 1907, 1921, 1908, 1905,
+    1921, 1930, 1912, 1914, 1914, 1918, 1911, 1916, 1909, 1914, 1921, 1903, 1921, 1929, 1910, 1912,
+    1916, 1915, 1907, 1922, 1920, 1923, 1921, 1911, 1914, 1911, 1936, 1913, 1923, 1928, 1915, 1918,
+    1919, 1929, 1907, 1918, 1920, 1920, 1910, 1924, 1920, 1909, 1908, 1932, 1912, 1904, 1920, 1908,
+    1917, 1921, 1910, 1906, 1932, 1907, 1908, 1917, 1921, 1917, 1911, 1925, 1909, 1911, 1923, 1926,
+    1922, 1925, 1921, 1925, 1913, 1913, 1923, 1926, 1915, 1913, 1917, 1927, 1918, 1917, 1918, 1917,
+    1923, 1916, 1920, 1917, 1913, 1920, 1922, 1906, 1921, 1921, 1919, 1911, 1915, 1925, 1913, 1928,
+};
+
+#endif // IMPACT_FIXTURES_H
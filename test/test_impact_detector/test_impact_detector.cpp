@@ -0,0 +1,104 @@
+#include <unity.h>
+#include "impact_detector.h"
+#include "impact_fixtures.h"
+
+#define BLOCK_SAMPLES 128
+#define SAMPLE_US(n) ((uint64_t)(n) * FIXTURE_PERIOD_US)
+
+static ImpactDetector detector;
+
+// 按设备上DMA帧的大小分块送入
+static void playFixture(const uint16_t* samples, uint16_t count, uint64_t startUs = 0) {
+    for (uint16_t i = 0; i < count; i += BLOCK_SAMPLES) {
+        uint16_t block = count - i < BLOCK_SAMPLES ? count - i : BLOCK_SAMPLES;
+        detector.process(samples + i, block, startUs + SAMPLE_US(i), FIXTURE_PERIOD_US);
+    }
+}
+
+void setUp(void) {
+    detector.reset();
+    detector.setConfig(ImpactDetector::defaultConfig(200000));
+}
+
+void tearDown(void) {}
+
+void test_single_hit_timestamped_at_crossing(void) {
+    playFixture(kSingleHit, sizeof(kSingleHit) / sizeof(kSingleHit[0]));
+
+    ImpactEvent event;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    // 时刻精确到采样（0.125ms），与分块和处理时机无关
+    TEST_ASSERT_UINT32_WITHIN(2 * FIXTURE_PERIOD_US, SAMPLE_US(600), (uint32_t)event.atUs);
+    TEST_ASSERT_GREATER_THAN(400, event.peak);
+    TEST_ASSERT_LESS_THAN(30, event.noiseFloor);
+    TEST_ASSERT_UINT32_WITHIN(6, 27, event.strength);
+    TEST_ASSERT_FALSE(detector.nextEvent(event));
+}
+
+void test_threshold_adapts_to_rising_noise(void) {
+    playFixture(kRisingNoise, sizeof(kRisingNoise) / sizeof(kRisingNoise[0]));
+
+    // 噪声升高期间无误触发，之后较弱的敲击仍能检出
+    ImpactEvent event;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    TEST_ASSERT_UINT32_WITHIN(3 * FIXTURE_PERIOD_US, SAMPLE_US(1500), (uint32_t)event.atUs);
+    TEST_ASSERT_GREATER_THAN(30, event.noiseFloor);
+    TEST_ASSERT_FALSE(detector.nextEvent(event));
+    TEST_ASSERT_GREATER_THAN(150, detector.threshold());
+}
+
+void test_bounce_suppressed_second_hit_reported(void) {
+    ImpactDetectorConfig config = ImpactDetector::defaultConfig(100000);
+    detector.setConfig(config);
+    playFixture(kBounceAndHit, sizeof(kBounceAndHit) / sizeof(kBounceAndHit[0]));
+
+    ImpactEvent event;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    TEST_ASSERT_UINT32_WITHIN(2 * FIXTURE_PERIOD_US, SAMPLE_US(700), (uint32_t)event.atUs);
+    uint16_t firstPeak = event.peak;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    TEST_ASSERT_UINT32_WITHIN(3 * FIXTURE_PERIOD_US, SAMPLE_US(1700), (uint32_t)event.atUs);
+    TEST_ASSERT_LESS_THAN(firstPeak, event.peak);
+    TEST_ASSERT_FALSE(detector.nextEvent(event));
+}
+
+void test_refractory_rejects_close_hits(void) {
+    // 防抖间隔长于两次敲击之差时，第二次计为被拒绝
+    detector.setConfig(ImpactDetector::defaultConfig(300000));
+    playFixture(kBounceAndHit, sizeof(kBounceAndHit) / sizeof(kBounceAndHit[0]));
+
+    ImpactEvent event;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    TEST_ASSERT_FALSE(detector.nextEvent(event));
+    TEST_ASSERT_EQUAL_UINT32(1, detector.rejected());
+}
+
+void test_baseline_drift_does_not_trigger(void) {
+    playFixture(kBaselineDrift, sizeof(kBaselineDrift) / sizeof(kBaselineDrift[0]));
+
+    ImpactEvent event;
+    TEST_ASSERT_FALSE(detector.nextEvent(event));
+    // 基线跟随漂移上移（时间常数128ms，尚未完全跟上）
+    TEST_ASSERT_GREATER_THAN(1830, detector.baseline());
+}
+
+void test_timestamp_offset_by_block_start(void) {
+    // 64位时间戳在大偏移处保持采样精度
+    const uint64_t startUs = 0x1FFFFFFF0ULL;
+    playFixture(kSingleHit, sizeof(kSingleHit) / sizeof(kSingleHit[0]), startUs);
+
+    ImpactEvent event;
+    TEST_ASSERT_TRUE(detector.nextEvent(event));
+    TEST_ASSERT_UINT32_WITHIN(2 * FIXTURE_PERIOD_US, SAMPLE_US(600), (uint32_t)(event.atUs - startUs));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_hit_timestamped_at_crossing);
+    RUN_TEST(test_threshold_adapts_to_rising_noise);
+    RUN_TEST(test_bounce_suppressed_second_hit_reported);
+    RUN_TEST(test_refractory_rejects_close_hits);
+    RUN_TEST(test_baseline_drift_does_not_trigger);
+    RUN_TEST(test_timestamp_offset_by_block_start);
+    return UNITY_END();
+}
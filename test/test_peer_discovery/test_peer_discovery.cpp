@@ -0,0 +1,164 @@
+#include <unity.h>
+#include <string.h>
+#include "peer_cache.h"
+#include "peer_discovery.h"
+
+static const uint8_t MAC_A[6] = {0x50, 0x78, 0x7d, 0x46, 0xd4, 0x80};
+static const uint8_t MAC_B[6] = {0x50, 0x78, 0x7d, 0x46, 0xcc, 0x90};
+
+static void macFor(uint8_t id, uint8_t* mac) {
+    memcpy(mac, MAC_A, 6);
+    mac[5] = id;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_cache_most_recent_first_and_evicts_oldest(void) {
+    PeerCache cache;
+    uint8_t mac[6];
+    for (uint8_t id = 1; id <= PEER_CACHE_SIZE + 1; id++) {
+        macFor(id, mac);
+        cache.remember(mac, -40 - id);
+    }
+    TEST_ASSERT_EQUAL_UINT8(PEER_CACHE_SIZE, cache.count());
+    TEST_ASSERT_EQUAL_UINT8(PEER_CACHE_SIZE + 1, cache.at(0).mac[5]);
+    macFor(1, mac);
+    TEST_ASSERT_FALSE(cache.contains(mac));     // 最久未用的被淘汰
+
+    // 再次连接的对端移到最前，连接次数累加
+    macFor(3, mac);
+    cache.remember(mac, -30);
+    TEST_ASSERT_EQUAL_INT(0, cache.indexOf(mac));
+    TEST_ASSERT_EQUAL_INT8(-30, cache.at(0).rssi);
+    TEST_ASSERT_EQUAL_UINT8(2, cache.at(0).connects);
+    TEST_ASSERT_EQUAL_UINT8(PEER_CACHE_SIZE, cache.count());
+
+    TEST_ASSERT_TRUE(cache.forget(mac));
+    TEST_ASSERT_EQUAL_UINT8(PEER_CACHE_SIZE - 1, cache.count());
+    TEST_ASSERT_EQUAL_UINT8(PEER_CACHE_SIZE + 1, cache.at(0).mac[5]);
+}
+
+void test_cache_round_trip_and_corruption(void) {
+    PeerCache cache;
+    cache.remember(MAC_A, -52);
+    cache.remember(MAC_B, -67);
+
+    uint8_t blob[PEER_CACHE_BLOB_SIZE];
+    size_t length = cache.encode(blob, sizeof(blob));
+    TEST_ASSERT_EQUAL_UINT32(4 + 2 * 8 + 4, length);
+
+    PeerCache loaded;
+    TEST_ASSERT_TRUE(loaded.decode(blob, length));
+    TEST_ASSERT_EQUAL_UINT8(2, loaded.count());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(MAC_B, loaded.at(0).mac, 6);
+    TEST_ASSERT_EQUAL_INT8(-52, loaded.at(1).rssi);
+
+    blob[5] ^= 0x01;
+    PeerCache corrupted;
+    TEST_ASSERT_FALSE(corrupted.decode(blob, length));
+    TEST_ASSERT_EQUAL_UINT8(0, corrupted.count());
+    TEST_ASSERT_FALSE(corrupted.decode(blob, length - 1));
+}
+
+void test_probe_schedule_jitter_and_window(void) {
+    ProbeSchedule a, b;
+    a.begin(1000, 50000, 30000, 1000000, 0x46d480);
+    b.begin(1000, 50000, 30000, 1000000, 0x46cc90);
+    TEST_ASSERT_TRUE(a.due(1000));              // 开始即发第一个探测
+    TEST_ASSERT_TRUE(b.due(1000));
+
+    // 逐微秒推进，记录两者的发送时刻
+    uint64_t lastA = 1000, lastB = 1000;
+    int sameSlot = 0;
+    for (uint64_t now = 1001; now <= 1100000; now++) {
+        bool sentA = a.due(now), sentB = b.due(now);
+        if (sentA) {
+            TEST_ASSERT_TRUE(now - lastA >= 50000 && now - lastA < 80000);
+            lastA = now;
+        }
+        if (sentB) {
+            lastB = now;
+        }
+        if (sentA && sentB) {
+            sameSlot++;
+        }
+    }
+    // 种子不同，抖动序列不同，不会每次都同时发
+    TEST_ASSERT_LESS_THAN(a.sent() - 1, sameSlot);
+    TEST_ASSERT_TRUE(a.sent() >= 13 && a.sent() <= 20);
+    TEST_ASSERT_FALSE(a.active());
+    TEST_ASSERT_TRUE(lastB > 900000);
+}
+
+void test_discovery_completes_soon_after_first_answer(void) {
+    PeerDiscovery discovery;
+    discovery.begin(0, 1234);
+
+    // 对端在200ms上电，之后的第一个探测得到应答（主循环10ms一次）
+    uint64_t answeredAt = 0;
+    uint64_t now = 0;
+    for (; now < DISCOVERY_SCAN_US; now += 10000) {
+        if (discovery.probeDue(now) && now >= 200000 && answeredAt == 0) {
+            answeredAt = now + 10000;
+        }
+        if (answeredAt && now >= answeredAt) {
+            discovery.onResponse(now);
+        }
+        if (discovery.update(now) == DISCOVERY_DONE) {
+            break;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(DISCOVERY_DONE, discovery.state());
+    TEST_ASSERT_TRUE(now - answeredAt >= DISCOVERY_SETTLE_US);
+    TEST_ASSERT_LESS_THAN(600000, now);        // 远早于原来的10秒被动等待
+    TEST_ASSERT_FALSE(discovery.probeDue(now + 1000000));
+}
+
+void test_discovery_gives_up_without_answer(void) {
+    PeerDiscovery discovery;
+    discovery.begin(0, 99);
+    uint64_t now = 0;
+    while (discovery.update(now) == DISCOVERY_PROBING) {
+        discovery.probeDue(now);
+        now += 10000;
+    }
+    TEST_ASSERT_EQUAL_INT(DISCOVERY_EMPTY, discovery.state());
+    TEST_ASSERT_UINT32_WITHIN(10000, DISCOVERY_SCAN_US, (uint32_t)now);
+    TEST_ASSERT_GREATER_THAN(40, discovery.probesSent());
+}
+
+void test_known_peers_reconnect_within_one_second(void) {
+    // 两个锥桶相继上电（从机晚300ms），各自向缓存中的对端探测；
+    // 对端上电后的主循环收到探测立即应答，每次往返约一个主循环周期，前两个探测丢失
+    const uint64_t masterUpUs = 250000, slaveUpUs = 550000;
+    ProbeSchedule master, slave;
+    master.begin(masterUpUs, RECONNECT_PROBE_INTERVAL_US, RECONNECT_PROBE_JITTER_US, RECONNECT_WINDOW_US, 0x46d480);
+    slave.begin(slaveUpUs, RECONNECT_PROBE_INTERVAL_US, RECONNECT_PROBE_JITTER_US, RECONNECT_WINDOW_US, 0x46cc90);
+
+    uint64_t connectedUs = 0;
+    int delivered = 0;
+    for (uint64_t now = 0; now < 2000000 && !connectedUs; now += 10000) {
+        bool masterProbe = now >= masterUpUs && master.due(now);
+        bool slaveProbe = now >= slaveUpUs && slave.due(now);
+        // 探测只有在对端已上电时才会被应答
+        if ((masterProbe && now >= slaveUpUs) || (slaveProbe && now >= masterUpUs)) {
+            if (++delivered > 2) {
+                connectedUs = now + 10000;
+            }
+        }
+    }
+    TEST_ASSERT_TRUE(connectedUs > 0);
+    TEST_ASSERT_LESS_THAN(1000000, connectedUs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_cache_most_recent_first_and_evicts_oldest);
+    RUN_TEST(test_cache_round_trip_and_corruption);
+    RUN_TEST(test_probe_schedule_jitter_and_window);
+    RUN_TEST(test_discovery_completes_soon_after_first_answer);
+    RUN_TEST(test_discovery_gives_up_without_answer);
+    RUN_TEST(test_known_peers_reconnect_within_one_second);
+    return UNITY_END();
+}
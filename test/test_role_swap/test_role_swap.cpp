@@ -0,0 +1,350 @@
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "role_swap.h"
+
+#define MS_US           1000ULL
+#define SECOND_US       1000000ULL
+#define SIM_COMMAND     0x05
+#define SIM_LOOP_US     (10 * MS_US)
+#define SWAP_BUDGET_US  (50 * MS_US)
+
+// 双节点仿真：两台设备各自10ms主循环（相位不同），无线单向延迟2-5ms
+//   角色交换帧在主循环中处理（与固件的邮箱一致），开始/完成信号在接收回调中立即处理
+enum SimKind { SIM_SWAP, SIM_START, SIM_COMPLETE };
+
+struct SimPacket {
+    uint64_t deliverUs;
+    int to;
+    SimKind kind;
+    RoleSwapFrame frame;
+};
+
+struct SimNode {
+    RoleSwap swap;
+    bool waiting;             // 回合之间
+    uint64_t roundStartUs;
+    RoleSwapSession session;  // 本机作为主机时的课程状态
+    uint64_t phaseUs;
+    bool touchPending;
+    std::vector<RoleSwapFrame> inbox;
+
+    SimNode() : swap(SIM_COMMAND) {}
+};
+
+struct Sim {
+    SimNode nodes[2];
+    std::vector<SimPacket> air;
+    uint64_t nowUs;
+    uint32_t rng;
+    int dropNext[2][8];       // 按阶段丢弃发往某节点的下一帧
+    bool deadLink[2];         // 发往该节点的帧全部丢失
+    uint32_t declines;
+    uint32_t fixedLatencyUs;  // 非0时使用固定延迟
+
+    void begin(int master) {
+        nowUs = 0;
+        rng = 12345;
+        air.clear();
+        memset(dropNext, 0, sizeof(dropNext));
+        deadLink[0] = deadLink[1] = false;
+        declines = 0;
+        fixedLatencyUs = 0;
+        for (int i = 0; i < 2; i++) {
+            SimNode& node = nodes[i];
+            node.swap.begin(i == master);
+            node.waiting = true;
+            node.roundStartUs = 0;
+            memset(&node.session, 0, sizeof(node.session));
+            node.phaseUs = i == 0 ? 0 : 3700;
+            node.touchPending = false;
+            node.inbox.clear();
+        }
+        nodes[master].session.alertSeconds = 600;
+        nodes[master].session.ledColor = 3;
+        nodes[master].session.ledBrightness = 70;
+        nodes[master].session.flags = ROLE_SWAP_FLAG_SOUND;
+    }
+
+    int master() const { return nodes[0].swap.isMaster() ? 0 : 1; }
+    bool consistent() const { return nodes[0].swap.isMaster() != nodes[1].swap.isMaster(); }
+
+    uint32_t latencyUs() {
+        if (fixedLatencyUs) {
+            return fixedLatencyUs;
+        }
+        rng = rng * 1103515245u + 12345u;
+        return 2000 + (rng >> 16) % 3000;
+    }
+
+    void send(int from, SimKind kind, const RoleSwapFrame* frame) {
+        int to = 1 - from;
+        if (deadLink[to]) {
+            return;
+        }
+        if (kind == SIM_SWAP && dropNext[to][frame->phase] > 0) {
+            dropNext[to][frame->phase]--;
+            return;
+        }
+        SimPacket packet;
+        packet.deliverUs = nowUs + latencyUs();
+        packet.to = to;
+        packet.kind = kind;
+        if (frame) {
+            packet.frame = *frame;
+        }
+        air.push_back(packet);
+    }
+
+    void deliver() {
+        for (size_t i = 0; i < air.size();) {
+            if (air[i].deliverUs > nowUs) {
+                i++;
+                continue;
+            }
+            SimPacket packet = air[i];
+            air.erase(air.begin() + i);
+            SimNode& node = nodes[packet.to];
+            if (packet.kind == SIM_SWAP) {
+                node.inbox.push_back(packet.frame);
+            } else if (packet.kind == SIM_START && node.swap.isMaster() && node.waiting) {
+                node.waiting = false;
+                node.roundStartUs = nowUs;
+            } else if (packet.kind == SIM_COMPLETE && !node.swap.isMaster() && !node.waiting) {
+                node.waiting = true;
+            }
+        }
+    }
+
+    void loop(int index) {
+        SimNode& node = nodes[index];
+        RoleSwapFrame out;
+        for (size_t i = 0; i < node.inbox.size(); i++) {
+            if (node.swap.receive(node.inbox[i], nowUs, node.waiting, out)) {
+                if (out.phase == ROLE_SWAP_DECLINE) {
+                    declines++;
+                }
+                send(index, SIM_SWAP, &out);
+            }
+        }
+        node.inbox.clear();
+        if (node.swap.takeRoleChanged() && node.swap.isMaster()) {
+            node.session = node.swap.adopted();
+        }
+
+        // 触发检测：从机在回合之间发出开始信号，主机在计时中结束回合
+        if (node.touchPending) {
+            node.touchPending = false;
+            if (!node.swap.isMaster() && node.waiting) {
+                node.waiting = false;
+                send(index, SIM_START, nullptr);
+            } else if (node.swap.isMaster() && !node.waiting) {
+                uint32_t ticks = (uint32_t)((nowUs - node.roundStartUs) / 100);
+                node.session.rounds++;
+                node.session.totalTicks += ticks;
+                node.session.lastTicks = ticks;
+                node.waiting = true;
+                send(index, SIM_COMPLETE, nullptr);
+            }
+        }
+
+        node.session.elapsedMs = (uint32_t)(nowUs / MS_US);
+        if (node.swap.poll(nowUs, node.waiting, node.session, out)) {
+            send(index, SIM_SWAP, &out);
+        }
+    }
+
+    void runUntil(uint64_t endUs) {
+        while (nowUs < endUs) {
+            nowUs += 100;
+            deliver();
+            for (int i = 0; i < 2; i++) {
+                if (nowUs % SIM_LOOP_US == nodes[i].phaseUs) {
+                    loop(i);
+                }
+            }
+        }
+    }
+
+    void touch(int index) { nodes[index].touchPending = true; }
+
+    // 从请求到双方角色一致翻转所用的时间；超时返回0
+    uint64_t swapFrom(int requester, uint64_t limitUs) {
+        int before = master();
+        uint64_t startUs = nowUs;
+        nodes[requester].swap.request();
+        while (nowUs - startUs < limitUs) {
+            runUntil(nowUs + 100);
+            if (consistent() && master() != before && !nodes[before].swap.requested()) {
+                return nowUs - startUs;
+            }
+        }
+        return 0;
+    }
+};
+
+static Sim sim;
+
+void setUp(void) {
+    sim.begin(0);
+}
+
+void tearDown(void) {}
+
+void test_frame_layout_and_decode(void) {
+    RoleSwapFrame frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.command = SIM_COMMAND;
+    frame.phase = ROLE_SWAP_OFFER;
+    frame.sequence = 7;
+    frame.session.rounds = 12;
+    frame.session.totalTicks = 345678;
+
+    uint8_t bytes[sizeof(RoleSwapFrame)];
+    memcpy(bytes, &frame, sizeof(frame));
+    RoleSwapFrame decoded;
+    TEST_ASSERT_TRUE(roleSwapDecode(bytes, sizeof(bytes), SIM_COMMAND, decoded));
+    TEST_ASSERT_EQUAL_UINT8(7, decoded.sequence);
+    TEST_ASSERT_EQUAL_UINT16(12, decoded.session.rounds);
+    TEST_ASSERT_EQUAL_UINT32(345678, decoded.session.totalTicks);
+
+    TEST_ASSERT_FALSE(roleSwapDecode(bytes, sizeof(bytes) - 1, SIM_COMMAND, decoded));
+    TEST_ASSERT_FALSE(roleSwapDecode(bytes, sizeof(bytes), SIM_COMMAND + 1, decoded));
+    bytes[1] = 0;
+    TEST_ASSERT_FALSE(roleSwapDecode(bytes, sizeof(bytes), SIM_COMMAND, decoded));
+}
+
+void test_swap_hands_over_session(void) {
+    sim.runUntil(SECOND_US);
+    sim.nodes[0].session.rounds = 5;
+    sim.nodes[0].session.totalTicks = 123456;
+    sim.nodes[0].session.lastTicks = 24000;
+
+    uint64_t took = sim.swapFrom(0, SECOND_US);
+    TEST_ASSERT_TRUE(took > 0);
+    TEST_ASSERT_TRUE(took < SWAP_BUDGET_US);
+    TEST_ASSERT_EQUAL(1, sim.master());
+    TEST_ASSERT_TRUE(sim.consistent());
+
+    const RoleSwapSession& adopted = sim.nodes[1].session;
+    TEST_ASSERT_EQUAL_UINT16(5, adopted.rounds);
+    TEST_ASSERT_EQUAL_UINT32(123456, adopted.totalTicks);
+    TEST_ASSERT_EQUAL_UINT32(24000, adopted.lastTicks);
+    TEST_ASSERT_EQUAL_UINT16(600, adopted.alertSeconds);
+    TEST_ASSERT_EQUAL_UINT8(70, adopted.ledBrightness);
+    TEST_ASSERT_EQUAL_UINT8(ROLE_SWAP_FLAG_SOUND, adopted.flags);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.nodes[0].swap.swaps());
+    TEST_ASSERT_TRUE(sim.nodes[0].swap.lastSwapUs() < SWAP_BUDGET_US);
+}
+
+void test_slave_request_is_negotiated(void) {
+    sim.runUntil(SECOND_US);
+    uint64_t took = sim.swapFrom(1, SECOND_US);
+    TEST_ASSERT_TRUE(took > 0);
+    TEST_ASSERT_TRUE(took < SWAP_BUDGET_US);
+    TEST_ASSERT_EQUAL(1, sim.master());
+}
+
+void test_shuttle_drill_alternates_without_losing_rounds(void) {
+    // 30个回合：起点锥桶（从机）触发，跑3-4秒，终点锥桶（主机）触发，
+    // 0.5秒后在终点请求交换，1.5秒后从终点（此时应为从机）出发
+    const uint32_t reps = 30;
+    uint64_t expectedTicks = 0;
+    uint64_t worstUs = 0;
+    sim.runUntil(SECOND_US);
+    for (uint32_t rep = 0; rep < reps; rep++) {
+        int startCone = 1 - sim.master();
+        int endCone = sim.master();
+        sim.touch(startCone);
+        uint64_t runUs = 3 * SECOND_US + (rep * 137 % 1000) * MS_US;
+        sim.runUntil(sim.nowUs + runUs);
+        sim.touch(endCone);
+        sim.runUntil(sim.nowUs + 500 * MS_US);
+        TEST_ASSERT_EQUAL_UINT16(rep + 1, sim.nodes[endCone].session.rounds);
+        expectedTicks += runUs / 100;
+
+        uint64_t took = sim.swapFrom(endCone, SECOND_US);
+        TEST_ASSERT_TRUE(took > 0);
+        if (took > worstUs) {
+            worstUs = took;
+        }
+        TEST_ASSERT_EQUAL(startCone, sim.master());
+        sim.runUntil(sim.nowUs + SECOND_US);
+    }
+
+    const RoleSwapSession& session = sim.nodes[sim.master()].session;
+    TEST_ASSERT_EQUAL_UINT16(reps, session.rounds);
+    // 每回合起止各有一个主循环周期和一次无线延迟的量化误差
+    int64_t errorTicks = (int64_t)session.totalTicks - (int64_t)expectedTicks;
+    TEST_ASSERT_TRUE(errorTicks > -(int64_t)reps * 200);
+    TEST_ASSERT_TRUE(errorTicks < (int64_t)reps * 200);
+    TEST_ASSERT_TRUE(worstUs < SWAP_BUDGET_US);
+    TEST_ASSERT_EQUAL_UINT32(reps / 2, sim.nodes[0].swap.swaps());
+    TEST_ASSERT_EQUAL_UINT32(reps / 2, sim.nodes[1].swap.swaps());
+    TEST_ASSERT_EQUAL_UINT32(0, sim.declines);
+}
+
+void test_start_race_declines_and_swaps_after_round(void) {
+    // 主机在1.000s发出OFFER（5ms后到达），从机在1.0037s被触发：拒绝交换，回合照常计完，之后再交换
+    sim.fixedLatencyUs = 5000;
+    sim.runUntil(995 * MS_US);
+    sim.nodes[0].swap.request();
+    sim.touch(1);
+    sim.runUntil(sim.nowUs + 30 * MS_US);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.declines);
+    TEST_ASSERT_EQUAL(0, sim.master());
+    TEST_ASSERT_FALSE(sim.nodes[0].waiting);
+    TEST_ASSERT_TRUE(sim.nodes[0].swap.requested());
+
+    sim.runUntil(sim.nowUs + 2 * SECOND_US);
+    TEST_ASSERT_EQUAL(0, sim.master());
+    sim.touch(0);
+    sim.runUntil(sim.nowUs + 60 * MS_US);
+    TEST_ASSERT_EQUAL(1, sim.master());
+    TEST_ASSERT_TRUE(sim.consistent());
+    TEST_ASSERT_EQUAL_UINT16(1, sim.nodes[1].session.rounds);
+    TEST_ASSERT_TRUE(sim.nodes[1].session.totalTicks > 19000);
+}
+
+void test_lost_accept_is_repeated(void) {
+    sim.runUntil(SECOND_US);
+    sim.dropNext[0][ROLE_SWAP_ACCEPT] = 1;
+    uint64_t took = sim.swapFrom(0, SECOND_US);
+    TEST_ASSERT_TRUE(took > 0);
+    TEST_ASSERT_TRUE(took < SWAP_BUDGET_US);
+    TEST_ASSERT_EQUAL(1, sim.master());
+    TEST_ASSERT_EQUAL_UINT32(1, sim.nodes[0].swap.swaps());
+}
+
+void test_timeout_cancels_accepted_swap(void) {
+    // OFFER送达但之后发往主机的帧全部丢失：主机超时发CANCEL，对端退回从机
+    sim.runUntil(SECOND_US);
+    sim.deadLink[0] = true;
+    sim.nodes[0].swap.request();
+    sim.runUntil(sim.nowUs + 30 * MS_US);
+    TEST_ASSERT_TRUE(sim.nodes[1].swap.isMaster());
+
+    sim.runUntil(sim.nowUs + ROLE_SWAP_TIMEOUT_US + 30 * MS_US);
+    TEST_ASSERT_EQUAL(0, sim.master());
+    TEST_ASSERT_TRUE(sim.consistent());
+    TEST_ASSERT_EQUAL_UINT32(1, sim.nodes[0].swap.failures());
+    TEST_ASSERT_FALSE(sim.nodes[0].swap.requested());
+
+    // 链路恢复后可以再次交换
+    sim.deadLink[0] = false;
+    uint64_t took = sim.swapFrom(0, SECOND_US);
+    TEST_ASSERT_TRUE(took > 0);
+    TEST_ASSERT_EQUAL(1, sim.master());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_frame_layout_and_decode);
+    RUN_TEST(test_swap_hands_over_session);
+    RUN_TEST(test_slave_request_is_negotiated);
+    RUN_TEST(test_shuttle_drill_alternates_without_losing_rounds);
+    RUN_TEST(test_start_race_declines_and_swaps_after_round);
+    RUN_TEST(test_lost_accept_is_repeated);
+    RUN_TEST(test_timeout_cancels_accepted_swap);
+    return UNITY_END();
+}
@@ -0,0 +1,221 @@
+#include <unity.h>
+#include <string.h>
+#include "sensor_trace.h"
+
+#define RING_BYTES 4096
+#define MAX_CAPTURED 1024
+
+static uint8_t ring[RING_BYTES];
+static TraceWriter writer(ring, RING_BYTES);
+
+// 解析结果
+struct Captured {
+    TraceHeader header;
+    TraceFooter footer;
+    bool gotHeader;
+    bool gotEnd;
+    uint64_t edgeUs[MAX_CAPTURED];
+    bool edgeLevel[MAX_CAPTURED];
+    uint16_t edgeCount;
+    uint16_t samples[MAX_CAPTURED];
+    uint64_t sampleUs[MAX_CAPTURED];
+    uint16_t sampleCount;
+};
+
+static Captured captured;
+
+static void onHeader(const TraceHeader& header, void* context) {
+    Captured* c = (Captured*)context;
+    c->header = header;
+    c->gotHeader = true;
+}
+
+static void onEdge(uint64_t atUs, bool level, void* context) {
+    Captured* c = (Captured*)context;
+    c->edgeUs[c->edgeCount] = atUs;
+    c->edgeLevel[c->edgeCount] = level;
+    c->edgeCount++;
+}
+
+static void onSamples(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs, void* context) {
+    Captured* c = (Captured*)context;
+    for (uint16_t i = 0; i < count; i++) {
+        c->samples[c->sampleCount] = samples[i];
+        c->sampleUs[c->sampleCount] = firstUs + (uint64_t)i * periodUs;
+        c->sampleCount++;
+    }
+}
+
+static void onEnd(const TraceFooter& footer, void* context) {
+    Captured* c = (Captured*)context;
+    c->footer = footer;
+    c->gotEnd = true;
+}
+
+static const TraceCallbacks callbacks = {onHeader, onEdge, onSamples, onEnd, &captured};
+
+// 取出环形缓冲区全部字节
+static size_t drain(uint8_t* out, size_t maxLength) {
+    size_t total = 0;
+    size_t n;
+    while ((n = writer.read(out + total, maxLength - total)) > 0) {
+        total += n;
+    }
+    return total;
+}
+
+void setUp(void) {
+    memset(&captured, 0, sizeof(captured));
+}
+
+void tearDown(void) {}
+
+void test_edges_round_trip_with_64bit_times(void) {
+    const uint64_t base = 0x1234567890ULL;
+    writer.start(TRACE_KIND_EDGES, 0, 200);
+    for (int i = 0; i < 100; i++) {
+        writer.recordEdge(base + i * 1500ULL + (i & 3), (i & 1) == 0);
+    }
+    writer.stop(2);
+
+    static uint8_t stream[RING_BYTES];
+    size_t length = drain(stream, sizeof(stream));
+    TraceParser parser(callbacks);
+    parser.feed(stream, length);
+
+    TEST_ASSERT_TRUE(captured.gotHeader);
+    TEST_ASSERT_EQUAL_UINT8(TRACE_KIND_EDGES, captured.header.kind);
+    TEST_ASSERT_EQUAL_UINT32(200, captured.header.debounceMs);
+    TEST_ASSERT_EQUAL_UINT16(100, captured.edgeCount);
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT_EQUAL_UINT64(base + i * 1500ULL + (i & 3), captured.edgeUs[i]);
+        TEST_ASSERT_EQUAL((i & 1) == 0, captured.edgeLevel[i]);
+    }
+    TEST_ASSERT_TRUE(captured.gotEnd);
+    TEST_ASSERT_EQUAL_UINT32(2, captured.footer.droppedEdges);
+    TEST_ASSERT_EQUAL_UINT32(0, parser.badChunks());
+    // 每个边沿约2字节，远小于原始的9字节
+    TEST_ASSERT_LESS_THAN(100 * 3, length);
+}
+
+void test_samples_split_across_chunks(void) {
+    static uint16_t samples[600];
+    for (int i = 0; i < 600; i++) {
+        samples[i] = (uint16_t)(2048 + ((i * 37) % 801) - 400);
+    }
+    samples[300] = 4095;
+    samples[301] = 0;
+
+    writer.start(TRACE_KIND_SAMPLES, 8000, 200);
+    writer.recordSamples(samples, 600, 5000000, 125);
+    writer.stop();
+
+    static uint8_t stream[RING_BYTES];
+    size_t length = drain(stream, sizeof(stream));
+    TraceParser parser(callbacks);
+    // 逐字节输入，验证跨调用的分段解析
+    for (size_t i = 0; i < length; i++) {
+        parser.feed(stream + i, 1);
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(600, captured.sampleCount);
+    TEST_ASSERT_GREATER_THAN(4, parser.chunks());
+    for (int i = 0; i < 600; i++) {
+        TEST_ASSERT_EQUAL_UINT16(samples[i], captured.samples[i]);
+        TEST_ASSERT_EQUAL_UINT64(5000000 + i * 125ULL, captured.sampleUs[i]);
+    }
+}
+
+void test_ring_overflow_drops_whole_chunks(void) {
+    static uint8_t small[300];
+    TraceWriter tiny(small, sizeof(small));
+    static uint16_t samples[400];
+    for (int i = 0; i < 400; i++) {
+        samples[i] = 2000 + (i & 7);
+    }
+
+    tiny.start(TRACE_KIND_SAMPLES, 8000, 200);
+    tiny.recordSamples(samples, 400, 0, 125);
+    TEST_ASSERT_GREATER_THAN(0, tiny.droppedChunks());
+
+    static uint8_t stream[600];
+    size_t length = 0;
+    size_t n;
+    while ((n = tiny.read(stream + length, sizeof(stream) - length)) > 0) {
+        length += n;
+    }
+    tiny.stop();
+    while ((n = tiny.read(stream + length, sizeof(stream) - length)) > 0) {
+        length += n;
+    }
+
+    TraceParser parser(callbacks);
+    parser.feed(stream, length);
+    TEST_ASSERT_EQUAL_UINT32(0, parser.badChunks());
+    TEST_ASSERT_TRUE(captured.gotEnd);
+    TEST_ASSERT_EQUAL_UINT32(tiny.droppedChunks(), captured.footer.droppedChunks);
+    TEST_ASSERT_LESS_THAN(400, captured.sampleCount);
+}
+
+void test_resync_after_text_and_corruption(void) {
+    writer.start(TRACE_KIND_EDGES, 0, 150);
+    writer.recordEdge(1000, false);
+    writer.flush();
+    writer.recordEdge(2000, true);
+    writer.flush();
+    writer.recordEdge(3000, false);
+    writer.stop();
+
+    static uint8_t stream[RING_BYTES];
+    const char* log = "训练开始\n\xA5 noise \xA5\x5A\x02";
+    size_t prefix = strlen(log);
+    memcpy(stream, log, prefix);
+    size_t length = prefix + drain(stream + prefix, sizeof(stream) - prefix);
+
+    // 破坏第二个边沿块的负载：该块被丢弃，其余块正常解析
+    size_t second = prefix;
+    int found = 0;
+    for (size_t i = prefix; i + 2 < length; i++) {
+        if (stream[i] == TRACE_SYNC_0 && stream[i + 1] == TRACE_SYNC_1 && stream[i + 2] == TRACE_CHUNK_EDGES) {
+            if (++found == 2) {
+                second = i;
+                break;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(2, found);
+    stream[second + TRACE_CHUNK_HEADER_BYTES + 9] ^= 0x40;
+
+    TraceParser parser(callbacks);
+    parser.feed(stream, length);
+
+    TEST_ASSERT_TRUE(captured.gotHeader);
+    TEST_ASSERT_EQUAL_UINT32(150, captured.header.debounceMs);
+    TEST_ASSERT_EQUAL_UINT16(2, captured.edgeCount);
+    TEST_ASSERT_EQUAL_UINT64(1000, captured.edgeUs[0]);
+    TEST_ASSERT_EQUAL_UINT64(3000, captured.edgeUs[1]);
+    TEST_ASSERT_TRUE(captured.gotEnd);
+    TEST_ASSERT_GREATER_THAN(0, parser.badChunks());
+    TEST_ASSERT_GREATER_THAN(prefix - 1, parser.skippedBytes());
+}
+
+void test_score_hits_against_truth(void) {
+    const uint64_t truth[] = {1000000, 2000000, 3000000, 4000000};
+    // 1.01s匹配；1.05s为回弹误触发；3s漏检；4.004s在容差内
+    const uint64_t detected[] = {1010000, 1050000, 2000000, 4004000, 5000000};
+    TraceScore score = scoreHits(detected, 5, truth, 4, 20000);
+    TEST_ASSERT_EQUAL_UINT32(5, score.detected);
+    TEST_ASSERT_EQUAL_UINT32(3, score.matched);
+    TEST_ASSERT_EQUAL_UINT32(2, score.falseHits);
+    TEST_ASSERT_EQUAL_UINT32(1, score.missed);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_edges_round_trip_with_64bit_times);
+    RUN_TEST(test_samples_split_across_chunks);
+    RUN_TEST(test_ring_overflow_drops_whole_chunks);
+    RUN_TEST(test_resync_after_text_and_corruption);
+    RUN_TEST(test_score_hits_against_truth);
+    return UNITY_END();
+}
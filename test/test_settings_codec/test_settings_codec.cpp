@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <string.h>
+#include "settings_codec.h"
+#include "crc32.h"
+
+static SystemSettings defaults;
+static SystemSettings custom;
+
+static void resealCrc(uint8_t* blob, size_t size) {
+    uint32_t crc = crc32Update(0, blob, size - 4);
+    for (int i = 0; i < 4; i++) {
+        blob[size - 4 + i] = crc >> (8 * i);
+    }
+}
+
+void setUp(void) {
+    memset(&defaults, 0, sizeof(defaults));
+    settingsApplyDefaults(defaults);
+
+    custom = defaults;
+    custom.soundEnabled = false;
+    custom.ledColor = LED_COLOR_PURPLE;
+    custom.ledBrightness = 35;
+    custom.alertDuration = 240;
+    const uint8_t mac[6] = {0x24, 0x6F, 0x28, 0xAA, 0xBB, 0xCC};
+    memcpy(custom.pairedDeviceMac, mac, 6);
+    custom.hasPairedDevice = true;
+}
+
+void tearDown(void) {}
+
+void test_roundtrip(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    TEST_ASSERT_EQUAL(SETTINGS_BLOB_SIZE, settingsEncode(custom, blob, sizeof(blob)));
+
+    SystemSettings decoded = defaults;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_OK, settingsDecode(blob, sizeof(blob), decoded));
+    TEST_ASSERT_FALSE(decoded.soundEnabled);
+    TEST_ASSERT_EQUAL(LED_COLOR_PURPLE, decoded.ledColor);
+    TEST_ASSERT_EQUAL(35, decoded.ledBrightness);
+    TEST_ASSERT_EQUAL(240, decoded.alertDuration);
+    TEST_ASSERT_TRUE(decoded.hasPairedDevice);
+    TEST_ASSERT_EQUAL_MEMORY(custom.pairedDeviceMac, decoded.pairedDeviceMac, 6);
+}
+
+void test_encoding_is_stable(void) {
+    // 编码只依赖字段值，相同设置得到相同字节（用于跳过无变化的写入）
+    uint8_t a[SETTINGS_BLOB_SIZE];
+    uint8_t b[SETTINGS_BLOB_SIZE];
+    SystemSettings other = custom;
+    other.year = 2030;
+    other.minute = 59;
+    settingsEncode(custom, a, sizeof(a));
+    settingsEncode(other, b, sizeof(b));
+    TEST_ASSERT_EQUAL_MEMORY(a, b, sizeof(a));
+    TEST_ASSERT_EQUAL(0, settingsEncode(custom, a, sizeof(a) - 1));
+}
+
+void test_corruption_leaves_settings_untouched(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    settingsEncode(custom, blob, sizeof(blob));
+
+    SystemSettings decoded = defaults;
+    blob[SETTINGS_HEADER_SIZE + SETTINGS_OFFSET_BRIGHTNESS] ^= 0x10;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_BAD_CRC, settingsDecode(blob, sizeof(blob), decoded));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &decoded, sizeof(decoded));
+
+    settingsEncode(custom, blob, sizeof(blob));
+    blob[0] ^= 0xFF;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_BAD_MAGIC, settingsDecode(blob, sizeof(blob), decoded));
+    settingsEncode(custom, blob, sizeof(blob));
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_BAD_LENGTH, settingsDecode(blob, sizeof(blob) - 1, decoded));
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_BAD_LENGTH, settingsDecode(blob, 3, decoded));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &decoded, sizeof(decoded));
+}
+
+void test_newer_schema_is_rejected(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    settingsEncode(custom, blob, sizeof(blob));
+    blob[2] = SETTINGS_SCHEMA_VERSION + 1;
+    resealCrc(blob, sizeof(blob));
+
+    SystemSettings decoded = defaults;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_UNSUPPORTED, settingsDecode(blob, sizeof(blob), decoded));
+    TEST_ASSERT_EQUAL_MEMORY(&defaults, &decoded, sizeof(decoded));
+}
+
+void test_short_payload_keeps_defaults_for_missing_fields(void) {
+    // 只含前3个字段的payload（模拟较早的追加式布局）
+    uint8_t full[SETTINGS_BLOB_SIZE];
+    settingsEncode(custom, full, sizeof(full));
+
+    uint8_t blob[SETTINGS_HEADER_SIZE + 3 + 4];
+    memcpy(blob, full, SETTINGS_HEADER_SIZE + 3);
+    blob[3] = 3;
+    resealCrc(blob, sizeof(blob));
+
+    SystemSettings decoded = defaults;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_OK, settingsDecode(blob, sizeof(blob), decoded));
+    TEST_ASSERT_EQUAL(LED_COLOR_PURPLE, decoded.ledColor);
+    TEST_ASSERT_EQUAL(35, decoded.ledBrightness);
+    TEST_ASSERT_EQUAL(DEFAULT_ALERT_DURATION, decoded.alertDuration);
+    // 没有MAC字段时不能认为已配对
+    TEST_ASSERT_FALSE(decoded.hasPairedDevice);
+}
+
+void test_out_of_range_values_are_repaired(void) {
+    uint8_t blob[SETTINGS_BLOB_SIZE];
+    settingsEncode(custom, blob, sizeof(blob));
+    blob[SETTINGS_HEADER_SIZE + SETTINGS_OFFSET_LED_COLOR] = 200;
+    blob[SETTINGS_HEADER_SIZE + SETTINGS_OFFSET_BRIGHTNESS] = 150;
+    blob[SETTINGS_HEADER_SIZE + SETTINGS_OFFSET_ALERT] = 5;
+    blob[SETTINGS_HEADER_SIZE + SETTINGS_OFFSET_ALERT + 1] = 0;
+    resealCrc(blob, sizeof(blob));
+
+    SystemSettings decoded = defaults;
+    TEST_ASSERT_EQUAL(SETTINGS_DECODE_OK, settingsDecode(blob, sizeof(blob), decoded));
+    TEST_ASSERT_EQUAL(DEFAULT_LED_COLOR, decoded.ledColor);
+    TEST_ASSERT_EQUAL(DEFAULT_LED_BRIGHTNESS, decoded.ledBrightness);
+    TEST_ASSERT_EQUAL(DEFAULT_ALERT_DURATION, decoded.alertDuration);
+    TEST_ASSERT_FALSE(decoded.soundEnabled);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_roundtrip);
+    RUN_TEST(test_encoding_is_stable);
+    RUN_TEST(test_corruption_leaves_settings_untouched);
+    RUN_TEST(test_newer_schema_is_rejected);
+    RUN_TEST(test_short_payload_keeps_defaults_for_missing_fields);
+    RUN_TEST(test_out_of_range_values_are_repaired);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include <unity.h>
+#include "time_sync.h"
+
+#define EPOCH_S 1760000000UL
+
+static TimeSyncMessage makeMessage(uint16_t sequence, uint32_t seconds, uint32_t micros, uint8_t flags = 0) {
+    TimeSyncMessage message = {};
+    message.command = 0x30;
+    message.flags = flags;
+    message.sequence = sequence;
+    message.epochSeconds = seconds;
+    message.microseconds = micros;
+    message.utcOffset = 8 * 3600;
+    return message;
+}
+
+static int64_t epochUs(uint32_t seconds, uint32_t micros) {
+    return (int64_t)seconds * 1000000 + micros;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_first_message_steps_clock(void) {
+    WallClockSync clock;
+    TEST_ASSERT_FALSE(clock.valid());
+    TEST_ASSERT_EQUAL_INT64(0, clock.epochMicros(5000000));
+
+    TEST_ASSERT_EQUAL(TIME_SYNC_STEPPED, clock.apply(makeMessage(1, EPOCH_S, 250000), 5000000));
+    TEST_ASSERT_TRUE(clock.valid());
+    TEST_ASSERT_EQUAL_INT32(8 * 3600, clock.utcOffset());
+
+    // 接收时刻对应主机时间加上估计延迟，之后随本地单调时钟前进
+    int64_t expected = epochUs(EPOCH_S, 250000) + TIME_SYNC_LATENCY_US;
+    TEST_ASSERT_EQUAL_INT64(expected, clock.epochMicros(5000000));
+    TEST_ASSERT_EQUAL_INT64(expected + 1234567, clock.epochMicros(5000000 + 1234567));
+}
+
+void test_small_error_is_slewed(void) {
+    WallClockSync clock;
+    clock.apply(makeMessage(1, EPOCH_S, 0), 1000000);
+
+    // 3秒后主机比本地快800us
+    int64_t local = 4000000;
+    TEST_ASSERT_EQUAL(TIME_SYNC_SLEWED, clock.apply(makeMessage(2, EPOCH_S + 3, 800), local));
+    TEST_ASSERT_EQUAL_INT64(800, clock.lastErrorUs());
+    int64_t base = epochUs(EPOCH_S + 3, 0) + TIME_SYNC_LATENCY_US;
+    TEST_ASSERT_EQUAL_INT64(base + 800 / TIME_SYNC_SLEW_DIVISOR, clock.epochMicros(local));
+
+    // 连续同一误差逐步收敛
+    for (uint16_t seq = 3; seq < 40; seq++) {
+        local += 3000000;
+        clock.apply(makeMessage(seq, EPOCH_S + 3 * (seq - 1), 800), local);
+    }
+    TEST_ASSERT_INT64_WITHIN(3, epochUs(EPOCH_S + 3 * 38, 800) + TIME_SYNC_LATENCY_US, clock.epochMicros(local));
+}
+
+void test_large_error_steps_clock(void) {
+    WallClockSync clock;
+    clock.apply(makeMessage(1, EPOCH_S, 0), 1000000);
+
+    TEST_ASSERT_EQUAL(TIME_SYNC_STEPPED, clock.apply(makeMessage(2, EPOCH_S + 60, 0), 2000000));
+    TEST_ASSERT_EQUAL_INT64(59000000, clock.lastErrorUs());
+    TEST_ASSERT_EQUAL_INT64(epochUs(EPOCH_S + 60, 0) + TIME_SYNC_LATENCY_US, clock.epochMicros(2000000));
+
+    // 时间回拨同样直接跳变
+    TEST_ASSERT_EQUAL(TIME_SYNC_STEPPED, clock.apply(makeMessage(3, EPOCH_S - 3600, 0), 3000000));
+    TEST_ASSERT_EQUAL_INT64(epochUs(EPOCH_S - 3600, 0) + TIME_SYNC_LATENCY_US, clock.epochMicros(3000000));
+}
+
+void test_manual_set_steps_even_when_close(void) {
+    WallClockSync clock;
+    clock.apply(makeMessage(1, EPOCH_S, 0), 1000000);
+
+    TEST_ASSERT_EQUAL(TIME_SYNC_STEPPED,
+                      clock.apply(makeMessage(2, EPOCH_S + 1, 5000, TIME_SYNC_FLAG_SET), 2000000));
+    TEST_ASSERT_EQUAL_INT64(epochUs(EPOCH_S + 1, 5000) + TIME_SYNC_LATENCY_US, clock.epochMicros(2000000));
+}
+
+void test_duplicate_is_ignored(void) {
+    WallClockSync clock;
+    clock.apply(makeMessage(7, EPOCH_S, 0), 1000000);
+    int64_t before = clock.epochMicros(1500000);
+
+    // 重传的同一消息晚到，不能把时钟拉回
+    TEST_ASSERT_EQUAL(TIME_SYNC_DUPLICATE, clock.apply(makeMessage(7, EPOCH_S, 0), 1500000));
+    TEST_ASSERT_EQUAL_INT64(before, clock.epochMicros(1500000));
+    TEST_ASSERT_EQUAL_UINT32(1, clock.syncCount());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_message_steps_clock);
+    RUN_TEST(test_small_error_is_slewed);
+    RUN_TEST(test_large_error_steps_clock);
+    RUN_TEST(test_manual_set_steps_even_when_close);
+    RUN_TEST(test_duplicate_is_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,398 @@
+#include <unity.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "training_log.h"
+#include "crc32.h"
+
+// 主机文件存储 - 每段一个普通文件，行为与LittleFS后端一致
+class FileLogStorage : public LogStorage {
+public:
+    explicit FileLogStorage(const char* directory) : directory(directory) {}
+
+    bool begin() override { return true; }
+
+    int listSegments(uint32_t* ids, int maxIds) override {
+        DIR* dir = opendir(directory);
+        if (!dir) return 0;
+        int count = 0;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr && count < maxIds) {
+            char* end = nullptr;
+            unsigned long id = strtoul(entry->d_name, &end, 16);
+            if (end == entry->d_name + 8 && strcmp(end, ".seg") == 0) {
+                ids[count++] = id;
+            }
+        }
+        closedir(dir);
+        return count;
+    }
+
+    int32_t segmentSize(uint32_t id) override {
+        struct stat st;
+        return stat(path(id), &st) == 0 ? (int32_t)st.st_size : -1;
+    }
+
+    int32_t read(uint32_t id, uint32_t offset, void* buffer, uint32_t length) override {
+        FILE* file = fopen(path(id), "rb");
+        if (!file) return -1;
+        fseek(file, offset, SEEK_SET);
+        int32_t result = fread(buffer, 1, length, file);
+        fclose(file);
+        return result;
+    }
+
+    bool append(uint32_t id, const void* data, uint32_t length) override {
+        if (failAppends) return false;
+        FILE* file = fopen(path(id), "ab");
+        if (!file) return false;
+        size_t written = fwrite(data, 1, length, file);
+        fclose(file);
+        return written == length;
+    }
+
+    bool truncate(uint32_t id, uint32_t size) override { return ::truncate(path(id), size) == 0; }
+    bool remove(uint32_t id) override { return ::remove(path(id)) == 0; }
+
+    const char* path(uint32_t id) {
+        snprintf(pathBuffer, sizeof(pathBuffer), "%s/%08x.seg", directory, id);
+        return pathBuffer;
+    }
+
+    bool failAppends = false;
+
+private:
+    const char* directory;
+    char pathBuffer[256];
+};
+
+static char testDir[64];
+
+static PackedTrainingRecord makeRecord(uint32_t i) {
+    return TrainingRecordStore::pack(1700000000UL + i * 60, (1000 + i) * 1000ULL, MODE_VIBRATION_TRAINING,
+                                     RECORD_FLAG_COMPLETED | RECORD_FLAG_CLOCK_VALID);
+}
+
+struct Collected {
+    uint32_t count;
+    uint32_t firstSequence;
+    uint32_t lastSequence;
+    bool ordered;
+    bool matches;
+};
+
+static void collect(const PackedTrainingRecord& record, uint32_t sequence, void* context) {
+    Collected* out = (Collected*)context;
+    if (out->count == 0) {
+        out->firstSequence = sequence;
+    } else if (sequence != out->lastSequence + 1) {
+        out->ordered = false;
+    }
+    PackedTrainingRecord expected = makeRecord(sequence);
+    if (memcmp(&expected, &record, sizeof(record)) != 0) {
+        out->matches = false;
+    }
+    out->lastSequence = sequence;
+    out->count++;
+}
+
+static Collected collectFrom(TrainingLog& log, uint32_t fromSequence) {
+    Collected out = {0, 0, 0, true, true};
+    log.forEach(fromSequence, collect, &out);
+    return out;
+}
+
+static void appendRecords(TrainingLog& log, uint32_t from, uint32_t count, uint32_t flushEvery) {
+    for (uint32_t i = from; i < from + count; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i, log.append(makeRecord(i)));
+        if (flushEvery && (i + 1) % flushEvery == 0) {
+            TEST_ASSERT_TRUE(log.flush());
+        }
+    }
+    TEST_ASSERT_TRUE(log.flush());
+}
+
+void setUp(void) {
+    strcpy(testDir, "/tmp/tlog_test_XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(testDir));
+}
+
+void tearDown(void) {
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf %s", testDir);
+    system(command);
+}
+
+void test_roundtrip_and_reopen(void) {
+    FileLogStorage storage(testDir);
+    {
+        TrainingLog log(storage);
+        TEST_ASSERT_TRUE(log.begin());
+        TEST_ASSERT_EQUAL_UINT32(0, log.nextSequence());
+        appendRecords(log, 0, 100, 10);
+        TEST_ASSERT_EQUAL_UINT32(100, log.persistedRecords());
+    }
+
+    TrainingLog reopened(storage);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(100, reopened.nextSequence());
+    TEST_ASSERT_EQUAL(0, reopened.lastScan().repairedBytes);
+
+    Collected all = collectFrom(reopened, 0);
+    TEST_ASSERT_EQUAL_UINT32(100, all.count);
+    TEST_ASSERT_TRUE(all.ordered);
+    TEST_ASSERT_TRUE(all.matches);
+
+    Collected tail = collectFrom(reopened, 95);
+    TEST_ASSERT_EQUAL_UINT32(5, tail.count);
+    TEST_ASSERT_EQUAL_UINT32(95, tail.firstSequence);
+
+    // 重新打开后继续追加到同一段
+    appendRecords(reopened, 100, 5, 0);
+    TEST_ASSERT_EQUAL(1, reopened.segmentCount());
+    TEST_ASSERT_EQUAL_UINT32(105, collectFrom(reopened, 0).count);
+}
+
+void test_unflushed_records_are_not_persisted(void) {
+    FileLogStorage storage(testDir);
+    {
+        TrainingLog log(storage);
+        TEST_ASSERT_TRUE(log.begin());
+        appendRecords(log, 0, 20, 0);
+        log.append(makeRecord(20));
+        log.append(makeRecord(21));
+        TEST_ASSERT_EQUAL(2, log.pendingRecords());
+    }
+
+    TrainingLog reopened(storage);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(20, reopened.nextSequence());
+}
+
+void test_torn_write_is_truncated(void) {
+    FileLogStorage storage(testDir);
+    {
+        TrainingLog log(storage);
+        TEST_ASSERT_TRUE(log.begin());
+        appendRecords(log, 0, 30, 10);
+    }
+
+    // 模拟断电：最后一个块只写入了一半
+    int32_t intactSize = storage.segmentSize(1);
+    uint8_t partial[LOG_BLOCK_BYTES(10)];
+    memset(partial, 0, sizeof(partial));
+    LogBlockHeader header = {LOG_BLOCK_MAGIC, 10, 30};
+    memcpy(partial, &header, sizeof(header));
+    TEST_ASSERT_TRUE(storage.append(1, partial, sizeof(partial) / 2));
+
+    TrainingLog reopened(storage);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(sizeof(partial) / 2, reopened.lastScan().repairedBytes);
+    TEST_ASSERT_EQUAL_INT32(intactSize, storage.segmentSize(1));
+    TEST_ASSERT_EQUAL_UINT32(30, reopened.nextSequence());
+
+    // 修复后可以继续正常追加
+    appendRecords(reopened, 30, 10, 0);
+    TrainingLog again(storage);
+    TEST_ASSERT_TRUE(again.begin());
+    Collected all = collectFrom(again, 0);
+    TEST_ASSERT_EQUAL_UINT32(40, all.count);
+    TEST_ASSERT_TRUE(all.ordered);
+    TEST_ASSERT_TRUE(all.matches);
+}
+
+void test_corrupted_block_detected_by_crc(void) {
+    FileLogStorage storage(testDir);
+    {
+        TrainingLog log(storage);
+        TEST_ASSERT_TRUE(log.begin());
+        appendRecords(log, 0, 30, 10);
+    }
+
+    // 翻转第二个块中的一个记录字节
+    uint32_t offset = sizeof(LogSegmentHeader) + LOG_BLOCK_BYTES(10) + sizeof(LogBlockHeader) + 3;
+    FILE* file = fopen(storage.path(1), "r+b");
+    TEST_ASSERT_NOT_NULL(file);
+    fseek(file, offset, SEEK_SET);
+    int value = fgetc(file);
+    fseek(file, offset, SEEK_SET);
+    fputc(value ^ 0x40, file);
+    fclose(file);
+
+    TrainingLog reopened(storage);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(10, reopened.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(2 * LOG_BLOCK_BYTES(10), reopened.lastScan().repairedBytes);
+
+    Collected all = collectFrom(reopened, 0);
+    TEST_ASSERT_EQUAL_UINT32(10, all.count);
+    TEST_ASSERT_TRUE(all.matches);
+}
+
+void test_rotation_sealing_and_retention(void) {
+    FileLogStorage storage(testDir);
+    // 每段最多容纳3个10条记录的块
+    const uint32_t segmentBytes = sizeof(LogSegmentHeader) + 3 * LOG_BLOCK_BYTES(10) + sizeof(LogSegmentTrailer);
+    {
+        TrainingLog log(storage, segmentBytes, 4);
+        TEST_ASSERT_TRUE(log.begin());
+        appendRecords(log, 0, 180, 10);
+
+        // 18个块 -> 6段，只保留最新4段
+        TEST_ASSERT_EQUAL(4, log.segmentCount());
+        TEST_ASSERT_EQUAL_UINT32(3, log.segment(0).id);
+        TEST_ASSERT_EQUAL_UINT32(60, log.segment(0).firstSequence);
+        TEST_ASSERT_TRUE(log.segment(0).sealed);
+        TEST_ASSERT_FALSE(log.segment(3).sealed);
+        TEST_ASSERT_EQUAL(-1, storage.segmentSize(1));
+        TEST_ASSERT_EQUAL(-1, storage.segmentSize(2));
+        for (int i = 0; i < log.segmentCount(); i++) {
+            TEST_ASSERT_TRUE(log.segment(i).size <= segmentBytes);
+        }
+    }
+
+    TrainingLog reopened(storage, segmentBytes, 4);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL(3, reopened.lastScan().sealedSegments);
+    TEST_ASSERT_EQUAL(1, reopened.lastScan().scannedSegments);
+    TEST_ASSERT_EQUAL_UINT32(180, reopened.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(120, reopened.persistedRecords());
+
+    Collected all = collectFrom(reopened, 0);
+    TEST_ASSERT_EQUAL_UINT32(120, all.count);
+    TEST_ASSERT_EQUAL_UINT32(60, all.firstSequence);
+    TEST_ASSERT_TRUE(all.ordered);
+    TEST_ASSERT_TRUE(all.matches);
+}
+
+void test_unsealed_middle_segment_is_sealed_on_boot(void) {
+    FileLogStorage storage(testDir);
+    const uint32_t segmentBytes = sizeof(LogSegmentHeader) + 2 * LOG_BLOCK_BYTES(10) + sizeof(LogSegmentTrailer);
+    {
+        TrainingLog log(storage, segmentBytes, 8);
+        TEST_ASSERT_TRUE(log.begin());
+        appendRecords(log, 0, 40, 10);
+    }
+
+    // 模拟封存前断电：去掉第1段的段尾
+    int32_t sealedSize = storage.segmentSize(1);
+    TEST_ASSERT_TRUE(storage.truncate(1, sealedSize - sizeof(LogSegmentTrailer)));
+
+    {
+        TrainingLog reopened(storage, segmentBytes, 8);
+        TEST_ASSERT_TRUE(reopened.begin());
+        TEST_ASSERT_TRUE(reopened.segment(0).sealed);
+        TEST_ASSERT_EQUAL_INT32(sealedSize, storage.segmentSize(1));
+        TEST_ASSERT_EQUAL_UINT32(40, collectFrom(reopened, 0).count);
+    }
+
+    TrainingLog again(storage, segmentBytes, 8);
+    TEST_ASSERT_TRUE(again.begin());
+    TEST_ASSERT_EQUAL(1, again.lastScan().sealedSegments);
+}
+
+void test_boot_scan_reads_only_headers_and_trailers(void) {
+    FileLogStorage storage(testDir);
+    const uint32_t segmentBytes = sizeof(LogSegmentHeader) + 8 * LOG_BLOCK_BYTES(LOG_BATCH_MAX) + sizeof(LogSegmentTrailer);
+    {
+        TrainingLog log(storage, segmentBytes, LOG_MAX_SEGMENTS);
+        TEST_ASSERT_TRUE(log.begin());
+        // 20个封存段 + 1个只有一个块的活动段
+        appendRecords(log, 0, 20 * 8 * LOG_BATCH_MAX + 10, LOG_BATCH_MAX);
+    }
+
+    TrainingLog reopened(storage, segmentBytes, LOG_MAX_SEGMENTS);
+    TEST_ASSERT_TRUE(reopened.begin());
+    const LogScanReport& scan = reopened.lastScan();
+    TEST_ASSERT_EQUAL(20, scan.sealedSegments);
+    TEST_ASSERT_EQUAL(1, scan.scannedSegments);
+    // 封存段只读段头和段尾；活动段读段头、尝试读段尾，再校验唯一的块
+    uint32_t expectedBytes = 20 * (sizeof(LogSegmentHeader) + sizeof(LogSegmentTrailer))
+                           + sizeof(LogSegmentHeader) + sizeof(LogSegmentTrailer) + LOG_BLOCK_BYTES(10);
+    TEST_ASSERT_EQUAL_UINT32(expectedBytes, scan.bytesRead);
+    TEST_ASSERT_EQUAL_UINT32(20 * 8 * LOG_BATCH_MAX + 10, reopened.nextSequence());
+}
+
+void test_failed_flush_keeps_batch_for_retry(void) {
+    FileLogStorage storage(testDir);
+    TrainingLog log(storage);
+    TEST_ASSERT_TRUE(log.begin());
+    appendRecords(log, 0, 10, 0);
+
+    storage.failAppends = true;
+    for (uint32_t i = 10; i < 15; i++) {
+        log.append(makeRecord(i));
+    }
+    TEST_ASSERT_FALSE(log.flush());
+    TEST_ASSERT_EQUAL(5, log.pendingRecords());
+
+    storage.failAppends = false;
+    TEST_ASSERT_TRUE(log.flush());
+    TEST_ASSERT_EQUAL_UINT32(15, collectFrom(log, 0).count);
+}
+
+static void collectRaw(const PackedTrainingRecord& record, uint32_t sequence, void* context) {
+    ((PackedTrainingRecord*)context)[sequence] = record;
+}
+
+void test_v1_segment_is_upgraded_and_sealed(void) {
+    FileLogStorage storage(testDir);
+
+    // 手工写入版本1的未封存段，用时单位为毫秒
+    LogSegmentHeader header = {LOG_SEGMENT_MAGIC, 1, sizeof(LogSegmentHeader), 1, 0};
+    header.crc = crc32Update(0, &header, offsetof(LogSegmentHeader, crc));
+    uint32_t roundFlags = RECORD_FLAG_COMPLETED | RECORD_FLAG_CLOCK_VALID;
+    uint32_t sessionFlags = roundFlags | RECORD_FLAG_SESSION;
+    PackedTrainingRecord v1[2] = {
+        {1700000000UL, 1234 | (MODE_VIBRATION_TRAINING << RECORD_MODE_SHIFT) | (roundFlags << RECORD_FLAGS_SHIFT)},
+        {1700000060UL, 90000 | (MODE_VIBRATION_TRAINING << RECORD_MODE_SHIFT) | (sessionFlags << RECORD_FLAGS_SHIFT)},
+    };
+    LogBlockHeader block = {LOG_BLOCK_MAGIC, 2, 0};
+    uint32_t crc = crc32Update(0, &block, sizeof(block));
+    crc = crc32Update(crc, v1, sizeof(v1));
+    TEST_ASSERT_TRUE(storage.append(1, &header, sizeof(header)));
+    TEST_ASSERT_TRUE(storage.append(1, &block, sizeof(block)));
+    TEST_ASSERT_TRUE(storage.append(1, v1, sizeof(v1)));
+    TEST_ASSERT_TRUE(storage.append(1, &crc, sizeof(crc)));
+
+    TrainingLog log(storage);
+    TEST_ASSERT_TRUE(log.begin());
+    TEST_ASSERT_EQUAL(1, log.segmentCount());
+    TEST_ASSERT_TRUE(log.segment(0).sealed);
+    TEST_ASSERT_EQUAL(1, log.segment(0).version);
+    TEST_ASSERT_EQUAL_UINT32(2, log.nextSequence());
+
+    // 读取时换算为当前单位，模式和标志不变
+    PackedTrainingRecord upgraded[3];
+    log.forEach(0, collectRaw, upgraded);
+    TEST_ASSERT_EQUAL_UINT64(1234000, TrainingRecordStore::durationUs(upgraded[0]));
+    TEST_ASSERT_EQUAL_UINT64(90000000, TrainingRecordStore::durationUs(upgraded[1]));
+    TEST_ASSERT_TRUE(TrainingRecordStore::unpack(upgraded[0]).completed);
+    TEST_ASSERT_EQUAL(MODE_VIBRATION_TRAINING, TrainingRecordStore::unpack(upgraded[1]).mode);
+
+    // 新记录写入新的当前版本段
+    log.append(makeRecord(2));
+    TEST_ASSERT_TRUE(log.flush());
+    TEST_ASSERT_EQUAL(2, log.segmentCount());
+    TEST_ASSERT_EQUAL(LOG_FORMAT_VERSION, log.segment(1).version);
+    log.forEach(2, collectRaw, upgraded);
+    TEST_ASSERT_EQUAL_UINT64(1002000, TrainingRecordStore::durationUs(upgraded[2]));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_roundtrip_and_reopen);
+    RUN_TEST(test_unflushed_records_are_not_persisted);
+    RUN_TEST(test_torn_write_is_truncated);
+    RUN_TEST(test_corrupted_block_detected_by_crc);
+    RUN_TEST(test_rotation_sealing_and_retention);
+    RUN_TEST(test_unsealed_middle_segment_is_sealed_on_boot);
+    RUN_TEST(test_boot_scan_reads_only_headers_and_trailers);
+    RUN_TEST(test_failed_flush_keeps_batch_for_retry);
+    RUN_TEST(test_v1_segment_is_upgraded_and_sealed);
+    return UNITY_END();
+}
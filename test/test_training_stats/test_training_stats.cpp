@@ -0,0 +1,265 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "training_stats.h"
+
+// 2024-01-01 00:00:00 UTC
+#define BASE_EPOCH 1704067200UL
+#define BASE_DAY   (BASE_EPOCH / 86400UL)
+
+static TrainingStatsEngine engine;
+static uint32_t sequence;
+
+static void addRound(uint32_t epoch, uint32_t durationMs, bool completed = true) {
+    uint8_t flags = RECORD_FLAG_CLOCK_VALID | (completed ? RECORD_FLAG_COMPLETED : 0);
+    engine.add(TrainingRecordStore::pack(epoch, durationMs * 1000ULL, MODE_VIBRATION_TRAINING, flags), sequence++);
+}
+
+void setUp(void) {
+    engine.reset();
+    engine.setUtcOffset(0);
+    sequence = 0;
+}
+
+void tearDown(void) {}
+
+void test_totals_match_naive_recompute_over_many_records(void) {
+    // 10000条记录分布在约70天内，与逐条重算的结果对比
+    double sum = 0;
+    double sumSquares = 0;
+    uint32_t completed = 0;
+    uint32_t best = UINT32_MAX;
+    uint64_t total = 0;
+    uint32_t seed = 12345;
+
+    for (int i = 0; i < 10000; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t duration = 800 + (seed >> 8) % 9000;
+        bool done = (seed & 0x0F) != 0;
+        addRound(BASE_EPOCH + i * 600, duration, done);
+
+        total += duration;
+        if (done) {
+            completed++;
+            sum += duration;
+            sumSquares += (double)duration * duration;
+            if (duration < best) best = duration;
+        }
+    }
+
+    double mean = sum / completed;
+    double stddev = sqrt((sumSquares - sum * mean) / (completed - 1));
+
+    const StatsTotals& totals = engine.totals();
+    TEST_ASSERT_EQUAL_UINT32(10000, totals.rounds);
+    TEST_ASSERT_EQUAL_UINT32(completed, totals.completed);
+    TEST_ASSERT_EQUAL_UINT64(total, totals.totalMs);
+    TEST_ASSERT_EQUAL_UINT32(best, totals.bestMs);
+    TEST_ASSERT_UINT32_WITHIN(1, (uint32_t)(mean + 0.5), engine.meanMs());
+    TEST_ASSERT_UINT32_WITHIN(1, (uint32_t)(stddev + 0.5), engine.stddevMs());
+
+    // 全部日桶合并后应与累计统计一致
+    StatsRange all;
+    engine.range(engine.latestDay(), STATS_DAY_BUCKETS, all);
+    TEST_ASSERT_EQUAL_UINT32(10000, all.rounds);
+    TEST_ASSERT_EQUAL_UINT32(completed, all.completed);
+    TEST_ASSERT_EQUAL_UINT32(best, all.bestMs);
+    TEST_ASSERT_UINT32_WITHIN(1, engine.meanMs(), all.meanMs);
+    TEST_ASSERT_UINT32_WITHIN(2, engine.stddevMs(), all.stddevMs);
+}
+
+void test_day_buckets_follow_calendar_days_and_timezone(void) {
+    addRound(BASE_EPOCH + 23 * 3600, 1000);      // UTC 1月1日 23:00
+    addRound(BASE_EPOCH + 24 * 3600 + 60, 3000); // UTC 1月2日 00:01
+
+    TEST_ASSERT_NOT_NULL(engine.day(BASE_DAY));
+    TEST_ASSERT_EQUAL(1, engine.day(BASE_DAY)->rounds);
+    TEST_ASSERT_EQUAL(1, engine.day(BASE_DAY + 1)->rounds);
+
+    // UTC+8：两条记录都落在本地1月2日
+    engine.reset();
+    engine.setUtcOffset(8 * 3600);
+    sequence = 0;
+    addRound(BASE_EPOCH + 23 * 3600, 1000);
+    addRound(BASE_EPOCH + 24 * 3600 + 60, 3000);
+
+    TEST_ASSERT_NULL(engine.day(BASE_DAY));
+    const StatsDayBucket* bucket = engine.day(BASE_DAY + 1);
+    TEST_ASSERT_NOT_NULL(bucket);
+    TEST_ASSERT_EQUAL(2, bucket->rounds);
+    TEST_ASSERT_EQUAL_UINT32(1000, bucket->bestMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 2000.0, bucket->mean);
+}
+
+void test_old_days_roll_out_of_window(void) {
+    addRound(BASE_EPOCH, 1000);
+    addRound(BASE_EPOCH + STATS_DAY_BUCKETS * 86400UL, 2000);
+
+    // 同一槽位被新日期复用，旧日期不再可见，但累计统计保留
+    TEST_ASSERT_NULL(engine.day(BASE_DAY));
+    TEST_ASSERT_NOT_NULL(engine.day(BASE_DAY + STATS_DAY_BUCKETS));
+    TEST_ASSERT_EQUAL_UINT32(2, engine.totals().rounds);
+
+    // 早于窗口的迟到记录不进入日桶
+    addRound(BASE_EPOCH + 3600, 500);
+    TEST_ASSERT_NULL(engine.day(BASE_DAY));
+    TEST_ASSERT_EQUAL(1, engine.day(BASE_DAY + STATS_DAY_BUCKETS)->rounds);
+    TEST_ASSERT_EQUAL_UINT32(500, engine.totals().bestMs);
+}
+
+void test_records_without_valid_clock_and_sessions(void) {
+    engine.add(TrainingRecordStore::pack(0, 1500000, MODE_VIBRATION_TRAINING, RECORD_FLAG_COMPLETED), sequence++);
+    engine.add(TrainingRecordStore::pack(BASE_EPOCH, 60000000, MODE_VIBRATION_TRAINING,
+                                         RECORD_FLAG_COMPLETED | RECORD_FLAG_CLOCK_VALID | RECORD_FLAG_SESSION),
+               sequence++);
+
+    TEST_ASSERT_EQUAL_UINT32(1, engine.totals().rounds);
+    TEST_ASSERT_EQUAL_UINT32(1500, engine.totals().bestMs);
+    TEST_ASSERT_EQUAL_UINT32(1, engine.totals().sessions);
+    TEST_ASSERT_EQUAL_UINT64(60000, engine.totals().sessionMs);
+
+    const StatsDayBucket* bucket = engine.day(BASE_DAY);
+    TEST_ASSERT_NOT_NULL(bucket);
+    TEST_ASSERT_EQUAL(0, bucket->rounds);
+    TEST_ASSERT_EQUAL(1, bucket->sessions);
+}
+
+void test_range_and_week_over_week(void) {
+    for (int day = 0; day < 14; day++) {
+        // 第一周每天3000ms，第二周每天2000ms
+        uint32_t duration = day < 7 ? 3000 : 2000;
+        addRound(BASE_EPOCH + day * 86400UL + 3600, duration);
+        addRound(BASE_EPOCH + day * 86400UL + 7200, duration);
+    }
+
+    StatsRange thisWeek, lastWeek;
+    engine.range(BASE_DAY + 13, 7, thisWeek);
+    engine.range(BASE_DAY + 6, 7, lastWeek);
+    TEST_ASSERT_EQUAL_UINT32(14, thisWeek.rounds);
+    TEST_ASSERT_EQUAL(7, thisWeek.activeDays);
+    TEST_ASSERT_EQUAL_UINT32(2000, thisWeek.meanMs);
+    TEST_ASSERT_EQUAL_UINT32(0, thisWeek.stddevMs);
+    TEST_ASSERT_EQUAL_UINT32(3000, lastWeek.meanMs);
+
+    StatsRange both;
+    engine.range(BASE_DAY + 13, 14, both);
+    TEST_ASSERT_EQUAL_UINT32(2500, both.meanMs);
+    TEST_ASSERT_UINT32_WITHIN(1, 509, both.stddevMs);
+}
+
+void test_snapshot_roundtrip_and_replay(void) {
+    for (int i = 0; i < 50; i++) {
+        addRound(BASE_EPOCH + i * 3600, 1000 + i * 10);
+    }
+
+    static uint8_t buffer[STATS_SNAPSHOT_BYTES];
+    TEST_ASSERT_EQUAL(STATS_SNAPSHOT_BYTES, engine.saveSnapshot(buffer, sizeof(buffer)));
+
+    TrainingStatsEngine restored;
+    TEST_ASSERT_TRUE(restored.loadSnapshot(buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_UINT32(50, restored.nextSequence());
+    TEST_ASSERT_EQUAL_UINT32(engine.meanMs(), restored.meanMs());
+    TEST_ASSERT_EQUAL_UINT32(engine.totals().rounds, restored.totals().rounds);
+
+    // 回放时已包含在快照中的记录被忽略
+    restored.add(TrainingRecordStore::pack(BASE_EPOCH, 1000, 0, RECORD_FLAG_COMPLETED), 10);
+    TEST_ASSERT_EQUAL_UINT32(50, restored.totals().rounds);
+    restored.add(TrainingRecordStore::pack(BASE_EPOCH, 1000, 0, RECORD_FLAG_COMPLETED), 50);
+    TEST_ASSERT_EQUAL_UINT32(51, restored.totals().rounds);
+    TEST_ASSERT_EQUAL_UINT32(1, restored.totals().bestMs);
+}
+
+void test_corrupt_snapshot_is_rejected(void) {
+    addRound(BASE_EPOCH, 1000);
+
+    static uint8_t buffer[STATS_SNAPSHOT_BYTES];
+    engine.saveSnapshot(buffer, sizeof(buffer));
+    buffer[sizeof(StatsSnapshotHeader) + 5] ^= 0x01;
+
+    TrainingStatsEngine restored;
+    TEST_ASSERT_FALSE(restored.loadSnapshot(buffer, sizeof(buffer)));
+    TEST_ASSERT_FALSE(restored.loadSnapshot(buffer, sizeof(buffer) - 1));
+    TEST_ASSERT_EQUAL_UINT32(0, restored.totals().rounds);
+}
+
+void test_histogram_bins_are_monotonic_and_geometric(void) {
+    TEST_ASSERT_EQUAL(0, TrainingStatsEngine::histogramBin(100));
+    TEST_ASSERT_EQUAL(0, TrainingStatsEngine::histogramBin(250));
+    TEST_ASSERT_EQUAL(4, TrainingStatsEngine::histogramBin(500));
+    TEST_ASSERT_EQUAL(STATS_HIST_BINS - 1, TrainingStatsEngine::histogramBin(RECORD_DURATION_MAX));
+
+    uint8_t previous = 0;
+    for (uint32_t ms = 200; ms < 70000; ms += 7) {
+        uint8_t bin = TrainingStatsEngine::histogramBin(ms);
+        TEST_ASSERT_TRUE(bin >= previous);
+        TEST_ASSERT_TRUE(bin == 0 || ms >= TrainingStatsEngine::histogramEdge(bin));
+        TEST_ASSERT_TRUE(bin == STATS_HIST_BINS - 1 || ms < TrainingStatsEngine::histogramEdge(bin + 1));
+        previous = bin;
+    }
+}
+
+void test_histogram_median_is_within_one_bin(void) {
+    // 同一天的一组用时，中位数误差不超过所在桶宽度
+    const uint32_t durations[] = {1800, 2100, 2300, 2450, 2600, 2900, 4200};
+    for (uint32_t d : durations) {
+        addRound(BASE_EPOCH + 3600, d);
+    }
+    StatsTrend trend;
+    engine.trend(BASE_DAY, 1, trend);
+    TEST_ASSERT_EQUAL(1, trend.count);
+
+    uint8_t bin = TrainingStatsEngine::histogramBin(2450);
+    uint32_t width = TrainingStatsEngine::histogramEdge(bin + 1) - TrainingStatsEngine::histogramEdge(bin);
+    TEST_ASSERT_UINT32_WITHIN(width, 2450, trend.medianMs[0]);
+}
+
+void test_trend_daily_and_downsampled(void) {
+    // 90天内每天4次，第n天的用时为 2000 + 20n
+    for (int day = 0; day < 90; day++) {
+        for (int i = 0; i < 4; i++) {
+            addRound(BASE_EPOCH + day * 86400UL + i * 600, 2000 + day * 20);
+        }
+    }
+    uint32_t lastDay = BASE_DAY + 89;
+
+    StatsTrend week;
+    engine.trend(lastDay, 7, week);
+    TEST_ASSERT_EQUAL(7, week.count);
+    TEST_ASSERT_EQUAL(1, week.daysPerPoint);
+
+    StatsTrend quarter;
+    engine.trend(lastDay, 90, quarter);
+    TEST_ASSERT_EQUAL(30, quarter.count);
+    TEST_ASSERT_EQUAL(3, quarter.daysPerPoint);
+
+    // 最新点与7天序列末点覆盖相同的最近几天，趋势整体上升
+    TEST_ASSERT_TRUE(quarter.medianMs[0] > 0);
+    TEST_ASSERT_TRUE(quarter.medianMs[29] > quarter.medianMs[0]);
+    for (int i = 1; i < 30; i++) {
+        TEST_ASSERT_TRUE(quarter.medianMs[i] >= quarter.medianMs[i - 1]);
+    }
+    uint8_t bin = TrainingStatsEngine::histogramBin(2000 + 89 * 20);
+    uint32_t width = TrainingStatsEngine::histogramEdge(bin + 1) - TrainingStatsEngine::histogramEdge(bin);
+    TEST_ASSERT_UINT32_WITHIN(width, 2000 + 89 * 20, week.medianMs[6]);
+
+    // 没有数据的天为0
+    StatsTrend future;
+    engine.trend(lastDay + 3, 7, future);
+    TEST_ASSERT_EQUAL_UINT32(0, future.medianMs[6]);
+    TEST_ASSERT_TRUE(future.medianMs[0] > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_totals_match_naive_recompute_over_many_records);
+    RUN_TEST(test_day_buckets_follow_calendar_days_and_timezone);
+    RUN_TEST(test_old_days_roll_out_of_window);
+    RUN_TEST(test_records_without_valid_clock_and_sessions);
+    RUN_TEST(test_range_and_week_over_week);
+    RUN_TEST(test_snapshot_roundtrip_and_replay);
+    RUN_TEST(test_corrupt_snapshot_is_rejected);
+    RUN_TEST(test_histogram_bins_are_monotonic_and_geometric);
+    RUN_TEST(test_histogram_median_is_within_one_bin);
+    RUN_TEST(test_trend_daily_and_downsampled);
+    return UNITY_END();
+}
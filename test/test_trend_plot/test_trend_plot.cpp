@@ -0,0 +1,102 @@
+#include <unity.h>
+#include <string.h>
+#include "trend_plot.h"
+
+static uint8_t pixels[128 * 64 / 8];
+static FrameBuffer fb = {pixels, 128, 64};
+
+static bool pixelSet(int x, int y) {
+    return pixels[(y >> 3) * 128 + x] & (1 << (y & 7));
+}
+
+static int countPixels(void) {
+    int count = 0;
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 128; x++) {
+            if (pixelSet(x, y)) count++;
+        }
+    }
+    return count;
+}
+
+void setUp(void) {
+    memset(pixels, 0, sizeof(pixels));
+}
+
+void tearDown(void) {}
+
+void test_pixel_uses_page_layout(void) {
+    plotPixel(fb, 5, 0);
+    plotPixel(fb, 5, 9);
+    TEST_ASSERT_EQUAL_UINT8(0x01, pixels[5]);
+    TEST_ASSERT_EQUAL_UINT8(0x02, pixels[128 + 5]);
+
+    // 超出范围的像素被裁剪
+    plotPixel(fb, -1, 0);
+    plotPixel(fb, 128, 0);
+    plotPixel(fb, 0, 64);
+    TEST_ASSERT_EQUAL(2, countPixels());
+}
+
+void test_bresenham_lines(void) {
+    plotLine(fb, 0, 10, 20, 10);
+    TEST_ASSERT_EQUAL(21, countPixels());
+
+    memset(pixels, 0, sizeof(pixels));
+    plotLine(fb, 30, 40, 10, 20);
+    TEST_ASSERT_EQUAL(21, countPixels());
+    for (int i = 0; i <= 20; i++) {
+        TEST_ASSERT_TRUE(pixelSet(10 + i, 20 + i));
+    }
+
+    // 陡峭直线每行恰好一个像素，端点都被绘制
+    memset(pixels, 0, sizeof(pixels));
+    plotLine(fb, 50, 60, 53, 2);
+    TEST_ASSERT_EQUAL(59, countPixels());
+    TEST_ASSERT_TRUE(pixelSet(50, 60));
+    TEST_ASSERT_TRUE(pixelSet(53, 2));
+}
+
+void test_trend_scaling_and_gaps(void) {
+    const PlotArea area = {20, 30, 101, 21};
+    const uint32_t values[] = {3000, 0, 2000, 1000};
+    uint32_t low = 0, high = 0;
+
+    TEST_ASSERT_EQUAL(3, plotTrend(fb, area, values, 4, &low, &high));
+    TEST_ASSERT_EQUAL_UINT32(1000, low);
+    TEST_ASSERT_EQUAL_UINT32(3000, high);
+
+    // 最大值在顶部，最小值在底部，横向均分
+    TEST_ASSERT_TRUE(pixelSet(20, 30));
+    TEST_ASSERT_TRUE(pixelSet(87, 40));
+    TEST_ASSERT_TRUE(pixelSet(120, 50));
+    // 无数据的点被跳过，折线直接连接前后两点
+    TEST_ASSERT_TRUE(pixelSet(53, 35));
+
+    for (int x = 0; x < 128; x++) {
+        for (int y = 0; y < 64; y++) {
+            if (pixelSet(x, y)) {
+                TEST_ASSERT_TRUE(x >= 19 && x <= 121 && y >= 29 && y <= 51);
+            }
+        }
+    }
+}
+
+void test_trend_without_data(void) {
+    const PlotArea area = {0, 0, 128, 64};
+    const uint32_t values[] = {0, 0, 0};
+    uint32_t low = 1, high = 1;
+    TEST_ASSERT_EQUAL(0, plotTrend(fb, area, values, 3, &low, &high));
+    TEST_ASSERT_EQUAL_UINT32(0, low);
+    TEST_ASSERT_EQUAL_UINT32(0, high);
+    TEST_ASSERT_EQUAL(0, countPixels());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_pixel_uses_page_layout);
+    RUN_TEST(test_bresenham_lines);
+    RUN_TEST(test_trend_scaling_and_gaps);
+    RUN_TEST(test_trend_without_data);
+    return UNITY_END();
+}
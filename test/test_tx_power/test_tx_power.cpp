@@ -0,0 +1,118 @@
+#include <unity.h>
+#include "tx_power.h"
+
+static const uint8_t kNear[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x01};
+static const uint8_t kFar[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x02};
+static const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static TxPowerController power;
+
+// 简单链路模型：对端收到的RSSI = 满功率时的RSSI - 功率降低量
+static int8_t rssiAt(int8_t fullPowerRssi, int8_t level) {
+    return (int8_t)(fullPowerRssi - (TXP_LEVEL_MAX - level) / 4);
+}
+
+// 每秒一次心跳往返，持续seconds秒
+static void runLink(const uint8_t* mac, int8_t fullPowerRssi, uint32_t seconds, uint64_t& now) {
+    for (uint32_t i = 0; i < seconds; i++) {
+        now += 1000000;
+        int8_t level = power.levelFor(mac);
+        power.onSent(level);
+        power.onDelivery(mac, true, now);
+        power.onFeedback(mac, rssiAt(fullPowerRssi, level), now);
+    }
+}
+
+void setUp(void) {
+    power.reset();
+}
+
+void tearDown(void) {}
+
+void test_unknown_peer_uses_max(void) {
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kNear));
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kBroadcast));
+    TEST_ASSERT_EQUAL_INT32(200, power.stats().averageDeciDbm());
+}
+
+void test_near_peer_steps_down_to_target(void) {
+    uint64_t now = 0;
+    runLink(kNear, -55, 60, now);
+
+    // 降到接收强度落入[目标, 目标+带宽)，不低于目标
+    int8_t level = power.levelFor(kNear);
+    int8_t rssi = rssiAt(-55, level);
+    TEST_ASSERT_TRUE(rssi >= TXP_TARGET_RSSI);
+    TEST_ASSERT_TRUE(rssi < TXP_TARGET_RSSI + TXP_BAND_DB || level == TXP_LEVEL_MIN);
+    TEST_ASSERT_TRUE(level < TXP_LEVEL_MAX);
+    TEST_ASSERT_EQUAL_UINT16(0, power.stats().stepsUp);
+    TEST_ASSERT_LESS_THAN(200, power.stats().averageDeciDbm());
+}
+
+void test_far_peer_stays_at_max(void) {
+    uint64_t now = 0;
+    runLink(kFar, -75, 30, now);
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kFar));
+    TEST_ASSERT_EQUAL_UINT16(0, power.stats().stepsDown);
+}
+
+void test_loss_snaps_to_max_and_holds(void) {
+    uint64_t now = 0;
+    runLink(kNear, -55, 60, now);
+    TEST_ASSERT_TRUE(power.levelFor(kNear) < TXP_LEVEL_MAX);
+
+    for (uint8_t i = 0; i < TXP_LOSS_SNAP; i++) {
+        now += 10000;
+        power.onDelivery(kNear, false, now);
+    }
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kNear));
+    TEST_ASSERT_EQUAL_UINT16(1, power.stats().snaps);
+
+    // 暂停期内不降功率，之后重新收敛
+    runLink(kNear, -55, TXP_HOLDOFF_US / 1000000 - 1, now);
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kNear));
+    runLink(kNear, -55, 60, now);
+    TEST_ASSERT_TRUE(power.levelFor(kNear) < TXP_LEVEL_MAX);
+}
+
+void test_weak_feedback_steps_up(void) {
+    uint64_t now = 0;
+    runLink(kNear, -55, 60, now);
+    int8_t level = power.levelFor(kNear);
+
+    // 环境变差（如有人遮挡）：对端回报低于目标时升一级
+    now += 1000000;
+    power.onFeedback(kNear, TXP_TARGET_RSSI - 3, now);
+    TEST_ASSERT_EQUAL_INT8(level + TXP_STEP, power.levelFor(kNear));
+    TEST_ASSERT_EQUAL_UINT16(1, power.stats().stepsUp);
+}
+
+void test_broadcast_uses_highest_peer_level(void) {
+    uint64_t now = 0;
+    runLink(kNear, -55, 60, now);
+    runLink(kFar, -75, 5, now);
+    TEST_ASSERT_TRUE(power.levelFor(kNear) < TXP_LEVEL_MAX);
+    TEST_ASSERT_EQUAL_INT8(TXP_LEVEL_MAX, power.levelFor(kBroadcast));
+}
+
+void test_feedback_packing(void) {
+    uint32_t data = txPowerPackFeedback(3, -67);
+    TEST_ASSERT_TRUE(txPowerHasFeedback(data));
+    TEST_ASSERT_EQUAL_INT8(-67, txPowerFeedbackRssi(data));
+    TEST_ASSERT_EQUAL_UINT32(3, data & 0xFF);
+    // 尚未收到对端帧时不带回报，与旧固件的心跳data相同
+    TEST_ASSERT_EQUAL_UINT32(3, txPowerPackFeedback(3, 0));
+    TEST_ASSERT_FALSE(txPowerHasFeedback(5));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unknown_peer_uses_max);
+    RUN_TEST(test_near_peer_steps_down_to_target);
+    RUN_TEST(test_far_peer_stays_at_max);
+    RUN_TEST(test_loss_snaps_to_max_and_holds);
+    RUN_TEST(test_weak_feedback_steps_up);
+    RUN_TEST(test_broadcast_uses_highest_peer_level);
+    RUN_TEST(test_feedback_packing);
+    return UNITY_END();
+}
@@ -0,0 +1,288 @@
+#include <unity.h>
+#include <string.h>
+#include "clock.h"
+#include "tx_scheduler.h"
+
+#define AIRTIME_US 1500      // 单帧空口时间（含退避与应答）
+#define MAX_SENT   8192
+
+static const uint8_t kPeer[6] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0x02};
+static const uint8_t kBroadcast[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// 模拟信道：每帧占用AIRTIME_US后回调发送完成；busyCalls>0时模拟驱动缓冲区满
+class SimTransport : public TxTransport {
+public:
+    struct Sent {
+        uint8_t command;
+        uint8_t value;
+        uint64_t atUs;
+    };
+
+    Sent sent[MAX_SENT];
+    uint32_t sentCount;
+    uint64_t completeAtUs[8];
+    uint8_t pending;
+    uint32_t busyCalls;
+    bool dropCallbacks;
+    uint8_t interleaveKey;      // 非0时发送期间模拟接收回调入队一帧（同键可合并）
+    uint8_t depth;
+    uint8_t maxDepth;
+
+    void reset() {
+        sentCount = 0;
+        pending = 0;
+        busyCalls = 0;
+        dropCallbacks = false;
+        interleaveKey = 0;
+        depth = 0;
+        maxDepth = 0;
+    }
+
+    TxSendResult send(const uint8_t* mac, const uint8_t* data, uint8_t length) override;
+
+    TxSendResult transmit(const uint8_t* mac, const uint8_t* data, uint8_t length) {
+        if (busyCalls > 0) {
+            busyCalls--;
+            return TX_SEND_BUSY;
+        }
+        if (sentCount < MAX_SENT) {
+            sent[sentCount++] = {data[0], length > 1 ? data[1] : (uint8_t)0, Clock::nowUs()};
+        }
+        // 空口串行：前一帧发完后才开始
+        uint64_t start = pending ? completeAtUs[pending - 1] : Clock::nowUs();
+        completeAtUs[pending++] = start + AIRTIME_US;
+        return TX_SEND_OK;
+    }
+};
+
+static SimTransport channel;
+static TxScheduler* scheduler = nullptr;
+
+TxSendResult SimTransport::send(const uint8_t* mac, const uint8_t* data, uint8_t length) {
+    depth++;
+    if (depth > maxDepth) {
+        maxDepth = depth;
+    }
+    TxSendResult result = transmit(mac, data, length);
+    if (interleaveKey != 0) {
+        uint8_t key = interleaveKey;
+        interleaveKey = 0;
+        uint8_t reply[2] = {key, 0xEE};
+        scheduler->enqueue(mac, reply, sizeof(reply), TX_PRIO_HEARTBEAT, key);
+    }
+    depth--;
+    return result;
+}
+
+// 推进虚拟时间，到期的发送完成回调依次触发，每毫秒运行一次主循环
+static void run(uint64_t us) {
+    uint64_t end = Clock::nowUs() + us;
+    while (Clock::nowUs() < end) {
+        Clock::advanceUs(100);
+        while (channel.pending && channel.completeAtUs[0] <= Clock::nowUs()) {
+            memmove(channel.completeAtUs, channel.completeAtUs + 1, (channel.pending - 1) * sizeof(uint64_t));
+            channel.pending--;
+            if (!channel.dropCallbacks) {
+                scheduler->onSendComplete(true);
+            }
+        }
+        if (Clock::nowUs() % 1000 == 0) {
+            scheduler->service();
+        }
+    }
+}
+
+static bool send(uint8_t command, uint8_t value, TxPriority priority, uint8_t coalesceKey = 0,
+                 const uint8_t* mac = kPeer) {
+    uint8_t frame[2] = {command, value};
+    return scheduler->enqueue(mac, frame, sizeof(frame), priority, coalesceKey);
+}
+
+void setUp(void) {
+    Clock::setUs(1000000);
+    channel.reset();
+    delete scheduler;
+    scheduler = new TxScheduler(channel);
+}
+
+void tearDown(void) {}
+
+void test_idle_link_sends_immediately(void) {
+    TEST_ASSERT_TRUE(send(0x20, 1, TX_PRIO_TIMING));
+    TEST_ASSERT_EQUAL_UINT32(1, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT64(1000000, channel.sent[0].atUs);
+    TEST_ASSERT_EQUAL_UINT8(1, scheduler->inFlight());
+    run(2000);
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler->inFlight());
+}
+
+void test_priority_order_when_backlogged(void) {
+    // 第一帧占用名额后，其余按优先级而非入队顺序发出
+    send(0x06, 0, TX_PRIO_HEARTBEAT);
+    send(0x06, 1, TX_PRIO_HEARTBEAT);
+    send(0x40, 2, TX_PRIO_TELEMETRY);
+    send(0x10, 3, TX_PRIO_CONTROL);
+    send(0x40, 4, TX_PRIO_TELEMETRY);
+    run(20000);
+
+    TEST_ASSERT_EQUAL_UINT32(5, channel.sentCount);
+    const uint8_t expected[5] = {0, 3, 2, 4, 1};
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT8(expected[i], channel.sent[i].value);
+    }
+}
+
+void test_timing_never_waits_behind_heartbeat_under_load(void) {
+    // 10秒负载：每3ms一帧状态上报、每50ms一个心跳（信道利用率约50%），随机插入计时消息
+    uint32_t timingSent = 0;
+    uint32_t seed = 12345;
+    for (int ms = 0; ms < 10000; ms++) {
+        if (ms % 3 == 0) {
+            send(0x40, (uint8_t)ms, TX_PRIO_TELEMETRY);
+        }
+        if (ms % 50 == 7) {
+            send(0x06, (uint8_t)ms, TX_PRIO_HEARTBEAT, 0x06);
+        }
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 97 == 0) {
+            uint32_t before = channel.sentCount;
+            TEST_ASSERT_TRUE(send(0x20, 0xEE, TX_PRIO_TIMING));
+            // 入队当下即发出，与其它消息是否在途无关
+            TEST_ASSERT_EQUAL_UINT32(before + 1, channel.sentCount);
+            TEST_ASSERT_EQUAL_UINT8(0x20, channel.sent[channel.sentCount - 1].command);
+            timingSent++;
+        }
+        run(1000);
+    }
+
+    const TxStats& stats = scheduler->stats();
+    TEST_ASSERT_GREATER_THAN(50, timingSent);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxWaitUs[TX_PRIO_TIMING]);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.timeouts);
+    // 低优先级消息同时仍在持续发出
+    TEST_ASSERT_GREATER_THAN(3300, stats.sent);
+}
+
+void test_heartbeat_coalesced_in_queue(void) {
+    send(0x40, 0, TX_PRIO_TELEMETRY);           // 占用非计时名额
+    send(0x06, 1, TX_PRIO_HEARTBEAT, 0x06);
+    send(0x06, 2, TX_PRIO_HEARTBEAT, 0x06);
+    send(0x06, 3, TX_PRIO_HEARTBEAT, 0x06, kBroadcast);  // 目标不同，不合并
+    TEST_ASSERT_EQUAL_UINT8(2, scheduler->queued());
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->stats().coalesced);
+
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(3, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(2, channel.sent[1].value);
+    TEST_ASSERT_EQUAL_UINT8(3, channel.sent[2].value);
+}
+
+void test_full_queue_evicts_lowest_priority(void) {
+    send(0x40, 0xFF, TX_PRIO_TELEMETRY);        // 在途
+    for (int i = 0; i < TX_QUEUE_SIZE; i++) {
+        TEST_ASSERT_TRUE(send(0x06, (uint8_t)i, TX_PRIO_HEARTBEAT));
+    }
+    // 同级不挤占，控制消息挤掉最新的心跳
+    TEST_ASSERT_FALSE(send(0x06, 99, TX_PRIO_HEARTBEAT));
+    TEST_ASSERT_TRUE(send(0x10, 100, TX_PRIO_CONTROL));
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->stats().rejected);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->stats().evicted);
+
+    run(40000);
+    TEST_ASSERT_EQUAL_UINT32(1 + TX_QUEUE_SIZE, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(100, channel.sent[1].value);
+    TEST_ASSERT_EQUAL_UINT8(TX_QUEUE_SIZE - 2, channel.sent[TX_QUEUE_SIZE].value);
+}
+
+void test_busy_driver_backs_off_and_keeps_order(void) {
+    channel.busyCalls = 2;
+    TEST_ASSERT_TRUE(send(0x20, 1, TX_PRIO_TIMING));
+    TEST_ASSERT_TRUE(send(0x21, 2, TX_PRIO_TIMING));
+    TEST_ASSERT_EQUAL_UINT32(0, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(2, scheduler->queued());
+
+    run(TX_BUSY_BACKOFF_US * 3);
+    TEST_ASSERT_EQUAL_UINT32(2, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(1, channel.sent[0].value);
+    TEST_ASSERT_EQUAL_UINT8(2, channel.sent[1].value);
+    TEST_ASSERT_EQUAL_UINT32(2, scheduler->stats().busy);
+    TEST_ASSERT_GREATER_OR_EQUAL(TX_BUSY_BACKOFF_US, scheduler->stats().maxWaitUs[TX_PRIO_TIMING]);
+}
+
+void test_lost_callback_releases_slot(void) {
+    // 发送回调丢失时名额一直被占用，超时后回收，排队的帧继续发出
+    channel.dropCallbacks = true;
+    send(0x40, 0, TX_PRIO_TELEMETRY);
+    send(0x10, 1, TX_PRIO_CONTROL);
+    TEST_ASSERT_EQUAL_UINT32(1, channel.sentCount);
+
+    run(TX_COMPLETE_TIMEOUT_US + 2000);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->stats().timeouts);
+    TEST_ASSERT_EQUAL_UINT32(2, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(1, channel.sent[1].value);
+}
+
+void test_stale_heartbeat_expires(void) {
+    // 驱动持续忙时，心跳排队超过1秒后丢弃，计时消息保留
+    channel.busyCalls = 1000000;
+    send(0x06, 1, TX_PRIO_HEARTBEAT);
+    send(0x20, 2, TX_PRIO_TIMING);
+    run(1100000);
+    TEST_ASSERT_EQUAL_UINT32(1, scheduler->stats().expired);
+    TEST_ASSERT_EQUAL_UINT8(1, scheduler->queued());
+
+    channel.busyCalls = 0;
+    run(TX_BUSY_BACKOFF_US + 1000);
+    TEST_ASSERT_EQUAL_UINT32(1, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(0x20, channel.sent[0].command);
+}
+
+void test_hold_defers_without_expiring(void) {
+    // 锥桶接收关闭期间只入队，超过过期时间也保留，解除后按优先级发出
+    scheduler->setHold(true);
+    send(0x06, 1, TX_PRIO_HEARTBEAT, 0x06);
+    send(0x10, 2, TX_PRIO_CONTROL);
+    run(1500000);
+    TEST_ASSERT_EQUAL_UINT32(0, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->stats().expired);
+
+    scheduler->setHold(false);
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(2, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(2, channel.sent[0].value);
+    TEST_ASSERT_EQUAL_UINT8(1, channel.sent[1].value);
+    // 保持时间不计入排队等待
+    TEST_ASSERT_LESS_THAN(10000, scheduler->stats().maxWaitUs[TX_PRIO_HEARTBEAT]);
+}
+
+void test_enqueue_during_send_does_not_touch_frame_in_flight(void) {
+    // 主循环发送心跳时接收回调入队同键的心跳应答：不改写正在发送的帧，也不嵌套发送
+    channel.interleaveKey = 0x06;
+    send(0x06, 1, TX_PRIO_HEARTBEAT, 0x06);
+    TEST_ASSERT_EQUAL_UINT32(1, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(1, channel.sent[0].value);
+    TEST_ASSERT_EQUAL_UINT8(1, channel.maxDepth);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler->stats().coalesced);
+
+    // 回调入队的帧由正在运行的service()接着发出
+    run(10000);
+    TEST_ASSERT_EQUAL_UINT32(2, channel.sentCount);
+    TEST_ASSERT_EQUAL_UINT8(0xEE, channel.sent[1].value);
+    TEST_ASSERT_EQUAL_UINT8(0, scheduler->queued());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_link_sends_immediately);
+    RUN_TEST(test_priority_order_when_backlogged);
+    RUN_TEST(test_timing_never_waits_behind_heartbeat_under_load);
+    RUN_TEST(test_heartbeat_coalesced_in_queue);
+    RUN_TEST(test_full_queue_evicts_lowest_priority);
+    RUN_TEST(test_busy_driver_backs_off_and_keeps_order);
+    RUN_TEST(test_lost_callback_releases_slot);
+    RUN_TEST(test_stale_heartbeat_expires);
+    RUN_TEST(test_hold_defers_without_expiring);
+    RUN_TEST(test_enqueue_during_send_does_not_touch_frame_in_flight);
+    return UNITY_END();
+}
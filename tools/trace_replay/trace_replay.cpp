@@ -0,0 +1,347 @@
+// 传感器数据离线回放 - 用设备上相同的检测代码对采集的数据做参数扫描
+//
+// 编译 (在仓库根目录):
+//   g++ -std=c++17 -O2 -Ilib/sensor_trace -Ilib/crc32 -Ilib/impact_detector -Ilib/hal -o trace_replay tools/trace_replay/trace_replay.cpp lib/sensor_trace/sensor_trace.cpp lib/crc32/crc32.cpp lib/impact_detector/impact_detector.cpp
+//
+// 采集: 串口输入 "trace start"，训练结束后输入 "trace stop"，将串口原始输出保存为文件
+//   (例如 `cat /dev/ttyACM0 > session1.trace`)，文本日志会被自动跳过。
+// 标注: 与数据文件同名的 .truth 文件 (session1.trace.truth)，每行一个真实敲击时刻，
+//   单位毫秒，使用设备时钟 (可用 --list 输出的检测时刻对照视频整理)。
+//
+// 用法: trace_replay [选项] 文件...
+//   --tolerance-ms N        检测与标注的匹配容差，默认30
+//   --list                  逐个输出第一组参数的检测时刻
+//  开关量传感器 (边沿数据):
+//   --debounce A[:B:STEP]   防抖时间ms，默认使用采集时的设置
+//   --poll-us N             主循环轮询间隔，默认1000；0表示每个边沿都被立即采样
+//  模拟传感器 (采样数据):
+//   --refractory A[:B:STEP]     冲击最小间隔ms，默认使用采集时的设置
+//   --threshold-q4 A[:B:STEP]   阈值倍数 (1/16)
+//   --min-threshold A[:B:STEP]  最小阈值 (ADC计数)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "edge_queue.h"
+#include "sensor_trace.h"
+#include "hal_host.h"
+#include "impact_detector.h"
+
+struct SampleBlock {
+    uint64_t firstUs;
+    uint32_t periodUs;
+    std::vector<uint16_t> samples;
+};
+
+struct Recording {
+    std::string path;
+    TraceHeader header;
+    TraceFooter footer;
+    bool hasHeader;
+    bool hasEnd;
+    std::vector<Edge> edges;
+    std::vector<SampleBlock> blocks;
+    std::vector<uint64_t> truth;
+    uint32_t badChunks;
+};
+
+struct Range {
+    uint32_t first;
+    uint32_t last;
+    uint32_t step;
+    bool set;
+};
+
+struct Options {
+    uint32_t toleranceUs;
+    uint32_t pollUs;
+    bool list;
+    Range debounce;
+    Range refractory;
+    Range thresholdQ4;
+    Range minThreshold;
+};
+
+static void onHeader(const TraceHeader& header, void* context) {
+    Recording* r = (Recording*)context;
+    r->header = header;
+    r->hasHeader = true;
+}
+
+static void onEdge(uint64_t atUs, bool level, void* context) {
+    ((Recording*)context)->edges.push_back({atUs, level});
+}
+
+static void onSamples(const uint16_t* samples, uint16_t count, uint64_t firstUs, uint32_t periodUs, void* context) {
+    Recording* r = (Recording*)context;
+    // 相邻且连续的块合并，减少回放时的分块
+    if (!r->blocks.empty()) {
+        SampleBlock& last = r->blocks.back();
+        if (last.periodUs == periodUs && last.samples.size() < 4096 &&
+            last.firstUs + last.samples.size() * (uint64_t)periodUs == firstUs) {
+            last.samples.insert(last.samples.end(), samples, samples + count);
+            return;
+        }
+    }
+    r->blocks.push_back({firstUs, periodUs, std::vector<uint16_t>(samples, samples + count)});
+}
+
+static void onEnd(const TraceFooter& footer, void* context) {
+    Recording* r = (Recording*)context;
+    r->footer = footer;
+    r->hasEnd = true;
+}
+
+static bool loadRecording(const char* path, Recording& recording) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "无法打开 %s\n", path);
+        return false;
+    }
+    recording = Recording();
+    recording.path = path;
+
+    TraceCallbacks callbacks = {onHeader, onEdge, onSamples, onEnd, &recording};
+    TraceParser parser(callbacks);
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        parser.feed(buffer, n);
+    }
+    fclose(file);
+    recording.badChunks = parser.badChunks();
+
+    if (!recording.hasHeader) {
+        fprintf(stderr, "%s: 未找到数据头\n", path);
+        return false;
+    }
+
+    std::string truthPath = std::string(path) + ".truth";
+    file = fopen(truthPath.c_str(), "r");
+    if (file) {
+        char line[64];
+        while (fgets(line, sizeof(line), file)) {
+            char* end;
+            double ms = strtod(line, &end);
+            if (end != line) {
+                recording.truth.push_back((uint64_t)(ms * 1000.0 + 0.5));
+            }
+        }
+        fclose(file);
+    }
+
+    uint64_t samples = 0;
+    for (const SampleBlock& block : recording.blocks) {
+        samples += block.samples.size();
+    }
+    fprintf(stderr, "%s: %s, %zu个边沿, %llu个采样, %zu个标注, 损坏块%u, 设备丢弃块%u/边沿%u\n",
+            path, recording.header.kind == TRACE_KIND_SAMPLES ? "采样" : "边沿",
+            recording.edges.size(), (unsigned long long)samples, recording.truth.size(),
+            recording.badChunks, recording.footer.droppedChunks, recording.footer.droppedEdges);
+    return true;
+}
+
+// 开关量：按轮询时刻对边沿采样，同一轮询间隔内的多个边沿只看到最后的电平
+static void replayEdges(const Recording& recording, uint32_t debounceMs, uint32_t pollUs,
+                        std::vector<uint64_t>& hits) {
+    HostTriggerInput<0> input;
+    input.setDebounceMs(debounceMs);
+    if (recording.edges.empty()) {
+        return;
+    }
+
+    // 第一个边沿为开始采集时的电平
+    input.input = recording.edges[0].level;
+    input.poll(recording.edges[0].atUs);
+
+    size_t i = 1;
+    while (i < recording.edges.size()) {
+        uint64_t atUs = recording.edges[i].atUs;
+        uint64_t pollAt = pollUs ? (atUs + pollUs - 1) / pollUs * pollUs : atUs;
+        while (i < recording.edges.size() && recording.edges[i].atUs <= pollAt) {
+            input.input = recording.edges[i].level;
+            i++;
+        }
+        if (input.poll(pollAt)) {
+            hits.push_back(pollAt);
+        }
+    }
+}
+
+// 模拟：与设备相同按块送入ImpactDetector
+static void replaySamples(const Recording& recording, const ImpactDetectorConfig& config,
+                          std::vector<uint64_t>& hits) {
+    ImpactDetector detector;
+    detector.setConfig(config);
+    for (const SampleBlock& block : recording.blocks) {
+        for (size_t i = 0; i < block.samples.size(); i += 128) {
+            uint16_t count = (uint16_t)(block.samples.size() - i < 128 ? block.samples.size() - i : 128);
+            detector.process(&block.samples[i], count, block.firstUs + i * (uint64_t)block.periodUs, block.periodUs);
+            ImpactEvent event;
+            while (detector.nextEvent(event)) {
+                hits.push_back(event.atUs);
+            }
+        }
+    }
+}
+
+static bool parseRange(const char* text, Range& range) {
+    unsigned long a, b, step;
+    int fields = sscanf(text, "%lu:%lu:%lu", &a, &b, &step);
+    if (fields == 1) {
+        range = {(uint32_t)a, (uint32_t)a, 1, true};
+        return true;
+    }
+    if (fields == 3 && step > 0 && b >= a) {
+        range = {(uint32_t)a, (uint32_t)b, (uint32_t)step, true};
+        return true;
+    }
+    fprintf(stderr, "范围格式错误: %s (应为 A 或 A:B:STEP)\n", text);
+    return false;
+}
+
+static std::vector<uint32_t> expand(const Range& range, uint32_t fallback) {
+    std::vector<uint32_t> values;
+    if (!range.set) {
+        values.push_back(fallback);
+        return values;
+    }
+    for (uint32_t v = range.first; v <= range.last; v += range.step) {
+        values.push_back(v);
+    }
+    return values;
+}
+
+static void printRow(const char* params, const TraceScore& total, bool hasTruth) {
+    if (hasTruth) {
+        printf("%-36s %8u %8u %8u %8u\n", params, total.detected, total.matched, total.falseHits, total.missed);
+    } else {
+        printf("%-36s %8u\n", params, total.detected);
+    }
+}
+
+static void accumulate(TraceScore& total, const std::vector<uint64_t>& hits,
+                       const Recording& recording, uint32_t toleranceUs) {
+    TraceScore score = scoreHits(hits.data(), hits.size(), recording.truth.data(),
+                                 recording.truth.size(), toleranceUs);
+    total.detected += score.detected;
+    total.matched += score.matched;
+    total.falseHits += score.falseHits;
+    total.missed += score.missed;
+}
+
+static void listHits(const Recording& recording, const std::vector<uint64_t>& hits) {
+    for (uint64_t atUs : hits) {
+        printf("%s %.3f\n", recording.path.c_str(), atUs / 1000.0);
+    }
+}
+
+static void usage() {
+    fprintf(stderr,
+            "用法: trace_replay [--tolerance-ms N] [--list] [--debounce A[:B:STEP]] [--poll-us N]\n"
+            "                   [--refractory A[:B:STEP]] [--threshold-q4 A[:B:STEP]]\n"
+            "                   [--min-threshold A[:B:STEP]] 文件...\n");
+}
+
+int main(int argc, char** argv) {
+    Options options = {30000, 1000, false, {}, {}, {}, {}};
+    std::vector<Recording> recordings;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (strcmp(arg, "--tolerance-ms") == 0 && hasValue) {
+            options.toleranceUs = (uint32_t)atoi(argv[++i]) * 1000;
+        } else if (strcmp(arg, "--poll-us") == 0 && hasValue) {
+            options.pollUs = (uint32_t)atoi(argv[++i]);
+        } else if (strcmp(arg, "--list") == 0) {
+            options.list = true;
+        } else if (strcmp(arg, "--debounce") == 0 && hasValue) {
+            if (!parseRange(argv[++i], options.debounce)) return 1;
+        } else if (strcmp(arg, "--refractory") == 0 && hasValue) {
+            if (!parseRange(argv[++i], options.refractory)) return 1;
+        } else if (strcmp(arg, "--threshold-q4") == 0 && hasValue) {
+            if (!parseRange(argv[++i], options.thresholdQ4)) return 1;
+        } else if (strcmp(arg, "--min-threshold") == 0 && hasValue) {
+            if (!parseRange(argv[++i], options.minThreshold)) return 1;
+        } else if (arg[0] == '-') {
+            usage();
+            return 1;
+        } else {
+            recordings.emplace_back();
+            if (!loadRecording(arg, recordings.back())) {
+                return 1;
+            }
+        }
+    }
+    if (recordings.empty()) {
+        usage();
+        return 1;
+    }
+
+    // 所有文件须为同一种传感器，参数默认值取第一个文件的采集设置
+    const TraceHeader& first = recordings[0].header;
+    bool hasTruth = true;
+    for (const Recording& r : recordings) {
+        if (r.header.kind != first.kind) {
+            fprintf(stderr, "%s: 传感器类型与第一个文件不同\n", r.path.c_str());
+            return 1;
+        }
+        hasTruth = hasTruth && !r.truth.empty();
+    }
+    if (hasTruth) {
+        printf("%-36s %8s %8s %8s %8s\n", "参数", "检测", "命中", "误触发", "漏检");
+    } else {
+        printf("%-36s %8s\n", "参数 (缺少标注文件)", "检测");
+    }
+
+    char params[64];
+    bool listed = false;
+    std::vector<uint64_t> hits;
+    if (first.kind == TRACE_KIND_EDGES) {
+        for (uint32_t debounceMs : expand(options.debounce, first.debounceMs)) {
+            TraceScore total = {};
+            for (const Recording& r : recordings) {
+                hits.clear();
+                replayEdges(r, debounceMs, options.pollUs, hits);
+                accumulate(total, hits, r, options.toleranceUs);
+                if (options.list && !listed) {
+                    listHits(r, hits);
+                }
+            }
+            listed = true;
+            snprintf(params, sizeof(params), "debounce=%ums poll=%uus", debounceMs, options.pollUs);
+            printRow(params, total, hasTruth);
+        }
+        return 0;
+    }
+
+    ImpactDetectorConfig base = ImpactDetector::defaultConfig(first.debounceMs * 1000);
+    for (uint32_t refractoryMs : expand(options.refractory, first.debounceMs)) {
+        for (uint32_t thresholdQ4 : expand(options.thresholdQ4, base.thresholdQ4)) {
+            for (uint32_t minThreshold : expand(options.minThreshold, base.minThreshold)) {
+                ImpactDetectorConfig config = base;
+                config.refractoryUs = refractoryMs * 1000;
+                config.thresholdQ4 = (uint16_t)thresholdQ4;
+                config.minThreshold = (uint16_t)minThreshold;
+
+                TraceScore total = {};
+                for (const Recording& r : recordings) {
+                    hits.clear();
+                    replaySamples(r, config, hits);
+                    accumulate(total, hits, r, options.toleranceUs);
+                    if (options.list && !listed) {
+                        listHits(r, hits);
+                    }
+                }
+                listed = true;
+                snprintf(params, sizeof(params), "refractory=%ums threshold=%u/16 min=%u",
+                         refractoryMs, thresholdQ4, minThreshold);
+                printRow(params, total, hasTruth);
+            }
+        }
+    }
+    return 0;
+}